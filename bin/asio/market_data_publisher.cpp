@@ -0,0 +1,5 @@
+#include <pg/asio_test/market_data.hpp>
+
+int main() {
+	return market_data_publisher();
+}
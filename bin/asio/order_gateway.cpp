@@ -0,0 +1,5 @@
+#include <pg/asio_test/order_gateway.hpp>
+
+int main() {
+	return order_gateway();
+}
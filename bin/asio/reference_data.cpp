@@ -0,0 +1,5 @@
+#include <pg/asio_test/reference_data.hpp>
+
+int main(int argc, char** argv) {
+	return reference_data(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,5 @@
+#include <pg/asio_test/asio_test.hpp>
+
+int main() {
+	return socket_listener_pool();
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "pg/language_practice/async_logger.hpp"
+
+// AsyncFileLogger 呼叫端的成本：logf (format id + 原始參數) 跟 log (std::string,
+// 走 Logger 介面)，對照同步的 fmt::print 到同一個檔案。每輪 log kBurst 筆後
+// 停一下讓背景 thread 清 ring (模擬 matching thread 一陣一陣地出 log)，
+// 只計 log 呼叫本身的時間。
+
+constexpr std::size_t kBurst = 4096;
+constexpr std::size_t kRounds = 200;
+
+template <typename F>
+double per_call_ns(F&& log_one) {
+	double total = 0;
+	for (std::size_t r = 0; r < kRounds; ++r) {
+		auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < kBurst; ++i)
+			log_one(r * kBurst + i);
+		total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	return total / (kRounds * kBurst);
+}
+
+int main() {
+	const char* path = "/tmp/async_logger_bench.log";
+	std::remove(path);
+
+	double logf_ns, log_ns, dropped;
+	{
+		AsyncFileLoggerFactory factory(path);
+		std::unique_ptr<Logger> base = factory.create();
+		auto& logger = static_cast<AsyncFileLogger&>(*base);
+
+		logf_ns = per_call_ns([&](std::size_t i) {
+			logger.logf<"fill order {} qty {} @ {:.2f} side {}">(i, static_cast<uint32_t>(i % 100),
+																															 100.0 + (i % 50) * 0.01, "buy");
+		});
+		std::string msg = "cancel acknowledged for order 1234567890 by risk check";
+		log_ns = per_call_ns([&](std::size_t) { logger.log(msg); });
+		dropped = static_cast<double>(logger.dropped());
+	}	 // 解構時把剩下的寫完
+
+	std::FILE* file = std::fopen(path, "ab");
+	double sync_ns = per_call_ns([&](std::size_t i) {
+		fmt::print(file, "fill order {} qty {} @ {:.2f} side {}\n", i, static_cast<uint32_t>(i % 100),
+							 100.0 + (i % 50) * 0.01, "buy");
+	});
+	std::fclose(file);
+
+	std::cout << "caller-side ns per log call (" << kRounds << " bursts of " << kBurst << ")\n";
+	std::cout << "AsyncFileLogger::logf      " << logf_ns << "\n";
+	std::cout << "AsyncFileLogger::log       " << log_ns << "\n";
+	std::cout << "fmt::print to FILE (sync)  " << sync_ns << "\n";
+	std::cout << "dropped                    " << dropped << "\n";
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "pg/language_practice/some_ds.hpp"
+
+// ConcurrentBinaryHeap (一把 lock) vs ShardedConcurrentHeap (每 thread 一個 shard),
+// 1 ~ 64 threads。模擬 GTD 到期 queue: 每個 thread 反覆 push 一個到期時間再 pop 一個,
+// heap 先預填一半,量總吞吐量 (Mops/s)。
+
+constexpr std::size_t kShards = 64;
+constexpr std::size_t kPerShard = 1 << 12;
+constexpr std::size_t kCapacity = kShards * kPerShard;
+constexpr std::size_t kOpsPerThread = 200'000;
+
+using SingleLockHeap = ConcurrentBinaryHeap<uint64_t, uint64_t, kCapacity>;
+using ShardedHeap = ShardedConcurrentHeap<uint64_t, uint64_t, kPerShard, kShards>;
+
+// pop 出來的值加總，最後印出來，compiler 就不能把 pop 當成沒用到的結果省掉
+std::atomic<uint64_t> g_checksum{0};
+
+template <typename Heap>
+double run(Heap& heap, unsigned threads) {
+	std::mt19937_64 rng(42);
+	for (std::size_t i = 0; i < kCapacity / 4; ++i)
+		heap.push(rng() % 1'000'000, i);
+
+	std::atomic<unsigned> ready{0};
+	std::atomic<bool> go{false};
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t] {
+			std::mt19937_64 local(t + 1);
+			uint64_t sink = 0;
+			ready.fetch_add(1);
+			while (!go.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			std::size_t ops = kOpsPerThread / threads;
+			for (std::size_t i = 0; i < ops; ++i) {
+				heap.push(local() % 1'000'000, i);
+				uint64_t v;
+				if (heap.pop(v))
+					sink += v;
+			}
+			g_checksum.fetch_add(sink, std::memory_order_relaxed);
+		});
+	}
+	while (ready.load() != threads)
+		std::this_thread::yield();
+
+	auto start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+	for (auto& w : workers)
+		w.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t v;
+	while (heap.pop(v)) {
+	}
+	// 每個 thread 做 ops 次 push + ops 次 pop
+	return 2.0 * (kOpsPerThread / threads) * threads / seconds / 1e6;
+}
+
+int main() {
+	auto single = std::make_unique<SingleLockHeap>();
+	auto sharded = std::make_unique<ShardedHeap>();
+
+	std::cout << "threads  single-lock Mops/s  sharded Mops/s\n" << std::fixed << std::setprecision(2);
+	for (unsigned threads = 1; threads <= 64; threads *= 2) {
+		double a = run(*single, threads);
+		double b = run(*sharded, threads);
+		std::cout << std::setw(7) << threads << "  " << std::setw(18) << a << "  " << std::setw(14) << b
+							<< "\n";
+	}
+	std::cout << "(hardware threads: " << std::thread::hardware_concurrency() << ", checksum "
+						<< g_checksum.load() << ")\n";
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "pg/language_practice/type_erasure.hpp"
+
+// Task queue 的元素型別：std::function vs AnyCallable vs MoveOnlyAnyCallable。
+// 一個固定大小的 ring，先 enqueue kBatch 個 task 再一個一個 dequeue + 呼叫,
+// 量每個 task 的 enqueue + dequeue + call 平均 ns。抓的東西分三種大小：
+// 兩個指標 (trivially copyable)、一個 std::string (要真的 move)、一個
+// unique_ptr (move-only，只有 MoveOnlyAnyCallable 收得下)。
+
+constexpr std::size_t kBatch = 1024;
+constexpr std::size_t kRounds = 2000;
+
+// 用 placement new 自己管 slot，Task 不需要 default ctor / move assignment
+template <typename Task>
+class Ring {
+	alignas(Task) unsigned char storage_[kBatch * sizeof(Task)];
+	std::size_t head_ = 0, tail_ = 0;
+
+	Task* slot(std::size_t i) { return std::launder(reinterpret_cast<Task*>(storage_) + i % kBatch); }
+
+ public:
+	template <typename F>
+	void push(F&& f) {
+		::new (static_cast<void*>(slot(tail_++))) Task(std::forward<F>(f));
+	}
+
+	Task pop() {
+		Task* p = slot(head_++);
+		Task t(std::move(*p));
+		p->~Task();
+		return t;
+	}
+};
+
+template <typename Task, typename Make>
+double run(Make make) {
+	auto ring = std::make_unique<Ring<Task>>();
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < kRounds; ++r) {
+		for (std::size_t i = 0; i < kBatch; ++i)
+			ring->push(make(i));
+		for (std::size_t i = 0; i < kBatch; ++i)
+			ring->pop()();
+	}
+	auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return ns / (kRounds * kBatch);
+}
+
+int main() {
+	uint64_t sum = 0;
+	uint64_t* out = &sum;
+
+	auto small = [out](std::size_t i) { return [out, i] { *out += i; }; };
+	auto string = [out](std::size_t i) {
+		return [out, s = std::string(24, static_cast<char>('a' + i % 26))] { *out += s.size(); };
+	};
+	auto move_only = [out](std::size_t i) {
+		return [out, p = std::make_unique<std::size_t>(i)] { *out += *p; };
+	};
+
+	std::cout << "ns per task (enqueue + dequeue + call), batch " << kBatch << "\n";
+	std::cout << "capture          std::function  AnyCallable  MoveOnlyAnyCallable\n";
+	std::cout << "2 pointers       " << run<std::function<void()>>(small) << "\t\t"
+						<< run<AnyCallable>(small) << "\t\t" << run<MoveOnlyAnyCallable<>>(small) << "\n";
+	std::cout << "std::string      " << run<std::function<void()>>(string) << "\t\t"
+						<< run<AnyCallable>(string) << "\t\t" << run<MoveOnlyAnyCallable<>>(string) << "\n";
+	std::cout << "unique_ptr       -\t\t-\t\t" << run<MoveOnlyAnyCallable<>>(move_only) << "\n";
+	std::cout << "(sum " << sum << ")\n";
+}
@@ -16,4 +16,8 @@ using json = nlohmann::json;
 
 int asio_test();
 
-int socket_listener();
\ No newline at end of file
+int socket_listener();
+
+// socket_listener 的多執行緒版: threads 個 io_context (0 = 每顆核心一個)，
+// 各自綁在一條 thread 上，用 SO_REUSEPORT 的 acceptor 讓 kernel 分配連線
+int socket_listener_pool(unsigned threads = 0);
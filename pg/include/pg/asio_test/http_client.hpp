@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <nlohmann/json.hpp>
+
+// Coroutine 版的 HTTP/1.1 GET client (只講 port 80 的明文 HTTP)。
+// - DNS 結果依 host 快取，同一個 host 只 resolve 一次
+// - 連線 keep-alive，用完放回 per-host pool 給下一個 request 重用；
+//   pool 裡的連線被 server 關掉了，就自動換一條新的重送一次
+// - get_json_all 把多個 path 分到最多 connections_per_host 條連線上同時跑，
+//   每條連線上把 request 一次 pipeline 出去，再依序讀回 response
+// - body 就地留在連線的 receive buffer 裡 (chunked 也是原地拼回)，
+//   get_json 直接從那段 buffer parse，不先複製成 string
+// 不是 thread-safe: 一個 client 只在一個 (單 thread 的) executor 上用。
+class HttpClient {
+ public:
+	struct Response {
+		int status = 0;
+		std::string body;
+	};
+
+	explicit HttpClient(boost::asio::any_io_executor executor, size_t connections_per_host = 4);
+	~HttpClient();
+
+	HttpClient(const HttpClient&) = delete;
+	HttpClient& operator=(const HttpClient&) = delete;
+
+	boost::asio::awaitable<Response> get(std::string host, std::string path);
+
+	// 非 2xx 的 status 會丟 std::runtime_error
+	boost::asio::awaitable<nlohmann::json> get_json(std::string host, std::string path);
+
+	// 結果順序同 paths
+	boost::asio::awaitable<std::vector<nlohmann::json>> get_json_all(std::string host,
+																																	 std::vector<std::string> paths);
+
+	size_t resolves() const { return resolves_; }
+	size_t connects() const { return connects_; }
+
+ private:
+	struct Connection;
+
+	// response 的 body 在 connection buffer 裡的位置；下一次讀之前有效
+	struct Message {
+		int status = 0;
+		std::string_view body;
+		bool keep_alive = true;
+	};
+
+	boost::asio::any_io_executor executor_;
+	size_t connections_per_host_;
+	std::unordered_map<std::string, boost::asio::ip::tcp::resolver::results_type> dns_cache_;
+	std::unordered_map<std::string, std::vector<std::unique_ptr<Connection>>> idle_;
+	size_t resolves_ = 0;
+	size_t connects_ = 0;
+
+	boost::asio::awaitable<boost::asio::ip::tcp::resolver::results_type> resolve(
+			const std::string& host);
+	boost::asio::awaitable<std::unique_ptr<Connection>> connect(const std::string& host);
+	std::unique_ptr<Connection> take_idle(const std::string& host);
+	void release(const std::string& host, std::unique_ptr<Connection> connection);
+
+	// 在一條連線上 pipeline 送出 paths[first], paths[first + stride], ...，
+	// 每個 response 的 body 交給 handle(index, message)
+	template <typename Handler>
+	boost::asio::awaitable<void> pipeline(const std::string& host,
+																				const std::vector<std::string>& paths, size_t first,
+																				size_t stride, Handler handle);
+
+	static boost::asio::awaitable<Message> read_response(Connection& connection);
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <matching_engine/core/book_update.hpp>
+#include <matching_engine/core/types.hpp>
+
+// Market data 的 UDP multicast 協定。每個 datagram 是一個 MdPacketHeader
+// 後面接 count 個固定長度的 MdMessage，整包不超過一個 Ethernet MTU。
+// packet 的 sequence 從 1 開始連號；收方看到跳號，就對 retransmit port
+// 送 MdRetransmitRequest，publisher 從最近的 packet ring 裡單播補發。
+
+struct MdPacketHeader {
+	uint64_t sequence;	// 這個 packet 的序號
+	uint32_t session;		// publisher 每次啟動換一個，序號只在 session 內有意義
+	uint16_t count;			// 後面接幾個 MdMessage
+	uint16_t reserved;
+};
+
+enum class MdMessageType : uint8_t { Trade = 1, Level = 2 };
+
+struct MdMessage {
+	uint64_t id;	// Trade: order id；Level: BookUpdate::sequence
+	int64_t price_ticks;
+	uint64_t quantity;	// Trade: 成交量；Level: 該價位剩下的總量 (0 = 價位消失)
+	uint32_t symbol;
+	uint32_t orders;	// Level: 該價位的 order 數
+	MdMessageType type;
+	uint8_t side;	 // 0 = Buy, 1 = Sell
+	uint8_t reserved[6];
+};
+
+struct MdRetransmitRequest {
+	uint64_t sequence;	// 要補的第一個 packet
+	uint32_t count;
+	uint32_t session;
+};
+
+static_assert(sizeof(MdPacketHeader) == 16 && std::is_trivially_copyable_v<MdPacketHeader>);
+static_assert(sizeof(MdMessage) == 40 && std::is_trivially_copyable_v<MdMessage>);
+static_assert(sizeof(MdRetransmitRequest) == 16);
+
+// 把 fill 和 L2 delta 打包成 MTU 大小的 packet 送到 multicast group。
+// packet 直接在 retransmit ring 的 slot 裡組，送出後原地留著給補發用，
+// 整條路徑沒有複製也沒有配置記憶體。滿 SEND_BATCH 個 packet 才真的送，
+// Linux 上一次 sendmmsg() 送完整批。
+// 不是 thread-safe: publish 跟 serve_retransmits 要在同一條 thread 上。
+class MarketDataPublisher {
+ public:
+	static constexpr size_t PACKET_SIZE = 1472;	 // 1500 MTU - IP header - UDP header
+	static constexpr size_t MESSAGES_PER_PACKET =
+			(PACKET_SIZE - sizeof(MdPacketHeader)) / sizeof(MdMessage);
+	static constexpr size_t SEND_BATCH = 32;
+	static constexpr size_t RETRANSMIT_PACKETS = 4096;	// ring 保留最近幾個 packet
+	static constexpr size_t MAX_RETRANSMIT = 64;				// 一個 request 最多補幾個
+	static constexpr int SEND_WAIT_MS = 10;							// send buffer 滿時最多等多久
+
+	MarketDataPublisher(boost::asio::ip::udp::socket socket,
+											const boost::asio::ip::udp::endpoint& group, uint32_t session);
+
+	void add_fill(const matching_engine::OrderEvent& fill);
+	void add_update(const matching_engine::BookUpdate& update);
+
+	// 除了 Fill 以外的 event 都跳過
+	void publish(std::span<const matching_engine::OrderEvent> events,
+							 std::span<const matching_engine::BookUpdate> updates);
+
+	// 沒裝滿的 packet 也收尾，連同還沒送的一起送出
+	void flush();
+
+	// 倒空 AsyncMatchingEngine 的 fill 與 level delta queue 然後 flush；
+	// 回傳發出去的 message 數
+	template <typename Engine>
+	size_t drain(Engine& engine) {
+		size_t before = messages_;
+		std::array<matching_engine::OrderEvent, 256> events;
+		std::array<matching_engine::BookUpdate, 256> updates;
+		size_t n_events, n_updates;
+		do {
+			n_events = engine.poll_events(events);
+			n_updates = engine.poll_updates(updates);
+			publish(std::span(events).first(n_events), std::span(updates).first(n_updates));
+		} while (n_events == events.size() || n_updates == updates.size());
+		flush();
+		return messages_ - before;
+	}
+
+	// ring 裡序號為 sequence 的 packet；已被覆蓋或還沒送出就是空的
+	std::span<const std::byte> packet(uint64_t sequence) const;
+
+	// 在 requests socket 上回應補發 request，直到 socket 關閉
+	boost::asio::awaitable<void> serve_retransmits(boost::asio::ip::udp::socket& requests);
+
+	uint64_t next_sequence() const { return sequence_; }
+	size_t packets_sent() const { return packets_sent_; }
+	// 送出失敗的 packet 數；它們仍留在 ring 裡可以補發
+	size_t packets_dropped() const { return packets_dropped_; }
+	size_t messages_sent() const { return messages_; }
+
+ private:
+	struct Slot {
+		uint64_t sequence = 0;	// 0 = 空的
+		uint16_t size = 0;
+		alignas(8) std::array<std::byte, PACKET_SIZE> bytes;
+	};
+
+	boost::asio::ip::udp::socket socket_;
+	boost::asio::ip::udp::endpoint group_;
+	uint32_t session_;
+	std::vector<Slot> ring_;
+	uint64_t sequence_ = 1;	 // 正在組的 packet 的序號
+	size_t open_ = 0;				 // 正在組的 packet 已經放了幾個 message
+	size_t pending_ = 0;		 // 組好但還沒送的 packet 數 (序號緊接在 sequence_ 前面)
+	size_t packets_sent_ = 0;
+	size_t packets_dropped_ = 0;
+	size_t messages_ = 0;
+
+	Slot& slot(uint64_t sequence) { return ring_[sequence % RETRANSMIT_PACKETS]; }
+	void append(const MdMessage& message);
+	void close_packet();
+	void send_pending();
+};
+
+// 跑一個合成 order flow 的 engine，把 market data 送到 239.255.0.1:port，
+// 補發 request 收在 port + 1；每秒印一次吞吐量
+int market_data_publisher(unsigned short port = 30001);
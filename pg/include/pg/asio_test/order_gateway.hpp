@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// Order-entry gateway 的二進位協定。每個 frame 固定長度、主機位元組序
+// (x86 即 little-endian)。client 在同一條連線上持續送 OrderFrame；gateway
+// 每讀到一批就整批送進 matching engine，再用一次 scatter/gather write 回一組
+// ReportFrame: 先是每筆 order 的 ack / reject (順序同送來的 frame)，接著是
+// 這批產生的 fill。
+
+enum class FrameType : uint8_t { New = 0, Cancel = 1, Modify = 2 };
+
+enum class ReportType : uint8_t { Ack = 0, Reject = 1, Fill = 2 };
+
+struct OrderFrame {
+	uint64_t client_order_id;	 // client 自訂，原樣帶回 report
+	uint64_t order_id;				 // Cancel / Modify 的對象 (engine 指派的 id)
+	int64_t price_ticks;
+	uint64_t quantity;
+	uint32_t account;
+	FrameType type;
+	uint8_t side;				 // 0 = Buy, 1 = Sell
+	uint8_t order_type;	 // matching_engine::OrderType 的值
+	uint8_t reserved;
+};
+
+struct ReportFrame {
+	uint64_t client_order_id;
+	uint64_t order_id;
+	int64_t price_ticks;	// Ack: 委託價；Fill: 成交價
+	uint64_t quantity;		// Ack: 尚未成交的量；Fill: 成交量
+	ReportType type;
+	uint8_t reject_reason;	// matching_engine::RejectReason 的值
+	uint8_t reserved[6];
+};
+
+static_assert(sizeof(OrderFrame) == 40 && std::is_trivially_copyable_v<OrderFrame>);
+static_assert(sizeof(ReportFrame) == 40 && std::is_trivially_copyable_v<ReportFrame>);
+
+// 在 port 上跑 gateway，直到 io_context 停止
+int order_gateway(unsigned short port = 12346);
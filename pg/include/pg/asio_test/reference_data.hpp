@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+
+// 商品主檔 (instrument master) 的串流讀取。用 nlohmann 的 SAX 介面一個
+// token 一個 token 地 parse，遇到同時有 "symbol" 跟 "tick_size" 的 object
+// 就在它結束時交出一筆 InstrumentInfo，不建 DOM、不留整份文件；記憶體只有
+// 讀取 buffer 加上手上這一筆。文件外形不拘: 最外層是 array，或是包在
+// {"instruments": [...]} 之類的 object 裡都可以，其他欄位直接跳過。
+
+struct InstrumentInfo {
+	std::string symbol;
+	double tick_size = 0.0;		// 最小跳動單位，商品價格的單位 (例如 0.01)
+	uint64_t lot_size = 1;		// 沒有 "lot_size" 欄位就當 1
+};
+
+using InstrumentCallback = std::function<void(const InstrumentInfo&)>;
+
+// 從 in 邊讀邊 parse，回傳交出的筆數；JSON 格式錯誤會丟 std::runtime_error
+size_t ingest_instruments(std::istream& in, const InstrumentCallback& on_instrument);
+
+// GET http://host/path，body 一邊從 socket 進來一邊 parse，不先收完整個
+// response (固定 64 KiB 的接收 buffer)。SAX parser 是主動拉資料的，沒辦法
+// 在文件中間暫停，所以這裡用 blocking read；不想卡住 io thread 就放到別的
+// thread 上跑。非 2xx 的 status 丟 std::runtime_error。
+size_t fetch_instruments(const std::string& host, const std::string& path,
+												 const InstrumentCallback& on_instrument);
+
+// 讀 file (instrument master JSON)，印筆數、前幾筆和吞吐量
+int reference_data(const char* file);
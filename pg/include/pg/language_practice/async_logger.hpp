@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include "matching_engine/core/clock.hpp"
+#include "matching_engine/memory/async_ring_buffer.hpp"
+#include "pg/language_practice/factory.hpp"
+
+// 非同步的 binary logger，接在 factory.hpp 的 Logger / LoggerFactory 介面後面。
+//
+// 呼叫端 (matching thread 之類的熱路徑) 不 format、不配置、不碰檔案：只把
+// format string 的 id + 原始參數 (整數、浮點數、字元、靜態字串) 塞成一筆 64
+// bytes 的 LogRecord，push 進「這條 thread 自己的」SPSC ring
+// (AsyncRingBuffer)。背景 thread 輪流把每個 ring 清空，用 fmt 排版，累積成
+// 一大塊再一次 fwrite。
+//
+//   AsyncFileLogger logger("engine.log");
+//   logger.logf<"fill {} qty {} @ {}">(order_id, qty, price);
+//
+// - format string 是 template 參數：第一次用到時登記拿 id，之後只剩一次
+//   static 的讀取；參數個數 / 型別不合 format string 時編譯期就報錯。
+// - 參數只存值；const char* 只存指標，所以必須是字串常值之類活得比 logger
+//   久的字串。std::string 請走 log()。
+// - ring 滿了 (背景 thread 跟不上) 就丟掉這筆、dropped() 加一，不會讓呼叫端
+//   等。
+// - 同一條 thread 的紀錄保持順序；不同 thread 的行之間沒有全域排序，每行
+//   帶自己的時間戳。
+// - log(const std::string&) (Logger 介面) 把文字切成片段照樣丟進 ring，
+//   一樣不配置，只是多幾筆 record。中間有片段因為 ring 滿被丟掉時，整行
+//   都不輸出，不會把殘缺的前半段接到下一行。
+
+enum class LogArgType : uint8_t { Int, Uint, Double, Bool, Char, CString };
+
+union LogArg {
+	int64_t i;
+	uint64_t u;
+	double d;
+	bool b;
+	char c;
+	const char* s;
+};
+
+inline constexpr size_t kLogMaxArgs = 5;
+
+struct LogRecord {
+	uint64_t timestamp_ns;	// TscClock 的時間
+	uint32_t format_id;
+	uint8_t argc;	 // 文字片段時是這段的 byte 數
+	std::array<LogArgType, kLogMaxArgs> types;
+	uint16_t fragment;	// 文字片段是這行的第幾段，用來發現中間掉了一段
+	std::array<LogArg, kLogMaxArgs> args;	 // 文字片段時直接放字元
+};
+
+static_assert(sizeof(LogRecord) == 64 && std::is_trivially_copyable_v<LogRecord>);
+
+// 編譯期字串，讓 format string 可以當 template 參數
+template <size_t N>
+struct LogFormat {
+	char text[N];
+
+	constexpr LogFormat(const char (&s)[N]) {
+		for (size_t i = 0; i < N; ++i)
+			text[i] = s[i];
+	}
+};
+
+class AsyncFileLogger : public Logger {
+ public:
+	static constexpr size_t kRingCapacity = 1 << 14;	// 每條 thread 1 MB
+	static constexpr size_t kMaxThreads = 64;
+	static constexpr size_t kCachedLoggers = 8;	 // 每條 thread 快取幾個 logger 的 ring
+
+	// 開檔失敗丟 std::runtime_error
+	explicit AsyncFileLogger(const std::string& path);
+	~AsyncFileLogger() override;	// 把 ring 裡剩下的寫完才結束
+
+	AsyncFileLogger(const AsyncFileLogger&) = delete;
+	AsyncFileLogger& operator=(const AsyncFileLogger&) = delete;
+
+	// Logger 介面：文字切成片段丟進 ring
+	void log(const std::string& msg) override;
+
+	// 熱路徑
+	template <LogFormat Fmt, typename... Args>
+	void logf(const Args&... args) {
+		static_assert(sizeof...(Args) <= kLogMaxArgs, "too many log arguments");
+		[[maybe_unused]] fmt::format_string<const Args&...> check(Fmt.text);
+		static const uint32_t id = register_format(Fmt.text);
+
+		LogRecord r;
+		r.timestamp_ns = matching_engine::TscClock{}.now().nanoseconds;
+		r.format_id = id;
+		r.argc = static_cast<uint8_t>(sizeof...(Args));
+		size_t i = 0;
+		(encode(r, i++, args), ...);
+		push(r);
+	}
+
+	// 因為 ring 滿而丟掉的筆數
+	uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+	// format string 登記進全域表，回傳 id；表滿了回傳 kOverflowFormat
+	static uint32_t register_format(const char* fmt);
+
+ private:
+	using Ring = matching_engine::memory::AsyncRingBuffer<LogRecord, kRingCapacity>;
+
+	static constexpr uint32_t kTextFormat = 0;				// 文字的最後 (或唯一) 一段
+	static constexpr uint32_t kTextMoreFormat = 1;		// 文字片段，後面還有
+	static constexpr uint32_t kOverflowFormat = 2;		// format 表滿了
+
+	struct ThreadSlot {
+		uint64_t logger_id = 0;
+		Ring* ring = nullptr;
+	};
+
+	// 一條 thread 正在湊的文字行
+	struct PendingText {
+		std::string line;
+		uint64_t timestamp_ns = 0;	// 同一行的片段時間戳都一樣
+		uint16_t next_fragment = 0;
+		bool broken = false;	// 中間掉了片段，丟到這行結束為止
+	};
+
+	template <typename T>
+	static void encode(LogRecord& r, size_t i, const T& v) {
+		using D = std::decay_t<T>;
+		if constexpr (std::is_same_v<D, bool>) {
+			r.types[i] = LogArgType::Bool;
+			r.args[i].b = v;
+		} else if constexpr (std::is_same_v<D, char>) {
+			r.types[i] = LogArgType::Char;
+			r.args[i].c = v;
+		} else if constexpr (std::is_enum_v<D>) {
+			encode(r, i, static_cast<std::underlying_type_t<D>>(v));
+		} else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+			r.types[i] = LogArgType::Int;
+			r.args[i].i = v;
+		} else if constexpr (std::is_integral_v<D>) {
+			r.types[i] = LogArgType::Uint;
+			r.args[i].u = v;
+		} else if constexpr (std::is_floating_point_v<D>) {
+			r.types[i] = LogArgType::Double;
+			r.args[i].d = v;
+		} else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+			r.types[i] = LogArgType::CString;
+			r.args[i].s = v;
+		} else if constexpr (std::is_array_v<T> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>) {
+			r.types[i] = LogArgType::CString;
+			r.args[i].s = v;
+		} else {
+			static_assert(sizeof(T) == 0, "logf takes integers, floats, bool, char and static C strings");
+		}
+	}
+
+	void push(const LogRecord& r) noexcept {
+		Ring* ring = local_ring();
+		if (!ring || !ring->push(r)) [[unlikely]]
+			dropped_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// 這條 thread 在這個 logger 的 ring；thread_local 快取以 logger id 分格，
+	// 同時用好幾個 logger 也不會互相把對方踢掉 (id 撞格時才重新查一次)。
+	// 超過 kMaxThreads 條 thread 時是 nullptr (那些 thread 的 log 全部丟掉)。
+	Ring* local_ring() noexcept {
+		static thread_local std::array<ThreadSlot, kCachedLoggers> cache;
+		ThreadSlot& slot = cache[id_ % kCachedLoggers];
+		if (slot.logger_id != id_) [[unlikely]]
+			slot = register_thread();
+		return slot.ring;
+	}
+
+	ThreadSlot register_thread() noexcept;
+	void run(std::stop_token stop);
+	size_t drain(fmt::memory_buffer& out);
+	void format_record(size_t ring, const LogRecord& r, fmt::memory_buffer& out);
+	void write_out(fmt::memory_buffer& out);
+
+	const uint64_t id_;	 // 全域唯一，thread_local 快取用它判斷是不是這個 logger
+	std::FILE* file_;
+	int64_t wall_offset_ns_;	// system_clock - TscClock
+
+	std::mutex register_mutex_;
+	std::array<std::thread::id, kMaxThreads> owners_{};
+	std::array<std::unique_ptr<Ring>, kMaxThreads> rings_;
+	std::atomic<size_t> ring_count_{0};
+	// 以下只有背景 thread 用
+	std::array<PendingText, kMaxThreads> pending_text_;
+	fmt::dynamic_format_arg_store<fmt::format_context> args_;	// 每筆 clear() 重用，不重新配置
+	int64_t stamp_second_ = -1;	// stamp_ 是哪一秒的 "YYYY-mm-dd HH:MM:SS"
+	char stamp_[32] = {};
+	size_t stamp_len_ = 0;
+
+	std::atomic<uint64_t> dropped_{0};
+	std::jthread worker_;
+};
+
+// 4b) ConcreteCreator：非同步寫檔
+class AsyncFileLoggerFactory : public LoggerFactory {
+	std::string path_;
+
+ public:
+	explicit AsyncFileLoggerFactory(std::string path) : path_(std::move(path)) {}
+
+	std::unique_ptr<Logger> create() const override { return std::make_unique<AsyncFileLogger>(path_); }
+};
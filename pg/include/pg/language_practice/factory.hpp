@@ -1,3 +1,5 @@
+#pragma once
+
 #include <iostream>
 #include <memory>
 #include <string>
@@ -43,7 +45,7 @@ class FileLoggerFactory : public LoggerFactory {
 };
 
 // 5) 客戶端程式，與具體 Logger 解耦
-void runApp(const LoggerFactory& factory) {
+inline void runApp(const LoggerFactory& factory) {
 	auto logger = factory.create();
 	logger->log("Hello Factory!");
 }
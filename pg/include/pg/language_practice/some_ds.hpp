@@ -1,10 +1,19 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 // --------------------------------------------------------------
 // Utility traits & comparator
@@ -23,58 +32,158 @@ struct Less {
 #define QI_UNLIKELY(x) (x)
 #endif
 
+// Test-and-test-and-set spin lock: waiters spin on a plain load (the line
+// stays shared in their caches) with a pause between probes, doubling the
+// pause up to a cap, and only attempt the exchange once the flag reads clear.
+class SpinLock {
+	std::atomic<bool> locked_{false};
+
+	static void relax(unsigned n) noexcept {
+		for (unsigned i = 0; i < n; ++i) {
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			asm volatile("yield");
+#endif
+		}
+	}
+
+ public:
+	bool try_lock() noexcept {
+		return !locked_.load(std::memory_order_relaxed) &&
+					 !locked_.exchange(true, std::memory_order_acquire);
+	}
+
+	void lock() noexcept {
+		unsigned backoff = 1;
+		while (!try_lock()) {
+			do {
+				relax(backoff);
+				if (backoff < 64)
+					backoff <<= 1;
+			} while (locked_.load(std::memory_order_relaxed));
+		}
+	}
+
+	void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+};
+
 // --------------------------------------------------------------
-// 1. Fixed‑capacity binary heap (single‑thread)
+// 1. Fixed‑capacity d‑ary heap (single‑thread)
+//    * Arity children per node, 0‑based: children of i are
+//      Arity*i+1 .. Arity*i+Arity. The array is shifted by Arity‑1
+//      slots so each sibling group starts on a multiple of Arity;
+//      with Arity * sizeof(entry) == 64 (e.g. 4 × 16‑byte entries)
+//      sift_down reads exactly one cache line per level.
+//    * Sifts move a hole instead of swapping: the element being
+//      placed is held aside and written once at its final slot.
+//    * SplitValues keeps payloads in a separate slot array and only
+//      {key, slot} in the heap, so sifts never move a Value.
 // --------------------------------------------------------------
 
 /**
- * @tparam Key       priority key (ordered by Comp)
- * @tparam Value     payload stored alongside key
- * @tparam Capacity  maximum number of elements (compile‑time fixed)
- * @tparam Comp      strict weak ordering for Key (default: Less)
+ * @tparam Key          priority key (ordered by Comp)
+ * @tparam Value        payload stored alongside key
+ * @tparam Capacity     maximum number of elements (compile‑time fixed)
+ * @tparam Comp         strict weak ordering for Key (default: Less)
+ * @tparam Arity        children per node (power of two keeps index math to shifts)
+ * @tparam SplitValues  store values out of line (worth it when Value is large)
  */
 
-template <typename Key, typename Value, std::size_t Capacity, typename Comp = Less<Key>>
-class FixedBinaryHeap {
+template <typename Key, typename Value, std::size_t Capacity, typename Comp = Less<Key>,
+					std::size_t Arity = 4, bool SplitValues = false>
+class FixedDaryHeap {
 	static_assert(Capacity > 0, "Capacity must be positive");
+	static_assert(Arity >= 2, "Arity must be at least 2");
+	static_assert(!SplitValues || Capacity <= std::numeric_limits<uint32_t>::max(),
+								"value slots are 32‑bit");
 
-	struct Node {
+	struct InlineEntry {
 		Key key;
 		Value val;
 	};
+	struct SplitEntry {
+		Key key;
+		uint32_t slot;
+	};
+	using Entry = std::conditional_t<SplitValues, SplitEntry, InlineEntry>;
 
-	// index 1‑based to avoid (i‑1)/2 divisions
-	std::array<Node, Capacity + 1> buf_{};
+	struct NoValues {};
+	struct ValueSlots {
+		std::array<Value, Capacity> vals{};
+		std::array<uint32_t, Capacity> free{};	// stack of unused slots
+		std::size_t free_top = Capacity;
+
+		ValueSlots() {
+			for (std::size_t i = 0; i < Capacity; ++i)
+				free[i] = static_cast<uint32_t>(Capacity - 1 - i);
+		}
+	};
+
+	static constexpr std::size_t OFFSET = Arity - 1;
+
+	alignas(64) std::array<Entry, Capacity + OFFSET> buf_{};
 	std::size_t sz_ = 0;
+	[[no_unique_address]] std::conditional_t<SplitValues, ValueSlots, NoValues> slots_;
 	Comp comp_{};
 
 	// -------- helper ----------
-	inline void sift_up(std::size_t idx) {
-		while (idx > 1) {
-			std::size_t parent = idx >> 1;
-			if (QI_LIKELY(!comp_(buf_[idx].key, buf_[parent].key)))
+	Entry& at(std::size_t i) noexcept { return buf_[i + OFFSET]; }
+	const Entry& at(std::size_t i) const noexcept { return buf_[i + OFFSET]; }
+
+	Entry make_entry(const Key& k, const Value& v) {
+		if constexpr (SplitValues) {
+			uint32_t slot = slots_.free[--slots_.free_top];
+			slots_.vals[slot] = v;
+			return Entry{k, slot};
+		} else {
+			return Entry{k, v};
+		}
+	}
+
+	Value take_value(Entry& e) {
+		if constexpr (SplitValues) {
+			slots_.free[slots_.free_top++] = e.slot;
+			return std::move(slots_.vals[e.slot]);
+		} else {
+			return std::move(e.val);
+		}
+	}
+
+	// place e at hole idx or above it
+	inline void sift_up(std::size_t idx, Entry e) {
+		while (idx > 0) {
+			std::size_t parent = (idx - 1) / Arity;
+			if (QI_LIKELY(!comp_(e.key, at(parent).key)))
 				break;
-			std::swap(buf_[idx], buf_[parent]);
+			at(idx) = std::move(at(parent));
 			idx = parent;
 		}
+		at(idx) = std::move(e);
 	}
 
-	inline void sift_down(std::size_t idx) {
+	// place e at hole idx or below it
+	inline void sift_down(std::size_t idx, Entry e) {
 		for (;;) {
-			std::size_t left = idx << 1;
-			std::size_t right = left + 1;
-			if (left > sz_)
-				return;
-			std::size_t best = (right <= sz_ && comp_(buf_[right].key, buf_[left].key)) ? right : left;
-			if (!comp_(buf_[best].key, buf_[idx].key))
-				return;
-			std::swap(buf_[idx], buf_[best]);
+			std::size_t first = idx * Arity + 1;
+			if (first >= sz_)
+				break;
+			std::size_t last = first + Arity < sz_ ? first + Arity : sz_;
+			std::size_t best = first;
+			for (std::size_t c = first + 1; c < last; ++c)
+				if (comp_(at(c).key, at(best).key))
+					best = c;
+			if (!comp_(at(best).key, e.key))
+				break;
+			at(idx) = std::move(at(best));
 			idx = best;
 		}
+		at(idx) = std::move(e);
 	}
 
  public:
 	static constexpr std::size_t capacity = Capacity;
+	static constexpr std::size_t arity = Arity;
 
 	[[nodiscard]] bool empty() const noexcept { return sz_ == 0; }
 	[[nodiscard]] std::size_t size() const noexcept { return sz_; }
@@ -82,11 +191,41 @@ class FixedBinaryHeap {
 	/** push – returns false on overflow (asserts in NDEBUG off). */
 	bool push(const Key& k, const Value& v) {
 		if (QI_UNLIKELY(sz_ >= Capacity)) {
-			assert(false && "FixedBinaryHeap overflow");
+			assert(false && "FixedDaryHeap overflow");
 			return false;
 		}
-		buf_[++sz_] = Node{k, v};
-		sift_up(sz_);
+		std::size_t hole = sz_++;
+		sift_up(hole, make_entry(k, v));
+		return true;
+	}
+
+	/**
+	 * push_bulk – append every {key, value} of items (any range of
+	 * pair‑likes), all or nothing: false if they do not all fit. When the
+	 * batch is at least as large as the heap already is, the whole array is
+	 * rebuilt with Floyd's bottom‑up heapify, O(size) instead of
+	 * O(n log size); smaller batches are sifted up one by one.
+	 */
+	template <typename Range>
+	bool push_bulk(const Range& items) {
+		std::size_t n = 0;
+		for (auto it = std::begin(items); it != std::end(items); ++it)
+			++n;
+		if (QI_UNLIKELY(n > Capacity - sz_))
+			return false;
+
+		std::size_t old = sz_;
+		if (n < old) {
+			for (const auto& [k, v] : items)
+				push(k, v);
+			return true;
+		}
+		for (const auto& [k, v] : items)
+			at(sz_++) = make_entry(k, v);
+		if (sz_ > 1) {
+			for (std::size_t i = (sz_ - 2) / Arity + 1; i-- > 0;)
+				sift_down(i, std::move(at(i)));
+		}
 		return true;
 	}
 
@@ -94,39 +233,48 @@ class FixedBinaryHeap {
 	bool pop(Value& out) {
 		if (QI_UNLIKELY(sz_ == 0))
 			return false;
-		out = std::move(buf_[1].val);
-		buf_[1] = std::move(buf_[sz_--]);
-		if (sz_)
-			sift_down(1);
+		out = take_value(at(0));
+		if (--sz_)
+			sift_down(0, std::move(at(sz_)));
 		return true;
 	}
 
 	/** top – peek without removal. */
 	[[nodiscard]] const Value& top() const {
 		assert(sz_ && "top() on empty heap");
-		return buf_[1].val;
+		if constexpr (SplitValues)
+			return slots_.vals[at(0).slot];
+		else
+			return at(0).val;
+	}
+
+	/** top_key – key of the min element. */
+	[[nodiscard]] const Key& top_key() const {
+		assert(sz_ && "top_key() on empty heap");
+		return at(0).key;
 	}
 };
 
+/** The classic binary heap: FixedDaryHeap with two children per node. */
+template <typename Key, typename Value, std::size_t Capacity, typename Comp = Less<Key>>
+using FixedBinaryHeap = FixedDaryHeap<Key, Value, Capacity, Comp, 2>;
+
 // --------------------------------------------------------------
 // 2. Concurrent binary heap (spin‑lock wrapper)
-//     – suitable for low‑contention writer/reader threads. For
-//       very high contention, prefer sharded heaps or lock‑free
-//       skiplist‑based priority queues.
+//     – one lock around one heap: exact min, fine for a few
+//       threads. Under contention every push/pop serialises on the
+//       same cache line; use ShardedConcurrentHeap (2b) instead.
 // --------------------------------------------------------------
 
 template <typename Key, typename Value, std::size_t Capacity, typename Comp = Less<Key>>
 class ConcurrentBinaryHeap {
 	FixedBinaryHeap<Key, Value, Capacity, Comp> heap_;
-	mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+	mutable SpinLock lock_;
 
 	struct ScopedLock {
-		std::atomic_flag& f;
-		ScopedLock(std::atomic_flag& fl) : f(fl) {
-			while (f.test_and_set(std::memory_order_acquire))
-				;
-		}
-		~ScopedLock() { f.clear(std::memory_order_release); }
+		SpinLock& l;
+		ScopedLock(SpinLock& lk) : l(lk) { l.lock(); }
+		~ScopedLock() { l.unlock(); }
 	};
 
  public:
@@ -151,6 +299,115 @@ class ConcurrentBinaryHeap {
 	}
 };
 
+// --------------------------------------------------------------
+// 2b. Sharded concurrent heap (relaxed pop‑min)
+//     * Shards independent FixedBinaryHeaps, each with its own lock
+//       on its own cache line. A thread pushes into "its" shard
+//       (assigned round‑robin on first use), so pushers from
+//       different threads rarely touch the same line.
+//     * Each shard publishes its current min key in an atomic; pop
+//       scans those without locking, locks the best shard and pops
+//       it. While other threads push/pop concurrently the element
+//       returned may not be the global min (relaxed), but it is
+//       always the min of the shard it came from; with no concurrent
+//       writers it is exact. For expiry queues this only means an
+//       element can fire a few positions late, never early.
+// --------------------------------------------------------------
+
+template <typename Key, typename Value, std::size_t CapacityPerShard, std::size_t Shards = 16,
+					typename Comp = Less<Key>>
+class ShardedConcurrentHeap {
+	static_assert(Shards > 0, "Shards must be positive");
+	static_assert(std::is_trivially_copyable_v<Key>, "shard min keys are published atomically");
+
+	struct alignas(64) Shard {
+		SpinLock lock;
+		std::atomic<bool> nonempty{false};
+		std::atomic<Key> min_key{};
+		std::atomic<std::size_t> size{0};
+		FixedBinaryHeap<Key, Value, CapacityPerShard, Comp> heap;
+
+		// called with lock held, after every change
+		void publish() noexcept {
+			if (!heap.empty())
+				min_key.store(heap.top_key(), std::memory_order_relaxed);
+			nonempty.store(!heap.empty(), std::memory_order_release);
+			size.store(heap.size(), std::memory_order_relaxed);
+		}
+	};
+
+	std::array<Shard, Shards> shards_;
+	Comp comp_{};
+
+	static std::size_t home_shard() noexcept {
+		static std::atomic<std::size_t> next{0};
+		thread_local std::size_t home = next.fetch_add(1, std::memory_order_relaxed) % Shards;
+		return home;
+	}
+
+ public:
+	static constexpr std::size_t capacity = CapacityPerShard * Shards;
+
+	/** push – into the caller's shard, spilling to the next ones when full. */
+	bool push(const Key& k, const Value& v) {
+		std::size_t home = home_shard();
+		for (std::size_t i = 0; i < Shards; ++i) {
+			Shard& s = shards_[(home + i) % Shards];
+			s.lock.lock();
+			bool ok = s.heap.size() < CapacityPerShard && s.heap.push(k, v);
+			if (ok)
+				s.publish();
+			s.lock.unlock();
+			if (ok)
+				return true;
+		}
+		return false;
+	}
+
+	/** pop – smallest published shard min (see 2b). False only if every shard is empty. */
+	bool pop(Value& out) {
+		for (;;) {
+			Shard* best = nullptr;
+			Key best_key{};
+			for (Shard& s : shards_) {
+				if (!s.nonempty.load(std::memory_order_acquire))
+					continue;
+				Key k = s.min_key.load(std::memory_order_relaxed);
+				if (!best || comp_(k, best_key)) {
+					best = &s;
+					best_key = k;
+				}
+			}
+			if (!best)
+				return false;
+
+			best->lock.lock();
+			bool ok = best->heap.pop(out);
+			if (ok)
+				best->publish();
+			best->lock.unlock();
+			if (ok)
+				return true;
+			// shard drained between scan and lock – rescan
+		}
+	}
+
+	/** empty/size – snapshot, may be stale by the time they return. */
+	[[nodiscard]] bool empty() const {
+		for (const Shard& s : shards_)
+			if (s.nonempty.load(std::memory_order_acquire))
+				return false;
+		return true;
+	}
+
+	[[nodiscard]] std::size_t size() const {
+		std::size_t n = 0;
+		for (const Shard& s : shards_)
+			n += s.size.load(std::memory_order_relaxed);
+		return n;
+	}
+};
+
 // --------------------------------------------------------------
 // 3. Fixed‑capacity iterative segment tree
 //    * Range query in O(log N) using associative Op.
@@ -199,6 +456,219 @@ class FixedSegmentTree {
 	}
 };
 
+// --------------------------------------------------------------
+// 3b. Runtime‑sized iterative segment tree
+//    * Same bottom‑up scheme as 3, but any n (not only powers of
+//      two), sized at construction and stored on the heap.
+//    * Op need not be commutative: left and right partial results
+//      are kept apart and combined in order.
+// --------------------------------------------------------------
+
+template <typename T, typename Op = std::plus<>>
+class SegmentTree {
+	std::size_t n_;
+	T identity_;
+	Op op_;
+	std::vector<T> tree_;	 // [n, 2n) leaves, [1, n) internal nodes
+
+ public:
+	explicit SegmentTree(std::size_t n, T identity = T{}, Op op = {})
+			: n_(n), identity_(identity), op_(op), tree_(2 * n, identity) {}
+
+	[[nodiscard]] std::size_t size() const noexcept { return n_; }
+
+	/** build – replace the leaves with values (size() of them), O(n). */
+	void build(std::span<const T> values) {
+		assert(values.size() == n_);
+		std::copy(values.begin(), values.end(), tree_.begin() + n_);
+		for (std::size_t i = n_; i-- > 1;)
+			tree_[i] = op_(tree_[i << 1], tree_[i << 1 | 1]);
+	}
+
+	/** point update */
+	void set(std::size_t idx, const T& v) {
+		assert(idx < n_);
+		idx += n_;
+		tree_[idx] = v;
+		for (idx >>= 1; idx; idx >>= 1)
+			tree_[idx] = op_(tree_[idx << 1], tree_[idx << 1 | 1]);
+	}
+
+	/** range query [l, r] inclusive */
+	[[nodiscard]] T query(std::size_t l, std::size_t r) const {
+		assert(l <= r && r < n_);
+		T res_left = identity_;
+		T res_right = identity_;
+		for (l += n_, r += n_ + 1; l < r; l >>= 1, r >>= 1) {
+			if (l & 1)
+				res_left = op_(res_left, tree_[l++]);
+			if (r & 1)
+				res_right = op_(tree_[--r], res_right);
+		}
+		return op_(res_left, res_right);
+	}
+};
+
+// --------------------------------------------------------------
+// 3c. Wide (B‑ary) segment tree
+//    * Every node has B children stored side by side in one block,
+//      so a level is an array of blocks and each level above is B
+//      times shorter: 10M leaves at B = 16 is 6 levels.
+//    * A query reduces at most two partial blocks per level (the
+//      left and right edges of the range), each a branch‑free masked
+//      reduction over B contiguous values; with B * sizeof(T) == 64
+//      or 128 that is one or two cache lines per block.
+//    * For arithmetic T with std::plus the block reduction uses GCC
+//      vector types; other ops use an order‑preserving pairwise
+//      reduction the compiler can unroll.
+// --------------------------------------------------------------
+
+namespace some_ds_detail {
+
+template <typename T, typename Op>
+inline constexpr bool is_simd_sum = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+																		(std::is_same_v<Op, std::plus<>> || std::is_same_v<Op, std::plus<T>>);
+
+/** op over p[lo, hi) of a B‑wide block, identity outside it. */
+template <typename T, std::size_t B, typename Op>
+inline T reduce_block(const T* p, std::size_t lo, std::size_t hi, const Op& op, const T& identity) {
+#if defined(__GNUC__)
+	if constexpr (is_simd_sum<T, Op> && (B * sizeof(T)) % 32 == 0) {
+		constexpr std::size_t LANES = 32 / sizeof(T);
+		// typedef, not using: GCC drops vector_size on a dependent alias
+		typedef T Lanes __attribute__((vector_size(32)));
+		using Bits = std::conditional_t<sizeof(T) == 8, uint64_t,
+																		std::conditional_t<sizeof(T) == 4, uint32_t,
+																											 std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+		typedef Bits Mask __attribute__((vector_size(32)));
+
+		// B zeros then B ones: the window starting at B - n has lane j set iff
+		// j >= n, so both range masks are plain loads (no 64‑bit compares,
+		// which baseline x86‑64 does not have)
+		static constexpr auto WINDOW = [] {
+			std::array<Bits, 2 * B> w{};
+			for (std::size_t j = B; j < 2 * B; ++j)
+				w[j] = static_cast<Bits>(~Bits{0});
+			return w;
+		}();
+
+		Lanes acc{};
+		for (std::size_t base = 0; base < B; base += LANES) {
+			Mask v, from_lo, from_hi;
+			std::memcpy(&v, p + base, sizeof(v));
+			std::memcpy(&from_lo, WINDOW.data() + B - lo + base, sizeof(from_lo));
+			std::memcpy(&from_hi, WINDOW.data() + B - hi + base, sizeof(from_hi));
+			Mask kept = v & from_lo & ~from_hi;
+			Lanes lanes;
+			std::memcpy(&lanes, &kept, sizeof(lanes));
+			acc += lanes;
+		}
+		T sum = identity;
+		for (std::size_t j = 0; j < LANES; ++j)
+			sum += acc[j];
+		return sum;
+	}
+#endif
+	std::array<T, B> lane;
+	for (std::size_t j = 0; j < B; ++j)
+		lane[j] = (j >= lo && j < hi) ? p[j] : identity;
+	for (std::size_t w = B / 2; w; w >>= 1)
+		for (std::size_t j = 0; j < w; ++j)
+			lane[j] = op(lane[2 * j], lane[2 * j + 1]);
+	return lane[0];
+}
+
+}	 // namespace some_ds_detail
+
+template <typename T, std::size_t B = 16, typename Op = std::plus<>>
+class WideSegmentTree {
+	static_assert(B >= 2 && (B & (B - 1)) == 0, "B must be a power of two");
+
+	struct alignas((B * sizeof(T)) % 64 == 0 ? 64 : alignof(T)) Block {
+		std::array<T, B> v;
+	};
+
+	std::size_t n_;
+	T identity_;
+	Op op_;
+	std::vector<Block> blocks_;				 // every level, leaves first
+	std::vector<std::size_t> level_;	 // first block of each level
+
+	T* level_data(std::size_t k) noexcept { return blocks_[level_[k]].v.data(); }
+	const T* level_data(std::size_t k) const noexcept { return blocks_[level_[k]].v.data(); }
+
+	T reduce(std::size_t k, std::size_t block, std::size_t lo, std::size_t hi) const {
+		return some_ds_detail::reduce_block<T, B>(level_data(k) + block * B, lo, hi, op_, identity_);
+	}
+
+ public:
+	explicit WideSegmentTree(std::size_t n, T identity = T{}, Op op = {})
+			: n_(n), identity_(identity), op_(op) {
+		assert(n > 0);
+		std::size_t total = 0;
+		for (std::size_t len = n;;) {
+			std::size_t count = (len + B - 1) / B;
+			level_.push_back(total);
+			total += count;
+			if (count == 1)
+				break;
+			len = count;
+		}
+		Block empty;
+		empty.v.fill(identity);
+		blocks_.assign(total, empty);
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept { return n_; }
+	[[nodiscard]] std::size_t levels() const noexcept { return level_.size(); }
+
+	/** build – replace the leaves with values (size() of them), O(n). */
+	void build(std::span<const T> values) {
+		assert(values.size() == n_);
+		std::copy(values.begin(), values.end(), level_data(0));
+		for (std::size_t k = 0, len = n_; k + 1 < level_.size(); ++k) {
+			std::size_t count = (len + B - 1) / B;
+			T* parent = level_data(k + 1);
+			for (std::size_t b = 0; b < count; ++b)
+				parent[b] = reduce(k, b, 0, B);
+			len = count;
+		}
+	}
+
+	/** point update – one full block reduction per level */
+	void set(std::size_t idx, const T& v) {
+		assert(idx < n_);
+		level_data(0)[idx] = v;
+		for (std::size_t k = 0; k + 1 < level_.size(); ++k) {
+			std::size_t block = idx / B;
+			level_data(k + 1)[block] = reduce(k, block, 0, B);
+			idx = block;
+		}
+	}
+
+	/** range query [l, r] inclusive */
+	[[nodiscard]] T query(std::size_t l, std::size_t r) const {
+		assert(l <= r && r < n_);
+		T res_left = identity_;
+		T res_right = identity_;
+		std::size_t hi = r + 1;	 // [l, hi) on the current level
+		for (std::size_t k = 0;; ++k) {
+			std::size_t first = l / B, last = (hi - 1) / B;
+			if (first == last) {
+				res_left = op_(res_left, reduce(k, first, l % B, (hi - 1) % B + 1));
+				break;
+			}
+			res_left = op_(res_left, reduce(k, first, l % B, B));
+			res_right = op_(reduce(k, last, 0, (hi - 1) % B + 1), res_right);
+			l = first + 1;
+			hi = last;
+			if (l == hi)
+				break;
+		}
+		return op_(res_left, res_right);
+	}
+};
+
 // -----------------------------------------------------------------------------
 // 4. Lazy‑prop segment tree – range‑add / range‑sum (extendable)
 // -----------------------------------------------------------------------------
@@ -275,8 +745,232 @@ class FixedLazySegmentTree {
 	}
 };
 
+// -----------------------------------------------------------------------------
+// 4b. Generic lazy segment tree – any monoid, any action, no recursion
+//    * M describes the values and the actions on them (see RangeAddSum
+//      below for the exact members):
+//        value_type  / identity() / combine(a, b)    – the value monoid
+//        action_type / no_action() / compose(f, g)   – f after g
+//        apply(f, v, len)                             – f on a segment of
+//                                                       len elements
+//      apply must distribute over combine (same len split) and compose
+//      must agree with applying one action after the other.
+//    * Invariant: d_[k] already includes lz_[k]; lz_[k] is still owed to k's
+//      children. Updates push top‑down only along the two boundary paths,
+//      then apply bottom‑up; queries push nothing (const) and instead apply
+//      the ancestors' pending actions to the partial results on the way up.
+// -----------------------------------------------------------------------------
+
+template <typename M>
+class LazySegmentTree {
+ public:
+	using value_type = typename M::value_type;
+	using action_type = typename M::action_type;
+
+	/** One range update for apply_batch: f on [l, r] inclusive. */
+	struct RangeUpdate {
+		std::size_t l;
+		std::size_t r;
+		action_type f;
+	};
+
+ private:
+	std::size_t n_;
+	std::size_t size_;	// leaves, power of two ≥ n
+	std::size_t log_;
+	std::vector<value_type> d_;
+	std::vector<action_type> lz_;	 // internal nodes only
+
+	std::size_t len(std::size_t k) const noexcept {
+		return size_ >> (std::bit_width(k) - 1);
+	}
+
+	void pull(std::size_t k) { d_[k] = M::apply(lz_[k], M::combine(d_[2 * k], d_[2 * k + 1]), len(k)); }
+
+	void all_apply(std::size_t k, const action_type& f) {
+		d_[k] = M::apply(f, d_[k], len(k));
+		if (k < size_)
+			lz_[k] = M::compose(f, lz_[k]);
+	}
+
+	void push(std::size_t k) {
+		all_apply(2 * k, lz_[k]);
+		all_apply(2 * k + 1, lz_[k]);
+		lz_[k] = M::no_action();
+	}
+
+	// [l, r) in leaf indices: clear pending actions above both boundaries
+	void push_boundaries(std::size_t l, std::size_t r) {
+		for (std::size_t i = log_; i >= 1; --i) {
+			if (((l >> i) << i) != l)
+				push(l >> i);
+			if (((r >> i) << i) != r)
+				push((r - 1) >> i);
+		}
+	}
+
+	void apply_nodes(std::size_t l, std::size_t r, const action_type& f) {
+		for (; l < r; l >>= 1, r >>= 1) {
+			if (l & 1)
+				all_apply(l++, f);
+			if (r & 1)
+				all_apply(--r, f);
+		}
+	}
+
+ public:
+	explicit LazySegmentTree(std::size_t n)
+			: n_(n),
+				size_(std::bit_ceil(n ? n : 1)),
+				log_(std::countr_zero(size_)),
+				d_(2 * size_, M::identity()),
+				lz_(size_, M::no_action()) {}
+
+	[[nodiscard]] std::size_t size() const noexcept { return n_; }
+
+	/** build – replace every element (size() of them), O(n); clears pending actions. */
+	void build(std::span<const value_type> values) {
+		assert(values.size() == n_);
+		std::copy(values.begin(), values.end(), d_.begin() + size_);
+		std::fill(d_.begin() + size_ + n_, d_.end(), M::identity());
+		std::fill(lz_.begin(), lz_.end(), M::no_action());
+		for (std::size_t k = size_; k-- > 1;)
+			pull(k);
+	}
+
+	/** point assign */
+	void set(std::size_t idx, const value_type& v) {
+		assert(idx < n_);
+		idx += size_;
+		for (std::size_t i = log_; i >= 1; --i)
+			push(idx >> i);
+		d_[idx] = v;
+		for (std::size_t i = 1; i <= log_; ++i)
+			pull(idx >> i);
+	}
+
+	/** point query */
+	[[nodiscard]] value_type get(std::size_t idx) const {
+		assert(idx < n_);
+		idx += size_;
+		value_type v = d_[idx];
+		for (std::size_t i = 1; i <= log_; ++i)
+			v = M::apply(lz_[idx >> i], v, 1);
+		return v;
+	}
+
+	/** range update: f on every element of [l, r] inclusive */
+	void apply(std::size_t l, std::size_t r, const action_type& f) {
+		assert(l <= r && r < n_);
+		l += size_;
+		r += size_ + 1;
+		push_boundaries(l, r);
+		apply_nodes(l, r, f);
+		for (std::size_t i = 1; i <= log_; ++i) {
+			if (((l >> i) << i) != l)
+				pull(l >> i);
+			if (((r >> i) << i) != r)
+				pull((r - 1) >> i);
+		}
+	}
+
+	/**
+	 * apply_batch – the updates in order. A batch large enough to dirty
+	 * every node anyway (2·log n ancestors per update ≥ n) skips the
+	 * per‑update ancestor recomputes and rebuilds the inner nodes in one
+	 * bottom‑up pass at the end; smaller batches are applied one by one.
+	 * Pushes still happen per update (a later action must land after an
+	 * earlier one); the final pass is valid because pull() re‑applies the
+	 * node's own pending action, so stale inner values never leak.
+	 */
+	void apply_batch(std::span<const RangeUpdate> updates) {
+		if (updates.size() * 2 * log_ < size_) {
+			for (const RangeUpdate& u : updates)
+				apply(u.l, u.r, u.f);
+			return;
+		}
+		for (const RangeUpdate& u : updates) {
+			assert(u.l <= u.r && u.r < n_);
+			std::size_t l = u.l + size_, r = u.r + size_ + 1;
+			push_boundaries(l, r);
+			apply_nodes(l, r, u.f);
+		}
+		for (std::size_t k = size_; k-- > 1;)
+			pull(k);
+	}
+
+	/** range query over [l, r] inclusive */
+	[[nodiscard]] value_type query(std::size_t l, std::size_t r) const {
+		assert(l <= r && r < n_);
+		l += size_;
+		r += size_ + 1;
+		value_type res_left = M::identity(), res_right = M::identity();
+		std::size_t len_left = 0, len_right = 0;
+		// At level k the left boundary is ceil(l / 2^k): everything collected
+		// on the left so far lies inside node l‑1 one level up, and on the
+		// right inside node r, so those are the nodes whose pending actions
+		// the partial results still owe.
+		for (std::size_t k = 0; k < log_; ++k) {
+			if (l < r) {
+				if (l & 1) {
+					res_left = M::combine(res_left, d_[l++]);
+					len_left += std::size_t{1} << k;
+				}
+				if (r & 1) {
+					res_right = M::combine(d_[--r], res_right);
+					len_right += std::size_t{1} << k;
+				}
+			}
+			l = (l + 1) >> 1;
+			r >>= 1;
+			if (len_left)
+				res_left = M::apply(lz_[l - 1], res_left, len_left);
+			if (len_right)
+				res_right = M::apply(lz_[r], res_right, len_right);
+		}
+		if (l < r)	// the root itself
+			res_left = M::combine(res_left, d_[1]);
+		return M::combine(res_left, res_right);
+	}
+};
+
+/** LazySegmentTree policy: add a constant to a range, query range sums. */
+template <typename T>
+struct RangeAddSum {
+	using value_type = T;
+	using action_type = T;
+	static constexpr T identity() noexcept { return T{}; }
+	static constexpr T combine(const T& a, const T& b) noexcept { return a + b; }
+	static constexpr T no_action() noexcept { return T{}; }
+	static constexpr T compose(const T& f, const T& g) noexcept { return f + g; }
+	static constexpr T apply(const T& f, const T& v, std::size_t len) noexcept {
+		return v + f * static_cast<T>(len);
+	}
+};
+
+/** LazySegmentTree policy: assign a value to a range, query range minima. */
+template <typename T>
+struct RangeAssignMin {
+	using value_type = T;
+	using action_type = std::pair<bool, T>;	 // {assign?, value}
+	static constexpr T identity() noexcept { return std::numeric_limits<T>::max(); }
+	static constexpr T combine(const T& a, const T& b) noexcept { return b < a ? b : a; }
+	static constexpr action_type no_action() noexcept { return {false, T{}}; }
+	static constexpr action_type compose(const action_type& f, const action_type& g) noexcept {
+		return f.first ? f : g;
+	}
+	static constexpr T apply(const action_type& f, const T& v, std::size_t) noexcept {
+		return f.first ? f.second : v;
+	}
+};
+
 // -----------------------------------------------------------------------------
 // 5. Fenwick Tree / Binary Indexed Tree – prefix & range sums
+//    * build() in O(n): each node hands its sum to its parent once.
+//    * lower_bound(k): first index whose prefix sum reaches k, by binary
+//      lifting over the implicit tree in O(log n). Needs non‑negative
+//      elements (prefix sums monotone), e.g. depth per price level:
+//      "at which level does cumulative size reach X".
 // -----------------------------------------------------------------------------
 
 template <typename T, std::size_t N>
@@ -288,6 +982,18 @@ class FixedFenwickTree {
  public:
 	constexpr FixedFenwickTree() { bit_.fill(0); }
 
+	/** build – replace every element with values (N of them), O(N). */
+	void build(std::span<const T> values) {
+		assert(values.size() == N);
+		bit_[0] = 0;
+		std::copy(values.begin(), values.end(), bit_.begin() + 1);
+		for (std::size_t i = 1; i <= N; ++i) {
+			std::size_t parent = i + (i & -i);
+			if (parent <= N)
+				bit_[parent] += bit_[i];
+		}
+	}
+
 	/** add `delta` to element at index `idx` (0‑based). */
 	void add(std::size_t idx, T delta) {
 		assert(idx < N);
@@ -309,4 +1015,152 @@ class FixedFenwickTree {
 		assert(l <= r && r < N);
 		return prefix_sum(r) - (l ? prefix_sum(l - 1) : 0);
 	}
+
+	/** smallest idx with prefix_sum(idx) >= k, or N if the total is below k. */
+	[[nodiscard]] std::size_t lower_bound(T k) const {
+		std::size_t pos = 0;
+		for (std::size_t step = std::bit_floor(N); step; step >>= 1) {
+			if (pos + step <= N && bit_[pos + step] < k) {
+				pos += step;
+				k -= bit_[pos];
+			}
+		}
+		return pos;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// 5b. Runtime‑sized Fenwick tree – same operations, heap storage
+// -----------------------------------------------------------------------------
+
+template <typename T>
+class FenwickTree {
+	std::size_t n_;
+	std::vector<T> bit_;	// 1‑based indexing
+
+ public:
+	explicit FenwickTree(std::size_t n) : n_(n), bit_(n + 1, T{}) {}
+
+	[[nodiscard]] std::size_t size() const noexcept { return n_; }
+
+	/** build – replace every element with values (size() of them), O(n). */
+	void build(std::span<const T> values) {
+		assert(values.size() == n_);
+		bit_[0] = T{};
+		std::copy(values.begin(), values.end(), bit_.begin() + 1);
+		for (std::size_t i = 1; i <= n_; ++i) {
+			std::size_t parent = i + (i & -i);
+			if (parent <= n_)
+				bit_[parent] += bit_[i];
+		}
+	}
+
+	/** add `delta` to element at index `idx` (0‑based). */
+	void add(std::size_t idx, T delta) {
+		assert(idx < n_);
+		for (++idx; idx <= n_; idx += idx & -idx)
+			bit_[idx] += delta;
+	}
+
+	/** prefix sum [0, idx] inclusive. */
+	[[nodiscard]] T prefix_sum(std::size_t idx) const {
+		assert(idx < n_);
+		T res{};
+		for (++idx; idx; idx -= idx & -idx)
+			res += bit_[idx];
+		return res;
+	}
+
+	/** range sum [l, r] inclusive. */
+	[[nodiscard]] T range_sum(std::size_t l, std::size_t r) const {
+		assert(l <= r && r < n_);
+		return prefix_sum(r) - (l ? prefix_sum(l - 1) : T{});
+	}
+
+	/** smallest idx with prefix_sum(idx) >= k, or size() if the total is below k. */
+	[[nodiscard]] std::size_t lower_bound(T k) const {
+		std::size_t pos = 0;
+		for (std::size_t step = n_ ? std::bit_floor(n_) : 0; step; step >>= 1) {
+			if (pos + step <= n_ && bit_[pos + step] < k) {
+				pos += step;
+				k -= bit_[pos];
+			}
+		}
+		return pos;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// 5c. 2‑D Fenwick tree – point add, rectangle sums (e.g. price × time heatmap)
+//    * rows × cols grid, one flat row‑major array; O(log r · log c) per op.
+// -----------------------------------------------------------------------------
+
+template <typename T>
+class FenwickTree2D {
+	std::size_t rows_, cols_;
+	std::vector<T> bit_;	// (rows + 1) × (cols + 1), 1‑based in both
+
+	T& at(std::size_t r, std::size_t c) noexcept { return bit_[r * (cols_ + 1) + c]; }
+	const T& at(std::size_t r, std::size_t c) const noexcept { return bit_[r * (cols_ + 1) + c]; }
+
+ public:
+	FenwickTree2D(std::size_t rows, std::size_t cols)
+			: rows_(rows), cols_(cols), bit_((rows + 1) * (cols + 1), T{}) {}
+
+	[[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+	[[nodiscard]] std::size_t cols() const noexcept { return cols_; }
+
+	/** build – replace every cell with values (row‑major, rows × cols), O(rows · cols). */
+	void build(std::span<const T> values) {
+		assert(values.size() == rows_ * cols_);
+		std::fill(bit_.begin(), bit_.end(), T{});
+		for (std::size_t r = 1; r <= rows_; ++r)
+			std::copy_n(values.begin() + (r - 1) * cols_, cols_, bit_.begin() + r * (cols_ + 1) + 1);
+		// the 1‑D build along each row, then along each column
+		for (std::size_t r = 1; r <= rows_; ++r) {
+			for (std::size_t c = 1; c <= cols_; ++c) {
+				std::size_t parent = c + (c & -c);
+				if (parent <= cols_)
+					at(r, parent) += at(r, c);
+			}
+		}
+		for (std::size_t r = 1; r <= rows_; ++r) {
+			std::size_t parent = r + (r & -r);
+			if (parent > rows_)
+				continue;
+			for (std::size_t c = 1; c <= cols_; ++c)
+				at(parent, c) += at(r, c);
+		}
+	}
+
+	/** add `delta` to cell (row, col), 0‑based. */
+	void add(std::size_t row, std::size_t col, T delta) {
+		assert(row < rows_ && col < cols_);
+		for (std::size_t r = row + 1; r <= rows_; r += r & -r)
+			for (std::size_t c = col + 1; c <= cols_; c += c & -c)
+				at(r, c) += delta;
+	}
+
+	/** sum of the rectangle [0, row] × [0, col] inclusive. */
+	[[nodiscard]] T prefix_sum(std::size_t row, std::size_t col) const {
+		assert(row < rows_ && col < cols_);
+		T res{};
+		for (std::size_t r = row + 1; r; r -= r & -r)
+			for (std::size_t c = col + 1; c; c -= c & -c)
+				res += at(r, c);
+		return res;
+	}
+
+	/** sum of the rectangle [r0, r1] × [c0, c1] inclusive. */
+	[[nodiscard]] T rect_sum(std::size_t r0, std::size_t c0, std::size_t r1, std::size_t c1) const {
+		assert(r0 <= r1 && c0 <= c1 && r1 < rows_ && c1 < cols_);
+		T res = prefix_sum(r1, c1);
+		if (r0)
+			res -= prefix_sum(r0 - 1, c1);
+		if (c0)
+			res -= prefix_sum(r1, c0 - 1);
+		if (r0 && c0)
+			res += prefix_sum(r0 - 1, c0 - 1);
+		return res;
+	}
 };
@@ -1,3 +1,5 @@
+#include <cstddef>
+#include <cstring>
 #include <new>
 #include <type_traits>
 #include <utility>
@@ -10,6 +12,8 @@ struct CallableConcept {
 	virtual void call() = 0;
 	virtual CallableConcept* clone(void* buffer) const = 0;
 	virtual CallableConcept* heapClone() const = 0;
+	// 把自己 move 到 buffer（SBO 物件的移動建構用）
+	virtual CallableConcept* moveTo(void* buffer) noexcept = 0;
 };
 
 // 2. 具體模型（Model）模板：將任意符合 callable 介面的型別包裝起來。
@@ -28,6 +32,10 @@ struct CallableModel : CallableConcept {
 
 	// 動態配置到 heap
 	CallableConcept* heapClone() const override { return new CallableModel<F>(func); }
+
+	CallableConcept* moveTo(void* buffer) noexcept override {
+		return new (buffer) CallableModel<F>(std::move(func));
+	}
 };
 
 // 3. 包裝者（Wrapper）
@@ -67,10 +75,11 @@ class AnyCallable {
 		}
 	}
 
-	// 移動建構
+	// 移動建構：SBO 內的物件 move 過來，再把 other 那份解構掉
 	AnyCallable(AnyCallable&& other) noexcept {
 		if (other.in_sbo) {
-			ptr = other.ptr->clone(buffer);
+			ptr = other.ptr->moveTo(buffer);
+			other.ptr->~CallableConcept();
 			in_sbo = true;
 		} else {
 			ptr = other.ptr;
@@ -83,11 +92,115 @@ class AnyCallable {
 	~AnyCallable() {
 		if (!ptr)
 			return;
-		ptr->~CallableConcept();
-		if (!in_sbo)
+		if (in_sbo)
+			ptr->~CallableConcept();
+		else
 			delete ptr;
 	}
 
 	// 呼叫介面
 	void operator()() { ptr->call(); }
 };
+
+// 4. Move-only 版：給 task queue 當元素用
+//    * 只能 move，所以也收得下 move-only 的 callable（抓了 unique_ptr 的 lambda、
+//      std::packaged_task…）。
+//    * InlineSize 可調（預設 6 個指標 = 48 bytes）；放得下、而且 nothrow move 的
+//      callable 直接放在 buffer 裡，其餘放 heap、buffer 裡只存指標。
+//    * 不用虛擬繼承：每個型別 F 一張 static constexpr 的 function pointer 表，
+//      物件裡只有 buffer 加一個表指標，沒有 in_sbo flag。
+//    * relocate / destroy 可以是 nullptr：trivially copyable 的 callable（只抓
+//      指標、整數的 lambda）跟放 heap 的（buffer 裡只是個指標）搬家就是
+//      memcpy 整個 buffer，trivially destructible 的解構什麼都不做。queue 的
+//      enqueue / dequeue 大多只剩一次固定長度的 memcpy。
+template <size_t InlineSize = 6 * sizeof(void*)>
+class MoveOnlyAnyCallable {
+	static_assert(InlineSize >= sizeof(void*), "InlineSize 至少要放得下一個指標");
+
+	struct VTable {
+		void (*call)(void* obj);
+		void (*relocate)(void* dst, void* src) noexcept;	// move 到 dst 並解構 src；nullptr = memcpy
+		void (*destroy)(void* obj) noexcept;							// nullptr = 不用做事
+	};
+
+	template <typename F>
+	static constexpr bool fits_inline = sizeof(F) <= InlineSize &&
+																			alignof(F) <= alignof(std::max_align_t) &&
+																			std::is_nothrow_move_constructible_v<F>;
+
+	template <typename F>
+	static constexpr VTable inline_vtable{
+			[](void* obj) { (*static_cast<F*>(obj))(); },
+			std::is_trivially_copyable_v<F> ? nullptr
+																			: +[](void* dst, void* src) noexcept {
+																					F* from = static_cast<F*>(src);
+																					::new (dst) F(std::move(*from));
+																					from->~F();
+																				},
+			std::is_trivially_destructible_v<F> ? nullptr
+																					: +[](void* obj) noexcept { static_cast<F*>(obj)->~F(); },
+	};
+
+	template <typename F>
+	static constexpr VTable heap_vtable{
+			[](void* obj) { (**static_cast<F**>(obj))(); },
+			nullptr,	// buffer 裡只有指標，memcpy 就搬完了
+			[](void* obj) noexcept { delete *static_cast<F**>(obj); },
+	};
+
+	alignas(std::max_align_t) unsigned char buffer_[InlineSize];
+	const VTable* vtable_ = nullptr;
+
+	void relocate_from(MoveOnlyAnyCallable& other) noexcept {
+		vtable_ = other.vtable_;
+		if (vtable_ && vtable_->relocate)
+			vtable_->relocate(buffer_, other.buffer_);
+		else if (vtable_)
+			std::memcpy(buffer_, other.buffer_, InlineSize);
+		other.vtable_ = nullptr;
+	}
+
+ public:
+	static constexpr size_t inline_size = InlineSize;
+
+	MoveOnlyAnyCallable() noexcept = default;
+
+	template <typename F, typename D = std::decay_t<F>,
+						typename = std::enable_if_t<!std::is_same_v<D, MoveOnlyAnyCallable> &&
+																				std::is_invocable_v<D&>>>
+	MoveOnlyAnyCallable(F&& f) {
+		if constexpr (fits_inline<D>) {
+			::new (static_cast<void*>(buffer_)) D(std::forward<F>(f));
+			vtable_ = &inline_vtable<D>;
+		} else {
+			::new (static_cast<void*>(buffer_)) D*(new D(std::forward<F>(f)));
+			vtable_ = &heap_vtable<D>;
+		}
+	}
+
+	MoveOnlyAnyCallable(const MoveOnlyAnyCallable&) = delete;
+	MoveOnlyAnyCallable& operator=(const MoveOnlyAnyCallable&) = delete;
+
+	MoveOnlyAnyCallable(MoveOnlyAnyCallable&& other) noexcept { relocate_from(other); }
+
+	MoveOnlyAnyCallable& operator=(MoveOnlyAnyCallable&& other) noexcept {
+		if (this != &other) {
+			reset();
+			relocate_from(other);
+		}
+		return *this;
+	}
+
+	~MoveOnlyAnyCallable() { reset(); }
+
+	void reset() noexcept {
+		if (vtable_ && vtable_->destroy)
+			vtable_->destroy(buffer_);
+		vtable_ = nullptr;
+	}
+
+	explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+	// 呼叫介面（空的時候呼叫是 UB）
+	void operator()() { vtable_->call(buffer_); }
+};
@@ -1,8 +1,19 @@
 #include <pg/asio_test/asio_test.hpp>
+#include <pg/asio_test/http_client.hpp>
 
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/use_awaitable.hpp>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace asio = boost::asio;
 using asio::awaitable;
@@ -10,64 +21,36 @@ using asio::co_spawn;
 using asio::detached;
 using asio::use_awaitable;
 
+// 用 HttpClient 抓 reference data: 第一筆單獨抓，其餘一次並行 + pipeline，
+// 全部共用同一份 DNS 結果和 keep-alive 連線
 int asio_test() {
+	const std::string host = "jsonplaceholder.typicode.com";
+	std::exception_ptr failure;
 	try {
-		std::string host = "jsonplaceholder.typicode.com";
-		std::string path = "/todos/1";
-
-		boost::asio::io_context io_context;
-
-		tcp::resolver resolver(io_context);
-		tcp::socket socket(io_context);
-
-		auto endpoints = resolver.resolve(host, "http");
-		boost::asio::connect(socket, endpoints);
-
-		std::string request = fmt::format(
-				"GET {} HTTP/1.1\r\n"
-				"Host: {}\r\n"
-				"Accept: application/json\r\n"
-				"Connection: close\r\n\r\n",
-				path, host);
-		boost::asio::write(socket, boost::asio::buffer(request));
-
-		boost::asio::streambuf response;
-		boost::system::error_code ec;
-
-		boost::asio::read(socket, response, ec);
-
-		if (ec && ec != boost::asio::error::eof) {
-			throw boost::system::system_error(ec);
-		}
-		std::string response_str((std::istreambuf_iterator<char>(&response)),
-														 std::istreambuf_iterator<char>());
-		fmt::print(fg(fmt::color::red), "--- DEBUG START ---\n");
-		fmt::print(
-				"Full Response From Server ({} "
-				"bytes):\n<<<\n{}\n>>>\n",
-				response_str.length(), response_str);
-
-		size_t separator_pos = response_str.find("\r\n\r\n");
-		if (separator_pos != std::string::npos) {
-			std::string json_body = response_str.substr(separator_pos + 4);
-
-			fmt::print("Extracted JSON Body ({} bytes):\n<<<\n{}\n>>>\n", json_body.length(), json_body);
-			fmt::print(fg(fmt::color::red), "--- DEBUG END ---\n\n");
-
-			json data = json::parse(json_body);
+		asio::io_context io_context(1);
+		HttpClient client(io_context.get_executor());
 
+		auto fetch = [&]() -> awaitable<void> {
+			json data = co_await client.get_json(host, "/todos/1");
 			fmt::print(fg(fmt::color::cyan), "Todo Item #{}\n", data["id"].get<int>());
 			fmt::print("User ID:   {}\n", data["userId"].get<int>());
 			fmt::print("Title:     {}\n", data["title"].get<std::string>());
 			fmt::print("Completed: {}\n", data["completed"].get<bool>() ? "Yes" : "No");
 
-		} else {
-			fmt::print("Separator '\\r\\n\\r\\n' not found!\n");
-			fmt::print(fg(fmt::color::red), "--- DEBUG END ---\n\n");
-			fmt::print(stderr, fg(fmt::color::red),
-								 "Error: Could not find HTTP header/body separator.\n");
-			return 1;
-		}
+			std::vector<std::string> paths;
+			for (int id = 2; id <= 20; ++id) {
+				paths.push_back(fmt::format("/todos/{}", id));
+			}
+			std::vector<json> todos = co_await client.get_json_all(host, paths);
+			size_t completed = std::count_if(todos.begin(), todos.end(),
+																			 [](const json& todo) { return todo["completed"].get<bool>(); });
+			fmt::print("\nFetched {} more todos ({} completed) with {} DNS lookup(s), {} connection(s)\n",
+								 todos.size(), completed, client.resolves(), client.connects());
+		};
+		co_spawn(io_context, fetch(), [&](std::exception_ptr error) { failure = error; });
+		io_context.run();
+		if (failure)
+			std::rethrow_exception(failure);
 	} catch (std::exception& e) {
 		fmt::print(stderr, fg(fmt::color::red), "Error: {}\n", e.what());
 		return 1;
@@ -132,3 +115,73 @@ int socket_listener() {
 	}
 	return 0;
 }
+
+// SO_REUSEPORT: 多個 socket 綁同一個 port，由 kernel 把新連線分散給它們
+#if defined(SO_REUSEPORT)
+using reuse_port = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+// 把目前的 thread 綁到第 cpu 顆核心 (超過核心數就繞回來)，綁不了就算了
+static void pin_current_thread(unsigned cpu) {
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)cpu;
+#endif
+}
+
+int socket_listener_pool(unsigned threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+#if !defined(SO_REUSEPORT)
+	threads = 1;	// 沒有 SO_REUSEPORT 就只能有一個 acceptor
+#endif
+	try {
+		tcp::endpoint endpoint(tcp::v4(), 12345);
+
+		// 每個 thread 一個 io_context 和一個自己的 acceptor。連線在哪個
+		// io_context accept，就一直在那條 thread 上處理: io_context 只有一條
+		// thread 在跑，本身就是隱含的 strand，handler 之間不用鎖也不會換 thread
+		std::vector<std::unique_ptr<asio::io_context>> contexts;
+		std::vector<tcp::acceptor> acceptors;
+		acceptors.reserve(threads);	 // listener 拿的是 reference，不能讓 vector 搬家
+		for (unsigned i = 0; i < threads; ++i) {
+			contexts.push_back(std::make_unique<asio::io_context>(1));
+			tcp::acceptor& acceptor = acceptors.emplace_back(*contexts.back());
+			acceptor.open(endpoint.protocol());
+			acceptor.set_option(tcp::acceptor::reuse_address(true));
+#if defined(SO_REUSEPORT)
+			acceptor.set_option(reuse_port(true));
+#endif
+			acceptor.bind(endpoint);
+			acceptor.listen();
+		}
+
+		fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+							 "Async Socket Listener pool (port 12345, {} threads)\n", acceptors.size());
+		fmt::print("Waiting for connections...\n\n");
+
+		for (size_t i = 0; i < acceptors.size(); ++i) {
+			co_spawn(*contexts[i], listener(acceptors[i]), detached);
+		}
+
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < contexts.size(); ++i) {
+			workers.emplace_back([&contexts, i] {
+				pin_current_thread(static_cast<unsigned>(i));
+				contexts[i]->run();
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	} catch (std::exception& e) {
+		fmt::print(stderr, fg(fmt::color::red), "Error: {}\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,316 @@
+#include <pg/asio_test/http_client.hpp>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+namespace asio = boost::asio;
+using asio::awaitable;
+using asio::use_awaitable;
+using boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+struct HttpClient::Connection {
+	explicit Connection(asio::any_io_executor executor) : socket(executor) {}
+
+	tcp::socket socket;
+	std::vector<char> buffer = std::vector<char>(16 * 1024);
+	size_t begin = 0;	 // 還沒消化的資料在 [begin, end)
+	size_t end = 0;
+	bool reused = false;	// 從 pool 拿出來的 (server 可能早就關掉了)
+
+	// 再讀一些進來；buffer 滿了就長大，不會搬動 begin 之前的位置
+	awaitable<void> read_more() {
+		if (end == buffer.size()) {
+			buffer.resize(buffer.size() * 2);
+		}
+		end += co_await socket.async_read_some(asio::buffer(buffer.data() + end, buffer.size() - end),
+																					 use_awaitable);
+	}
+
+	// 新的 response 開始前把剩下的資料挪到最前面，buffer 才不會越長越大
+	void compact() {
+		if (begin > 0) {
+			std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+			end -= begin;
+			begin = 0;
+		}
+	}
+
+	std::string_view view(size_t from, size_t to) const { return {buffer.data() + from, to - from}; }
+};
+
+namespace {
+
+bool iequals(std::string_view a, std::string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+					 return std::tolower(static_cast<unsigned char>(x)) ==
+									std::tolower(static_cast<unsigned char>(y));
+				 });
+}
+
+std::string_view trim(std::string_view s) {
+	while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+		s.remove_prefix(1);
+	while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+		s.remove_suffix(1);
+	return s;
+}
+
+void append_request(std::string& out, const std::string& host, const std::string& path) {
+	fmt::format_to(std::back_inserter(out),
+								 "GET {} HTTP/1.1\r\n"
+								 "Host: {}\r\n"
+								 "Accept: application/json\r\n"
+								 "Connection: keep-alive\r\n\r\n",
+								 path, host);
+}
+
+}	 // namespace
+
+HttpClient::HttpClient(asio::any_io_executor executor, size_t connections_per_host)
+		: executor_(std::move(executor)), connections_per_host_(std::max<size_t>(1, connections_per_host)) {}
+
+HttpClient::~HttpClient() = default;
+
+awaitable<tcp::resolver::results_type> HttpClient::resolve(const std::string& host) {
+	if (auto it = dns_cache_.find(host); it != dns_cache_.end())
+		co_return it->second;
+	tcp::resolver resolver(executor_);
+	auto results = co_await resolver.async_resolve(host, "http", use_awaitable);
+	++resolves_;
+	dns_cache_[host] = results;
+	co_return results;
+}
+
+awaitable<std::unique_ptr<HttpClient::Connection>> HttpClient::connect(const std::string& host) {
+	auto endpoints = co_await resolve(host);
+	auto connection = std::make_unique<Connection>(executor_);
+	co_await asio::async_connect(connection->socket, endpoints, use_awaitable);
+	connection->socket.set_option(tcp::no_delay(true));
+	++connects_;
+	co_return connection;
+}
+
+std::unique_ptr<HttpClient::Connection> HttpClient::take_idle(const std::string& host) {
+	auto it = idle_.find(host);
+	if (it == idle_.end() || it->second.empty())
+		return nullptr;
+	auto connection = std::move(it->second.back());
+	it->second.pop_back();
+	connection->reused = true;
+	return connection;
+}
+
+void HttpClient::release(const std::string& host, std::unique_ptr<Connection> connection) {
+	auto& pool = idle_[host];
+	if (pool.size() < connections_per_host_) {
+		pool.push_back(std::move(connection));
+	}
+}
+
+// 讀一個完整的 response。header 用 string_view 在 buffer 上切；
+// body 是 Content-Length 就直接指向 buffer，chunked 就把各段原地往前搬成連續的一段
+awaitable<HttpClient::Message> HttpClient::read_response(Connection& c) {
+	c.compact();
+
+	size_t header_end;
+	while ((header_end = c.view(c.begin, c.end).find("\r\n\r\n")) == std::string_view::npos) {
+		co_await c.read_more();
+	}
+	header_end += c.begin;
+	std::string_view head = c.view(c.begin, header_end);
+
+	Message message;
+	size_t line_end = head.find("\r\n");
+	std::string_view status_line = head.substr(0, line_end);
+	if (status_line.size() < 12 || status_line.substr(0, 5) != "HTTP/")
+		throw std::runtime_error("malformed HTTP status line");
+	std::from_chars(status_line.data() + 9, status_line.data() + 12, message.status);
+	message.keep_alive = status_line.substr(0, 8) != "HTTP/1.0";
+
+	std::optional<size_t> content_length;
+	bool chunked = false;
+	while (line_end != std::string_view::npos) {
+		size_t next = head.find("\r\n", line_end + 2);
+		std::string_view line = head.substr(line_end + 2, next - line_end - 2);
+		line_end = next;
+		size_t colon = line.find(':');
+		if (colon == std::string_view::npos)
+			continue;
+		std::string_view name = trim(line.substr(0, colon));
+		std::string_view value = trim(line.substr(colon + 1));
+		if (iequals(name, "Content-Length")) {
+			size_t length = 0;
+			std::from_chars(value.data(), value.data() + value.size(), length);
+			content_length = length;
+		} else if (iequals(name, "Transfer-Encoding")) {
+			chunked = iequals(value, "chunked");
+		} else if (iequals(name, "Connection")) {
+			message.keep_alive = !iequals(value, "close");
+		}
+	}
+
+	size_t body = header_end + 4;
+	if (message.status / 100 == 1) {
+		// 1xx 是中間回應 (100 Continue、103 Early Hints)，沒有 body，真正的回應接在後面
+		c.begin = body;
+		co_return co_await read_response(c);
+	}
+	if (message.status == 204 || message.status == 304) {
+		// 規定沒有 body；304 的 Content-Length 說的是原本那份資源，不能照著讀
+		message.body = c.view(body, body);
+		c.begin = body;
+	} else if (chunked) {
+		// [body, out) 是已經拼好的 body，read 是下一段 chunk size 那一行
+		size_t out = body, read = body;
+		while (true) {
+			size_t eol;
+			while ((eol = c.view(read, c.end).find("\r\n")) == std::string_view::npos) {
+				co_await c.read_more();
+			}
+			eol += read;
+			size_t size = 0;
+			std::from_chars(c.buffer.data() + read, c.buffer.data() + eol, size, 16);
+			read = eol + 2;
+			while (c.end < read + size + 2) {
+				co_await c.read_more();
+			}
+			if (size == 0) {
+				// 不收 trailer: 最後一個 chunk 後面直接就是空行
+				c.begin = read + 2;
+				break;
+			}
+			std::memmove(c.buffer.data() + out, c.buffer.data() + read, size);
+			out += size;
+			read += size + 2;
+		}
+		message.body = c.view(body, out);
+	} else if (content_length) {
+		while (c.end < body + *content_length) {
+			co_await c.read_more();
+		}
+		message.body = c.view(body, body + *content_length);
+		c.begin = body + *content_length;
+	} else {
+		// 沒有長度: 讀到 server 關閉為止，這條連線之後不能再用
+		boost::system::error_code ec;
+		while (!ec) {
+			if (c.end == c.buffer.size()) {
+				c.buffer.resize(c.buffer.size() * 2);
+			}
+			c.end += co_await c.socket.async_read_some(
+					asio::buffer(c.buffer.data() + c.end, c.buffer.size() - c.end),
+					asio::redirect_error(use_awaitable, ec));
+		}
+		if (ec != asio::error::eof)
+			throw boost::system::system_error(ec);
+		message.body = c.view(body, c.end);
+		message.keep_alive = false;
+		c.begin = c.end;
+	}
+	co_return message;
+}
+
+template <typename Handler>
+awaitable<void> HttpClient::pipeline(const std::string& host, const std::vector<std::string>& paths,
+																		 size_t first, size_t stride, Handler handle) {
+	for (size_t done = first; done < paths.size();) {
+		auto connection = take_idle(host);
+		if (!connection) {
+			connection = co_await connect(host);
+		}
+
+		std::string requests;
+		for (size_t i = done; i < paths.size(); i += stride) {
+			append_request(requests, host, paths[i]);
+		}
+
+		bool keep_alive = true;
+		try {
+			co_await asio::async_write(connection->socket, asio::buffer(requests), use_awaitable);
+			while (done < paths.size() && keep_alive) {
+				Message message = co_await read_response(*connection);
+				handle(done, message);
+				keep_alive = message.keep_alive;
+				done += stride;
+			}
+		} catch (const boost::system::system_error&) {
+			// pool 裡的舊連線可能已經被 server 關了: 換一條新的，從還沒收到的那個重送
+			if (!connection->reused)
+				throw;
+			continue;
+		}
+		if (keep_alive) {
+			// 每個 request 的回應都讀完了，留在 buffer 裡的位元組不屬於任何人
+			assert(connection->begin == connection->end);
+			release(host, std::move(connection));
+		}
+		// server 中途不 keep-alive 了: 剩下的在下一條連線上重送
+	}
+}
+
+awaitable<HttpClient::Response> HttpClient::get(std::string host, std::string path) {
+	std::vector<std::string> paths{std::move(path)};
+	Response response;
+	co_await pipeline(host, paths, 0, 1, [&](size_t, const Message& message) {
+		response.status = message.status;
+		response.body.assign(message.body);
+	});
+	co_return response;
+}
+
+awaitable<json> HttpClient::get_json(std::string host, std::string path) {
+	std::vector<std::string> paths{std::move(path)};
+	json result;
+	co_await pipeline(host, paths, 0, 1, [&](size_t, const Message& message) {
+		if (message.status < 200 || message.status >= 300)
+			throw std::runtime_error(fmt::format("GET {}{}: HTTP {}", host, paths[0], message.status));
+		result = json::parse(message.body.begin(), message.body.end());
+	});
+	co_return result;
+}
+
+awaitable<std::vector<json>> HttpClient::get_json_all(std::string host,
+																											 std::vector<std::string> paths) {
+	std::vector<json> results(paths.size());
+	size_t lanes = std::min(connections_per_host_, paths.size());
+	if (lanes == 0)
+		co_return results;
+
+	// 每條連線一個 coroutine；全部結束時 cancel timer 叫醒這裡
+	asio::steady_timer all_done(executor_, asio::steady_timer::time_point::max());
+	size_t running = lanes;
+	std::exception_ptr failure;
+	auto parse = [&](size_t index, const Message& message) {
+		if (message.status < 200 || message.status >= 300)
+			throw std::runtime_error(
+					fmt::format("GET {}{}: HTTP {}", host, paths[index], message.status));
+		results[index] = json::parse(message.body.begin(), message.body.end());
+	};
+	for (size_t lane = 0; lane < lanes; ++lane) {
+		asio::co_spawn(executor_, pipeline(host, paths, lane, lanes, parse),
+									 [&](std::exception_ptr error) {
+										 if (error && !failure)
+											 failure = error;
+										 if (--running == 0)
+											 all_done.cancel();
+									 });
+	}
+	boost::system::error_code ec;
+	co_await all_done.async_wait(asio::redirect_error(use_awaitable, ec));
+	if (failure)
+		std::rethrow_exception(failure);
+	co_return results;
+}
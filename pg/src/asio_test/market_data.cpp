@@ -0,0 +1,287 @@
+#include <pg/asio_test/market_data.hpp>
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#endif
+
+#include <matching_engine/matching/async_engine.hpp>
+
+namespace asio = boost::asio;
+using asio::awaitable;
+using asio::co_spawn;
+using asio::detached;
+using asio::use_awaitable;
+using boost::asio::ip::udp;
+
+namespace me = matching_engine;
+
+MarketDataPublisher::MarketDataPublisher(udp::socket socket, const udp::endpoint& group,
+																				 uint32_t session)
+		: socket_(std::move(socket)), group_(group), session_(session), ring_(RETRANSMIT_PACKETS) {}
+
+void MarketDataPublisher::add_fill(const me::OrderEvent& fill) {
+	MdMessage message{};
+	message.id = fill.order_id.value;
+	message.price_ticks = fill.fill_info.fill_price.ticks;
+	message.quantity = fill.fill_info.filled_quantity.value;
+	message.symbol = fill.symbol.value;
+	message.type = MdMessageType::Trade;
+	message.side = fill.side == me::Side::Buy ? 0 : 1;
+	append(message);
+}
+
+void MarketDataPublisher::add_update(const me::BookUpdate& update) {
+	MdMessage message{};
+	message.id = update.sequence;
+	message.price_ticks = update.price.ticks;
+	message.quantity = update.quantity.value;
+	message.symbol = update.symbol.value;
+	message.orders = update.orders;
+	message.type = MdMessageType::Level;
+	message.side = update.side == me::Side::Buy ? 0 : 1;
+	append(message);
+}
+
+void MarketDataPublisher::publish(std::span<const me::OrderEvent> events,
+																	std::span<const me::BookUpdate> updates) {
+	for (const me::OrderEvent& event : events) {
+		if (event.type == me::OrderEventType::Fill) {
+			add_fill(event);
+		}
+	}
+	for (const me::BookUpdate& update : updates) {
+		add_update(update);
+	}
+}
+
+void MarketDataPublisher::flush() {
+	if (open_ > 0) {
+		close_packet();
+	}
+	send_pending();
+}
+
+std::span<const std::byte> MarketDataPublisher::packet(uint64_t sequence) const {
+	const Slot& s = ring_[sequence % RETRANSMIT_PACKETS];
+	// 還在組或還沒送出的 packet 不給補發
+	if (s.sequence != sequence || sequence >= sequence_ - pending_)
+		return {};
+	return std::span(s.bytes).first(s.size);
+}
+
+// message 直接寫進目前這個 packet 在 ring 裡的 slot，header 留到收尾才寫
+void MarketDataPublisher::append(const MdMessage& message) {
+	Slot& s = slot(sequence_);
+	std::memcpy(s.bytes.data() + sizeof(MdPacketHeader) + open_ * sizeof(MdMessage), &message,
+							sizeof(message));
+	++messages_;
+	if (++open_ == MESSAGES_PER_PACKET) {
+		close_packet();
+	}
+}
+
+void MarketDataPublisher::close_packet() {
+	Slot& s = slot(sequence_);
+	MdPacketHeader header{.sequence = sequence_,
+												.session = session_,
+												.count = static_cast<uint16_t>(open_),
+												.reserved = 0};
+	std::memcpy(s.bytes.data(), &header, sizeof(header));
+	s.sequence = sequence_;
+	s.size = static_cast<uint16_t>(sizeof(MdPacketHeader) + open_ * sizeof(MdMessage));
+	++sequence_;
+	open_ = 0;
+	if (++pending_ == SEND_BATCH) {
+		send_pending();
+	}
+}
+
+// 組好的 packet 一次送出。Linux 上是一個 sendmmsg() system call，
+// 其他平台退回一個 packet 一次 send_to。UDP 送不出去就丟掉，收方會要補發
+void MarketDataPublisher::send_pending() {
+	if (pending_ == 0)
+		return;
+	uint64_t first = sequence_ - pending_;
+#if defined(__linux__)
+	std::array<iovec, SEND_BATCH> iov;
+	std::array<mmsghdr, SEND_BATCH> headers{};
+	for (size_t i = 0; i < pending_; ++i) {
+		Slot& s = slot(first + i);
+		iov[i] = iovec{.iov_base = s.bytes.data(), .iov_len = s.size};
+		headers[i].msg_hdr.msg_name = group_.data();
+		headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(group_.size());
+		headers[i].msg_hdr.msg_iov = &iov[i];
+		headers[i].msg_hdr.msg_iovlen = 1;
+	}
+	// 被 signal 打斷就重送；send buffer 滿了 (EAGAIN) 等它可寫再送，等太久或
+	// 其他錯誤才放棄，剩下的算 drop (還在 ring 裡，收端可以要求補發)
+	size_t sent = 0;
+	while (sent < pending_) {
+		int n = ::sendmmsg(socket_.native_handle(), headers.data() + sent,
+											 static_cast<unsigned>(pending_ - sent), 0);
+		if (n > 0) {
+			sent += static_cast<size_t>(n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			pollfd writable{.fd = socket_.native_handle(), .events = POLLOUT, .revents = 0};
+			if (::poll(&writable, 1, SEND_WAIT_MS) > 0)
+				continue;
+		}
+		break;
+	}
+#else
+	size_t sent = 0;
+	for (size_t i = 0; i < pending_; ++i) {
+		Slot& s = slot(first + i);
+		boost::system::error_code ec;
+		socket_.send_to(asio::buffer(s.bytes.data(), s.size), group_, 0, ec);
+		sent += !ec;
+	}
+#endif
+	packets_sent_ += sent;
+	packets_dropped_ += pending_ - sent;
+	pending_ = 0;
+}
+
+// 補發用同步 send_to: 要是 co_await 非同步送，送到一半 ring slot 可能已經被
+// 新的 packet 蓋掉
+awaitable<void> MarketDataPublisher::serve_retransmits(udp::socket& requests) {
+	MdRetransmitRequest request;
+	udp::endpoint from;
+	try {
+		while (true) {
+			size_t n = co_await requests.async_receive_from(asio::buffer(&request, sizeof(request)), from,
+																											use_awaitable);
+			if (n != sizeof(request) || request.session != session_)
+				continue;
+			uint32_t count = std::min<uint32_t>(request.count, MAX_RETRANSMIT);
+			for (uint32_t i = 0; i < count; ++i) {
+				std::span<const std::byte> bytes = packet(request.sequence + i);
+				if (bytes.empty())
+					break;	// 已經不在 ring 裡，收方只能重新跟 snapshot 同步
+				boost::system::error_code ec;
+				requests.send_to(asio::buffer(bytes.data(), bytes.size()), from, 0, ec);
+			}
+		}
+	} catch (std::exception& e) {
+		fmt::print(fg(fmt::color::red), "Retransmit error: {}\n", e.what());
+	}
+}
+
+namespace {
+
+using DemoBook =
+		me::matching::BasicOrderBook<me::matching::LadderPriceLevels, me::CachedClock<me::TscClock>>;
+using DemoEngine = me::matching::AsyncMatchingEngine<1 << 14, DemoBook>;
+
+template <typename Task>
+auto run_inline(Task task) {
+	while (!task.done()) {
+		task.resume();
+	}
+	return task.get_result();
+}
+
+// 合成 order flow: 一批一批丟進 engine，每批之後把 market data 倒出去，
+// 再讓出 thread 給 retransmit request
+awaitable<void> run_flow(DemoEngine& engine, MarketDataPublisher& publisher) {
+	constexpr size_t BATCH = 256;
+	std::mt19937_64 rng(42);
+	std::uniform_int_distribution<int64_t> offset(-5, 20);
+	std::uniform_int_distribution<uint64_t> quantity(1, 100);
+	std::uniform_int_distribution<int> roll(0, 9);
+	std::vector<me::OrderEvent> batch(BATCH);
+	uint64_t next_id = 1;
+
+	auto executor = co_await asio::this_coro::executor;
+	auto last = std::chrono::steady_clock::now();
+	size_t last_messages = 0, last_packets = 0;
+	while (true) {
+		for (me::OrderEvent& order : batch) {
+			int r = roll(rng);
+			if (r < 4 && next_id > 1) {
+				// 四成 cancel 某個之前的 order，book 才不會一直長大
+				std::uniform_int_distribution<uint64_t> id(1, next_id - 1);
+				order = me::OrderEvent{.type = me::OrderEventType::Cancel, .order_id = me::OrderId{id(rng)}};
+				continue;
+			}
+			me::Side side = r % 2 ? me::Side::Buy : me::Side::Sell;
+			int64_t distance = offset(rng);
+			order = me::OrderEvent{.type = me::OrderEventType::New,
+														 .price = me::Price{10000 + (side == me::Side::Buy ? -distance : distance)},
+														 .quantity = me::Quantity{quantity(rng)},
+														 .side = side};
+			++next_id;
+		}
+		run_inline(engine.process_batch_async(batch));
+		publisher.drain(engine);
+
+		auto now = std::chrono::steady_clock::now();
+		if (now - last >= std::chrono::seconds(1)) {
+			double seconds = std::chrono::duration<double>(now - last).count();
+			fmt::print("{:>12.0f} updates/s {:>10.0f} packets/s  (next seq {}, {} dropped)\n",
+								 (publisher.messages_sent() - last_messages) / seconds,
+								 (publisher.packets_sent() - last_packets) / seconds, publisher.next_sequence(),
+								 publisher.packets_dropped());
+			last = now;
+			last_messages = publisher.messages_sent();
+			last_packets = publisher.packets_sent();
+		}
+		co_await asio::post(executor, use_awaitable);
+	}
+}
+
+}	 // namespace
+
+int market_data_publisher(unsigned short port) {
+	try {
+		asio::io_context io_context(1);
+		udp::endpoint group(asio::ip::make_address("239.255.0.1"), port);
+
+		// 只在本機 loopback 上 multicast，TTL 1 不出這個網段
+		udp::socket socket(io_context, udp::v4());
+		socket.set_option(asio::ip::multicast::outbound_interface(asio::ip::address_v4::loopback()));
+		socket.set_option(asio::ip::multicast::enable_loopback(true));
+		socket.set_option(asio::ip::multicast::hops(1));
+		socket.set_option(asio::socket_base::send_buffer_size(4 << 20));
+
+		udp::socket requests(io_context, udp::endpoint(udp::v4(), static_cast<unsigned short>(port + 1)));
+
+		auto session = static_cast<uint32_t>(
+				std::chrono::system_clock::now().time_since_epoch() / std::chrono::seconds(1));
+		auto publisher = std::make_unique<MarketDataPublisher>(std::move(socket), group, session);
+		auto engine = std::make_unique<DemoEngine>();
+
+		fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+							 "Market data on {}:{} (session {}, {} updates per packet), retransmits on {}\n",
+							 group.address().to_string(), port, session,
+							 MarketDataPublisher::MESSAGES_PER_PACKET, port + 1);
+
+		co_spawn(io_context, publisher->serve_retransmits(requests), detached);
+		co_spawn(io_context, run_flow(*engine, *publisher), detached);
+		io_context.run();
+	} catch (std::exception& e) {
+		fmt::print(stderr, fg(fmt::color::red), "Error: {}\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include <pg/asio_test/order_gateway.hpp>
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// boost/asio/awaitable.hpp 用到 std::exchange 卻沒有 include <utility>
+#include <boost/asio.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <matching_engine/core/packed_event.hpp>
+#include <matching_engine/matching/async_engine.hpp>
+
+namespace asio = boost::asio;
+using asio::awaitable;
+using asio::co_spawn;
+using asio::detached;
+using asio::use_awaitable;
+using boost::asio::ip::tcp;
+
+namespace me = matching_engine;
+
+namespace {
+
+// 所有連線共用一個 engine，而且只有 io_context 那一條 thread 會碰它，
+// 所以不用鎖。用 CachedClock: 一批 order 只讀一次 TSC
+using GatewayBook =
+		me::matching::BasicOrderBook<me::matching::LadderPriceLevels, me::CachedClock<me::TscClock>>;
+using GatewayEngine = me::matching::AsyncMatchingEngine<1 << 14, GatewayBook>;
+
+constexpr size_t MAX_BATCH = 256;	 // 一次 decode 的 frame 數上限
+constexpr size_t READ_BUFFER_SIZE = MAX_BATCH * sizeof(OrderFrame);
+
+// engine 的 awaitable 都是當場完成，直接在這裡推到結束，不用經過 executor
+template <typename Task>
+auto run_inline(Task task) {
+	while (!task.done()) {
+		task.resume();
+	}
+	return task.get_result();
+}
+
+// 從 read buffer 裡就地取出一個 frame；位置不一定對齊，用 memcpy 讀
+me::OrderEvent decode(const char* bytes) {
+	OrderFrame frame;
+	std::memcpy(&frame, bytes, sizeof(frame));
+
+	me::OrderEvent event{.type = me::OrderEventType::New};
+	switch (frame.type) {
+		case FrameType::Cancel:
+			event.type = me::OrderEventType::Cancel;
+			break;
+		case FrameType::Modify:
+			event.type = me::OrderEventType::Modify;
+			break;
+		default:
+			break;
+	}
+	event.order_id = me::OrderId{frame.order_id};
+	event.account = me::AccountId{frame.account};
+	event.price = me::Price{frame.price_ticks};
+	event.quantity = me::Quantity{frame.quantity};
+	event.side = frame.side == 0 ? me::Side::Buy : me::Side::Sell;
+	event.order_type = static_cast<me::OrderType>(frame.order_type);
+	return event;
+}
+
+ReportFrame ack_report(uint64_t client_order_id, const me::OrderEvent& ack) {
+	ReportFrame report{};
+	report.client_order_id = client_order_id;
+	report.order_id = ack.order_id.value;
+	report.price_ticks = ack.price.ticks;
+	report.quantity = ack.fill_info.remaining_quantity.value;
+	report.type = ReportType::Ack;
+	if (ack.type == me::OrderEventType::Reject) {
+		report.type = ReportType::Reject;
+		report.reject_reason =
+				static_cast<uint8_t>(me::PackedOrderEvent::from_event(ack).reject_reason);
+	}
+	return report;
+}
+
+// 一條連線。read buffer、decode 出來的 order、ack 與 report 都在連線開始時
+// 配置一次，之後每批都重用，steady state 下不再配置記憶體
+awaitable<void> handle_session(tcp::socket socket, GatewayEngine& engine) {
+	std::vector<char> buffer(READ_BUFFER_SIZE);
+	size_t buffered = 0;
+
+	std::vector<me::OrderEvent> orders, acks, events(MAX_BATCH);
+	std::vector<me::BookUpdate> updates(MAX_BATCH);
+	std::vector<uint64_t> client_ids;
+	std::vector<ReportFrame> ack_reports, fill_reports;
+	orders.reserve(MAX_BATCH);
+	acks.reserve(MAX_BATCH);
+	client_ids.reserve(MAX_BATCH);
+	ack_reports.reserve(MAX_BATCH);
+	fill_reports.reserve(MAX_BATCH);
+
+	try {
+		while (true) {
+			size_t n = co_await socket.async_read_some(
+					asio::buffer(buffer.data() + buffered, buffer.size() - buffered), use_awaitable);
+			buffered += n;
+
+			// 只處理完整的 frame，不滿一個 frame 的尾巴留到下次
+			size_t frames = buffered / sizeof(OrderFrame);
+			if (frames == 0)
+				continue;
+
+			orders.clear();
+			client_ids.clear();
+			for (size_t i = 0; i < frames; ++i) {
+				const char* bytes = buffer.data() + i * sizeof(OrderFrame);
+				orders.push_back(decode(bytes));
+				uint64_t client_order_id;
+				std::memcpy(&client_order_id, bytes, sizeof(client_order_id));
+				client_ids.push_back(client_order_id);
+			}
+
+			// 整批一次送進 engine，acks[i] 對應 orders[i]
+			acks.resize(frames);
+			run_inline(engine.process_batch_async(orders, acks));
+
+			ack_reports.clear();
+			for (size_t i = 0; i < frames; ++i) {
+				ack_reports.push_back(ack_report(client_ids[i], acks[i]));
+			}
+
+			// fill 依 order 的處理順序出來，所以用一個往前走的 cursor 就能對回
+			// client id。只回報這批 order 自己的 fill；更早掛在簿上的 order 被動
+			// 成交時不在這條連線回報
+			fill_reports.clear();
+			size_t cursor = 0;
+			while (size_t count = engine.poll_events(events)) {
+				for (size_t k = 0; k < count; ++k) {
+					const me::OrderEvent& fill = events[k];
+					if (fill.type != me::OrderEventType::Fill)
+						continue;
+					while (cursor < frames && acks[cursor].order_id != fill.order_id) {
+						++cursor;
+					}
+					if (cursor == frames) {
+						cursor = 0;	 // 對不到: 更早那批 order 的被動成交
+						continue;
+					}
+					ReportFrame report{};
+					report.client_order_id = client_ids[cursor];
+					report.order_id = fill.order_id.value;
+					report.price_ticks = fill.fill_info.fill_price.ticks;
+					report.quantity = fill.fill_info.filled_quantity.value;
+					report.type = ReportType::Fill;
+					fill_reports.push_back(report);
+				}
+				if (count < events.size())
+					break;
+			}
+
+			// engine 每批也會推 L2 delta；gateway 不發行情，照樣清掉，不然
+			// update queue 滿了之後每次 push 都失敗，dropped_updates() 一直漲
+			while (engine.poll_updates(updates) == updates.size()) {
+			}
+
+			// ack 跟 fill 兩段 buffer 一次 scatter/gather 寫出，不先拼在一起
+			std::array<asio::const_buffer, 2> reports{asio::buffer(ack_reports),
+																								 asio::buffer(fill_reports)};
+			co_await asio::async_write(socket, reports, use_awaitable);
+
+			size_t consumed = frames * sizeof(OrderFrame);
+			std::memmove(buffer.data(), buffer.data() + consumed, buffered - consumed);
+			buffered -= consumed;
+		}
+	} catch (const boost::system::system_error& e) {
+		if (e.code() != asio::error::eof) {
+			fmt::print(fg(fmt::color::red), "Session error: {}\n", e.what());
+		}
+	}
+	fmt::print(fg(fmt::color::yellow), "[Gateway] Session closed ({} fills dropped so far)\n",
+						 engine.dropped_events());
+}
+
+// accept 之後每條連線各自一個 coroutine，連線會一直保持到 client 關閉
+awaitable<void> gateway_listener(tcp::acceptor& acceptor, GatewayEngine& engine) {
+	while (true) {
+		tcp::socket socket = co_await acceptor.async_accept(use_awaitable);
+		socket.set_option(tcp::no_delay(true));
+
+		fmt::print(fg(fmt::color::cyan), "[Gateway] New session from {}:{}\n",
+							 socket.remote_endpoint().address().to_string(), socket.remote_endpoint().port());
+
+		co_spawn(acceptor.get_executor(), handle_session(std::move(socket), engine), detached);
+	}
+}
+
+}	 // namespace
+
+int order_gateway(unsigned short port) {
+	try {
+		// concurrency hint 1: 只有一條 thread 跑這個 io_context
+		asio::io_context io_context(1);
+		tcp::acceptor acceptor(io_context, tcp::endpoint(tcp::v4(), port));
+
+		// engine 裡的 ring buffer 太大，不能放在 stack 上
+		auto engine = std::make_unique<GatewayEngine>();
+
+		fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+							 "Binary order gateway on port {} ({}-byte order frames, {}-byte reports)\n", port,
+							 sizeof(OrderFrame), sizeof(ReportFrame));
+		fmt::print("Waiting for sessions...\n\n");
+
+		co_spawn(io_context, gateway_listener(acceptor, *engine), detached);
+		io_context.run();
+	} catch (std::exception& e) {
+		fmt::print(stderr, fg(fmt::color::red), "Error: {}\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,255 @@
+#include <pg/asio_test/reference_data.hpp>
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <array>
+#include <chrono>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <nlohmann/json.hpp>
+
+namespace asio = boost::asio;
+using boost::asio::ip::tcp;
+using json = nlohmann::json;
+
+namespace {
+
+// 只記得目前在哪一層、上一個 key 是什麼，和正在組的那一筆 record
+class InstrumentSax : public nlohmann::json_sax<json> {
+	struct Frame {
+		InstrumentInfo record;
+		bool has_symbol = false;
+		bool has_tick_size = false;
+	};
+
+	const InstrumentCallback& on_instrument_;
+	std::vector<Frame> objects_;	// 每一層還沒結束的 object 一個
+	std::string key_;							// 最近一個 key，只在 object 直屬的值上有意義
+	bool key_pending_ = false;		// key_ 還沒被值用掉
+	size_t count_ = 0;
+
+	// 目前這個值屬於最內層 object 的哪個欄位；在 array 裡就沒有
+	std::string_view field() {
+		if (!key_pending_ || objects_.empty())
+			return {};
+		key_pending_ = false;
+		return key_;
+	}
+
+	void number(double value) {
+		std::string_view name = field();
+		if (name == "tick_size") {
+			objects_.back().record.tick_size = value;
+			objects_.back().has_tick_size = true;
+		} else if (name == "lot_size" && value >= 1) {
+			objects_.back().record.lot_size = static_cast<uint64_t>(value);
+		}
+	}
+
+ public:
+	explicit InstrumentSax(const InstrumentCallback& on_instrument)
+			: on_instrument_(on_instrument) {}
+
+	size_t count() const { return count_; }
+
+	bool null() override {
+		field();
+		return true;
+	}
+
+	bool boolean(bool) override {
+		field();
+		return true;
+	}
+
+	bool number_integer(number_integer_t value) override {
+		number(static_cast<double>(value));
+		return true;
+	}
+
+	bool number_unsigned(number_unsigned_t value) override {
+		number(static_cast<double>(value));
+		return true;
+	}
+
+	bool number_float(number_float_t value, const string_t&) override {
+		number(value);
+		return true;
+	}
+
+	bool string(string_t& value) override {
+		std::string_view name = field();
+		if (name == "symbol") {
+			objects_.back().record.symbol = std::move(value);
+			objects_.back().has_symbol = true;
+		} else if (name == "tick_size") {
+			// 有些主檔把數字寫成字串
+			double tick = 0.0;
+			auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), tick);
+			if (ec == std::errc{} && end == value.data() + value.size()) {
+				objects_.back().record.tick_size = tick;
+				objects_.back().has_tick_size = true;
+			}
+		}
+		return true;
+	}
+
+	bool binary(binary_t&) override {
+		field();
+		return true;
+	}
+
+	bool start_object(std::size_t) override {
+		field();
+		objects_.emplace_back();
+		return true;
+	}
+
+	bool key(string_t& value) override {
+		key_.assign(value);
+		key_pending_ = true;
+		return true;
+	}
+
+	bool end_object() override {
+		Frame& frame = objects_.back();
+		if (frame.has_symbol && frame.has_tick_size) {
+			on_instrument_(frame.record);
+			++count_;
+		}
+		objects_.pop_back();
+		return true;
+	}
+
+	bool start_array(std::size_t) override {
+		field();
+		return true;
+	}
+
+	bool end_array() override { return true; }
+
+	bool parse_error(std::size_t position, const std::string&,
+									 const nlohmann::detail::exception& e) override {
+		throw std::runtime_error(fmt::format("instrument file, byte {}: {}", position, e.what()));
+	}
+};
+
+// 把 socket 上的 HTTP response body 包成 streambuf: 第一次被要資料時讀掉
+// header，之後每次 underflow 就 read_some 一塊進同一個固定 buffer。
+// 送的是 HTTP/1.0 request，server 回的 body 不會是 chunked，讀到關線為止
+class HttpBodyBuf : public std::streambuf {
+	tcp::socket& socket_;
+	std::array<char, 64 * 1024> buffer_;
+	bool in_body_ = false;
+
+	void read_header() {
+		size_t have = 0;
+		while (true) {
+			if (have == buffer_.size())
+				throw std::runtime_error("HTTP response header larger than the receive buffer");
+			have += socket_.read_some(asio::buffer(buffer_.data() + have, buffer_.size() - have));
+			std::string_view received(buffer_.data(), have);
+			size_t end = received.find("\r\n\r\n");
+			if (end == std::string_view::npos)
+				continue;
+
+			int status = 0;
+			if (received.size() >= 12 && received.substr(0, 5) == "HTTP/") {
+				std::from_chars(received.data() + 9, received.data() + 12, status);
+			}
+			if (status < 200 || status >= 300)
+				throw std::runtime_error(fmt::format("HTTP status {}", status));
+			setg(buffer_.data(), buffer_.data() + end + 4, buffer_.data() + have);
+			in_body_ = true;
+			return;
+		}
+	}
+
+ protected:
+	int_type underflow() override {
+		if (!in_body_) {
+			read_header();
+			if (gptr() < egptr())
+				return traits_type::to_int_type(*gptr());
+		}
+		boost::system::error_code ec;
+		size_t n = socket_.read_some(asio::buffer(buffer_), ec);
+		if (ec && ec != asio::error::eof)
+			throw boost::system::system_error(ec);
+		if (n == 0)
+			return traits_type::eof();
+		setg(buffer_.data(), buffer_.data(), buffer_.data() + n);
+		return traits_type::to_int_type(*gptr());
+	}
+
+ public:
+	explicit HttpBodyBuf(tcp::socket& socket) : socket_(socket) {}
+};
+
+}	 // namespace
+
+size_t ingest_instruments(std::istream& in, const InstrumentCallback& on_instrument) {
+	InstrumentSax sax(on_instrument);
+	json::sax_parse(in, &sax);
+	return sax.count();
+}
+
+size_t fetch_instruments(const std::string& host, const std::string& path,
+												 const InstrumentCallback& on_instrument) {
+	asio::io_context io_context;
+	tcp::resolver resolver(io_context);
+	tcp::socket socket(io_context);
+	asio::connect(socket, resolver.resolve(host, "http"));
+
+	std::string request = fmt::format(
+			"GET {} HTTP/1.0\r\n"
+			"Host: {}\r\n"
+			"Accept: application/json\r\n\r\n",
+			path, host);
+	asio::write(socket, asio::buffer(request));
+
+	HttpBodyBuf body(socket);
+	std::istream in(&body);
+	return ingest_instruments(in, on_instrument);
+}
+
+int reference_data(const char* file) {
+	if (!file) {
+		fmt::print(stderr, "usage: reference_data <instruments.json>\n");
+		return 1;
+	}
+	try {
+		std::ifstream in(file, std::ios::binary);
+		if (!in)
+			throw std::runtime_error(fmt::format("cannot open {}", file));
+
+		size_t shown = 0;
+		auto start = std::chrono::steady_clock::now();
+		size_t count = ingest_instruments(in, [&](const InstrumentInfo& instrument) {
+			if (shown++ < 5) {
+				fmt::print("{:<12} tick {:<10} lot {}\n", instrument.symbol, instrument.tick_size,
+									 instrument.lot_size);
+			}
+		});
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		auto bytes = static_cast<double>(std::filesystem::file_size(file));
+		fmt::print(fg(fmt::color::cyan), "{} instruments in {:.3f} s", count, seconds);
+		if (bytes > 0 && seconds > 0) {
+			fmt::print(fg(fmt::color::cyan), " ({:.0f} MB/s)", bytes / seconds / 1e6);
+		}
+		fmt::print("\n");
+	} catch (std::exception& e) {
+		fmt::print(stderr, fg(fmt::color::red), "Error: {}\n", e.what());
+		return 1;
+	}
+	return 0;
+}
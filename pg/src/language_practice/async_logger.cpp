@@ -0,0 +1,202 @@
+#include <pg/language_practice/async_logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace {
+
+// format string 全域表。寫入 (登記) 在 mutex 底下；背景 thread 讀的是
+// 「某筆 record push 之前就登記好的 id」，ring 的 release / acquire 已經保證
+// 看得到，所以讀不用鎖。前三格留給文字片段 / 表滿了。
+constexpr uint32_t kMaxFormats = 4096;
+constexpr uint32_t kReservedFormats = 3;
+
+std::array<const char*, kMaxFormats> g_formats{"{}", "{}", "<log format table full>"};
+uint32_t g_format_count = kReservedFormats;
+std::mutex g_format_mutex;
+
+std::atomic<uint64_t> g_next_logger_id{1};
+
+constexpr size_t kTextBytes = sizeof(LogRecord::args);
+constexpr size_t kFlushBytes = 64 * 1024;
+constexpr auto kIdleSleep = std::chrono::microseconds(200);
+
+int64_t wall_minus_tsc_ns() {
+	auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+									std::chrono::system_clock::now().time_since_epoch())
+									.count();
+	return static_cast<int64_t>(wall) -
+				 static_cast<int64_t>(matching_engine::TscClock{}.now().nanoseconds);
+}
+
+}	 // namespace
+
+uint32_t AsyncFileLogger::register_format(const char* fmt) {
+	std::lock_guard lock(g_format_mutex);
+	if (g_format_count == kMaxFormats)
+		return kOverflowFormat;
+	g_formats[g_format_count] = fmt;
+	return g_format_count++;
+}
+
+AsyncFileLogger::AsyncFileLogger(const std::string& path)
+		: id_(g_next_logger_id.fetch_add(1, std::memory_order_relaxed)),
+			file_(std::fopen(path.c_str(), "ab")),
+			wall_offset_ns_(wall_minus_tsc_ns()) {
+	if (!file_)
+		throw std::runtime_error("AsyncFileLogger: cannot open " + path);
+	worker_ = std::jthread([this](std::stop_token stop) { run(stop); });
+}
+
+AsyncFileLogger::~AsyncFileLogger() {
+	worker_.request_stop();
+	worker_.join();
+	std::fclose(file_);
+}
+
+void AsyncFileLogger::log(const std::string& msg) {
+	LogRecord r;
+	r.timestamp_ns = matching_engine::TscClock{}.now().nanoseconds;
+	r.fragment = 0;
+	size_t at = 0;
+	do {
+		size_t n = std::min(kTextBytes, msg.size() - at);
+		std::memcpy(r.args.data(), msg.data() + at, n);
+		at += n;
+		r.argc = static_cast<uint8_t>(n);
+		r.format_id = at < msg.size() ? kTextMoreFormat : kTextFormat;
+		push(r);
+		++r.fragment;
+	} while (at < msg.size());
+}
+
+AsyncFileLogger::ThreadSlot AsyncFileLogger::register_thread() noexcept {
+	std::lock_guard lock(register_mutex_);
+	auto self = std::this_thread::get_id();
+	size_t count = ring_count_.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < count; ++i) {
+		if (owners_[i] == self)
+			return {id_, rings_[i].get()};
+	}
+	if (count == kMaxThreads)
+		return {id_, nullptr};
+
+	rings_[count].reset(new (std::nothrow) Ring);
+	if (!rings_[count])
+		return {id_, nullptr};
+	owners_[count] = self;
+	ring_count_.store(count + 1, std::memory_order_release);	// 背景 thread 從這裡看到新 ring
+	return {id_, rings_[count].get()};
+}
+
+void AsyncFileLogger::run(std::stop_token stop) {
+	fmt::memory_buffer out;
+	while (true) {
+		// 先看 stop 再清：stop 之後最後一輪一定會把 stop 之前 push 的都清掉
+		bool stopping = stop.stop_requested();
+		size_t drained = drain(out);
+		if (out.size() >= kFlushBytes || (drained == 0 && out.size() > 0))
+			write_out(out);
+		if (drained == 0) {
+			if (stopping)
+				break;
+			std::this_thread::sleep_for(kIdleSleep);
+		}
+	}
+	write_out(out);
+	std::fflush(file_);
+}
+
+size_t AsyncFileLogger::drain(fmt::memory_buffer& out) {
+	std::array<LogRecord, 256> batch;
+	size_t total = 0;
+	size_t count = ring_count_.load(std::memory_order_acquire);
+	for (size_t i = 0; i < count; ++i) {
+		size_t n;
+		while ((n = rings_[i]->pop_bulk(batch)) > 0) {
+			for (size_t k = 0; k < n; ++k)
+				format_record(i, batch[k], out);
+			total += n;
+			if (out.size() >= kFlushBytes)
+				write_out(out);
+		}
+	}
+	return total;
+}
+
+void AsyncFileLogger::format_record(size_t ring, const LogRecord& r, fmt::memory_buffer& out) {
+	auto append = [&](std::string_view s) { out.append(s.data(), s.data() + s.size()); };
+
+	// 文字片段：湊滿一整段才輸出。第 0 段開始新的一行 (前一行沒收到結尾就
+	// 直接丟掉)；段數或時間戳接不上表示中間掉了，這行收到結尾時整行丟掉
+	if (r.format_id == kTextMoreFormat || r.format_id == kTextFormat) {
+		PendingText& pending = pending_text_[ring];
+		if (r.fragment == 0) {
+			pending.line.clear();
+			pending.timestamp_ns = r.timestamp_ns;
+			pending.broken = false;
+		} else if (r.fragment != pending.next_fragment || r.timestamp_ns != pending.timestamp_ns) {
+			pending.line.clear();
+			pending.broken = true;
+		}
+		pending.next_fragment = static_cast<uint16_t>(r.fragment + 1);
+		if (!pending.broken)
+			pending.line.append(reinterpret_cast<const char*>(r.args.data()), r.argc);
+		if (r.format_id == kTextMoreFormat)
+			return;
+		if (pending.broken) {
+			pending.broken = false;
+			return;
+		}
+	}
+
+	// "2026-10-14 03:04:05.123456789 [t0] "；日期時間那段一秒才重排一次
+	int64_t wall = static_cast<int64_t>(r.timestamp_ns) + wall_offset_ns_;
+	int64_t second = wall / 1'000'000'000;
+	if (second != stamp_second_) {
+		std::time_t t = static_cast<std::time_t>(second);
+		std::tm tm{};
+		gmtime_r(&t, &tm);
+		stamp_len_ = std::strftime(stamp_, sizeof(stamp_), "%Y-%m-%d %H:%M:%S", &tm);
+		stamp_second_ = second;
+	}
+	fmt::format_to(std::back_inserter(out), "{}.{:09} [t{}] ", std::string_view(stamp_, stamp_len_),
+								 wall % 1'000'000'000, ring);
+
+	if (r.format_id == kTextFormat) {
+		append(pending_text_[ring].line);
+		pending_text_[ring].line.clear();
+	} else {
+		args_.clear();
+		for (size_t i = 0; i < r.argc; ++i) {
+			switch (r.types[i]) {
+				case LogArgType::Int: args_.push_back(r.args[i].i); break;
+				case LogArgType::Uint: args_.push_back(r.args[i].u); break;
+				case LogArgType::Double: args_.push_back(r.args[i].d); break;
+				case LogArgType::Bool: args_.push_back(r.args[i].b); break;
+				case LogArgType::Char: args_.push_back(r.args[i].c); break;
+				case LogArgType::CString: args_.push_back(r.args[i].s); break;
+			}
+		}
+		try {
+			fmt::vformat_to(std::back_inserter(out), fmt::string_view(g_formats[r.format_id]), args_);
+		} catch (const fmt::format_error& e) {
+			fmt::format_to(std::back_inserter(out), "<format error: {}>", e.what());
+		}
+	}
+	append("\n");
+}
+
+void AsyncFileLogger::write_out(fmt::memory_buffer& out) {
+	if (out.size() == 0)
+		return;
+	std::fwrite(out.data(), 1, out.size(), file_);
+	out.clear();
+}
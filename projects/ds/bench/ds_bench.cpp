@@ -0,0 +1,484 @@
+// ds_bench —— ds/ 跟 pg 的 some_ds.hpp 各結構的 per-op 微基準。
+//
+// 每個 (結構, 操作, n) 量一次：操作的輸入事先產生好，計時區間內只跑操作
+// 本身；同時用 perf_event 讀 cycles / instructions / cache misses / branch
+// misses，全部除以操作次數。n 從 L1 裝得下一路到遠大於 LLC (預設 2^10 ~
+// 2^22 個元素)，看每一階 cache 掉下去的成本。
+//
+// 結果以一份 JSON 印在 stdout，方便存檔、跨 commit 比較：
+//   ./ds_bench > ds_bench.json
+//   ./ds_bench --max-log2 18 --ops 200000   # 小一點、快一點
+//
+// perf_event 開不起來 (容器、VM 沒有 PMU、perf_event_paranoid 太高) 時
+// counters_available 是 false，計數欄位是 null，ns_per_op 照樣有。
+// 要有意義的數字請用 Release build。
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <ds/tree/btree.hpp>
+#include <ds/tree/tree.hpp>
+
+#if DS_BENCH_SOME_DS
+#include <pg/language_practice/some_ds.hpp>
+#endif
+
+namespace {
+
+// 讓編譯器以為 value 被用到了，不能把整段計算消掉
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile T sink;
+  sink = value;
+#endif
+}
+
+// cycles / instructions / cache misses / branch misses 四個硬體計數器開成一組，
+// 一次 read 全部拿回來；只算 user space。
+class PerfCounters {
+public:
+  static constexpr std::size_t kCount = 4;
+  using Values = std::array<std::uint64_t, kCount>;
+
+  PerfCounters() {
+#if defined(__linux__)
+    constexpr std::array<std::uint64_t, kCount> configs{
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    for (std::size_t i = 0; i < kCount; ++i) {
+      perf_event_attr attr{};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.disabled = i == 0 ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int group = i == 0 ? -1 : fd_[0];
+      fd_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+      if (fd_[i] < 0) {
+        close_all();
+        return;
+      }
+    }
+    available_ = true;
+#endif
+  }
+
+  ~PerfCounters() { close_all(); }
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool available() const { return available_; }
+
+  void start() {
+#if defined(__linux__)
+    if (!available_) return;
+    ioctl(fd_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fd_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  std::optional<Values> stop() {
+#if defined(__linux__)
+    if (!available_) return std::nullopt;
+    ioctl(fd_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    std::array<std::uint64_t, 1 + kCount> buf{};  // { nr, values[nr] }
+    if (read(fd_[0], buf.data(), sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return std::nullopt;
+    Values v;
+    std::copy(buf.begin() + 1, buf.end(), v.begin());
+    return v;
+#else
+    return std::nullopt;
+#endif
+  }
+
+private:
+  std::array<int, kCount> fd_{-1, -1, -1, -1};
+  bool available_ = false;
+
+  void close_all() {
+#if defined(__linux__)
+    for (int& fd : fd_) {
+      if (fd >= 0) ::close(fd);
+      fd = -1;
+    }
+#endif
+    available_ = false;
+  }
+};
+
+struct Result {
+  std::string structure;
+  std::string op;
+  std::size_t n;
+  std::size_t bytes;  // 結構大約佔的記憶體 (working set)
+  std::size_t ops;
+  double ns_per_op;
+  std::optional<PerfCounters::Values> counters;
+};
+
+struct Options {
+  unsigned min_log2 = 10;
+  unsigned max_log2 = 22;
+  std::size_t ops = 1 << 20;
+};
+
+class Bench {
+public:
+  explicit Bench(const Options& options) : options_(options) {}
+
+  const Options& options() const { return options_; }
+  bool counters_available() const { return perf_.available(); }
+  const std::vector<Result>& results() const { return results_; }
+
+  // body() 做 ops 次操作
+  template <typename F>
+  void run(std::string structure, std::string op, std::size_t n, std::size_t bytes,
+           std::size_t ops, F&& body) {
+    perf_.start();
+    auto begin = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    auto counters = perf_.stop();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+    results_.push_back({std::move(structure), std::move(op), n, bytes, ops,
+                        ns / static_cast<double>(ops), counters});
+    std::fprintf(stderr, "%-22s %-14s n=2^%-2u %8.1f ns/op\n", results_.back().structure.c_str(),
+                 results_.back().op.c_str(), static_cast<unsigned>(std::countr_zero(n)),
+                 results_.back().ns_per_op);
+  }
+
+private:
+  Options options_;
+  PerfCounters perf_;
+  std::vector<Result> results_;
+};
+
+std::vector<std::uint64_t> random_keys(std::size_t n, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<std::uint64_t> keys(n);
+  for (auto& k : keys) k = rng();
+  return keys;
+}
+
+// [l, r] 隨機區間 (l <= r < n)
+std::vector<std::pair<std::size_t, std::size_t>> random_ranges(std::size_t n, std::size_t count,
+                                                               std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<std::pair<std::size_t, std::size_t>> ranges(count);
+  for (auto& [l, r] : ranges) {
+    l = rng() % n;
+    r = rng() % n;
+    if (l > r) std::swap(l, r);
+  }
+  return ranges;
+}
+
+std::vector<std::size_t> random_indices(std::size_t n, std::size_t count, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<std::size_t> idx(count);
+  for (auto& i : idx) i = rng() % n;
+  return idx;
+}
+
+// ---------------------------------------------------------------- ds/
+
+void bench_bst(Bench& bench, std::size_t n) {
+  auto keys = random_keys(n, 1);
+  auto probes = random_indices(n, bench.options().ops, 2);
+  std::size_t bytes = n * (sizeof(std::uint64_t) + 2 * sizeof(void*) + 16);
+
+  ds::BinarySearchTree<std::uint64_t> tree;
+  bench.run("BinarySearchTree", "insert", n, bytes, n, [&] {
+    for (auto k : keys) tree.insert(k);
+  });
+  bench.run("BinarySearchTree", "contains", n, bytes, probes.size(), [&] {
+    std::size_t hits = 0;
+    for (auto i : probes) hits += tree.contains(keys[i] ^ (i & 1));  // 一半找得到
+    keep(hits);
+  });
+}
+
+void bench_btree(Bench& bench, std::size_t n) {
+  auto keys = random_keys(n, 1);
+  auto probes = random_indices(n, bench.options().ops, 2);
+  std::size_t bytes = n * sizeof(std::uint64_t) * 3 / 2;
+
+  ds::BTree<std::uint64_t> tree;
+  bench.run("BTree", "insert", n, bytes, n, [&] {
+    for (auto k : keys) tree.insert(k);
+  });
+  bench.run("BTree", "contains", n, bytes, probes.size(), [&] {
+    std::size_t hits = 0;
+    for (auto i : probes) hits += tree.contains(keys[i] ^ (i & 1));
+    keep(hits);
+  });
+}
+
+#if DS_BENCH_SOME_DS
+
+// ---------------------------------------------------------------- some_ds.hpp
+
+template <std::size_t N>
+void bench_heaps(Bench& bench) {
+  std::size_t ops = bench.options().ops;
+  auto keys = random_keys(N / 2 + ops, 3);
+
+  {
+    auto heap = std::make_unique<FixedBinaryHeap<std::uint64_t, std::uint64_t, N>>();
+    for (std::size_t i = 0; i < N / 2; ++i) heap->push(keys[i], i);
+    bench.run("FixedBinaryHeap", "push+pop", N, sizeof(*heap), ops, [&] {
+      std::uint64_t v = 0, sum = 0;
+      for (std::size_t i = 0; i < ops; ++i) {
+        heap->push(keys[N / 2 + i], i);
+        heap->pop(v);
+        sum += v;
+      }
+      keep(sum);
+    });
+  }
+  {
+    auto heap = std::make_unique<ConcurrentBinaryHeap<std::uint64_t, std::uint64_t, N>>();
+    for (std::size_t i = 0; i < N / 2; ++i) heap->push(keys[i], i);
+    bench.run("ConcurrentBinaryHeap", "push+pop", N, sizeof(*heap), ops, [&] {
+      std::uint64_t v = 0, sum = 0;
+      for (std::size_t i = 0; i < ops; ++i) {
+        heap->push(keys[N / 2 + i], i);
+        heap->pop(v);
+        sum += v;
+      }
+      keep(sum);
+    });
+  }
+}
+
+template <std::size_t N>
+void bench_segment_trees(Bench& bench) {
+  std::size_t ops = bench.options().ops;
+  auto values = random_keys(N, 4);
+  for (auto& v : values) v %= 1000;
+  auto ranges = random_ranges(N, ops, 5);
+  auto points = random_indices(N, ops, 6);
+
+  {
+    auto tree = std::make_unique<FixedSegmentTree<std::uint64_t, N>>();
+    for (std::size_t i = 0; i < N; ++i) tree->set(i, values[i]);
+    bench.run("FixedSegmentTree", "query", N, sizeof(*tree), ops, [&] {
+      std::uint64_t sum = 0;
+      for (auto [l, r] : ranges) sum += tree->query(l, r);
+      keep(sum);
+    });
+    bench.run("FixedSegmentTree", "set", N, sizeof(*tree), ops, [&] {
+      for (auto i : points) tree->set(i, i);
+    });
+  }
+  {
+    SegmentTree<std::uint64_t> tree(N);
+    tree.build(values);
+    bench.run("SegmentTree", "query", N, 2 * N * sizeof(std::uint64_t), ops, [&] {
+      std::uint64_t sum = 0;
+      for (auto [l, r] : ranges) sum += tree.query(l, r);
+      keep(sum);
+    });
+  }
+  {
+    WideSegmentTree<std::uint64_t> tree(N);
+    tree.build(values);
+    std::size_t bytes = N * sizeof(std::uint64_t) * 16 / 15;
+    bench.run("WideSegmentTree", "query", N, bytes, ops, [&] {
+      std::uint64_t sum = 0;
+      for (auto [l, r] : ranges) sum += tree.query(l, r);
+      keep(sum);
+    });
+    bench.run("WideSegmentTree", "set", N, bytes, ops, [&] {
+      for (auto i : points) tree.set(i, i);
+    });
+  }
+  {
+    auto tree = std::make_unique<FixedLazySegmentTree<std::int64_t, N>>();
+    bench.run("FixedLazySegmentTree", "add+sum", N, sizeof(*tree), ops, [&] {
+      std::int64_t sum = 0;
+      for (std::size_t i = 0; i < ops; ++i) {
+        auto [l, r] = ranges[i];
+        if (i & 1) {
+          sum += tree->range_sum(l, r);
+        } else {
+          tree->range_add(l, r, 1);
+        }
+      }
+      keep(sum);
+    });
+  }
+  {
+    LazySegmentTree<RangeAddSum<std::int64_t>> tree(N);
+    std::size_t bytes = 3 * N * sizeof(std::int64_t);
+    bench.run("LazySegmentTree", "add+sum", N, bytes, ops, [&] {
+      std::int64_t sum = 0;
+      for (std::size_t i = 0; i < ops; ++i) {
+        auto [l, r] = ranges[i];
+        if (i & 1) {
+          sum += tree.query(l, r);
+        } else {
+          tree.apply(l, r, 1);
+        }
+      }
+      keep(sum);
+    });
+  }
+}
+
+template <std::size_t N>
+void bench_fenwick(Bench& bench) {
+  std::size_t ops = bench.options().ops;
+  auto values = random_keys(N, 7);
+  for (auto& v : values) v %= 1000;
+  auto points = random_indices(N, ops, 8);
+
+  auto tree = std::make_unique<FixedFenwickTree<std::uint64_t, N>>();
+  tree->build(values);
+  std::uint64_t total = tree->prefix_sum(N - 1);
+  bench.run("FixedFenwickTree", "add+prefix", N, sizeof(*tree), ops, [&] {
+    std::uint64_t sum = 0;
+    for (auto i : points) {
+      tree->add(i, 1);
+      sum += tree->prefix_sum(i);
+    }
+    keep(sum);
+  });
+  bench.run("FixedFenwickTree", "lower_bound", N, sizeof(*tree), ops, [&] {
+    std::size_t sum = 0;
+    for (auto i : points) sum += tree->lower_bound(total / N * i);
+    keep(sum);
+  });
+}
+
+// 固定大小的結構要編譯期的 N：對每個 log2 各展開一次
+template <unsigned... Log2>
+void bench_some_ds(Bench& bench, std::integer_sequence<unsigned, Log2...>) {
+  auto one = [&]<unsigned L>() {
+    if (L < bench.options().min_log2 || L > bench.options().max_log2) return;
+    constexpr std::size_t n = std::size_t{1} << L;
+    bench_heaps<n>(bench);
+    bench_segment_trees<n>(bench);
+    bench_fenwick<n>(bench);
+  };
+  (one.template operator()<Log2>(), ...);
+}
+
+#endif  // DS_BENCH_SOME_DS
+
+std::string cpu_model() {
+  std::ifstream in("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      auto colon = line.find(':');
+      if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+    }
+  }
+  return "unknown";
+}
+
+std::string json_escape(const std::string& s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') out.push_back('\\');
+    if (static_cast<unsigned char>(c) >= 0x20) out.push_back(c);
+  }
+  return out;
+}
+
+void print_json(const Bench& bench) {
+  static constexpr std::array<const char*, PerfCounters::kCount> names{
+      "cycles_per_op", "instructions_per_op", "cache_misses_per_op", "branch_misses_per_op"};
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+
+  std::printf("{\n");
+  std::printf("  \"schema\": 1,\n");
+  std::printf("  \"unix_time\": %lld,\n", static_cast<long long>(seconds));
+  std::printf("  \"cpu\": \"%s\",\n", json_escape(cpu_model()).c_str());
+  std::printf("  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+  std::printf("  \"counters_available\": %s,\n", bench.counters_available() ? "true" : "false");
+  std::printf("  \"results\": [\n");
+  const auto& results = bench.results();
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    std::printf("    {\"structure\": \"%s\", \"op\": \"%s\", \"n\": %zu, \"bytes\": %zu, \"ops\": %zu, "
+                "\"ns_per_op\": %.3f",
+                r.structure.c_str(), r.op.c_str(), r.n, r.bytes, r.ops, r.ns_per_op);
+    for (std::size_t c = 0; c < PerfCounters::kCount; ++c) {
+      if (r.counters) {
+        std::printf(", \"%s\": %.3f", names[c],
+                    static_cast<double>((*r.counters)[c]) / static_cast<double>(r.ops));
+      } else {
+        std::printf(", \"%s\": null", names[c]);
+      }
+    }
+    std::printf("}%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string flag = argv[i];
+    unsigned long value = std::strtoul(argv[i + 1], nullptr, 10);
+    if (flag == "--min-log2") {
+      options.min_log2 = static_cast<unsigned>(value);
+    } else if (flag == "--max-log2") {
+      options.max_log2 = static_cast<unsigned>(value);
+    } else if (flag == "--ops") {
+      options.ops = std::max<std::size_t>(1, value);
+    } else {
+      std::fprintf(stderr, "usage: ds_bench [--min-log2 N] [--max-log2 N] [--ops N]\n");
+      return 1;
+    }
+  }
+  options.max_log2 = std::min(options.max_log2, 22u);  // 固定大小的結構只展開到 2^22
+
+  Bench bench(options);
+  if (!bench.counters_available()) {
+    std::fprintf(stderr, "perf_event unavailable; reporting time only\n");
+  }
+  for (unsigned l = options.min_log2; l <= options.max_log2; l += 4) {
+    std::size_t n = std::size_t{1} << l;
+    bench_bst(bench, n);
+    bench_btree(bench, n);
+  }
+#if DS_BENCH_SOME_DS
+  bench_some_ds(bench, std::integer_sequence<unsigned, 10, 14, 18, 22>{});
+#endif
+  print_json(bench);
+  return 0;
+}
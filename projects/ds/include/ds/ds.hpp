@@ -6,5 +6,6 @@
 
 #include <ds/graph/graph.hpp>
 #include <ds/list/list.hpp>
+#include <ds/tree/btree.hpp>
 #include <ds/tree/tree.hpp>
 #include <ds/trie/trie.hpp>
@@ -1,24 +1,259 @@
 #pragma once
 
-// 無向圖 (adjacency list)。骨架而已，實作留給你。
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ds {
+
+// 無向圖。分兩段：
 //
-// 建議的 API（自己增刪）：
-//   void               add_edge(const T& a, const T& b);
-//   bool               has_edge(const T& a, const T& b) const;
-//   std::vector<T>     neighbors(const T& v) const;
-//   std::size_t        num_vertices() const;
+// - GraphBuilder<T> 可以一直 add_edge，頂點第一次出現時配一個連續的
+//   VertexId (0, 1, 2…)，邊先存成一串 (a, b)。
+// - freeze() 之後變成唯讀的 Graph<T>，用 CSR (compressed sparse row) 存：
+//   offsets_[v] .. offsets_[v + 1] 是 v 的鄰居在 targets_ 裡的範圍，排序
+//   過、去掉重複。整張圖就是兩個 array，走訪時連續讀，不用每個頂點一次
+//   hash lookup + 一個 heap vector。
 //
-// 建議的儲存結構：std::unordered_map<T, std::vector<T>> adj_;
+// neighbors() 回傳 std::span<const VertexId>，指向圖內部，不複製。T ↔ id 的
+// 對應只在 API 邊界查一次 (id() / vertex())。
+using VertexId = std::uint32_t;
 
-namespace ds {
+template <typename T>
+class Graph;
+
+template <typename T>
+class GraphBuilder {
+public:
+  // 回傳 v 的 id，第一次看到就新配一個
+  VertexId add_vertex(const T& v) {
+    auto [it, inserted] = ids_.try_emplace(v, static_cast<VertexId>(vertices_.size()));
+    if (inserted) vertices_.push_back(v);
+    return it->second;
+  }
+
+  void add_edge(const T& a, const T& b) {
+    VertexId x = add_vertex(a);
+    VertexId y = add_vertex(b);
+    edges_.emplace_back(x, y);
+  }
+
+  std::size_t num_vertices() const { return vertices_.size(); }
+
+  // 蓋出 CSR；builder 之後就空了
+  Graph<T> freeze() &&;
+
+private:
+  std::vector<T> vertices_;
+  std::unordered_map<T, VertexId> ids_;
+  std::vector<std::pair<VertexId, VertexId>> edges_;
+};
+
+// BFS 參數。alpha / beta 是 direction-optimizing BFS (Beamer et al.) 的兩個
+// 門檻：frontier 的邊數超過「還沒走過的邊 / alpha」就從 top-down 換成
+// bottom-up，frontier 頂點數掉到「n / beta」以下再換回來。
+struct BfsOptions {
+  unsigned threads = 1;
+  double alpha = 14.0;
+  double beta = 24.0;
+};
 
 template <typename T>
 class Graph {
 public:
-  // TODO: 你的 public API
+  static constexpr std::uint32_t kUnreachable = std::numeric_limits<std::uint32_t>::max();
+
+  std::size_t num_vertices() const { return vertices_.size(); }
+  std::size_t num_edges() const { return targets_.size() / 2; }  // 每條無向邊存兩次
+
+  std::optional<VertexId> id(const T& v) const {
+    auto it = ids_.find(v);
+    if (it == ids_.end()) return std::nullopt;
+    return it->second;
+  }
+  const T& vertex(VertexId v) const { return vertices_[v]; }
+
+  std::span<const VertexId> neighbors(VertexId v) const {
+    return {targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1]};
+  }
+  std::span<const VertexId> neighbors(const T& v) const {
+    auto x = id(v);
+    return x ? neighbors(*x) : std::span<const VertexId>{};
+  }
+
+  std::size_t degree(VertexId v) const { return offsets_[v + 1] - offsets_[v]; }
+
+  bool has_edge(const T& a, const T& b) const {
+    auto x = id(a), y = id(b);
+    if (!x || !y) return false;
+    auto adj = neighbors(*x);
+    return std::binary_search(adj.begin(), adj.end(), *y);
+  }
+
+  // 從 source 出發的 BFS 距離 (邊數)，到不了的是 kUnreachable。
+  //
+  // 每一層二選一：
+  // - top-down：掃 frontier 的每個鄰居，CAS 搶下還沒訪問的頂點。frontier
+  //   小的時候便宜。
+  // - bottom-up：每個還沒訪問的頂點掃自己的鄰居，遇到一個在 frontier
+  //   (bitmap) 裡的就停。frontier 很大時大部分頂點第一個鄰居就命中，
+  //   邊看得比 top-down 少很多，也不用 CAS。
+  // 兩種都把工作平均切給 options.threads 條 thread；每層結束在 std::barrier
+  // 上集合，由 completion 合併各 thread 的下一層、決定下一層的方向。
+  std::vector<std::uint32_t> bfs(VertexId source, BfsOptions options = {}) const;
 
 private:
-  // TODO: 你的儲存結構
+  friend class GraphBuilder<T>;
+
+  std::vector<T> vertices_;
+  std::unordered_map<T, VertexId> ids_;
+  std::vector<std::uint64_t> offsets_{0};
+  std::vector<VertexId> targets_;
 };
 
+template <typename T>
+Graph<T> GraphBuilder<T>::freeze() && {
+  Graph<T> g;
+  std::size_t n = vertices_.size();
+
+  // counting sort by 起點：先數 degree，再一次放好兩個方向
+  g.offsets_.assign(n + 1, 0);
+  for (auto [a, b] : edges_) {
+    ++g.offsets_[a + 1];
+    ++g.offsets_[b + 1];
+  }
+  for (std::size_t v = 0; v < n; ++v) g.offsets_[v + 1] += g.offsets_[v];
+  g.targets_.resize(g.offsets_[n]);
+  std::vector<std::uint64_t> fill(g.offsets_.begin(), g.offsets_.end() - 1);
+  for (auto [a, b] : edges_) {
+    g.targets_[fill[a]++] = b;
+    g.targets_[fill[b]++] = a;
+  }
+
+  // 每段排序、去重，再往前壓實
+  std::uint64_t out = 0;
+  for (std::size_t v = 0; v < n; ++v) {
+    auto first = g.targets_.begin() + static_cast<std::ptrdiff_t>(g.offsets_[v]);
+    auto last = g.targets_.begin() + static_cast<std::ptrdiff_t>(g.offsets_[v + 1]);
+    std::sort(first, last);
+    last = std::unique(first, last);
+    g.offsets_[v] = out;
+    out = static_cast<std::uint64_t>(
+        std::copy(first, last, g.targets_.begin() + static_cast<std::ptrdiff_t>(out)) -
+        g.targets_.begin());
+  }
+  g.offsets_[n] = out;
+  g.targets_.resize(out);
+  g.targets_.shrink_to_fit();
+
+  g.vertices_ = std::move(vertices_);
+  g.ids_ = std::move(ids_);
+  edges_.clear();
+  return g;
+}
+
+template <typename T>
+std::vector<std::uint32_t> Graph<T>::bfs(VertexId source, BfsOptions options) const {
+  std::size_t n = num_vertices();
+  std::vector<std::uint32_t> dist(n, kUnreachable);
+  if (source >= n) return dist;
+
+  unsigned threads = std::max(1u, options.threads);
+  dist[source] = 0;
+
+  std::vector<VertexId> frontier{source};
+  std::vector<std::uint64_t> in_frontier((n + 63) / 64, 0);  // bottom-up 用的 bitmap
+  std::vector<std::vector<VertexId>> next(threads);
+  std::vector<std::uint64_t> next_edges(threads, 0);
+  std::uint64_t unexplored_edges = targets_.size() - degree(source);
+  std::uint32_t level = 0;
+  bool bottom_up = false;
+  bool done = false;
+
+  auto merge = [&]() noexcept {
+    frontier.clear();
+    std::uint64_t frontier_edges = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+      frontier.insert(frontier.end(), next[t].begin(), next[t].end());
+      next[t].clear();
+      frontier_edges += next_edges[t];
+      next_edges[t] = 0;
+    }
+    unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+    ++level;
+    done = frontier.empty();
+    if (done) return;
+
+    if (!bottom_up &&
+        static_cast<double>(frontier_edges) > static_cast<double>(unexplored_edges) / options.alpha) {
+      bottom_up = true;
+    } else if (bottom_up &&
+               static_cast<double>(frontier.size()) < static_cast<double>(n) / options.beta) {
+      bottom_up = false;
+    }
+    if (bottom_up) {
+      std::fill(in_frontier.begin(), in_frontier.end(), 0);
+      for (VertexId v : frontier) in_frontier[v / 64] |= std::uint64_t{1} << (v % 64);
+    }
+  };
+  std::barrier sync(static_cast<std::ptrdiff_t>(threads), merge);
+
+  auto worker = [&](unsigned t) {
+    while (true) {
+      std::uint32_t depth = level + 1;
+      std::vector<VertexId>& mine = next[t];
+      std::uint64_t edges = 0;
+      if (!bottom_up) {
+        std::size_t begin = frontier.size() * t / threads;
+        std::size_t end = frontier.size() * (t + 1) / threads;
+        for (std::size_t i = begin; i < end; ++i) {
+          for (VertexId u : neighbors(frontier[i])) {
+            std::atomic_ref<std::uint32_t> d(dist[u]);
+            std::uint32_t expected = kUnreachable;
+            if (d.load(std::memory_order_relaxed) == kUnreachable &&
+                d.compare_exchange_strong(expected, depth, std::memory_order_relaxed)) {
+              mine.push_back(u);
+              edges += degree(u);
+            }
+          }
+        }
+      } else {
+        // 頂點範圍按 64 對齊切，每條 thread 只寫自己那段的 dist
+        std::size_t words = in_frontier.size();
+        std::size_t begin = std::min(n, words * t / threads * 64);
+        std::size_t end = std::min(n, words * (t + 1) / threads * 64);
+        for (std::size_t u = begin; u < end; ++u) {
+          std::atomic_ref<std::uint32_t> d(dist[u]);
+          if (d.load(std::memory_order_relaxed) != kUnreachable) continue;
+          for (VertexId v : neighbors(static_cast<VertexId>(u))) {
+            if (in_frontier[v / 64] >> (v % 64) & 1) {
+              d.store(depth, std::memory_order_relaxed);
+              mine.push_back(static_cast<VertexId>(u));
+              edges += degree(static_cast<VertexId>(u));
+              break;
+            }
+          }
+        }
+      }
+      next_edges[t] = edges;
+      sync.arrive_and_wait();
+      if (done) return;
+    }
+  };
+
+  std::vector<std::jthread> pool;
+  for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+  worker(0);
+  return dist;
+}
+
 }  // namespace ds
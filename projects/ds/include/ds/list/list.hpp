@@ -1,26 +1,256 @@
 #pragma once
 
-// 單向鏈結串列 (singly linked list)。骨架而已，實作留給你。
-//
-// 建議的 API（自己增刪）：
-//   void               push_front(const T& value);
-//   void               push_back(const T& value);
-//   bool               empty() const;
-//   std::size_t        size() const;
-//   std::vector<T>     to_vector() const;   // 方便寫測試比對
-//
-// 建議的節點：struct Node { T value; std::unique_ptr<Node> next; };
-//   head_ 持有第一個節點，注意 unique_ptr 的所有權轉移。
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
 
 namespace ds {
 
-template <typename T>
+// 單向的 unrolled linked list：每個節點是一整塊 (BlockBytes，cache line 的
+// 倍數) 裡面連續放好幾個元素，節點之間才用指標串。走訪時一次讀一整塊，
+// 一個元素平均分到的指標和配置成本只有 1 / capacity。
+//
+// - push_back 往尾巴那塊的後面放，push_front 往頭那塊的前面放 (每塊記
+//   [begin, end) 兩個位置)，滿了才接一塊新的。
+// - pop_front 讓它當 FIFO 用 (例如每個價位的委託排隊)；頭那塊空了就收進
+//   free list，下一次要新塊時先從這裡拿，穩定狀態下不再向 resource 要
+//   記憶體。shrink_to_fit() 把 free list 還回去。
+// - 節點從建構時給的 std::pmr::memory_resource 配 (預設 new/delete)，
+//   跟 BinarySearchTree 一樣可以放進 arena；解構是迴圈。
+// - 有 forward iterator，不用再 to_vector() 複製一份才能看內容。
+template <typename T, std::size_t BlockBytes = 128>
 class List {
+  static_assert(BlockBytes % 64 == 0, "BlockBytes 要是 cache line (64) 的倍數");
+
+  struct Header {
+    void* next;
+    std::uint32_t begin;
+    std::uint32_t end;
+  };
+
+public:
+  // 每塊放幾個元素 (至少 1)
+  static constexpr std::size_t kCapacity =
+      sizeof(T) + sizeof(Header) <= BlockBytes ? (BlockBytes - sizeof(Header)) / sizeof(T) : 1;
+
+private:
+  struct alignas(64) Node {
+    Node* next = nullptr;
+    std::uint32_t begin = 0;  // 有效元素在 [begin, end)
+    std::uint32_t end = 0;
+    alignas(T) std::byte storage[kCapacity * sizeof(T)];
+
+    T* slot(std::size_t i) { return std::launder(reinterpret_cast<T*>(storage) + i); }
+    const T* slot(std::size_t i) const {
+      return std::launder(reinterpret_cast<const T*>(storage) + i);
+    }
+  };
+
+  template <bool Const>
+  class Iter {
+    using NodePtr = std::conditional_t<Const, const Node*, Node*>;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    Iter() = default;
+    Iter(NodePtr node, std::uint32_t i) : node_(node), i_(i) {}
+    // iterator → const_iterator
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    Iter(const Iter<false>& other) : node_(other.node_), i_(other.i_) {}
+
+    reference operator*() const { return *node_->slot(i_); }
+    pointer operator->() const { return node_->slot(i_); }
+
+    Iter& operator++() {
+      if (++i_ == node_->end) {
+        node_ = node_->next;
+        i_ = node_ ? node_->begin : 0;
+      }
+      return *this;
+    }
+    Iter operator++(int) {
+      Iter old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const Iter& other) const { return node_ == other.node_ && i_ == other.i_; }
+
+  private:
+    friend class List;
+    template <bool>
+    friend class Iter;
+    NodePtr node_ = nullptr;
+    std::uint32_t i_ = 0;
+  };
+
 public:
-  // TODO: 你的 public API
+  using value_type = T;
+  using iterator = Iter<false>;
+  using const_iterator = Iter<true>;
+
+  List() = default;
+  explicit List(std::pmr::memory_resource* resource) : alloc_(resource) {}
+
+  List(const List&) = delete;
+  List& operator=(const List&) = delete;
+
+  List(List&& other) noexcept
+      : alloc_(other.alloc_),
+        head_(std::exchange(other.head_, nullptr)),
+        tail_(std::exchange(other.tail_, nullptr)),
+        free_(std::exchange(other.free_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  // 跟 BinarySearchTree 一樣：節點連同 other 的 resource 一起接過來
+  List& operator=(List&& other) noexcept {
+    if (this != &other) {
+      clear();
+      shrink_to_fit();
+      std::destroy_at(&alloc_);  // polymorphic_allocator 不能 assign，換一個新的
+      std::construct_at(&alloc_, other.alloc_.resource());
+      head_ = std::exchange(other.head_, nullptr);
+      tail_ = std::exchange(other.tail_, nullptr);
+      free_ = std::exchange(other.free_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~List() {
+    clear();
+    shrink_to_fit();
+  }
+
+  void push_front(const T& value) {
+    if (!head_ || head_->begin == 0) {
+      Node* n = acquire(kCapacity);  // 空塊，從最後面往前填
+      n->next = head_;
+      head_ = n;
+      if (!tail_) tail_ = n;
+    }
+    std::construct_at(head_->slot(head_->begin - 1), value);
+    --head_->begin;
+    ++size_;
+  }
+
+  void push_back(const T& value) {
+    if (!tail_ || tail_->end == kCapacity) {
+      Node* n = acquire(0);
+      if (tail_) {
+        tail_->next = n;
+      } else {
+        head_ = n;
+      }
+      tail_ = n;
+    }
+    std::construct_at(tail_->slot(tail_->end), value);
+    ++tail_->end;
+    ++size_;
+  }
+
+  T& front() {
+    assert(!empty());
+    return *head_->slot(head_->begin);
+  }
+  const T& front() const {
+    assert(!empty());
+    return *head_->slot(head_->begin);
+  }
+  T& back() {
+    assert(!empty());
+    return *tail_->slot(tail_->end - 1);
+  }
+  const T& back() const {
+    assert(!empty());
+    return *tail_->slot(tail_->end - 1);
+  }
+
+  void pop_front() {
+    assert(!empty());
+    std::destroy_at(head_->slot(head_->begin));
+    ++head_->begin;
+    --size_;
+    if (head_->begin == head_->end) {
+      Node* n = head_;
+      head_ = n->next;
+      if (!head_) tail_ = nullptr;
+      recycle(n);
+    }
+  }
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  iterator begin() { return head_ ? iterator(head_, head_->begin) : iterator(); }
+  iterator end() { return iterator(); }
+  const_iterator begin() const { return head_ ? const_iterator(head_, head_->begin) : const_iterator(); }
+  const_iterator end() const { return const_iterator(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // 方便寫測試比對
+  std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+  // 清空元素；節點收進 free list 留著重用
+  void clear() {
+    while (head_) {
+      Node* n = head_;
+      head_ = n->next;
+      std::destroy(n->slot(n->begin), n->slot(n->end));
+      recycle(n);
+    }
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+  // free list 上的節點還給 resource
+  void shrink_to_fit() {
+    while (free_) {
+      Node* n = free_;
+      free_ = n->next;
+      alloc_.deallocate(n, 1);
+    }
+  }
+
+  std::pmr::memory_resource* resource() const { return alloc_.resource(); }
 
 private:
-  // TODO: 你的 Node 結構與 head_ / size_
+  std::pmr::polymorphic_allocator<Node> alloc_;
+  Node* head_ = nullptr;
+  Node* tail_ = nullptr;
+  Node* free_ = nullptr;  // 空塊 (元素已解構) 的 stack，用 next 串
+  std::size_t size_ = 0;
+
+  // at = 空塊的起始位置：push_back 用 0，push_front 用 kCapacity
+  Node* acquire(std::size_t at) {
+    Node* n = free_;
+    if (n) {
+      free_ = n->next;
+    } else {
+      n = alloc_.allocate(1);
+      ::new (static_cast<void*>(n)) Node;
+    }
+    n->next = nullptr;
+    n->begin = n->end = static_cast<std::uint32_t>(at);
+    return n;
+  }
+
+  void recycle(Node* n) {
+    n->next = free_;
+    free_ = n;
+  }
 };
 
 }  // namespace ds
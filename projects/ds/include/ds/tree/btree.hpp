@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ds {
+
+// B-tree 版的有序集合，API 跟 BinarySearchTree 一樣 (insert / contains /
+// inorder / size / empty)，給千萬筆 key 等級的 ordered ID set 用。
+//
+// - 每個節點最多 MaxKeys 個 key (預設 63)，連續放在一個 array 裡；樹高是
+//   log_{MaxKeys/2}(n)，一千萬筆 key 也只有 4~5 層，任何輸入順序都一樣
+//   (BST 遇到排序好的輸入會退化成 O(n) 深)。
+// - 節點放在 std::vector 裡、用 index 互指：insert 不會每次 new 一個節點，
+//   解構就是釋放幾個 vector，不會遞迴。內部節點的 children 另外存，leaf
+//   不背那一大塊 children array。
+// - 節點內用 branchless binary search (比較結果直接變 offset，沒有分支
+//   預測失敗)。insert 走 CLRS 的「往下走時遇到滿的就先拆」，整條路只走一
+//   次、不遞迴；inorder 用顯式 stack。
+// - BTree(sorted) 從排好序的資料 O(n) 由下往上直接蓋出整棵樹。
+// - 兩個 vector 都從建構時給的 std::pmr::memory_resource 配置，可以跟
+//   BinarySearchTree 一樣放進同一個 arena。
+template <typename T, std::size_t MaxKeys = 63>
+class BTree {
+  static_assert(MaxKeys >= 3 && MaxKeys % 2 == 1, "MaxKeys 要是 >= 3 的奇數 (= 2t - 1)");
+
+public:
+  BTree() = default;
+  explicit BTree(std::pmr::memory_resource* resource) : nodes_(resource), children_(resource) {}
+
+  // 從遞增序列 bulk load；相鄰重複的值只留一個。sorted 沒排好序是 UB
+  // (debug build 會 assert)。
+  explicit BTree(std::span<const T> sorted,
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : BTree(resource) {
+    std::vector<T> keys;
+    keys.reserve(sorted.size());
+    for (const T& v : sorted) {
+      assert(keys.empty() || !(v < keys.back()));
+      if (keys.empty() || keys.back() < v) keys.push_back(v);
+    }
+    bulk_load(std::move(keys));
+  }
+
+  void insert(const T& value) {
+    if (nodes_.empty()) {
+      root_ = new_node(true);
+    } else if (nodes_[root_].count == MaxKeys) {
+      std::uint32_t old_root = root_;
+      root_ = new_node(false);
+      child(root_, 0) = old_root;
+      split_child(root_, 0);
+    }
+
+    std::uint32_t cur = root_;
+    while (true) {
+      std::size_t i = lower_bound(nodes_[cur], value);
+      if (i < nodes_[cur].count && !(value < nodes_[cur].keys[i])) return;  // 已存在
+      if (nodes_[cur].leaf) {
+        Node& n = nodes_[cur];
+        for (std::size_t j = n.count; j > i; --j) n.keys[j] = std::move(n.keys[j - 1]);
+        n.keys[i] = value;
+        ++n.count;
+        ++size_;
+        return;
+      }
+      if (nodes_[child(cur, i)].count == MaxKeys) {
+        split_child(cur, i);
+        const T& promoted = nodes_[cur].keys[i];
+        if (!(value < promoted) && !(promoted < value)) return;
+        if (promoted < value) ++i;
+      }
+      cur = child(cur, i);
+    }
+  }
+
+  bool contains(const T& value) const {
+    if (nodes_.empty()) return false;
+    std::uint32_t cur = root_;
+    while (true) {
+      const Node& n = nodes_[cur];
+      std::size_t i = lower_bound(n, value);
+      if (i < n.count && !(value < n.keys[i])) return true;
+      if (n.leaf) return false;
+      cur = child(cur, i);
+    }
+  }
+
+  // 中序走訪 → 由小到大的排序序列。
+  std::vector<T> inorder() const {
+    std::vector<T> out;
+    out.reserve(size_);
+    if (nodes_.empty()) return out;
+
+    // (節點, 下一個要輸出的 key 位置)；先一路走到最左的 leaf
+    std::vector<std::pair<std::uint32_t, std::size_t>> stack;
+    auto descend = [&](std::uint32_t node) {
+      while (true) {
+        stack.emplace_back(node, 0);
+        if (nodes_[node].leaf) return;
+        node = child(node, 0);
+      }
+    };
+    descend(root_);
+    while (!stack.empty()) {
+      auto& [node, next] = stack.back();
+      const Node& n = nodes_[node];
+      if (n.leaf) {
+        for (std::size_t i = 0; i < n.count; ++i) out.push_back(n.keys[i]);
+        stack.pop_back();
+      } else if (next < n.count) {
+        out.push_back(n.keys[next]);
+        std::uint32_t right = child(node, ++next);
+        descend(right);
+      } else {
+        stack.pop_back();
+      }
+    }
+    return out;
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // 根到 leaf 的層數 (空樹為 0)
+  std::size_t height() const {
+    if (nodes_.empty()) return 0;
+    std::size_t h = 1;
+    for (std::uint32_t cur = root_; !nodes_[cur].leaf; cur = child(cur, 0)) ++h;
+    return h;
+  }
+
+private:
+  static constexpr std::size_t kMinKeys = MaxKeys / 2;  // t - 1
+  static constexpr std::uint32_t kNone = UINT32_MAX;
+
+  struct Node {
+    std::array<T, MaxKeys> keys{};
+    std::uint16_t count = 0;
+    bool leaf = true;
+    std::uint32_t kids = kNone;  // 內部節點在 children_ 裡的位置
+  };
+
+  std::pmr::vector<Node> nodes_;
+  std::pmr::vector<std::array<std::uint32_t, MaxKeys + 1>> children_;
+  std::uint32_t root_ = 0;
+  std::size_t size_ = 0;
+
+  std::uint32_t new_node(bool leaf) {
+    Node n;
+    n.leaf = leaf;
+    if (!leaf) {
+      n.kids = static_cast<std::uint32_t>(children_.size());
+      children_.emplace_back();
+    }
+    nodes_.push_back(std::move(n));
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+  }
+
+  std::uint32_t& child(std::uint32_t node, std::size_t i) { return children_[nodes_[node].kids][i]; }
+  std::uint32_t child(std::uint32_t node, std::size_t i) const {
+    return children_[nodes_[node].kids][i];
+  }
+
+  // 第一個 >= value 的位置 (count 表示全部都比 value 小)
+  static std::size_t lower_bound(const Node& n, const T& value) {
+    if (n.count == 0) return 0;
+    const T* base = n.keys.data();
+    std::size_t len = n.count;
+    while (len > 1) {
+      std::size_t half = len / 2;
+      base += (base[half - 1] < value) ? half : 0;
+      len -= half;
+    }
+    return static_cast<std::size_t>(base - n.keys.data()) + (*base < value ? 1 : 0);
+  }
+
+  // parent 的第 i 個 child 是滿的：拆成兩半，中間的 key 升到 parent 的 i
+  void split_child(std::uint32_t parent, std::size_t i) {
+    std::uint32_t full = child(parent, i);
+    std::uint32_t right = new_node(nodes_[full].leaf);  // 可能讓 nodes_ 重新配置，之後才拿參考
+    Node& l = nodes_[full];
+    Node& r = nodes_[right];
+
+    for (std::size_t j = 0; j < kMinKeys; ++j) r.keys[j] = std::move(l.keys[kMinKeys + 1 + j]);
+    if (!l.leaf) {
+      for (std::size_t j = 0; j <= kMinKeys; ++j) child(right, j) = child(full, kMinKeys + 1 + j);
+    }
+    r.count = kMinKeys;
+    l.count = kMinKeys;
+
+    Node& p = nodes_[parent];
+    for (std::size_t j = p.count; j > i; --j) {
+      p.keys[j] = std::move(p.keys[j - 1]);
+      child(parent, j + 1) = child(parent, j);
+    }
+    p.keys[i] = std::move(l.keys[kMinKeys]);
+    child(parent, i + 1) = right;
+    ++p.count;
+  }
+
+  // 把 n 個 item 平均分成 m 個節點，每兩個節點之間留一個 item 升到上一層。
+  // m = ceil((n + 1) / (MaxKeys + 1)) 讓每個節點 <= MaxKeys，且 m >= 2 時
+  // 每個節點 >= MaxKeys / 2，符合 B-tree 的下限。
+  void bulk_load(std::vector<T> keys) {
+    size_ = keys.size();
+    if (keys.empty()) return;
+
+    std::vector<std::uint32_t> below;  // 下一層的節點 (leaf 層時為空)
+    while (true) {
+      std::size_t n = keys.size();
+      std::size_t m = (n + 1 + MaxKeys) / (MaxKeys + 1);
+      std::size_t per_node = (n - (m - 1)) / m;
+      std::size_t extra = (n - (m - 1)) % m;  // 前 extra 個節點多拿一個
+
+      std::vector<std::uint32_t> level;
+      std::vector<T> promoted;
+      level.reserve(m);
+      promoted.reserve(m - 1);
+      bool leaf = below.empty();
+      std::size_t at = 0, kid = 0;
+      for (std::size_t j = 0; j < m; ++j) {
+        std::uint32_t node = new_node(leaf);
+        std::size_t take = per_node + (j < extra ? 1 : 0);
+        Node& nd = nodes_[node];
+        for (std::size_t k = 0; k < take; ++k) nd.keys[k] = std::move(keys[at++]);
+        nd.count = static_cast<std::uint16_t>(take);
+        if (!leaf) {
+          for (std::size_t k = 0; k <= take; ++k) child(node, k) = below[kid++];
+        }
+        level.push_back(node);
+        if (j + 1 < m) promoted.push_back(std::move(keys[at++]));
+      }
+
+      if (m == 1) {
+        root_ = level.front();
+        return;
+      }
+      keys = std::move(promoted);
+      below = std::move(level);
+    }
+  }
+};
+
+}  // namespace ds
@@ -1,24 +1,79 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ds {
 
 // 一個最小的二元搜尋樹 (BST)，header-only，當作 ds/ playground 的範例結構。
 // 重點不在效能，而在「實作 + tests/ 下的 tree_test.cpp + ctest 一鍵跑」的流程。
+//
+// 節點從建構時給的 std::pmr::memory_resource 配置 (預設是 new/delete)。
+// 給它一個 std::pmr::monotonic_buffer_resource，節點就一個接一個 bump 配置在
+// 連續的大塊記憶體裡。建構時再說 arena = true，表示記憶體由 resource 整塊
+// 一次還：clear / 解構不逐個 deallocate，T 是 trivially destructible 時
+// 連走訪都省了。insert / inorder / 解構全是迴圈，排序好的輸入把樹拉成一條
+// 百萬深的鏈也不會炸 stack。
 template <typename T>
 class BinarySearchTree {
 public:
-  void insert(const T& value) { root_ = insert(std::move(root_), value); }
+  BinarySearchTree() = default;
+  // arena: resource 自己一次還全部記憶體 (例如 monotonic_buffer_resource)
+  explicit BinarySearchTree(std::pmr::memory_resource* resource, bool arena = false)
+      : alloc_(resource), arena_(arena) {}
+
+  BinarySearchTree(const BinarySearchTree&) = delete;
+  BinarySearchTree& operator=(const BinarySearchTree&) = delete;
+
+  BinarySearchTree(BinarySearchTree&& other) noexcept
+      : alloc_(other.alloc_),
+        arena_(other.arena_),
+        root_(std::exchange(other.root_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  // 節點是 other 的 resource 配的，所以連 resource 一起接過來 (pmr allocator
+  // 不 propagate，這裡刻意換掉；不然就得逐個複製到自己的 resource)。
+  BinarySearchTree& operator=(BinarySearchTree&& other) noexcept {
+    if (this != &other) {
+      clear();
+      std::destroy_at(&alloc_);  // polymorphic_allocator 不能 assign，換一個新的
+      std::construct_at(&alloc_, other.alloc_.resource());
+      arena_ = other.arena_;
+      root_ = std::exchange(other.root_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~BinarySearchTree() { clear(); }
+
+  void insert(const T& value) {
+    Node** link = &root_;
+    while (*link) {
+      if (value < (*link)->value) {
+        link = &(*link)->left;
+      } else if ((*link)->value < value) {
+        link = &(*link)->right;
+      } else {
+        return;  // 相等 → 視為已存在，不重複插入。
+      }
+    }
+    Node* node = alloc_.allocate(1);
+    std::construct_at(node, value);
+    *link = node;
+    ++size_;
+  }
 
   bool contains(const T& value) const {
-    const Node* cur = root_.get();
+    const Node* cur = root_;
     while (cur) {
       if (value < cur->value) {
-        cur = cur->left.get();
+        cur = cur->left;
       } else if (cur->value < value) {
-        cur = cur->right.get();
+        cur = cur->right;
       } else {
         return true;
       }
@@ -29,43 +84,61 @@ public:
   // 中序走訪 → 由小到大的排序序列。
   std::vector<T> inorder() const {
     std::vector<T> out;
-    inorder(root_.get(), out);
+    out.reserve(size_);
+    std::vector<const Node*> stack;
+    const Node* cur = root_;
+    while (cur || !stack.empty()) {
+      for (; cur; cur = cur->left) stack.push_back(cur);
+      cur = stack.back();
+      stack.pop_back();
+      out.push_back(cur->value);
+      cur = cur->right;
+    }
     return out;
   }
 
   std::size_t size() const { return size_; }
   bool empty() const { return size_ == 0; }
 
-private:
-  struct Node {
-    explicit Node(T v) : value(std::move(v)) {}
-    T value;
-    std::unique_ptr<Node> left;
-    std::unique_ptr<Node> right;
-  };
-
-  std::unique_ptr<Node> insert(std::unique_ptr<Node> node, const T& value) {
-    if (!node) {
-      ++size_;
-      return std::make_unique<Node>(value);
+  // 釋放所有節點。arena 的記憶體由 resource 一起還，T 又不用解構的話直接
+  // 把樹丟掉；否則只解構不 deallocate。
+  void clear() {
+    if (std::is_trivially_destructible_v<T> && arena_) {
+      root_ = nullptr;
+      size_ = 0;
+      return;
     }
-    if (value < node->value) {
-      node->left = insert(std::move(node->left), value);
-    } else if (node->value < value) {
-      node->right = insert(std::move(node->right), value);
+    // 右旋把左子樹轉到右邊，變成一條只往右的鏈再逐個釋放，不用額外 stack
+    Node* cur = root_;
+    while (cur) {
+      if (Node* left = cur->left) {
+        cur->left = left->right;
+        left->right = cur;
+        cur = left;
+      } else {
+        Node* next = cur->right;
+        std::destroy_at(cur);
+        if (!arena_) alloc_.deallocate(cur, 1);
+        cur = next;
+      }
     }
-    // 相等 → 視為已存在，不重複插入。
-    return node;
+    root_ = nullptr;
+    size_ = 0;
   }
 
-  void inorder(const Node* node, std::vector<T>& out) const {
-    if (!node) return;
-    inorder(node->left.get(), out);
-    out.push_back(node->value);
-    inorder(node->right.get(), out);
-  }
+  std::pmr::memory_resource* resource() const { return alloc_.resource(); }
+
+private:
+  struct Node {
+    explicit Node(const T& v) : value(v) {}
+    T value;
+    Node* left = nullptr;
+    Node* right = nullptr;
+  };
 
-  std::unique_ptr<Node> root_;
+  std::pmr::polymorphic_allocator<Node> alloc_;
+  bool arena_ = false;
+  Node* root_ = nullptr;
   std::size_t size_ = 0;
 };
 
@@ -1,23 +1,491 @@
 #pragma once
 
-// 前綴樹 (Trie)，存字串。骨架而已，實作留給你。
-//
-// 建議的 API（自己增刪）：
-//   void  insert(const std::string& word);
-//   bool  contains(const std::string& word) const;     // 完整單字
-//   bool  starts_with(const std::string& prefix) const; // 任意前綴
-//
-// 建議的節點：每個 Node 有 children (例如 std::array<unique_ptr<Node>, 26>
-//   或 std::unordered_map<char, unique_ptr<Node>>) 與 is_end 旗標。
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace ds {
 
+// 前綴樹，存任意 byte 字串 (ticker、ISIN…)，做 insert / contains /
+// starts_with。實作是 adaptive radix tree (ART)：
+//
+// - 節點依 child 數換型：Leaf(0) → Node4 → Node16 → Node48 → Node256。
+//   Node4/16 是 key byte + child 指標兩個小 array；Node16 用 SSE2 一次比
+//   16 個 byte。Node48 是 256 格的 byte → slot 索引；Node256 直接查表。
+//   小節點不背 256 個指標，一個 child 的節點只有幾十 byte。
+// - path compression：只有一條路的一串 byte 存成節點的 prefix，不用一個
+//   byte 一個節點。prefix 完整存下來 (pessimistic)，不用回頭比對 key。
+// - 某個 key 是另一個 key 的前綴 (例如 "AB" 跟 "ABC") 時，用節點上的
+//   is_end 標記，不需要終止字元。
+// - 節點跟 BinarySearchTree 一樣從建構時給的 std::pmr::memory_resource
+//   配置；解構用顯式 stack，不遞迴。
+//
+// freeze() 把整棵樹序列化成一塊連續、只用 offset 互指的 byte，可以直接
+// 寫檔，開機時 mmap 進來交給 FrozenTrie 查 (見下面)。
 class Trie {
 public:
-  // TODO: 你的 public API
+  Trie() : Trie(std::pmr::get_default_resource()) {}
+  explicit Trie(std::pmr::memory_resource* resource) : alloc_(resource) {
+    root_ = alloc_.new_object<Node>(Kind::Leaf, resource);
+  }
+
+  Trie(const Trie&) = delete;
+  Trie& operator=(const Trie&) = delete;
+
+  ~Trie() {
+    std::vector<Node*> stack{root_};
+    while (!stack.empty()) {
+      Node* n = stack.back();
+      stack.pop_back();
+      for_each_child(n, [&](std::uint8_t, Node* c) { stack.push_back(c); });
+      destroy(n);
+    }
+  }
+
+  // 新 key 回 true，已經有了回 false
+  bool insert(std::string_view word) {
+    Node** ref = &root_;
+    std::size_t depth = 0;
+    while (true) {
+      Node* n = *ref;
+      std::string_view rest = word.substr(depth);
+      std::size_t common = common_prefix(n->prefix, rest);
+
+      if (common < n->prefix.size()) {
+        // key 在 prefix 中間分岔：切成「共同部分」的新節點，原本的節點掛在
+        // 它下面，prefix 去掉共同部分和分岔的那個 byte
+        Node* split = new_node(Kind::N4);
+        split->prefix.assign(n->prefix, 0, common);
+        auto edge = static_cast<std::uint8_t>(n->prefix[common]);
+        n->prefix.erase(0, common + 1);
+        *ref = split;
+        add_child(ref, edge, n);
+        if (common == rest.size()) {
+          (*ref)->is_end = true;
+        } else {
+          add_child(ref, static_cast<std::uint8_t>(rest[common]), new_leaf(rest.substr(common + 1)));
+        }
+        ++size_;
+        return true;
+      }
+
+      depth += common;
+      if (depth == word.size()) {
+        if (n->is_end) return false;
+        n->is_end = true;
+        ++size_;
+        return true;
+      }
+
+      auto byte = static_cast<std::uint8_t>(word[depth]);
+      Node** next = find_child(n, byte);
+      if (!next) {
+        add_child(ref, byte, new_leaf(word.substr(depth + 1)));
+        ++size_;
+        return true;
+      }
+      ref = next;
+      ++depth;
+    }
+  }
+
+  // 完整單字
+  bool contains(std::string_view word) const {
+    const Node* n = descend(word, false);
+    return n && n->is_end;
+  }
+
+  // 任意前綴 (空字串：有任何 key 就算)
+  bool starts_with(std::string_view prefix) const {
+    return size_ != 0 && descend(prefix, true) != nullptr;
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  std::pmr::memory_resource* resource() const { return alloc_.resource(); }
+
+  // 序列化成 FrozenTrie 讀得懂的格式 (native byte order)
+  std::vector<std::byte> freeze() const;
+
+private:
+  enum class Kind : std::uint8_t { Leaf, N4, N16, N48, N256 };
+
+  struct Node {
+    Node(Kind k, std::pmr::memory_resource* resource) : kind(k), prefix(resource) {}
+    Kind kind;
+    bool is_end = false;
+    std::uint16_t count = 0;
+    std::pmr::string prefix;
+  };
+  struct Node4 : Node {
+    using Node::Node;
+    std::array<std::uint8_t, 4> keys{};
+    std::array<Node*, 4> child{};
+  };
+  struct Node16 : Node {
+    using Node::Node;
+    alignas(16) std::array<std::uint8_t, 16> keys{};
+    std::array<Node*, 16> child{};
+  };
+  struct Node48 : Node {
+    using Node::Node;
+    std::array<std::uint8_t, 256> slot{};  // 0 = 沒有，否則 child 位置 + 1
+    std::array<Node*, 48> child{};
+  };
+  struct Node256 : Node {
+    using Node::Node;
+    std::array<Node*, 256> child{};
+  };
+
+  std::pmr::polymorphic_allocator<> alloc_;
+  Node* root_ = nullptr;
+  std::size_t size_ = 0;
+
+  static std::size_t common_prefix(std::string_view a, std::string_view b) {
+    std::size_t n = std::min(a.size(), b.size());
+    std::size_t i = 0;
+    while (i < n && a[i] == b[i]) ++i;
+    return i;
+  }
+
+  Node* new_node(Kind kind) {
+    switch (kind) {
+      case Kind::Leaf: return alloc_.new_object<Node>(kind, resource());
+      case Kind::N4: return alloc_.new_object<Node4>(kind, resource());
+      case Kind::N16: return alloc_.new_object<Node16>(kind, resource());
+      case Kind::N48: return alloc_.new_object<Node48>(kind, resource());
+      case Kind::N256: return alloc_.new_object<Node256>(kind, resource());
+    }
+    return nullptr;
+  }
+
+  Node* new_leaf(std::string_view prefix) {
+    Node* leaf = new_node(Kind::Leaf);
+    leaf->prefix.assign(prefix);
+    leaf->is_end = true;
+    return leaf;
+  }
+
+  void destroy(Node* n) {
+    switch (n->kind) {
+      case Kind::Leaf: alloc_.delete_object(n); break;
+      case Kind::N4: alloc_.delete_object(static_cast<Node4*>(n)); break;
+      case Kind::N16: alloc_.delete_object(static_cast<Node16*>(n)); break;
+      case Kind::N48: alloc_.delete_object(static_cast<Node48*>(n)); break;
+      case Kind::N256: alloc_.delete_object(static_cast<Node256*>(n)); break;
+    }
+  }
+
+  static int find16(const std::uint8_t* keys, std::size_t count, std::uint8_t byte) {
+#if defined(__SSE2__)
+    __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                 _mm_load_si128(reinterpret_cast<const __m128i*>(keys)));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << count) - 1);
+    return mask ? __builtin_ctz(mask) : -1;
+#else
+    for (std::size_t i = 0; i < count; ++i)
+      if (keys[i] == byte) return static_cast<int>(i);
+    return -1;
+#endif
+  }
+
+  static Node** find_child(Node* n, std::uint8_t byte) {
+    switch (n->kind) {
+      case Kind::Leaf: return nullptr;
+      case Kind::N4: {
+        auto* m = static_cast<Node4*>(n);
+        for (std::size_t i = 0; i < m->count; ++i)
+          if (m->keys[i] == byte) return &m->child[i];
+        return nullptr;
+      }
+      case Kind::N16: {
+        auto* m = static_cast<Node16*>(n);
+        int i = find16(m->keys.data(), m->count, byte);
+        return i < 0 ? nullptr : &m->child[static_cast<std::size_t>(i)];
+      }
+      case Kind::N48: {
+        auto* m = static_cast<Node48*>(n);
+        return m->slot[byte] ? &m->child[m->slot[byte] - 1] : nullptr;
+      }
+      case Kind::N256: {
+        auto* m = static_cast<Node256*>(n);
+        return m->child[byte] ? &m->child[byte] : nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename F>
+  static void for_each_child(const Node* n, F&& f) {
+    switch (n->kind) {
+      case Kind::Leaf: break;
+      case Kind::N4: {
+        auto* m = static_cast<const Node4*>(n);
+        for (std::size_t i = 0; i < m->count; ++i) f(m->keys[i], m->child[i]);
+        break;
+      }
+      case Kind::N16: {
+        auto* m = static_cast<const Node16*>(n);
+        for (std::size_t i = 0; i < m->count; ++i) f(m->keys[i], m->child[i]);
+        break;
+      }
+      case Kind::N48: {
+        auto* m = static_cast<const Node48*>(n);
+        for (std::size_t b = 0; b < 256; ++b)
+          if (m->slot[b]) f(static_cast<std::uint8_t>(b), m->child[m->slot[b] - 1]);
+        break;
+      }
+      case Kind::N256: {
+        auto* m = static_cast<const Node256*>(n);
+        for (std::size_t b = 0; b < 256; ++b)
+          if (m->child[b]) f(static_cast<std::uint8_t>(b), m->child[b]);
+        break;
+      }
+    }
+  }
+
+  static std::size_t capacity(Kind kind) {
+    switch (kind) {
+      case Kind::Leaf: return 0;
+      case Kind::N4: return 4;
+      case Kind::N16: return 16;
+      case Kind::N48: return 48;
+      case Kind::N256: return 256;
+    }
+    return 0;
+  }
+
+  // *ref 滿了就換成大一號的節點 (prefix / is_end / children 搬過去)
+  void grow(Node** ref) {
+    Node* old = *ref;
+    Kind next = old->kind == Kind::Leaf ? Kind::N4
+                : old->kind == Kind::N4 ? Kind::N16
+                : old->kind == Kind::N16 ? Kind::N48
+                                         : Kind::N256;
+    Node* bigger = new_node(next);
+    bigger->is_end = old->is_end;
+    bigger->prefix = std::move(old->prefix);
+    for_each_child(old, [&](std::uint8_t b, Node* c) { insert_child(bigger, b, c); });
+    destroy(old);
+    *ref = bigger;
+  }
+
+  // 呼叫前要確定還有空位
+  static void insert_child(Node* n, std::uint8_t byte, Node* c) {
+    switch (n->kind) {
+      case Kind::Leaf: break;
+      case Kind::N4: {
+        auto* m = static_cast<Node4*>(n);
+        m->keys[m->count] = byte;
+        m->child[m->count] = c;
+        break;
+      }
+      case Kind::N16: {
+        auto* m = static_cast<Node16*>(n);
+        m->keys[m->count] = byte;
+        m->child[m->count] = c;
+        break;
+      }
+      case Kind::N48: {
+        auto* m = static_cast<Node48*>(n);
+        m->child[m->count] = c;
+        m->slot[byte] = static_cast<std::uint8_t>(m->count + 1);
+        break;
+      }
+      case Kind::N256: static_cast<Node256*>(n)->child[byte] = c; break;
+    }
+    ++n->count;
+  }
+
+  void add_child(Node** ref, std::uint8_t byte, Node* c) {
+    if ((*ref)->count == capacity((*ref)->kind)) grow(ref);
+    insert_child(*ref, byte, c);
+  }
+
+  // 沿 key 走到底的節點；partial = true 時 key 停在某個 prefix 中間也算
+  const Node* descend(std::string_view key, bool partial) const {
+    const Node* n = root_;
+    std::size_t depth = 0;
+    while (true) {
+      std::string_view rest = key.substr(depth);
+      std::size_t common = common_prefix(n->prefix, rest);
+      if (common < n->prefix.size()) return partial && common == rest.size() ? n : nullptr;
+      depth += common;
+      if (depth == key.size()) return n;
+      Node* const* next = find_child(const_cast<Node*>(n), static_cast<std::uint8_t>(key[depth]));
+      if (!next) return nullptr;
+      n = *next;
+      ++depth;
+    }
+  }
+};
+
+// 唯讀、可 mmap 的 Trie。底下那塊 byte 由呼叫端持有 (vector、mmap 的檔案
+// 都行)，FrozenTrie 只是一個 view，建構 O(1)。
+//
+// 格式 (native byte order，所有 record 4-byte 對齊)：
+//   header  : "DSTRIE01" | u32 version | u32 reserved | u64 size   (24 bytes)
+//   node    : u8 flags (bit0 = is_end) | u8 0 | u16 child_count | u32 prefix_len
+//             | u32 child_offset[child_count] | u8 key[child_count] (遞增)
+//             | prefix bytes | 補到 4 的倍數
+// root 在 offset 24。換 Node 型別的事在凍結時就攤平了：child 數 <= 16 用
+// SSE 比對，再多就對排序好的 key 做 binary search。
+class FrozenTrie {
+public:
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::size_t kHeaderSize = 24;
+
+  explicit FrozenTrie(std::span<const std::byte> bytes) : bytes_(bytes) {
+    if (bytes.size() < kHeaderSize + 8 || std::memcmp(bytes.data(), "DSTRIE01", 8) != 0 ||
+        read<std::uint32_t>(8) != kVersion) {
+      bytes_ = {};
+      return;
+    }
+    size_ = static_cast<std::size_t>(read<std::uint64_t>(16));
+  }
+
+  // magic / version 對得上 (否則當成空的)
+  bool valid() const { return !bytes_.empty(); }
+
+  bool contains(std::string_view word) const {
+    std::size_t node = 0;
+    return descend(word, false, node) && (read<std::uint8_t>(node) & 1);
+  }
+
+  bool starts_with(std::string_view prefix) const {
+    std::size_t node = 0;
+    return size_ != 0 && descend(prefix, true, node);
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
 
 private:
-  // TODO: 你的 Node 結構與 root_
+  std::span<const std::byte> bytes_;
+  std::size_t size_ = 0;
+
+  template <typename U>
+  U read(std::size_t offset) const {
+    U value;
+    std::memcpy(&value, bytes_.data() + offset, sizeof(U));
+    return value;
+  }
+
+  bool descend(std::string_view key, bool partial, std::size_t& node) const {
+    if (!valid()) return false;
+    node = kHeaderSize;
+    std::size_t depth = 0;
+    while (true) {
+      if (node + 8 > bytes_.size()) return false;
+      std::size_t count = read<std::uint16_t>(node + 2);
+      std::size_t prefix_len = read<std::uint32_t>(node + 4);
+      std::size_t offsets = node + 8;
+      std::size_t keys = offsets + 4 * count;
+      std::size_t prefix = keys + count;
+      if (prefix + prefix_len > bytes_.size()) return false;
+
+      std::string_view rest = key.substr(depth);
+      std::string_view stored(reinterpret_cast<const char*>(bytes_.data() + prefix), prefix_len);
+      std::size_t common = 0;
+      while (common < prefix_len && common < rest.size() && stored[common] == rest[common]) ++common;
+      if (common < prefix_len) return partial && common == rest.size();
+      depth += common;
+      if (depth == key.size()) return true;
+
+      auto byte = static_cast<std::uint8_t>(key[depth]);
+      const auto* key_bytes = reinterpret_cast<const std::uint8_t*>(bytes_.data() + keys);
+      int i = find(key_bytes, count, byte);
+      if (i < 0) return false;
+      node = read<std::uint32_t>(offsets + 4 * static_cast<std::size_t>(i));
+      ++depth;
+    }
+  }
+
+  static int find(const std::uint8_t* keys, std::size_t count, std::uint8_t byte) {
+    if (count <= 16) {
+#if defined(__SSE2__)
+      alignas(16) std::uint8_t lanes[16] = {};
+      std::memcpy(lanes, keys, count);
+      __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                   _mm_load_si128(reinterpret_cast<const __m128i*>(lanes)));
+      unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << count) - 1);
+      return mask ? __builtin_ctz(mask) : -1;
+#else
+      for (std::size_t i = 0; i < count; ++i)
+        if (keys[i] == byte) return static_cast<int>(i);
+      return -1;
+#endif
+    }
+    const std::uint8_t* it = std::lower_bound(keys, keys + count, byte);
+    return it != keys + count && *it == byte ? static_cast<int>(it - keys) : -1;
+  }
 };
 
+inline std::vector<std::byte> Trie::freeze() const {
+  // BFS 排出節點順序並算 offset，第二輪再照順序寫出去
+  struct Entry {
+    const Node* node;
+    std::vector<std::pair<std::uint8_t, std::size_t>> children;  // (byte, 在 order 裡的位置)
+  };
+  std::vector<Entry> order{{root_, {}}};
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    std::vector<std::pair<std::uint8_t, const Node*>> kids;
+    for_each_child(order[i].node, [&](std::uint8_t b, const Node* c) { kids.emplace_back(b, c); });
+    std::sort(kids.begin(), kids.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto [b, c] : kids) {
+      order[i].children.emplace_back(b, order.size());
+      order.push_back({c, {}});
+    }
+  }
+
+  auto record_size = [](const Entry& e) {
+    std::size_t n = 8 + 5 * e.children.size() + e.node->prefix.size();
+    return (n + 3) & ~std::size_t{3};
+  };
+  std::vector<std::uint32_t> offset(order.size());
+  std::size_t total = FrozenTrie::kHeaderSize;
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    offset[i] = static_cast<std::uint32_t>(total);
+    total += record_size(order[i]);
+  }
+
+  std::vector<std::byte> out(total);
+  auto put = [&](std::size_t at, const auto& value) {
+    std::memcpy(out.data() + at, &value, sizeof(value));
+  };
+  std::memcpy(out.data(), "DSTRIE01", 8);
+  put(8, FrozenTrie::kVersion);
+  put(12, std::uint32_t{0});
+  put(16, static_cast<std::uint64_t>(size_));
+
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    const Entry& e = order[i];
+    std::size_t at = offset[i];
+    std::size_t count = e.children.size();
+    put(at, static_cast<std::uint8_t>(e.node->is_end ? 1 : 0));
+    put(at + 2, static_cast<std::uint16_t>(count));
+    put(at + 4, static_cast<std::uint32_t>(e.node->prefix.size()));
+    for (std::size_t c = 0; c < count; ++c) {
+      put(at + 8 + 4 * c, offset[e.children[c].second]);
+      put(at + 8 + 4 * count + c, e.children[c].first);
+    }
+    std::memcpy(out.data() + at + 8 + 5 * count, e.node->prefix.data(), e.node->prefix.size());
+  }
+  return out;
+}
+
 }  // namespace ds
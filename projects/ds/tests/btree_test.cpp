@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <ds/tree/btree.hpp>
+
+TEST_CASE("BTree: insert 後 contains 找得到") {
+  ds::BTree<int> tree;
+  CHECK(tree.empty());
+  CHECK_FALSE(tree.contains(5));
+
+  tree.insert(5);
+  tree.insert(3);
+  tree.insert(8);
+
+  CHECK(tree.size() == 3);
+  CHECK(tree.contains(5));
+  CHECK(tree.contains(3));
+  CHECK(tree.contains(8));
+  CHECK_FALSE(tree.contains(42));
+}
+
+TEST_CASE("BTree: 重複插入不會增加 size") {
+  ds::BTree<int, 3> tree;
+  for (int round = 0; round < 3; ++round) {
+    for (int v = 0; v < 50; ++v) tree.insert(v);
+  }
+  CHECK(tree.size() == 50);
+}
+
+TEST_CASE("BTree: 排序好的輸入樹高仍是 log") {
+  ds::BTree<int, 7> tree;
+  for (int v = 0; v < 10000; ++v) tree.insert(v);
+  CHECK(tree.size() == 10000);
+  // 每個節點至少 3 個 key、4 個 child → 10000 筆最多 7 層
+  CHECK(tree.height() <= 7);
+  CHECK(tree.contains(0));
+  CHECK(tree.contains(9999));
+  CHECK_FALSE(tree.contains(10000));
+}
+
+TEST_CASE("BTree: 隨機插入跟 std::set 一致，中序走訪是排序好的") {
+  std::mt19937 rng(7);
+  ds::BTree<std::uint32_t, 5> tree;
+  std::set<std::uint32_t> expected;
+  for (int i = 0; i < 5000; ++i) {
+    std::uint32_t v = rng() % 3000;
+    tree.insert(v);
+    expected.insert(v);
+  }
+  CHECK(tree.size() == expected.size());
+  CHECK(tree.inorder() == std::vector<std::uint32_t>(expected.begin(), expected.end()));
+  for (std::uint32_t v = 0; v < 3000; ++v) {
+    CHECK(tree.contains(v) == (expected.count(v) == 1));
+  }
+}
+
+TEST_CASE("BTree: 從排序好的資料 bulk load") {
+  std::vector<int> sorted(1000);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  sorted.insert(sorted.begin() + 500, 499);  // 重複值只留一個
+
+  for (std::size_t n : {0u, 1u, 7u, 8u, 64u, 1001u}) {
+    std::vector<int> input(sorted.begin(), sorted.begin() + n);
+    ds::BTree<int, 7> tree(input);
+    input.erase(std::unique(input.begin(), input.end()), input.end());
+    CHECK(tree.size() == input.size());
+    CHECK(tree.inorder() == input);
+
+    // bulk load 出來的樹照樣可以繼續 insert
+    tree.insert(-1);
+    tree.insert(5000);
+    CHECK(tree.contains(-1));
+    CHECK(tree.contains(5000));
+    CHECK(tree.size() == input.size() + 2);
+  }
+}
+
+TEST_CASE("BTree: 節點 vector 放進 monotonic arena") {
+  std::pmr::monotonic_buffer_resource arena;
+  ds::BTree<int, 7> tree(&arena);
+  for (int v = 0; v < 1000; ++v) tree.insert(v);
+  CHECK(tree.size() == 1000);
+  CHECK(tree.contains(999));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// 測試共用的 pmr fixture。檔名不是 *_test.cpp，不會被 GLOB 成另一支測試。
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace ds_tests {
+
+// 記下經過它的配置 / 歸還次數，其餘交給 upstream
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace ds_tests
@@ -1,8 +1,96 @@
 #include <doctest/doctest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <ds/graph/graph.hpp>
 
-// 拿掉 doctest::skip() 之後就會被 ctest 跑到。先把實作寫好，再回來填測試。
-TEST_CASE("graph: add_edge / has_edge" * doctest::skip()) {
-  // TODO: 你的測試
+TEST_CASE("graph: add_edge / has_edge") {
+  ds::GraphBuilder<std::string> builder;
+  builder.add_edge("acct-1", "clearing-A");
+  builder.add_edge("acct-2", "clearing-A");
+  builder.add_edge("acct-2", "clearing-A");  // 重複的邊只留一條
+  builder.add_edge("clearing-A", "clearing-B");
+  ds::Graph<std::string> g = std::move(builder).freeze();
+
+  CHECK(g.num_vertices() == 4);
+  CHECK(g.num_edges() == 3);
+  CHECK(g.has_edge("acct-1", "clearing-A"));
+  CHECK(g.has_edge("clearing-A", "acct-1"));  // 無向
+  CHECK_FALSE(g.has_edge("acct-1", "acct-2"));
+  CHECK_FALSE(g.has_edge("acct-1", "nobody"));
+}
+
+TEST_CASE("graph: neighbors 回傳排序好的 span，不複製") {
+  ds::GraphBuilder<int> builder;
+  for (int v : {5, 3, 9, 3}) builder.add_edge(1, v);
+  ds::Graph<int> g = std::move(builder).freeze();
+
+  std::span<const ds::VertexId> adj = g.neighbors(1);
+  REQUIRE(adj.size() == 3);
+  std::vector<int> names;
+  for (ds::VertexId v : adj) names.push_back(g.vertex(v));
+  std::sort(names.begin(), names.end());
+  CHECK(names == std::vector<int>{3, 5, 9});
+  CHECK(std::is_sorted(adj.begin(), adj.end()));
+  CHECK(g.neighbors(42).empty());
+}
+
+namespace {
+
+std::vector<std::uint32_t> reference_bfs(const ds::Graph<int>& g, ds::VertexId source) {
+  std::vector<std::uint32_t> dist(g.num_vertices(), ds::Graph<int>::kUnreachable);
+  std::queue<ds::VertexId> queue;
+  dist[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    ds::VertexId v = queue.front();
+    queue.pop();
+    for (ds::VertexId u : g.neighbors(v)) {
+      if (dist[u] == ds::Graph<int>::kUnreachable) {
+        dist[u] = dist[v] + 1;
+        queue.push(u);
+      }
+    }
+  }
+  return dist;
+}
+
+ds::Graph<int> random_graph(int vertices, int edges, unsigned seed) {
+  std::mt19937 rng(seed);
+  ds::GraphBuilder<int> builder;
+  for (int v = 0; v < vertices; ++v) builder.add_vertex(v);
+  for (int e = 0; e < edges; ++e) builder.add_edge(rng() % vertices, rng() % vertices);
+  return std::move(builder).freeze();
+}
+
+}  // namespace
+
+TEST_CASE("graph: BFS 距離跟一般 BFS 一致 (top-down / bottom-up / 多 thread)") {
+  ds::Graph<int> g = random_graph(3000, 9000, 11);
+  ds::VertexId source = *g.id(0);
+  std::vector<std::uint32_t> expected = reference_bfs(g, source);
+
+  CHECK(g.bfs(source) == expected);
+  CHECK(g.bfs(source, {.threads = 4}) == expected);
+  // alpha 很小、beta 很大：幾乎每層都切到 bottom-up
+  CHECK(g.bfs(source, {.threads = 1, .alpha = 1e-9, .beta = 1e9}) == expected);
+  CHECK(g.bfs(source, {.threads = 3, .alpha = 1e-9, .beta = 1e9}) == expected);
+  // alpha 很大：永遠 top-down
+  CHECK(g.bfs(source, {.threads = 2, .alpha = 1e18}) == expected);
+}
+
+TEST_CASE("graph: 到不了的頂點是 kUnreachable") {
+  ds::GraphBuilder<int> builder;
+  builder.add_edge(0, 1);
+  builder.add_edge(2, 3);
+  ds::Graph<int> g = std::move(builder).freeze();
+  std::vector<std::uint32_t> dist = g.bfs(*g.id(0), {.threads = 2});
+  CHECK(dist[*g.id(1)] == 1);
+  CHECK(dist[*g.id(2)] == ds::Graph<int>::kUnreachable);
+  CHECK(dist[*g.id(3)] == ds::Graph<int>::kUnreachable);
 }
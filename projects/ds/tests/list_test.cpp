@@ -1,8 +1,94 @@
 #include <doctest/doctest.h>
 
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <ds/list/list.hpp>
 
-// 拿掉 doctest::skip() 之後就會被 ctest 跑到。先把實作寫好，再回來填測試。
-TEST_CASE("list: push_front / push_back / to_vector" * doctest::skip()) {
-  // TODO: 你的測試
+#include "counting_resource.hpp"
+
+TEST_CASE("list: push_front / push_back / to_vector") {
+  ds::List<int> list;
+  CHECK(list.empty());
+  CHECK(list.to_vector().empty());
+
+  list.push_back(2);
+  list.push_back(3);
+  list.push_front(1);
+  list.push_front(0);
+  CHECK(list.size() == 4);
+  CHECK(list.front() == 0);
+  CHECK(list.back() == 3);
+  CHECK(list.to_vector() == std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_CASE("list: 跨好幾塊的 iterator 走訪與修改") {
+  ds::List<int, 64> list;  // 一塊只放十來個 int，很快就跨塊
+  for (int v = 0; v < 100; ++v) list.push_back(v);
+  for (int v = -1; v >= -100; --v) list.push_front(v);
+  REQUIRE(list.size() == 200);
+
+  int expected = -100;
+  for (int v : list) CHECK(v == expected++);
+
+  for (int& v : list) v *= 2;
+  const ds::List<int, 64>& view = list;
+  ds::List<int, 64>::const_iterator it = view.begin();
+  CHECK(*it == -200);
+  CHECK(std::distance(view.begin(), view.end()) == 200);
+}
+
+using ds_tests::CountingResource;
+
+TEST_CASE("list: 當 FIFO 用，空掉的塊回收重用") {
+  CountingResource counting;
+  ds::List<std::string> fifo(&counting);
+  std::deque<std::string> expected;
+  std::mt19937 rng(3);
+
+  for (int round = 0; round < 20000; ++round) {
+    if (expected.size() < 50 && rng() % 2) {
+      std::string s = "order-" + std::to_string(round);
+      fifo.push_back(s);
+      expected.push_back(s);
+    } else if (!expected.empty()) {
+      REQUIRE(fifo.front() == expected.front());
+      fifo.pop_front();
+      expected.pop_front();
+    }
+    REQUIRE(fifo.size() == expected.size());
+  }
+  CHECK(fifo.to_vector() == std::vector<std::string>(expected.begin(), expected.end()));
+  // 最多 50 個排隊，需要的塊數有上限；之後都是從 free list 拿
+  CHECK(counting.allocations <= 50 / ds::List<std::string>::kCapacity + 2);
+}
+
+TEST_CASE("list: clear 之後可以繼續用") {
+  ds::List<std::string> list;
+  for (int v = 0; v < 30; ++v) list.push_front(std::to_string(v));
+  list.clear();
+  CHECK(list.empty());
+  CHECK(list.begin() == list.end());
+  list.push_back("again");
+  CHECK(list.to_vector() == std::vector<std::string>{"again"});
+}
+
+TEST_CASE("list: move assignment 接過 other 的元素和 resource") {
+  CountingResource counting;
+  ds::List<std::string> a;
+  for (int v = 0; v < 30; ++v) a.push_back(std::to_string(v));
+  ds::List<std::string> b(&counting);
+  b.push_back("x");
+  b.push_back("y");
+
+  a = std::move(b);
+  CHECK(b.empty());
+  CHECK(a.resource() == &counting);
+  CHECK(a.to_vector() == std::vector<std::string>{"x", "y"});
+  a.push_front("w");
+  CHECK(a.to_vector() == std::vector<std::string>{"w", "x", "y"});
 }
@@ -1,9 +1,12 @@
 #include <doctest/doctest.h>
 
+#include <memory_resource>
 #include <vector>
 
 #include <ds/tree/tree.hpp>
 
+#include "counting_resource.hpp"
+
 TEST_CASE("BST: insert 後 contains 找得到") {
   ds::BinarySearchTree<int> bst;
   CHECK(bst.empty());
@@ -34,3 +37,74 @@ TEST_CASE("BST: 中序走訪是排序好的") {
   std::vector<int> expected{1, 3, 4, 5, 7, 8, 9};
   CHECK(bst.inorder() == expected);
 }
+
+using ds_tests::CountingResource;
+
+TEST_CASE("BST: 節點從給定的 memory_resource 配置，解構時全部還回去") {
+  CountingResource counting;
+  {
+    ds::BinarySearchTree<int> bst(&counting);
+    for (int v : {5, 3, 8, 1, 4, 7, 9}) bst.insert(v);
+    bst.insert(5);
+    CHECK(counting.allocations == 7);
+  }
+  CHECK(counting.deallocations == 7);
+}
+
+TEST_CASE("BST: 放進 monotonic arena，節點連續 bump 配置") {
+  CountingResource upstream;
+  {
+    std::pmr::monotonic_buffer_resource arena(1 << 20, &upstream);
+    ds::BinarySearchTree<int> bst(&arena, /*arena=*/true);
+    for (int v = 0; v < 1000; ++v) bst.insert((v * 7919) % 1000);
+    CHECK(bst.size() == 1000);
+    CHECK(upstream.allocations == 1);  // 一個 1 MiB 的 block 就裝得下
+  }
+  CHECK(upstream.deallocations == 1);
+}
+
+TEST_CASE("BST: 沒說是 arena 就逐個 deallocate，即使 resource 是 arena 的子類別") {
+  struct CountingArena : std::pmr::monotonic_buffer_resource {
+    std::size_t deallocations = 0;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+      ++deallocations;
+      monotonic_buffer_resource::do_deallocate(p, bytes, align);
+    }
+  };
+  CountingArena arena;
+  {
+    ds::BinarySearchTree<int> bst(&arena);
+    for (int v : {5, 3, 8}) bst.insert(v);
+  }
+  CHECK(arena.deallocations == 3);
+}
+
+TEST_CASE("BST: move assignment 釋放舊節點，接過 other 的節點和 resource") {
+  CountingResource mine;
+  CountingResource theirs;
+  ds::BinarySearchTree<int> a(&mine);
+  for (int v : {2, 1, 3}) a.insert(v);
+  {
+    ds::BinarySearchTree<int> b(&theirs);
+    for (int v : {5, 4}) b.insert(v);
+    a = std::move(b);
+    CHECK(b.empty());
+  }
+  CHECK(mine.deallocations == 3);
+  CHECK(a.resource() == &theirs);
+  CHECK(a.inorder() == std::vector<int>{4, 5});
+  a.insert(6);
+  a.clear();
+  CHECK(theirs.allocations == 3);
+  CHECK(theirs.deallocations == 3);
+}
+
+TEST_CASE("BST: 排序好的輸入拉成長鏈，解構不會炸 stack") {
+  ds::BinarySearchTree<int> bst;
+  for (int v = 0; v < 20000; ++v) bst.insert(v);
+  CHECK(bst.size() == 20000);
+  CHECK(bst.inorder().back() == 19999);
+  bst.clear();
+  CHECK(bst.empty());
+  CHECK_FALSE(bst.contains(0));
+}
@@ -1,8 +1,120 @@
 #include <doctest/doctest.h>
 
+#include <cstddef>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
 #include <ds/trie/trie.hpp>
 
-// 拿掉 doctest::skip() 之後就會被 ctest 跑到。先把實作寫好，再回來填測試。
-TEST_CASE("trie: insert / contains / starts_with" * doctest::skip()) {
-  // TODO: 你的測試
+TEST_CASE("trie: insert / contains / starts_with") {
+  ds::Trie trie;
+  CHECK(trie.empty());
+  CHECK_FALSE(trie.starts_with(""));
+
+  CHECK(trie.insert("AAPL"));
+  CHECK(trie.insert("AMZN"));
+  CHECK(trie.insert("AMD"));
+  CHECK_FALSE(trie.insert("AAPL"));
+  CHECK(trie.size() == 3);
+
+  CHECK(trie.contains("AAPL"));
+  CHECK(trie.contains("AMD"));
+  CHECK_FALSE(trie.contains("AM"));
+  CHECK_FALSE(trie.contains("AMDX"));
+
+  CHECK(trie.starts_with(""));
+  CHECK(trie.starts_with("A"));
+  CHECK(trie.starts_with("AM"));
+  CHECK(trie.starts_with("AMZ"));
+  CHECK_FALSE(trie.starts_with("AB"));
+  CHECK_FALSE(trie.starts_with("MSFT"));
+}
+
+TEST_CASE("trie: key 是另一個 key 的前綴") {
+  ds::Trie trie;
+  trie.insert("US0378331005");  // ISIN
+  trie.insert("US03783");
+  trie.insert("US");
+  CHECK(trie.size() == 3);
+  CHECK(trie.contains("US"));
+  CHECK(trie.contains("US03783"));
+  CHECK(trie.contains("US0378331005"));
+  CHECK_FALSE(trie.contains("US0378"));
+  CHECK(trie.starts_with("US0378"));
+
+  CHECK(trie.insert(""));  // 空字串也是合法的 key
+  CHECK(trie.contains(""));
+}
+
+TEST_CASE("trie: 同一層長到 256 個 child (Node4/16/48/256 換型)") {
+  ds::Trie trie;
+  for (int b = 0; b < 256; ++b) {
+    std::string word = "X";
+    word.push_back(static_cast<char>(b));
+    CHECK(trie.insert(word));
+    for (int seen = 0; seen <= b; seen += 17) {
+      std::string earlier = "X";
+      earlier.push_back(static_cast<char>(seen));
+      CHECK(trie.contains(earlier));
+    }
+  }
+  CHECK(trie.size() == 256);
+  CHECK(trie.contains(std::string("X\0", 2)));
+  CHECK_FALSE(trie.contains("X"));
+}
+
+namespace {
+
+std::vector<std::string> random_words(std::size_t n, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<std::string> words;
+  for (std::size_t i = 0; i < n; ++i) {
+    std::string w(1 + rng() % 8, ' ');
+    for (char& c : w) c = static_cast<char>('A' + rng() % 6);  // 字母少 → 前綴重疊多
+    words.push_back(w);
+  }
+  return words;
+}
+
+}  // namespace
+
+TEST_CASE("trie: 隨機字串跟 std::set 一致") {
+  std::pmr::monotonic_buffer_resource arena;
+  ds::Trie trie(&arena);
+  std::set<std::string> expected;
+  for (const std::string& w : random_words(3000, 1)) {
+    CHECK(trie.insert(w) == expected.insert(w).second);
+  }
+  CHECK(trie.size() == expected.size());
+  for (const std::string& w : random_words(3000, 2)) {
+    CHECK(trie.contains(w) == (expected.count(w) == 1));
+    auto it = expected.lower_bound(w);
+    bool has_prefix = it != expected.end() && it->compare(0, w.size(), w) == 0;
+    CHECK(trie.starts_with(w) == has_prefix);
+  }
+}
+
+TEST_CASE("trie: freeze 之後的 FrozenTrie 查詢結果一樣") {
+  ds::Trie trie;
+  std::vector<std::string> words = random_words(2000, 3);
+  for (const std::string& w : words) trie.insert(w);
+  for (int b = 0; b < 200; ++b) trie.insert(std::string("Z") + static_cast<char>(b));
+
+  std::vector<std::byte> image = trie.freeze();
+  ds::FrozenTrie frozen(image);
+  REQUIRE(frozen.valid());
+  CHECK(frozen.size() == trie.size());
+  for (const std::string& w : random_words(2000, 4)) {
+    CHECK(frozen.contains(w) == trie.contains(w));
+    CHECK(frozen.starts_with(w) == trie.starts_with(w));
+  }
+  CHECK(frozen.contains(std::string("Z") + static_cast<char>(150)));
+  CHECK_FALSE(frozen.contains("Z"));
+
+  std::vector<std::byte> garbage(64, std::byte{0});
+  CHECK_FALSE(ds::FrozenTrie(garbage).valid());
+  CHECK_FALSE(ds::FrozenTrie(garbage).contains(""));
 }
@@ -0,0 +1,321 @@
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "matching_engine/core/clock.hpp"
+#include "matching_engine/matching/async_engine.hpp"
+#include "matching_engine/memory/async_ring_buffer.hpp"
+#include "matching_engine/metrics/histogram.hpp"
+
+using namespace matching_engine;
+using namespace matching_engine::matching;
+
+Timestamp Timestamp::now() noexcept {
+	auto now = std::chrono::high_resolution_clock::now();
+	auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+	return Timestamp{static_cast<uint64_t>(nanos)};
+}
+
+namespace {
+
+// Synthetic order flow. Limit prices are drawn around mid, uniformly over
+// +-spread ticks or normally with spread as the standard deviation, on the
+// buy side below mid and the sell side above it (so the book builds depth,
+// and the tails cross). Cancels target a random earlier order, which may
+// already have traded.
+struct FlowConfig {
+	size_t orders = 200'000;
+	double add_ratio = 0.6;
+	double cancel_ratio = 0.3;	// The rest are market orders
+	int64_t mid_ticks = 10000;
+	int64_t spread_ticks = 50;
+	bool normal_prices = false;
+	uint64_t max_quantity = 100;
+	uint64_t seed = 42;
+};
+
+class OrderFlow {
+	FlowConfig config_;
+	std::mt19937_64 rng_;
+	uint64_t next_id_ = 1;	// Book ids: one per New, accepted or not
+
+ public:
+	explicit OrderFlow(const FlowConfig& config) : config_(config), rng_(config.seed) {}
+
+	std::vector<OrderEvent> generate() {
+		std::vector<OrderEvent> events;
+		events.reserve(config_.orders);
+		std::uniform_real_distribution<double> pick(0.0, 1.0);
+		std::uniform_int_distribution<uint64_t> quantity(1, config_.max_quantity);
+		std::uniform_int_distribution<int> side(0, 1);
+		for (size_t i = 0; i < config_.orders; ++i) {
+			double roll = pick(rng_);
+			Side s = side(rng_) ? Side::Buy : Side::Sell;
+			if (roll < config_.cancel_ratio && next_id_ > 1) {
+				std::uniform_int_distribution<uint64_t> id(1, next_id_ - 1);
+				events.push_back(OrderEvent{.type = OrderEventType::Cancel, .order_id = OrderId{id(rng_)}});
+				continue;
+			}
+			OrderEvent event{.type = OrderEventType::New,
+											 .quantity = Quantity{quantity(rng_)},
+											 .side = s,
+											 .order_type = OrderType::Limit};
+			if (roll < config_.cancel_ratio + config_.add_ratio) {
+				event.price = Price{config_.mid_ticks + (s == Side::Buy ? -offset() : offset())};
+			} else {
+				event.order_type = OrderType::Market;
+			}
+			++next_id_;
+			events.push_back(event);
+		}
+		return events;
+	}
+
+ private:
+	// Distance from mid; negative values cross the spread
+	int64_t offset() {
+		if (config_.normal_prices) {
+			std::normal_distribution<double> d(config_.spread_ticks / 4.0,
+																				 static_cast<double>(config_.spread_ticks));
+			return static_cast<int64_t>(d(rng_));
+		}
+		std::uniform_int_distribution<int64_t> d(-config_.spread_ticks / 10, config_.spread_ticks);
+		return d(rng_);
+	}
+};
+
+uint64_t now_ns() noexcept { return TscClock{}.now().nanoseconds; }
+
+struct Report {
+	const char* name;
+	size_t operations = 0;		// Orders handled
+	uint64_t elapsed_ns = 0;
+	metrics::HistogramSnapshot latency;
+	const char* unit = "order";
+};
+
+void print_header() {
+	fmt::print("{:<44} {:>10} {:>14} {:>9} {:>9} {:>9}\n", "benchmark", "orders", "orders/sec",
+						 "p50 ns", "p99 ns", "p99.9 ns");
+}
+
+void print(const Report& report) {
+	double seconds = static_cast<double>(report.elapsed_ns) / 1e9;
+	double rate = seconds > 0 ? static_cast<double>(report.operations) / seconds : 0.0;
+	fmt::print("{:<44} {:>10} {:>14.0f} {:>9} {:>9} {:>9}  (per {})\n", report.name,
+						 report.operations, rate, report.latency.percentile(0.5),
+						 report.latency.percentile(0.99), report.latency.percentile(0.999), report.unit);
+}
+
+template <typename Task>
+auto run(Task task) {
+	while (!task.done()) {
+		task.resume();
+	}
+	return task.get_result();
+}
+
+BookConfig book_config(const FlowConfig& flow) {
+	BookConfig config;
+	config.reference_price = Price{flow.mid_ticks};
+	config.max_orders = flow.orders + 1;
+	return config;
+}
+
+template <typename Book>
+Report bench_sync(const char* name, const FlowConfig& flow, const std::vector<OrderEvent>& events) {
+	SyncMatchingEngine<Book> engine(book_config(flow));
+	NullEventSink sink;
+	metrics::LogHistogram latency;
+	uint64_t start = now_ns();
+	for (const OrderEvent& event : events) {
+		uint64_t t0 = now_ns();
+		engine.process_event(event, sink);
+		latency.record(now_ns() - t0);
+	}
+	Report report{.name = name, .operations = events.size(), .elapsed_ns = now_ns() - start};
+	latency.merge_into(report.latency);
+	return report;
+}
+
+// Queues this size do not fit on the stack
+using AsyncEngine = AsyncMatchingEngine<1 << 16, LadderOrderBook>;
+
+// Fills stay queued until someone reads them; drop them between timings
+void drain(AsyncEngine& engine) {
+	std::array<OrderEvent, 256> events;
+	while (engine.poll_events(events) == events.size()) {
+	}
+	std::array<BookUpdate, 256> updates;
+	while (engine.poll_updates(updates) == updates.size()) {
+	}
+}
+
+coro::Task<void> submit_all(AsyncEngine& engine, const std::vector<OrderEvent>& events,
+														metrics::LogHistogram& latency) {
+	for (size_t i = 0; i < events.size(); ++i) {
+		uint64_t t0 = now_ns();
+		co_await engine.submit_order_async(events[i]);
+		latency.record(now_ns() - t0);
+		if (i % 1024 == 1023) {
+			drain(engine);
+		}
+	}
+}
+
+Report bench_submit(const FlowConfig& flow, const std::vector<OrderEvent>& events) {
+	auto engine = std::make_unique<AsyncEngine>(book_config(flow));
+	metrics::LogHistogram latency;
+	uint64_t start = now_ns();
+	run(submit_all(*engine, events, latency));
+	Report report{.name = "AsyncMatchingEngine::submit_order_async",
+								.operations = events.size(),
+								.elapsed_ns = now_ns() - start};
+	latency.merge_into(report.latency);
+	return report;
+}
+
+Report bench_batch(const FlowConfig& flow, std::vector<OrderEvent> events, size_t batch) {
+	auto engine = std::make_unique<AsyncEngine>(book_config(flow));
+	metrics::LogHistogram latency;
+	uint64_t start = now_ns();
+	for (size_t i = 0; i < events.size(); i += batch) {
+		std::span<OrderEvent> block(events.data() + i, std::min(batch, events.size() - i));
+		uint64_t t0 = now_ns();
+		run(engine->process_batch_async(block));
+		latency.record(now_ns() - t0);
+		drain(*engine);
+	}
+	Report report{.name = "AsyncMatchingEngine::process_batch_async (64)",
+								.operations = events.size(),
+								.elapsed_ns = now_ns() - start,
+								.unit = "batch"};
+	latency.merge_into(report.latency);
+	return report;
+}
+
+// Pin the calling thread to cpu (modulo the cpus there are); best effort
+void pin_to(unsigned cpu) {
+#if defined(__linux__)
+	unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % cpus, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)cpu;
+#endif
+}
+
+// One producer stamps each slot with its send time, one consumer measures
+// how long the slot took to arrive
+Report bench_spsc(size_t transfers) {
+	using Ring = memory::AsyncRingBuffer<uint64_t, 1024>;
+	auto ring = std::make_unique<Ring>();
+	metrics::LogHistogram latency;
+	std::atomic<bool> ready{false};
+	bool shared_core = std::thread::hardware_concurrency() < 2;
+
+	uint64_t start = now_ns();
+	std::thread consumer([&] {
+		pin_to(1);
+		ready.store(true, std::memory_order_release);
+		for (size_t received = 0; received < transfers;) {
+			if (auto stamp = ring->pop()) {
+				latency.record(now_ns() - *stamp);
+				++received;
+			} else if (shared_core) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	pin_to(0);
+	while (!ready.load(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+	for (size_t sent = 0; sent < transfers;) {
+		if (ring->push(now_ns())) {
+			++sent;
+		} else if (shared_core) {
+			std::this_thread::yield();
+		}
+	}
+	consumer.join();
+
+	Report report{.name = "AsyncRingBuffer SPSC transfer (2 threads)",
+								.operations = transfers,
+								.elapsed_ns = now_ns() - start,
+								.unit = "slot"};
+	latency.merge_into(report.latency);
+	return report;
+}
+
+void usage() {
+	fmt::print(
+			"usage: matching_engine_bench [--orders N] [--add R] [--cancel R] [--spread TICKS]\n"
+			"                             [--normal] [--max-qty Q] [--seed S]\n"
+			"  market orders make up whatever add + cancel leave over\n");
+}
+
+}	 // namespace
+
+int main(int argc, char** argv) {
+	FlowConfig flow;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		auto value = [&] { return i + 1 < argc ? argv[++i] : "0"; };
+		if (arg == "--orders") {
+			flow.orders = std::strtoull(value(), nullptr, 10);
+		} else if (arg == "--add") {
+			flow.add_ratio = std::strtod(value(), nullptr);
+		} else if (arg == "--cancel") {
+			flow.cancel_ratio = std::strtod(value(), nullptr);
+		} else if (arg == "--spread") {
+			flow.spread_ticks = std::max<int64_t>(1, std::strtoll(value(), nullptr, 10));
+		} else if (arg == "--normal") {
+			flow.normal_prices = true;
+		} else if (arg == "--max-qty") {
+			flow.max_quantity = std::max<uint64_t>(1, std::strtoull(value(), nullptr, 10));
+		} else if (arg == "--seed") {
+			flow.seed = std::strtoull(value(), nullptr, 10);
+		} else {
+			usage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+	if (flow.add_ratio < 0 || flow.cancel_ratio < 0 || flow.add_ratio + flow.cancel_ratio > 1) {
+		fmt::print("add and cancel ratios must be non-negative and sum to at most 1\n");
+		return 1;
+	}
+
+	std::vector<OrderEvent> events = OrderFlow(flow).generate();
+	fmt::print("{} events: {:.0f}% add, {:.0f}% cancel, {:.0f}% market, {} prices +-{} ticks\n\n",
+						 events.size(), flow.add_ratio * 100, flow.cancel_ratio * 100,
+						 (1 - flow.add_ratio - flow.cancel_ratio) * 100,
+						 flow.normal_prices ? "normal" : "uniform", flow.spread_ticks);
+
+	print_header();
+	print(bench_sync<OrderBook>("SyncMatchingEngine<OrderBook>", flow, events));
+	print(bench_sync<LadderOrderBook>("SyncMatchingEngine<LadderOrderBook>", flow, events));
+	print(bench_submit(flow, events));
+	print(bench_batch(flow, events, 64));
+	print(bench_spsc(events.size()));
+	return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "types.hpp"
+
+namespace matching_engine {
+
+// One L2 level change: the new aggregate at (side, price) after an add,
+// fill, cancel or modify touched it. quantity == 0 means the level is gone.
+// sequence counts every level change of the book, so a consumer that sees
+// a gap (or starts late) resyncs from a depth snapshot carrying the
+// sequence it reflects.
+struct BookUpdate {
+	uint64_t sequence;
+	Price price;
+	Quantity quantity;
+	SymbolId symbol;
+	uint32_t orders;
+	Side side;
+};
+
+static_assert(std::is_trivially_copyable_v<BookUpdate>, "BookUpdate must be memcpy-able");
+
+}	 // namespace matching_engine
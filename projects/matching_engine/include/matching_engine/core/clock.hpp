@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MATCHING_ENGINE_HAS_RDTSC 1
+#endif
+
+#include "types.hpp"
+
+namespace matching_engine {
+
+// Clock policies for the orderbook. A book reads its clock once per
+// add/modify/cancel and stamps every fill of that sweep with the same time.
+template <typename C>
+concept Clock = requires(C& clock) {
+	{ clock.now() } -> std::same_as<Timestamp>;
+};
+
+// Defers to Timestamp::now() (defined by the application)
+struct SystemClock {
+	Timestamp now() const noexcept { return Timestamp::now(); }
+};
+
+// Invariant TSC scaled to nanoseconds; calibrated against steady_clock the
+// first time any TscClock is used. Falls back to steady_clock off x86.
+class TscClock {
+	struct Calibration {
+		uint64_t base_tsc;
+		uint64_t base_ns;
+		uint64_t ns_per_tick_q32;	 // nanoseconds per tick, 32.32 fixed point
+	};
+
+	static uint64_t steady_ns() noexcept {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+																		 std::chrono::steady_clock::now().time_since_epoch())
+																		 .count());
+	}
+
+#ifdef MATCHING_ENGINE_HAS_RDTSC
+	static const Calibration& calibration() noexcept {
+		static const Calibration cal = [] {
+			uint64_t ns0 = steady_ns();
+			uint64_t tsc0 = __rdtsc();
+			uint64_t ns1;
+			do {
+				ns1 = steady_ns();
+			} while (ns1 - ns0 < 2'000'000);	// ~2 ms sample
+			uint64_t tsc1 = __rdtsc();
+			uint64_t ticks = tsc1 - tsc0 ? tsc1 - tsc0 : 1;
+			return Calibration{tsc1, ns1, ((ns1 - ns0) << 32) / ticks};
+		}();
+		return cal;
+	}
+#endif
+
+ public:
+	Timestamp now() const noexcept {
+#ifdef MATCHING_ENGINE_HAS_RDTSC
+		const Calibration& cal = calibration();
+		unsigned __int128 delta = __rdtsc() - cal.base_tsc;
+		return Timestamp{cal.base_ns + static_cast<uint64_t>((delta * cal.ns_per_tick_q32) >> 32)};
+#else
+		return Timestamp{steady_ns()};
+#endif
+	}
+};
+
+// "Engine time": the source clock is sampled only on refresh(), typically
+// once per inbound batch, and now() returns the cached value.
+template <Clock Source = SystemClock>
+class CachedClock {
+	Source source_;
+	Timestamp cached_;
+
+ public:
+	CachedClock() : cached_(source_.now()) {}
+
+	Timestamp now() const noexcept { return cached_; }
+	void refresh() noexcept { cached_ = source_.now(); }
+};
+
+// Deterministic time for replay and benchmarks; only moves when told to
+class ReplayClock {
+	Timestamp current_{0};
+
+ public:
+	Timestamp now() const noexcept { return current_; }
+	void set(Timestamp t) noexcept { current_ = t; }
+	void advance(uint64_t nanoseconds) noexcept { current_.nanoseconds += nanoseconds; }
+};
+
+}	 // namespace matching_engine
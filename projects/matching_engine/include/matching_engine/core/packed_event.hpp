@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "types.hpp"
+
+namespace matching_engine {
+
+// Cache-line-sized, trivially copyable record form of OrderEvent for ring
+// buffers and journals. The header is common to every event type; the body
+// is a union selected by type. Fills carry the timestamp once (OrderEvent
+// duplicates it in fill_info.fill_time) and reject reasons (on rejects and
+// self-trade cancels) become an enum code.
+// Order records keep their last fill price as a 32-bit offset from the
+// order price (NO_FILL_PRICE when it is zero, e.g. nothing filled yet);
+// iceberg orders keep their peak size there instead (their fill events
+// still carry every price). Events whose offset or peak does not fit are
+// not representable: check packable() first, from_event() asserts it.
+struct alignas(64) PackedOrderEvent {
+	// New / Cancel / Modify / Reject: the order plus its execution summary
+	struct OrderBody {
+		int64_t price_ticks;
+		uint64_t quantity;
+		uint64_t filled_quantity;
+		uint64_t remaining_quantity;
+	};
+
+	// Fill: one execution at price
+	struct FillBody {
+		int64_t price_ticks;
+		uint64_t filled_quantity;
+		uint64_t remaining_quantity;
+	};
+
+	uint64_t order_id;
+	uint64_t timestamp_ns;
+	uint32_t symbol_id;
+	uint32_t account_id;
+	OrderEventType type;
+	Side side;
+	OrderType order_type;
+	RejectReason reject_reason;
+	union {
+		int32_t last_fill_offset;		// Order records: fill price - price
+		uint32_t display_quantity;	// Iceberg order records
+	};
+
+	union {
+		OrderBody order;
+		FillBody fill;
+	};
+
+	static constexpr int32_t NO_FILL_PRICE = INT32_MIN;
+
+	// False if from_event() would have to truncate the event
+	static bool packable(const OrderEvent& event) noexcept {
+		if (event.type == OrderEventType::Fill)
+			return true;
+		if (event.order_type == OrderType::Iceberg)
+			return event.display_quantity.value <= UINT32_MAX;
+		if (event.fill_info.fill_price.ticks == 0)
+			return true;
+		// Subtracted in 128 bits so far-apart prices cannot overflow
+		__int128 offset = static_cast<__int128>(event.fill_info.fill_price.ticks) - event.price.ticks;
+		return offset > NO_FILL_PRICE && offset <= INT32_MAX;
+	}
+
+	static PackedOrderEvent from_event(const OrderEvent& event) noexcept {
+		assert(packable(event));
+		PackedOrderEvent packed;
+		std::memset(&packed, 0, sizeof(packed));
+		packed.order_id = event.order_id.value;
+		packed.symbol_id = event.symbol.value;
+		packed.account_id = event.account.value;
+		packed.timestamp_ns = event.timestamp.nanoseconds;
+		packed.type = event.type;
+		packed.side = event.side;
+		packed.order_type = event.order_type;
+
+		if (event.type == OrderEventType::Fill) {
+			packed.fill = FillBody{.price_ticks = event.fill_info.fill_price.ticks,
+														 .filled_quantity = event.fill_info.filled_quantity.value,
+														 .remaining_quantity = event.fill_info.remaining_quantity.value};
+			return packed;
+		}
+
+		packed.order.price_ticks = event.price.ticks;
+		packed.order.quantity = event.quantity.value;
+		packed.order.filled_quantity = event.fill_info.filled_quantity.value;
+		packed.order.remaining_quantity = event.fill_info.remaining_quantity.value;
+		if (event.order_type == OrderType::Iceberg) {
+			packed.display_quantity = static_cast<uint32_t>(event.display_quantity.value);
+		} else if (event.fill_info.fill_price.ticks == 0) {
+			packed.last_fill_offset = NO_FILL_PRICE;
+		} else {
+			packed.last_fill_offset =
+					static_cast<int32_t>(event.fill_info.fill_price.ticks - event.price.ticks);
+		}
+		if (event.type == OrderEventType::Reject || event.reject_reason) {
+			packed.reject_reason =
+					event.reject_reason ? reject_reason_from_text(*event.reject_reason) : RejectReason::Other;
+		}
+		return packed;
+	}
+
+	OrderEvent to_event() const noexcept {
+		OrderEvent event{.type = type,
+										 .order_id = OrderId{order_id},
+										 .symbol = SymbolId{symbol_id},
+										 .account = AccountId{account_id},
+										 .side = side,
+										 .order_type = order_type,
+										 .timestamp = Timestamp{timestamp_ns}};
+
+		if (type == OrderEventType::Fill) {
+			event.price = Price{fill.price_ticks};
+			event.quantity = Quantity{fill.filled_quantity};
+			event.fill_info = FillInfo{.filled_quantity = Quantity{fill.filled_quantity},
+																 .remaining_quantity = Quantity{fill.remaining_quantity},
+																 .fill_price = Price{fill.price_ticks},
+																 .fill_time = event.timestamp};
+			return event;
+		}
+
+		event.price = Price{order.price_ticks};
+		event.quantity = Quantity{order.quantity};
+		event.fill_info = FillInfo{.filled_quantity = Quantity{order.filled_quantity},
+															 .remaining_quantity = Quantity{order.remaining_quantity}};
+		if (order_type == OrderType::Iceberg) {
+			event.display_quantity = Quantity{display_quantity};
+		} else if (last_fill_offset != NO_FILL_PRICE) {
+			event.fill_info.fill_price = Price{order.price_ticks + last_fill_offset};
+		}
+		if (type == OrderEventType::Reject || reject_reason != RejectReason::None) {
+			event.reject_reason = reject_reason_text(reject_reason);
+		}
+		return event;
+	}
+
+ private:
+	static RejectReason reject_reason_from_text(const char* text) noexcept {
+		for (auto reason : {RejectReason::PriceOutOfRange, RejectReason::CapacityExhausted,
+												RejectReason::UnknownOrder, RejectReason::UnknownSymbol,
+												RejectReason::WouldCross, RejectReason::NotFillable,
+												RejectReason::RiskLimit, RejectReason::UnknownAccount,
+												RejectReason::SelfTrade, RejectReason::OffTick}) {
+			const char* known = reject_reason_text(reason);
+			if (text == known || std::strcmp(text, known) == 0)
+				return reason;
+		}
+		return RejectReason::Other;
+	}
+};
+
+static_assert(sizeof(PackedOrderEvent) == 64, "PackedOrderEvent must fill one cache line");
+static_assert(std::is_trivially_copyable_v<PackedOrderEvent>,
+							"PackedOrderEvent must be memcpy-able");
+
+}	 // namespace matching_engine
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "types.hpp"
+
+namespace matching_engine {
+
+// Decimal text to ticks without floating point: "100.29" at scale 100 is
+// exactly 10029. Digits finer than one tick round half away from zero
+// ("100.295" -> 10030); digits past the 18th decimal place are ignored.
+// scale is ticks per whole unit (Price::TICK_SIZE by default) and need not
+// be a power of ten. Accepts an optional sign, digits and at most one '.',
+// nothing else; nullopt if the text is malformed or the result does not fit
+// in int64_t.
+constexpr std::optional<Price> parse_price(std::string_view text,
+																					 int64_t scale = Price::TICK_SIZE) noexcept {
+	if (scale <= 0)
+		return std::nullopt;
+	bool negative = false;
+	if (!text.empty() && (text.front() == '-' || text.front() == '+')) {
+		negative = text.front() == '-';
+		text.remove_prefix(1);
+	}
+
+	unsigned __int128 whole = 0;
+	unsigned __int128 fraction = 0;			// Fractional digits kept, as an integer
+	unsigned __int128 denominator = 1;	// 10^(digits kept)
+	bool seen_point = false, seen_digit = false;
+	for (char c : text) {
+		if (c == '.' && !seen_point) {
+			seen_point = true;
+			continue;
+		}
+		if (c < '0' || c > '9')
+			return std::nullopt;
+		seen_digit = true;
+		unsigned digit = static_cast<unsigned>(c - '0');
+		if (!seen_point) {
+			whole = whole * 10 + digit;
+			if (whole > static_cast<unsigned __int128>(INT64_MAX))
+				return std::nullopt;
+		} else if (denominator < 1'000'000'000'000'000'000ull) {
+			fraction = fraction * 10 + digit;
+			denominator *= 10;
+		}
+	}
+	if (!seen_digit)
+		return std::nullopt;
+
+	// Round fraction * scale / denominator, half away from zero
+	unsigned __int128 scaled = fraction * static_cast<unsigned __int128>(scale);
+	unsigned __int128 ticks = scaled / denominator;
+	if (scaled % denominator * 2 >= denominator) {
+		++ticks;
+	}
+	ticks += whole * static_cast<unsigned __int128>(scale);
+
+	unsigned __int128 limit = static_cast<unsigned __int128>(INT64_MAX) + (negative ? 1 : 0);
+	if (ticks > limit)
+		return std::nullopt;
+	int64_t value = negative ? static_cast<int64_t>(0 - static_cast<uint64_t>(ticks))
+													 : static_cast<int64_t>(ticks);
+	return Price{value};
+}
+
+// |price| * quantity in ticks, computed in 128 bits; nullopt when it does
+// not fit in 64
+constexpr std::optional<uint64_t> checked_notional(Price price, Quantity quantity) noexcept {
+	uint64_t ticks = price.ticks < 0 ? 0 - static_cast<uint64_t>(price.ticks)
+																	 : static_cast<uint64_t>(price.ticks);
+	unsigned __int128 notional = static_cast<unsigned __int128>(ticks) * quantity.value;
+	if (notional > UINT64_MAX)
+		return std::nullopt;
+	return static_cast<uint64_t>(notional);
+}
+
+// Valid price increments of one instrument, by price band: from each
+// band's floor upwards prices must be a multiple of its increment (in
+// ticks), e.g. 1 tick below 10.00 and 5 ticks from there. Bands are kept in
+// a fixed array, lowest floor first; the common single-band, one-tick table
+// answers every check without dividing.
+class TickTable {
+ public:
+	static constexpr size_t MAX_BANDS = 8;
+
+	struct Band {
+		Price floor;
+		int64_t increment;
+	};
+
+	// Every tick is a valid price
+	constexpr TickTable() noexcept = default;
+
+	// One increment over the whole price range (at least one tick)
+	constexpr explicit TickTable(int64_t increment) noexcept {
+		bands_[0].increment = increment > 0 ? increment : 1;
+	}
+
+	// Add a band starting at floor; floors must be added in increasing
+	// order, increments must be positive. False if the table is full or the
+	// band is out of order.
+	constexpr bool add_band(Price floor, int64_t increment) noexcept {
+		if (count_ == MAX_BANDS || increment <= 0 || floor <= bands_[count_ - 1].floor)
+			return false;
+		bands_[count_++] = Band{floor, increment};
+		return true;
+	}
+
+	// Increment in force at price
+	constexpr int64_t increment_at(Price price) const noexcept {
+		size_t band = 0;
+		while (band + 1 < count_ && bands_[band + 1].floor <= price) {
+			++band;
+		}
+		return bands_[band].increment;
+	}
+
+	constexpr bool on_tick(Price price) const noexcept {
+		if (count_ == 1 && bands_[0].increment == 1)
+			return true;
+		return euclid_mod(price.ticks, increment_at(price)) == 0;
+	}
+
+	// Nearest valid price no worse for the side: buys round down, sells up
+	constexpr Price round(Price price, Side side) const noexcept {
+		int64_t increment = increment_at(price);
+		int64_t below = price.ticks - euclid_mod(price.ticks, increment);
+		if (below == price.ticks || side == Side::Buy)
+			return Price{below};
+		return Price{below + increment};
+	}
+
+	constexpr size_t bands() const noexcept { return count_; }
+	constexpr const Band& band(size_t i) const noexcept { return bands_[i]; }
+
+ private:
+	std::array<Band, MAX_BANDS> bands_{Band{Price{INT64_MIN}, 1}};
+	size_t count_ = 1;
+
+	static constexpr int64_t euclid_mod(int64_t value, int64_t divisor) noexcept {
+		int64_t r = value % divisor;
+		return r < 0 ? r + divisor : r;
+	}
+};
+
+}	 // namespace matching_engine
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cmath>
 #include <compare>
 #include <cstdint>
 #include <optional>
@@ -15,6 +16,21 @@ struct OrderId {
 	auto operator<=>(const OrderId&) const = default;
 };
 
+// Instrument identifier; each symbol trades in its own book
+struct SymbolId {
+	uint32_t value;
+
+	auto operator<=>(const SymbolId&) const = default;
+};
+
+// Trading account that owns an order. Ids are dense indices (per-account
+// state such as risk limits lives in flat arrays); 0 is the default account.
+struct AccountId {
+	uint32_t value;
+
+	auto operator<=>(const AccountId&) const = default;
+};
+
 struct Timestamp {
 	uint64_t nanoseconds;
 
@@ -28,8 +44,11 @@ struct Price {
 	int64_t ticks;														 // Price in minimum tick units
 	static constexpr int64_t TICK_SIZE = 100;	 // 0.01 = 1 cent
 
+	// Nearest tick (100.29 is 10029, not the 10028 truncation gives). For
+	// text input prefer parse_price() (tick.hpp), which never goes through
+	// a double.
 	static Price from_double(double price) noexcept {
-		return Price{static_cast<int64_t>(price * TICK_SIZE)};
+		return Price{static_cast<int64_t>(std::llround(price * TICK_SIZE))};
 	}
 
 	double to_double() const noexcept { return static_cast<double>(ticks) / TICK_SIZE; }
@@ -61,16 +80,79 @@ struct Quantity {
 enum class Side : uint8_t { Buy, Sell };
 
 // Order type
-enum class OrderType : uint8_t { Limit, Market };
+enum class OrderType : uint8_t {
+	Limit,							// Rest whatever does not trade at the limit price
+	Market,							// Trade at any price, drop the rest
+	ImmediateOrCancel,	// Trade up to the limit price, drop the rest
+	FillOrKill,					// Trade the whole quantity up to the limit price, or nothing
+	PostOnly,						// Rest without trading; rejected if it would cross
+	Iceberg							// Limit order showing at most display_quantity at a time
+};
+
+// What the book does when an incoming order would trade with a resting
+// order of the same account. Account 0 is exempt.
+enum class SelfTradePrevention : uint8_t {
+	None,						// Trade as usual
+	CancelNewest,		// Cancel what is left of the incoming order
+	CancelOldest,		// Cancel the resting order and keep matching
+	Decrement				// Shrink both by the smaller open quantity; cancel what reaches zero
+};
 
 // Order event type
 enum class OrderEventType : uint8_t {
 	New,		 // New order submission
 	Cancel,	 // Order cancellation
 	Fill,		 // Order fill (full or partial)
-	Reject	 // Order rejection
+	Reject,	 // Order rejection
+	Modify	 // Order price/quantity amendment
+};
+
+// Why an order was rejected
+enum class RejectReason : uint8_t {
+	None,
+	PriceOutOfRange,		// Limit price has no slot in the book
+	CapacityExhausted,	// Book cannot hold another resting order
+	UnknownOrder,				// Cancel/modify of an id that is not resting
+	UnknownSymbol,			// No book is registered for the event's symbol
+	WouldCross,					// Post-only order would have traded
+	NotFillable,				// Fill-or-kill order cannot fill completely
+	RiskLimit,					// Order would breach its account's risk limits
+	UnknownAccount,			// Account id has no risk slot
+	SelfTrade,					// Cancelled by self-trade prevention
+	OffTick,						// Price is not a multiple of the book's tick increment
+	Other
 };
 
+inline const char* reject_reason_text(RejectReason reason) noexcept {
+	switch (reason) {
+		case RejectReason::None:
+			return "none";
+		case RejectReason::PriceOutOfRange:
+			return "price outside book range";
+		case RejectReason::CapacityExhausted:
+			return "order capacity exhausted";
+		case RejectReason::UnknownOrder:
+			return "unknown order";
+		case RejectReason::UnknownSymbol:
+			return "unknown symbol";
+		case RejectReason::WouldCross:
+			return "post-only order would cross";
+		case RejectReason::NotFillable:
+			return "fill-or-kill order not fillable";
+		case RejectReason::RiskLimit:
+			return "risk limit exceeded";
+		case RejectReason::UnknownAccount:
+			return "unknown account";
+		case RejectReason::SelfTrade:
+			return "self-trade prevented";
+		case RejectReason::OffTick:
+			return "price not on tick";
+		case RejectReason::Other:
+			break;
+	}
+	return "other";
+}
+
 // Fill information
 struct FillInfo {
 	Quantity filled_quantity{0};
@@ -83,8 +165,11 @@ struct FillInfo {
 struct OrderEvent {
 	OrderEventType type;
 	OrderId order_id{0};
+	SymbolId symbol{0};
+	AccountId account{0};
 	Price price{0};
 	Quantity quantity{0};
+	Quantity display_quantity{0};	 // Iceberg peak size
 	Side side{Side::Buy};
 	OrderType order_type{OrderType::Limit};
 	Timestamp timestamp{0};
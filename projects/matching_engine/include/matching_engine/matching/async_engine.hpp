@@ -4,24 +4,69 @@
 
 #include "../core/types.hpp"
 #include "../memory/async_ring_buffer.hpp"
+#include "../memory/mpmc_ring_buffer.hpp"
+#include "../memory/seqlock.hpp"
+#include "../metrics/metrics.hpp"
 #include "../scheduler/coro_scheduler.hpp"
 #include "orderbook.hpp"
+#include "top_of_book.hpp"
 
 namespace matching_engine::matching {
 
-// SyncMatchingEngine wrapper for tests
+// SyncMatchingEngine wrapper for tests; Book selects the orderbook layout
+template <typename Book = OrderBook>
 class SyncMatchingEngine {
  private:
-	OrderBook orderbook_;
+	Book orderbook_;
 
  public:
 	SyncMatchingEngine() = default;
+	explicit SyncMatchingEngine(const BookConfig& config) : orderbook_(config) {}
 
 	Result<OrderEvent> add_order(Price price, Quantity quantity, Side side,
 															 OrderType type = OrderType::Limit) {
 		return orderbook_.add_order(price, quantity, side, type);
 	}
 
+	Result<OrderEvent> cancel_order(OrderId id) { return orderbook_.cancel_order(id); }
+
+	Result<OrderEvent> modify_order(OrderId id, Price new_price, Quantity new_quantity) {
+		return orderbook_.modify_order(id, new_price, new_quantity);
+	}
+
+	// Advance a cached engine clock (no-op for clocks read on demand)
+	void refresh_clock() {
+		if constexpr (requires { orderbook_.clock().refresh(); }) {
+			orderbook_.clock().refresh();
+		}
+	}
+
+	// Apply an inbound event according to its type
+	Result<OrderEvent> process_event(const OrderEvent& order) {
+		return process_event(order, orderbook_.default_sink());
+	}
+
+	// Same, with fills delivered to sink instead of take_events(). With
+	// metrics on, also times the event and counts its fills.
+	template <EventSink Sink>
+	Result<OrderEvent> process_event(const OrderEvent& order, Sink&& sink) {
+		if constexpr (metrics::enabled) {
+			uint64_t start = metrics::now_ns();
+			FillCountingSink<std::remove_reference_t<Sink>> counted{sink};
+			auto result = dispatch(order, counted);
+			metrics::record(metrics::Histogram::OrderToAck, metrics::now_ns() - start);
+			metrics::record(metrics::Histogram::FillsPerOrder, counted.fills);
+			metrics::count(metrics::Counter::Events);
+			metrics::count(metrics::Counter::Fills, counted.fills);
+			if (result.is_err()) {
+				metrics::count(metrics::Counter::Rejects);
+			}
+			return result;
+		} else {
+			return dispatch(order, sink);
+		}
+	}
+
 	std::optional<Price> get_best_bid() const { return orderbook_.get_best_bid(); }
 
 	std::optional<Price> get_best_ask() const { return orderbook_.get_best_ask(); }
@@ -30,21 +75,54 @@ class SyncMatchingEngine {
 		return orderbook_.get_market_depth(max_levels);
 	}
 
-	const OrderBook& orderbook() const { return orderbook_; }
-	OrderBook& orderbook() { return orderbook_; }
+	template <size_t N>
+	void snapshot_depth(DepthSnapshot<N>& snapshot) const {
+		orderbook_.snapshot_depth(snapshot);
+	}
+
+	const Book& orderbook() const { return orderbook_; }
+	Book& orderbook() { return orderbook_; }
 
 	std::vector<OrderEvent> take_events() { return orderbook_.take_events(); }
+
+ private:
+	template <typename Sink>
+	Result<OrderEvent> dispatch(const OrderEvent& order, Sink& sink) {
+		switch (order.type) {
+			case OrderEventType::Cancel:
+				return orderbook_.cancel_order(order.order_id, sink);
+			case OrderEventType::Modify:
+				return orderbook_.modify_order(order.order_id, order.price, order.quantity, sink);
+			default:
+				return orderbook_.add_order(order.price, order.quantity, order.side, order.order_type,
+																		sink, order.display_quantity, order.account);
+		}
+	}
 };
 
-// Wrapper that provides async interface for synchronous orderbook
-template <size_t EventQueueSize = 4096>
+// Wrapper that provides async interface for synchronous orderbook. Queue
+// picks the event queue: SPSC AsyncRingBuffer, or MpmcRingBuffer when
+// several threads drain events. After every submit and every batch the
+// top of book is republished (if it changed) through a SeqLock that any
+// thread may read.
+template <size_t EventQueueSize = 4096, typename Book = OrderBook,
+					template <typename, size_t> class Queue = memory::AsyncRingBuffer>
 class AsyncMatchingEngine {
  private:
-	SyncMatchingEngine engine_;
-	memory::AsyncRingBuffer<OrderEvent, EventQueueSize> event_queue_;
+	using EventQueue = Queue<OrderEvent, EventQueueSize>;
+	using UpdateQueue = Queue<BookUpdate, EventQueueSize>;
+
+	SyncMatchingEngine<Book> engine_;
+	EventQueue event_queue_;
+	UpdateQueue update_queue_;		// L2 level deltas, next to the fills
+	size_t dropped_events_ = 0;		// Fills lost to a full event queue
+	size_t dropped_updates_ = 0;	// Level deltas lost to a full update queue
+	memory::SeqLock<TopOfBook> top_of_book_;
+	uint64_t top_sequence_ = 0;	 // Book update sequence top_of_book_ reflects
 
  public:
 	AsyncMatchingEngine() = default;
+	explicit AsyncMatchingEngine(const BookConfig& config) : engine_(config) {}
 
 	// Async order submission
 	struct SubmitOrderAwaitable {
@@ -53,17 +131,17 @@ class AsyncMatchingEngine {
 		Result<OrderEvent> result{false};
 
 		bool await_ready() {
-			// Submit order immediately
-			result = async_engine.engine_.add_order(order_event.price, order_event.quantity,
-																							order_event.side, order_event.order_type);
-
-			// Queue any events generated
-			if (result.is_ok()) {
-				auto events = async_engine.engine_.take_events();
-				for (auto& evt : events) {
-					async_engine.event_queue_.push(std::move(evt));
-				}
-			}
+			metrics::ScopedTimer timer(metrics::Histogram::SubmitAwait);
+
+			// Submit order immediately; fills and level deltas go straight
+			// into their queues
+			MarketDataSink<RingBufferEventSink<EventQueue>, RingBufferUpdateSink<UpdateQueue>> sink{
+					{async_engine.event_queue_}, {async_engine.update_queue_}};
+			async_engine.engine_.refresh_clock();
+			result = async_engine.engine_.process_event(order_event, sink);
+			async_engine.dropped_events_ += sink.events.dropped;
+			async_engine.dropped_updates_ += sink.updates.dropped;
+			async_engine.publish_top_of_book();
 
 			return true;	// Always ready (synchronous execution)
 		}
@@ -120,32 +198,59 @@ class AsyncMatchingEngine {
 		co_return co_await event_queue_.pop_async();
 	}
 
+	// Fill out with queued events: waits for the first like get_event_async,
+	// then drains whatever else is already queued in one bulk pop. Returns
+	// the number of events written.
+	coro::Task<size_t> get_events_async(std::span<OrderEvent> out) {
+		if (out.empty())
+			co_return 0;
+		auto first = co_await event_queue_.pop_async();
+		if (!first.has_value())
+			co_return 0;
+		out[0] = std::move(*first);
+		co_return 1 + event_queue_.pop_bulk(out.subspan(1));
+	}
+
+	// Drain queued events without waiting; returns the number written
+	size_t poll_events(std::span<OrderEvent> out) { return event_queue_.pop_bulk(out); }
+
 	// Async batch processing
 	struct BatchAwaitable {
 		AsyncMatchingEngine& async_engine;
 		std::span<OrderEvent> orders;
+		std::span<OrderEvent> acks{};	 // When given, acks[i] = ack or reject of orders[i]
 		size_t processed = 0;
 
-		bool await_ready() { return false; }
-
-		void await_suspend(std::coroutine_handle<>) {
-			// Process all orders
-			for (auto& order : orders) {
-				auto result = async_engine.engine_.add_order(order.price, order.quantity, order.side,
-																										 order.order_type);
+		bool await_ready() {
+			metrics::ScopedTimer timer(metrics::Histogram::BatchAwait);
+
+			// Process all orders, staging fills and publishing them to the
+			// event queue a block at a time; one clock sample covers the
+			// whole batch
+			BulkRingBufferEventSink fills{async_engine.event_queue_};
+			MarketDataSink<BulkRingBufferEventSink<EventQueue>&, RingBufferUpdateSink<UpdateQueue>> sink{
+					fills, {async_engine.update_queue_}};
+			async_engine.engine_.refresh_clock();
+			for (size_t i = 0; i < orders.size(); ++i) {
+				auto result = async_engine.engine_.process_event(orders[i], sink);
 
 				if (result.is_ok()) {
 					++processed;
-
-					// Queue events
-					auto events = async_engine.engine_.take_events();
-					for (auto& evt : events) {
-						async_engine.event_queue_.push(std::move(evt));
-					}
+				}
+				if (i < acks.size()) {
+					acks[i] = result.value();
 				}
 			}
+			fills.flush();
+			async_engine.dropped_events_ += fills.dropped;
+			async_engine.dropped_updates_ += sink.updates.dropped;
+			async_engine.publish_top_of_book();
+
+			return true;	// Always ready (synchronous execution)
 		}
 
+		void await_suspend(std::coroutine_handle<>) {}
+
 		size_t await_resume() { return processed; }
 	};
 
@@ -153,6 +258,13 @@ class AsyncMatchingEngine {
 		co_return co_await BatchAwaitable{*this, orders};
 	}
 
+	// Same, also handing back each order's ack (assigned id, fill summary)
+	// or reject; acks needs room for orders.size() events
+	coro::Task<size_t> process_batch_async(std::span<OrderEvent> orders,
+																				 std::span<OrderEvent> acks) {
+		co_return co_await BatchAwaitable{*this, orders, acks};
+	}
+
 	// Async market depth query
 	struct MarketDepthAwaitable {
 		AsyncMatchingEngine& async_engine;
@@ -173,9 +285,45 @@ class AsyncMatchingEngine {
 		co_return co_await MarketDepthAwaitable{*this, max_levels};
 	}
 
+	// Async retrieval of the next L2 level delta
+	coro::Task<std::optional<BookUpdate>> get_update_async() {
+		co_return co_await update_queue_.pop_async();
+	}
+
+	// Drain queued level deltas without waiting; returns the number written
+	size_t poll_updates(std::span<BookUpdate> out) { return update_queue_.pop_bulk(out); }
+
+	// Resync point for the delta feed: top-N depth tagged with the sequence
+	// of the last level change it includes. Deltas with a higher sequence
+	// apply on top; a gap in the sequence means take a new snapshot.
+	template <size_t N>
+	coro::Task<DepthSnapshot<N>> get_depth_snapshot_async() {
+		DepthSnapshot<N> snapshot;
+		engine_.snapshot_depth(snapshot);
+		co_return snapshot;
+	}
+
+	// Top of book as of the last submit or batch, for any thread: poll
+	// try_load() wait-free, or load(). The engine's own thread may still
+	// use the awaitables above.
+	const memory::SeqLock<TopOfBook>& top_of_book() const { return top_of_book_; }
+
+	// Republish after changing the book through engine() directly; a no-op
+	// when no level changed since the last publication
+	void publish_top_of_book() {
+		const Book& book = engine_.orderbook();
+		if (book.update_sequence() != top_sequence_) {
+			top_sequence_ = book.update_sequence();
+			top_of_book_.store(matching::top_of_book(book));
+		}
+	}
+
+	size_t dropped_events() const { return dropped_events_; }
+	size_t dropped_updates() const { return dropped_updates_; }
+
 	// Access to underlying engine (for inspection)
-	const SyncMatchingEngine& engine() const { return engine_; }
-	SyncMatchingEngine& engine() { return engine_; }
+	const SyncMatchingEngine<Book>& engine() const { return engine_; }
+	SyncMatchingEngine<Book>& engine() { return engine_; }
 };
 
 }	 // namespace matching_engine::matching
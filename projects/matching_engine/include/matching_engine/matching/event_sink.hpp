@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "../core/book_update.hpp"
+#include "../core/packed_event.hpp"
+#include "../core/types.hpp"
+
+namespace matching_engine::matching {
+
+// Anything the match loop can hand an event to. Sinks are invoked inline for
+// every fill, so they should be cheap and must not re-enter the book.
+template <typename S>
+concept EventSink = requires(S& sink, const OrderEvent& event) { sink(event); };
+
+// Sinks that can also take a BookUpdate receive the L2 level deltas of
+// the operation; the rest never see them
+template <typename S>
+concept BookUpdateSink = requires(S& sink, const BookUpdate& update) { sink(update); };
+
+// Sinks that also take a run of events at once. A sweep that drains whole
+// levels hands each level's fills over as one span.
+template <typename S>
+concept EventBatchSink = EventSink<S> && requires(S& sink, std::span<const OrderEvent> events) {
+	sink(events);
+};
+
+// Appends to a caller-owned vector (the book's take_events() buffer)
+struct VectorEventSink {
+	std::vector<OrderEvent>& events;
+
+	void operator()(const OrderEvent& event) { events.push_back(event); }
+	void operator()(std::span<const OrderEvent> batch) {
+		events.insert(events.end(), batch.begin(), batch.end());
+	}
+};
+
+// Writes each event straight into a ring buffer slot, packing it first when
+// the buffer holds PackedOrderEvent records. Events that do not fit, in the
+// buffer or in a packed record, are counted rather than blocking the match
+// loop.
+template <typename Buffer>
+struct RingBufferEventSink {
+	Buffer& buffer;
+	size_t dropped = 0;
+
+	void operator()(const OrderEvent& event) noexcept {
+		bool pushed;
+		if constexpr (std::is_same_v<typename Buffer::value_type, PackedOrderEvent>) {
+			pushed = PackedOrderEvent::packable(event) &&
+							 buffer.push(PackedOrderEvent::from_event(event));
+		} else {
+			pushed = buffer.push(event);
+		}
+		if (!pushed) {
+			++dropped;
+		}
+	}
+
+	void operator()(std::span<const OrderEvent> events) noexcept {
+		if constexpr (std::is_same_v<typename Buffer::value_type, OrderEvent>) {
+			dropped += events.size() - buffer.push_bulk(events);
+		} else {
+			for (const OrderEvent& event : events) {
+				(*this)(event);
+			}
+		}
+	}
+};
+
+// Stages events in a local block and hands them to the ring buffer with
+// push_bulk, so a sweep producing many fills publishes the write index once
+// per block instead of once per fill. Call flush() (or let the destructor)
+// before anything reads the buffer.
+template <typename Buffer, size_t BlockSize = 64>
+struct BulkRingBufferEventSink {
+	using value_type = typename Buffer::value_type;
+
+	Buffer& buffer;
+	size_t dropped = 0;
+	std::array<value_type, BlockSize> block{};
+	size_t staged = 0;
+
+	explicit BulkRingBufferEventSink(Buffer& target) noexcept : buffer(target) {}
+
+	BulkRingBufferEventSink(const BulkRingBufferEventSink&) = delete;
+	BulkRingBufferEventSink& operator=(const BulkRingBufferEventSink&) = delete;
+
+	~BulkRingBufferEventSink() { flush(); }
+
+	void operator()(const OrderEvent& event) noexcept {
+		if constexpr (std::is_same_v<value_type, PackedOrderEvent>) {
+			if (!PackedOrderEvent::packable(event)) {
+				++dropped;
+				return;
+			}
+			block[staged++] = PackedOrderEvent::from_event(event);
+		} else {
+			block[staged++] = event;
+		}
+		if (staged == BlockSize) {
+			flush();
+		}
+	}
+
+	// Unpacked batches skip the staging block
+	void operator()(std::span<const OrderEvent> events) noexcept {
+		if constexpr (std::is_same_v<value_type, OrderEvent>) {
+			flush();
+			dropped += events.size() - buffer.push_bulk(events);
+		} else {
+			for (const OrderEvent& event : events) {
+				(*this)(event);
+			}
+		}
+	}
+
+	void flush() noexcept {
+		if (staged == 0)
+			return;
+		size_t pushed = buffer.push_bulk(std::span<const value_type>(block.data(), staged));
+		dropped += staged - pushed;
+		staged = 0;
+	}
+};
+
+// Queues L2 level deltas into their own ring buffer, counting overflow
+template <typename Buffer>
+struct RingBufferUpdateSink {
+	Buffer& buffer;
+	size_t dropped = 0;
+
+	void operator()(const BookUpdate& update) noexcept {
+		if (!buffer.push(update)) {
+			++dropped;
+		}
+	}
+};
+
+// Fans order events and level deltas out to two separate sinks
+template <EventSink Events, typename Updates>
+struct MarketDataSink {
+	Events events;
+	Updates updates;
+
+	void operator()(const OrderEvent& event) { events(event); }
+	void operator()(const BookUpdate& update) { updates(update); }
+
+	void operator()(std::span<const OrderEvent> batch)
+		requires EventBatchSink<Events>
+	{
+		events(batch);
+	}
+};
+
+// Passes everything on to sink, counting the fills that go through
+template <typename Sink>
+struct FillCountingSink {
+	Sink& sink;
+	size_t fills = 0;
+
+	void operator()(const OrderEvent& event) {
+		fills += event.type == OrderEventType::Fill;
+		sink(event);
+	}
+
+	void operator()(std::span<const OrderEvent> batch)
+		requires EventBatchSink<Sink>
+	{
+		for (const OrderEvent& event : batch) {
+			fills += event.type == OrderEventType::Fill;
+		}
+		sink(batch);
+	}
+
+	void operator()(const BookUpdate& update)
+		requires BookUpdateSink<Sink>
+	{
+		sink(update);
+	}
+};
+
+// Discards everything (replay, benchmarks)
+struct NullEventSink {
+	void operator()(const OrderEvent&) const noexcept {}
+	void operator()(std::span<const OrderEvent>) const noexcept {}
+};
+
+// Gathers events for sink into a local block and passes them on as spans;
+// for sinks that only take single events it forwards each one directly.
+// flush() before anything else reaches the sink, to keep events in order.
+template <typename Sink, size_t BlockSize = 32>
+struct EventBatcher {
+	Sink& sink;
+	std::array<OrderEvent, BlockSize> block;
+	size_t staged = 0;
+
+	explicit EventBatcher(Sink& target) noexcept : sink(target) {}
+
+	~EventBatcher() { flush(); }
+
+	void operator()(const OrderEvent& event) {
+		block[staged++] = event;
+		if (staged == BlockSize) {
+			flush();
+		}
+	}
+
+	void flush() {
+		if (staged == 0)
+			return;
+		sink(std::span<const OrderEvent>(block.data(), staged));
+		staged = 0;
+	}
+};
+
+template <typename Sink, size_t BlockSize>
+	requires(!EventBatchSink<Sink>)
+struct EventBatcher<Sink, BlockSize> {
+	Sink& sink;
+
+	explicit EventBatcher(Sink& target) noexcept : sink(target) {}
+
+	void operator()(const OrderEvent& event) { sink(event); }
+	void flush() noexcept {}
+};
+
+}	 // namespace matching_engine::matching
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/types.hpp"
+#include "../memory/mpmc_ring_buffer.hpp"
+#include "../scheduler/coro_scheduler.hpp"
+#include "../scheduler/thread_pool.hpp"
+#include "async_engine.hpp"
+
+namespace matching_engine::matching {
+
+// Many books, one per symbol, sharded over the workers of a ThreadPool.
+// Every shard owns a fixed subset of symbols (by symbol hash), an inbound
+// queue and a coroutine pinned to one worker, so each book is only ever
+// touched by that worker's thread. Acks, rejects and fills from all shards
+// are merged into one output queue.
+//
+// Lifecycle: add_symbol() for every instrument, then start(); submit()
+// from any thread; stop() (or the destructor) drains and joins the shards.
+template <typename Book = OrderBook, size_t InboundSize = 4096, size_t OutputSize = 16384>
+class MultiSymbolEngine {
+ public:
+	using InboundQueue = memory::MpmcRingBuffer<OrderEvent, InboundSize>;
+	using OutputQueue = memory::MpmcRingBuffer<OrderEvent, OutputSize>;
+
+ private:
+	struct Shard {
+		InboundQueue inbound;
+		std::unordered_map<uint32_t, std::unique_ptr<SyncMatchingEngine<Book>>> books;
+		std::atomic<size_t> processed{0};
+		std::atomic<size_t> dropped{0};	 // Output events lost to a full output queue
+	};
+
+	coro::ThreadPool& pool_;
+	std::vector<std::unique_ptr<Shard>> shards_;
+	std::vector<coro::Task<void>> drivers_;
+	OutputQueue output_;
+	bool running_ = false;
+
+	// Fibonacci hash so consecutive symbol ids spread over the shards
+	size_t shard_of(SymbolId symbol) const noexcept {
+		uint64_t h = uint64_t{symbol.value} * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>((h >> 32) % shards_.size());
+	}
+
+	void emit(Shard& shard, const OrderEvent& event) {
+		if (!output_.push(event)) {
+			shard.dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void handle(Shard& shard, const OrderEvent& event) {
+		auto it = shard.books.find(event.symbol.value);
+		if (it == shard.books.end()) {
+			OrderEvent rejected = event;
+			rejected.type = OrderEventType::Reject;
+			rejected.reject_reason = reject_reason_text(RejectReason::UnknownSymbol);
+			emit(shard, rejected);
+			return;
+		}
+
+		RingBufferEventSink sink{output_};
+		auto& engine = *it->second;
+		engine.refresh_clock();
+		auto result = engine.process_event(event, sink);
+		shard.dropped.fetch_add(sink.dropped, std::memory_order_relaxed);
+		emit(shard, result.value());
+	}
+
+	coro::Task<void> drive(Shard& shard, coro::Executor& worker) {
+		co_await coro::schedule_on(worker);
+		std::array<OrderEvent, 64> block;
+		for (;;) {
+			auto event = co_await shard.inbound.pop_async();
+			if (!event)
+				break;	// Closed and drained (the shard is the only consumer)
+			handle(shard, *event);
+
+			// Drain whatever else queued up behind it without re-parking
+			size_t n = 1;
+			while (size_t more = shard.inbound.pop_bulk(block)) {
+				for (size_t i = 0; i < more; ++i) {
+					handle(shard, block[i]);
+				}
+				n += more;
+			}
+			shard.processed.fetch_add(n, std::memory_order_relaxed);
+		}
+	}
+
+ public:
+	// shards defaults to one per pool worker
+	explicit MultiSymbolEngine(coro::ThreadPool& pool, size_t shards = 0) : pool_(pool) {
+		if (shards == 0) {
+			shards = pool.size();
+		}
+		shards_.reserve(shards);
+		for (size_t i = 0; i < shards; ++i) {
+			shards_.push_back(std::make_unique<Shard>());
+		}
+	}
+
+	MultiSymbolEngine(const MultiSymbolEngine&) = delete;
+	MultiSymbolEngine& operator=(const MultiSymbolEngine&) = delete;
+
+	~MultiSymbolEngine() { stop(); }
+
+	// Register a book; only before start(). config.symbol is overwritten.
+	bool add_symbol(SymbolId symbol, BookConfig config = {}) {
+		if (running_)
+			return false;
+		config.symbol = symbol;
+		auto& books = shards_[shard_of(symbol)]->books;
+		if (books.contains(symbol.value))
+			return false;
+		books.emplace(symbol.value, std::make_unique<SyncMatchingEngine<Book>>(config));
+		return true;
+	}
+
+	// Spawn one driver per shard, pinned round-robin onto the pool workers
+	void start() {
+		if (running_)
+			return;
+		running_ = true;
+		drivers_.reserve(shards_.size());
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			drivers_.push_back(drive(*shards_[i], pool_.worker(i % pool_.size())));
+			pool_.spawn(drivers_.back());
+		}
+	}
+
+	// Route an event to its symbol's shard; false if that shard's inbound
+	// queue is full (caller decides whether to retry or shed)
+	bool submit(const OrderEvent& event) {
+		return shards_[shard_of(event.symbol)]->inbound.push(event);
+	}
+
+	// Same, parking the calling coroutine while the shard is full
+	auto submit_async(const OrderEvent& event) {
+		return shards_[shard_of(event.symbol)]->inbound.push_async(event);
+	}
+
+	// Merged output: acks/rejects for every submitted event plus fills
+	std::optional<OrderEvent> poll() { return output_.pop(); }
+	size_t poll_bulk(std::span<OrderEvent> out) { return output_.pop_bulk(out); }
+	auto next_event_async() { return output_.pop_async(); }
+
+	// Close the inbound queues, let every shard drain, and wait for the
+	// drivers to finish. Also waits out any other work queued on the pool.
+	void stop() {
+		if (!running_)
+			return;
+		for (auto& shard : shards_) {
+			shard->inbound.close();
+		}
+		pool_.wait_idle();
+		drivers_.clear();
+		running_ = false;
+	}
+
+	size_t shard_count() const noexcept { return shards_.size(); }
+	size_t shard_for(SymbolId symbol) const noexcept { return shard_of(symbol); }
+
+	size_t processed() const noexcept {
+		size_t total = 0;
+		for (const auto& shard : shards_) {
+			total += shard->processed.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+	size_t dropped_events() const noexcept {
+		size_t total = 0;
+		for (const auto& shard : shards_) {
+			total += shard->dropped.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+};
+
+}	 // namespace matching_engine::matching
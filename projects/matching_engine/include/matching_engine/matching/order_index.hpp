@@ -0,0 +1,85 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "../core/types.hpp"
+#include "order_queue.hpp"
+
+namespace matching_engine::matching {
+
+// Fixed-capacity OrderId -> OrderNode* hash map. Open addressing with
+// linear probing and backward-shift deletion (no tombstones), sized once at
+// construction so lookups and updates never allocate.
+class OrderIndex {
+	struct Slot {
+		uint64_t key = 0;	 // 0 = empty (order ids start at 1)
+		OrderNode* node = nullptr;
+	};
+
+	std::pmr::vector<Slot> slots_;
+	size_t mask_;
+	size_t size_ = 0;
+
+	size_t home(uint64_t key) const noexcept {
+		// Fibonacci hashing spreads sequential ids across the table
+		return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+	}
+
+ public:
+	// Keeps the load factor at or below 1/2 for max_entries; the table comes
+	// from memory (the default resource when nullptr)
+	explicit OrderIndex(size_t max_entries, std::pmr::memory_resource* memory = nullptr)
+			: slots_(std::bit_ceil(max_entries * 2 < 2 ? size_t{2} : max_entries * 2),
+							 memory ? memory : std::pmr::get_default_resource()),
+				mask_(slots_.size() - 1) {}
+
+	size_t size() const noexcept { return size_; }
+
+	OrderNode* find(OrderId id) const noexcept {
+		for (size_t i = home(id.value);; i = (i + 1) & mask_) {
+			const Slot& slot = slots_[i];
+			if (slot.key == id.value)
+				return slot.node;
+			if (slot.key == 0)
+				return nullptr;
+		}
+	}
+
+	// Caller guarantees the id is not already present and capacity remains
+	void insert(OrderId id, OrderNode* node) noexcept {
+		size_t i = home(id.value);
+		while (slots_[i].key != 0) {
+			i = (i + 1) & mask_;
+		}
+		slots_[i] = Slot{id.value, node};
+		++size_;
+	}
+
+	bool erase(OrderId id) noexcept {
+		size_t i = home(id.value);
+		while (slots_[i].key != id.value) {
+			if (slots_[i].key == 0)
+				return false;
+			i = (i + 1) & mask_;
+		}
+
+		// Shift later members of the probe run back into the hole
+		size_t hole = i;
+		for (size_t j = (hole + 1) & mask_; slots_[j].key != 0; j = (j + 1) & mask_) {
+			size_t h = home(slots_[j].key);
+			// Move j if its home does not lie cyclically in (hole, j]
+			if (((j - h) & mask_) >= ((j - hole) & mask_)) {
+				slots_[hole] = slots_[j];
+				hole = j;
+			}
+		}
+		slots_[hole] = Slot{};
+		--size_;
+		return true;
+	}
+};
+
+}	 // namespace matching_engine::matching
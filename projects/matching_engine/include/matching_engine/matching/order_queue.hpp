@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "../core/types.hpp"
+
+namespace matching_engine::matching {
+
+// Simple order representation
+struct Order {
+	OrderId id;
+	Price price;
+	Quantity quantity;
+	Quantity filled{0};
+	Side side;
+	OrderType type;
+	Timestamp timestamp;
+
+	// Iceberg orders: quantity counts only what has been shown so far; the
+	// next slices (display at a time) come out of reserve
+	Quantity display{0};
+	Quantity reserve{0};
+
+	AccountId account{0};
+};
+
+// Resting order with intrusive links into its price level
+struct OrderNode {
+	Order order;
+	OrderNode* prev = nullptr;
+	OrderNode* next = nullptr;
+};
+
+// Intrusive doubly-linked FIFO of the orders resting at one price. The
+// queue never owns its nodes; unlinking an arbitrary node is O(1). It also
+// keeps the level's open quantity, so depth never has to walk the orders:
+// push/erase account for a node's unfilled remainder, and the book calls
+// reduce() whenever a resting order fills or shrinks in place. Iceberg
+// reserves are summed separately, as hidden quantity.
+class OrderQueue {
+	OrderNode* head_ = nullptr;
+	OrderNode* tail_ = nullptr;
+	size_t size_ = 0;
+	uint64_t open_quantity_ = 0;
+	uint64_t hidden_quantity_ = 0;
+
+	static uint64_t open_of(const OrderNode* node) noexcept {
+		return node->order.quantity.value - node->order.filled.value;
+	}
+
+ public:
+	class const_iterator {
+		const OrderNode* node_;
+
+	 public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Order;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Order*;
+		using reference = const Order&;
+
+		explicit const_iterator(const OrderNode* node = nullptr) noexcept : node_(node) {}
+
+		reference operator*() const noexcept { return node_->order; }
+		pointer operator->() const noexcept { return &node_->order; }
+
+		const_iterator& operator++() noexcept {
+			node_ = node_->next;
+			return *this;
+		}
+
+		const_iterator operator++(int) noexcept {
+			auto tmp = *this;
+			node_ = node_->next;
+			return tmp;
+		}
+
+		bool operator==(const const_iterator&) const = default;
+	};
+
+	bool empty() const noexcept { return head_ == nullptr; }
+	size_t size() const noexcept { return size_; }
+
+	// Unfilled quantity across all orders at this level
+	Quantity open_quantity() const noexcept { return Quantity{open_quantity_}; }
+
+	// Iceberg reserve behind the shown quantity
+	Quantity hidden_quantity() const noexcept { return Quantity{hidden_quantity_}; }
+
+	// A resting order lost quantity (fill or in-place reduction)
+	void reduce(Quantity quantity) noexcept { open_quantity_ -= quantity.value; }
+	void reduce_hidden(Quantity quantity) noexcept { hidden_quantity_ -= quantity.value; }
+
+	Order& front() noexcept { return head_->order; }
+	OrderNode* front_node() noexcept { return head_; }
+
+	void push_back(OrderNode* node) noexcept {
+		node->prev = tail_;
+		node->next = nullptr;
+		if (tail_) {
+			tail_->next = node;
+		} else {
+			head_ = node;
+		}
+		tail_ = node;
+		++size_;
+		open_quantity_ += open_of(node);
+		hidden_quantity_ += node->order.reserve.value;
+	}
+
+	OrderNode* pop_front() noexcept {
+		OrderNode* node = head_;
+		erase(node);
+		return node;
+	}
+
+	void erase(OrderNode* node) noexcept {
+		if (node->prev) {
+			node->prev->next = node->next;
+		} else {
+			head_ = node->next;
+		}
+		if (node->next) {
+			node->next->prev = node->prev;
+		} else {
+			tail_ = node->prev;
+		}
+		node->prev = node->next = nullptr;
+		--size_;
+		open_quantity_ -= open_of(node);
+		hidden_quantity_ -= node->order.reserve.value;
+	}
+
+	// Detach every node at once, leaving the level empty. Returns the old
+	// head; the chain still runs through next until the caller reuses it.
+	OrderNode* take_all() noexcept {
+		OrderNode* head = head_;
+		head_ = tail_ = nullptr;
+		size_ = 0;
+		open_quantity_ = 0;
+		hidden_quantity_ = 0;
+		return head;
+	}
+
+	const_iterator begin() const noexcept { return const_iterator{head_}; }
+	const_iterator end() const noexcept { return const_iterator{}; }
+};
+
+}	 // namespace matching_engine::matching
@@ -1,29 +1,39 @@
 #pragma once
 
-#include <list>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
+#include "../core/clock.hpp"
 #include "../core/types.hpp"
+#include "../memory/object_pool.hpp"
+#include "event_sink.hpp"
+#include "order_index.hpp"
+#include "order_queue.hpp"
+#include "price_levels.hpp"
+#include "risk.hpp"
 
 namespace matching_engine::matching {
 
-// Simple order representation
-struct Order {
-	OrderId id;
-	Price price;
-	Quantity quantity;
-	Quantity filled{0};
-	Side side;
-	OrderType type;
-	Timestamp timestamp;
-};
-
 // Market depth level
 struct DepthLevel {
 	Price price;
 	Quantity quantity;
+	size_t orders = 0;
+};
+
+// Top-N depth in fixed storage. The caller owns one per book and refills it
+// with snapshot_depth(), which costs O(N) and never allocates.
+template <size_t N>
+struct DepthSnapshot {
+	std::array<DepthLevel, N> bids{};
+	std::array<DepthLevel, N> asks{};
+	size_t bid_levels = 0;
+	size_t ask_levels = 0;
+	uint64_t sequence = 0;	// Last BookUpdate::sequence reflected here
 };
 
 // Market depth snapshot
@@ -64,53 +74,297 @@ class MarketDepth {
 	}
 };
 
-// Simple orderbook implementation
-class OrderBook {
+// Price-time priority orderbook. The Levels template picks how each side
+// indexes its price levels (see price_levels.hpp); matching logic is shared.
+// Resting orders live in a fixed-capacity node pool and are linked into
+// their level's FIFO intrusively, with an OrderId index for O(1) cancel.
+// Clock is read once per operation (see clock.hpp); Risk vets orders
+// before they trade and follows each account's exposure (see risk.hpp).
+template <template <typename, Side> class Levels, Clock BookClock = SystemClock,
+					RiskPolicy Risk = NoRiskChecks>
+class BasicOrderBook {
+ public:
+	// Orders resting at one price, FIFO for time priority
+	using Level = OrderQueue;
+
  private:
-	// Price -> list of orders at that price (FIFO for time priority)
-	std::map<Price, std::list<Order>, std::greater<>> bids_;	// Descending
-	std::map<Price, std::list<Order>, std::less<>> asks_;			// Ascending
+	Levels<Level, Side::Buy> bids_;		// Best = highest
+	Levels<Level, Side::Sell> asks_;	// Best = lowest
+
+	memory::ObjectPool<OrderNode> pool_;
+	OrderIndex index_;
+	BookClock clock_;
+	Risk risk_;
+	SymbolId symbol_;
+	SelfTradePrevention self_trade_;
+	TickTable ticks_;
 
 	size_t order_count_ = 0;
 	uint64_t next_order_id_ = 1;
+	uint64_t update_sequence_ = 0;	// Level changes so far (see BookUpdate)
 
 	std::vector<OrderEvent> pending_events_;
 
  public:
-	// Add order and match
+	explicit BasicOrderBook(const BookConfig& config = {})
+			: bids_(config),
+				asks_(config),
+				pool_(config.max_orders, config.memory),
+				index_(config.max_orders, config.memory),
+				risk_(config),
+				symbol_(config.symbol),
+				self_trade_(config.self_trade),
+				ticks_(config.ticks) {}
+
+	// Non-copyable, non-movable (levels hold pointers into the pool)
+	BasicOrderBook(const BasicOrderBook&) = delete;
+	BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+
+	// Add order and match; fills are buffered for take_events()
 	Result<OrderEvent> add_order(Price price, Quantity quantity, Side side,
 															 OrderType type = OrderType::Limit) {
+		return add_order(price, quantity, side, type, default_sink());
+	}
+
+	// Add order and match, handing each fill to sink as it happens. The
+	// runtime type is switched on once, into the add_order<Type> instance
+	// for it. display is the iceberg peak size; other types ignore it.
+	template <EventSink Sink>
+	Result<OrderEvent> add_order(Price price, Quantity quantity, Side side, OrderType type,
+															 Sink&& sink, Quantity display = Quantity{0},
+															 AccountId account = AccountId{0}) {
+		switch (type) {
+			case OrderType::Limit:
+				return add_order<OrderType::Limit>(price, quantity, side, sink, display, account);
+			case OrderType::Market:
+				return add_order<OrderType::Market>(price, quantity, side, sink, display, account);
+			case OrderType::ImmediateOrCancel:
+				return add_order<OrderType::ImmediateOrCancel>(price, quantity, side, sink, display,
+																											 account);
+			case OrderType::FillOrKill:
+				return add_order<OrderType::FillOrKill>(price, quantity, side, sink, display, account);
+			case OrderType::PostOnly:
+				return add_order<OrderType::PostOnly>(price, quantity, side, sink, display, account);
+			case OrderType::Iceberg:
+				return add_order<OrderType::Iceberg>(price, quantity, side, sink, display, account);
+		}
+		return reject(OrderEvent{.type = OrderEventType::New,
+														 .symbol = symbol_,
+														 .account = account,
+														 .price = price,
+														 .quantity = quantity,
+														 .side = side,
+														 .order_type = type},
+									RejectReason::Other);
+	}
+
+	// One order type, resolved at compile time: each instance carries only
+	// the checks its type needs, so a plain limit order runs the same code
+	// as before the other types existed. Callers that know the type
+	// statically can call this directly.
+	template <OrderType Type, EventSink Sink>
+	Result<OrderEvent> add_order(Price price, Quantity quantity, Side side, Sink&& sink,
+															 Quantity display = Quantity{0}, AccountId account = AccountId{0}) {
+		constexpr bool rests =
+				Type == OrderType::Limit || Type == OrderType::PostOnly || Type == OrderType::Iceberg;
+		constexpr bool priced = Type != OrderType::Market;
+
 		Order order{.id = OrderId{next_order_id_++},
 								.price = price,
 								.quantity = quantity,
 								.filled = Quantity{0},
 								.side = side,
-								.type = type,
-								.timestamp = Timestamp::now()};
+								.type = Type,
+								.timestamp = clock_.now(),
+								.display = Type == OrderType::Iceberg ? display : Quantity{0},
+								.account = account};
 
 		OrderEvent event{.type = OrderEventType::New,
 										 .order_id = order.id,
+										 .symbol = symbol_,
+										 .account = account,
 										 .price = order.price,
 										 .quantity = order.quantity,
+										 .display_quantity = order.display,
 										 .side = order.side,
 										 .order_type = order.type,
 										 .timestamp = order.timestamp};
 
-		// Try to match
-		if (side == Side::Buy) {
-			match_buy_order(order, event);
+		if constexpr (priced) {
+			if (!ticks_.on_tick(price)) {
+				return reject(event, RejectReason::OffTick);
+			}
+		}
+
+		// An order that may rest must be able to rest at its price
+		if constexpr (rests) {
+			if (!accepts(side, price)) {
+				return reject(event, RejectReason::PriceOutOfRange);
+			}
+			if (pool_.full()) {
+				return reject(event, RejectReason::CapacityExhausted);
+			}
+		}
+
+		// A market order is valued at what its sweep would cost
+		Price valued_at = price;
+		if constexpr (!priced && !std::is_same_v<Risk, NoRiskChecks>) {
+			valued_at = sweep_price(side, quantity);
+		}
+		if (RejectReason risk = risk_.check(account, side, valued_at, quantity);
+				risk != RejectReason::None) {
+			return reject(event, risk);
+		}
+
+		if constexpr (Type == OrderType::PostOnly) {
+			if (would_cross(side, price)) {
+				return reject(event, RejectReason::WouldCross);
+			}
+			event.fill_info.remaining_quantity = quantity;
 		} else {
-			match_sell_order(order, event);
+			if constexpr (Type == OrderType::FillOrKill) {
+				if (RejectReason unfillable = fill_or_kill_check(order);
+						unfillable != RejectReason::None) {
+					return reject(event, unfillable);
+				}
+			}
+			match<priced>(order, event, sink);
 		}
 
 		// If not fully filled, add to book
-		if (order.filled.value < order.quantity.value && type == OrderType::Limit) {
-			if (side == Side::Buy) {
-				bids_[order.price].push_back(order);
-			} else {
-				asks_[order.price].push_back(order);
+		if constexpr (rests) {
+			if (order.filled.value < order.quantity.value) {
+				if constexpr (Type == OrderType::Iceberg) {
+					hide_reserve(order);
+				}
+				rest(pool_.allocate(OrderNode{.order = order}), sink);
 			}
-			++order_count_;
+		}
+
+		return Result<OrderEvent>::Ok(event);
+	}
+
+	// Remove a resting order
+	Result<OrderEvent> cancel_order(OrderId id) { return cancel_order(id, default_sink()); }
+
+	template <EventSink Sink>
+	Result<OrderEvent> cancel_order(OrderId id, Sink&& sink) {
+		OrderNode* node = index_.find(id);
+		if (!node) {
+			return reject(OrderEvent{.type = OrderEventType::Cancel, .order_id = id, .symbol = symbol_},
+										RejectReason::UnknownOrder);
+		}
+
+		const Order& order = node->order;
+		OrderEvent event{.type = OrderEventType::Cancel,
+										 .order_id = order.id,
+										 .symbol = symbol_,
+										 .account = order.account,
+										 .price = order.price,
+										 .quantity = Quantity{open_of(order)},
+										 .display_quantity = order.display,
+										 .side = order.side,
+										 .order_type = order.type,
+										 .timestamp = clock_.now()};
+
+		unlink(node, sink);
+		release(node);
+		return Result<OrderEvent>::Ok(event);
+	}
+
+	// Change price and/or total quantity of a resting order. Shrinking the
+	// quantity at the same price keeps time priority; anything else re-enters
+	// the order at the back of the queue and may trade (a post-only order
+	// that would is rejected instead). A quantity at or below what has
+	// already filled cancels the order. An iceberg's quantity is its total,
+	// shown and hidden; shrinking takes the hidden part first.
+	Result<OrderEvent> modify_order(OrderId id, Price new_price, Quantity new_quantity) {
+		return modify_order(id, new_price, new_quantity, default_sink());
+	}
+
+	template <EventSink Sink>
+	Result<OrderEvent> modify_order(OrderId id, Price new_price, Quantity new_quantity,
+																	Sink&& sink) {
+		OrderNode* node = index_.find(id);
+		if (!node) {
+			return reject(OrderEvent{.type = OrderEventType::Modify, .order_id = id, .symbol = symbol_},
+										RejectReason::UnknownOrder);
+		}
+
+		Order& order = node->order;
+		if (new_quantity.value <= order.filled.value) {
+			return cancel_order(id, sink);
+		}
+		RejectReason invalid = RejectReason::None;
+		if (!accepts(order.side, new_price)) {
+			invalid = RejectReason::PriceOutOfRange;
+		} else if (!ticks_.on_tick(new_price)) {
+			invalid = RejectReason::OffTick;
+		}
+		if (invalid != RejectReason::None) {
+			return reject(OrderEvent{.type = OrderEventType::Modify,
+															 .order_id = id,
+															 .symbol = symbol_,
+															 .account = order.account,
+															 .price = new_price,
+															 .quantity = new_quantity,
+															 .side = order.side,
+															 .order_type = order.type},
+										invalid);
+		}
+
+		OrderEvent event{.type = OrderEventType::Modify,
+										 .order_id = order.id,
+										 .symbol = symbol_,
+										 .account = order.account,
+										 .price = new_price,
+										 .quantity = new_quantity,
+										 .display_quantity = order.display,
+										 .side = order.side,
+										 .order_type = order.type,
+										 .timestamp = clock_.now()};
+
+		// In-place reduction keeps the node where it is
+		uint64_t total = order.quantity.value + order.reserve.value;
+		if (new_price == order.price && new_quantity.value <= total) {
+			Level* level = level_of(order);
+			uint64_t cut = total - new_quantity.value;
+			Quantity hidden{std::min(cut, order.reserve.value)};
+			order.reserve.value -= hidden.value;
+			level->reduce_hidden(hidden);
+			level->reduce(Quantity{cut - hidden.value});
+			order.quantity.value -= cut - hidden.value;
+			risk_.closed(order.account, order.side, Quantity{cut});
+			level_changed(sink, order.side, order.price, level);
+			event.fill_info.remaining_quantity = Quantity{open_of(order)};
+			return Result<OrderEvent>::Ok(event);
+		}
+
+		if (order.type == OrderType::PostOnly && would_cross(order.side, new_price)) {
+			return reject(event, RejectReason::WouldCross);
+		}
+		Quantity new_open{new_quantity.value - order.filled.value};
+		if (RejectReason risk =
+						risk_.check(order.account, order.side, new_price, new_open, Quantity{open_of(order)});
+				risk != RejectReason::None) {
+			return reject(event, risk);
+		}
+
+		// Cancel/replace: pull the node, re-match, rest the remainder in the same node
+		unlink(node, sink);
+		order.price = new_price;
+		order.quantity = new_quantity;
+		order.reserve = Quantity{0};
+		order.timestamp = event.timestamp;
+
+		event.fill_info.filled_quantity = order.filled;
+		match<true>(order, event, sink);
+
+		if (order.filled.value < order.quantity.value) {
+			hide_reserve(order);
+			rest(node, sink);
+		} else {
+			release(node);
 		}
 
 		return Result<OrderEvent>::Ok(event);
@@ -119,169 +373,564 @@ class OrderBook {
 	std::optional<Price> get_best_bid() const {
 		if (bids_.empty())
 			return std::nullopt;
-		return bids_.begin()->first;
+		return bids_.best_price();
 	}
 
 	std::optional<Price> get_best_ask() const {
 		if (asks_.empty())
 			return std::nullopt;
-		return asks_.begin()->first;
+		return asks_.best_price();
 	}
 
 	MarketDepth get_market_depth(size_t max_levels = 10) const {
 		MarketDepth depth;
+		collect_depth(bids_, max_levels, [&](const DepthLevel& level) {
+			depth.add_bid(level.price, level.quantity);
+		});
+		collect_depth(asks_, max_levels, [&](const DepthLevel& level) {
+			depth.add_ask(level.price, level.quantity);
+		});
+		return depth;
+	}
 
-		size_t count = 0;
-		for (const auto& [price, orders] : bids_) {
-			if (count >= max_levels)
-				break;
-
-			Quantity total{0};
-			for (const auto& order : orders) {
-				total.value += (order.quantity.value - order.filled.value);
-			}
+	// Refill snapshot with the best N levels of each side
+	template <size_t N>
+	void snapshot_depth(DepthSnapshot<N>& snapshot) const {
+		snapshot.bid_levels = 0;
+		collect_depth(bids_, N, [&](const DepthLevel& level) {
+			snapshot.bids[snapshot.bid_levels++] = level;
+		});
+		snapshot.ask_levels = 0;
+		collect_depth(asks_, N, [&](const DepthLevel& level) {
+			snapshot.asks[snapshot.ask_levels++] = level;
+		});
+		snapshot.sequence = update_sequence_;
+	}
 
-			if (total.value > 0) {
-				depth.add_bid(price, total);
-				++count;
-			}
+	// Visit one side's levels best-first until f(Price, const Level&)
+	// returns false
+	template <typename F>
+	void for_each_level(Side side, F&& f) const {
+		if (side == Side::Buy) {
+			bids_.for_each(f);
+		} else {
+			asks_.for_each(f);
 		}
+	}
 
-		count = 0;
-		for (const auto& [price, orders] : asks_) {
-			if (count >= max_levels)
-				break;
-
-			Quantity total{0};
-			for (const auto& order : orders) {
-				total.value += (order.quantity.value - order.filled.value);
-			}
+	// Visit every resting order: bids then asks, best level first, time
+	// priority within a level. Re-resting them in this order rebuilds the
+	// same queues.
+	template <typename F>
+	void for_each_order(F&& f) const {
+		for (Side side : {Side::Buy, Side::Sell}) {
+			for_each_level(side, [&](Price, const Level& level) {
+				for (const Order& order : level) {
+					f(order);
+				}
+				return true;
+			});
+		}
+	}
 
-			if (total.value > 0) {
-				depth.add_ask(price, total);
-				++count;
-			}
+	// Put a previously resting order back verbatim (id, fills, timestamp),
+	// at the back of its level. For rebuilding a book from a snapshot; false
+	// if the order cannot rest here.
+	bool restore_order(const Order& order) {
+		if (order.filled.value >= order.quantity.value || !accepts(order.side, order.price) ||
+				index_.find(order.id)) {
+			return false;
 		}
+		OrderNode* node = pool_.allocate(OrderNode{.order = order});
+		if (!node)
+			return false;
+		NullEventSink sink;
+		rest(node, sink);
+		if (order.id.value >= next_order_id_) {
+			next_order_id_ = order.id.value + 1;
+		}
+		return true;
+	}
 
-		return depth;
+	uint64_t next_order_id() const { return next_order_id_; }
+
+	// Resume id assignment and the update sequence where a snapshot left off
+	void restore_counters(uint64_t next_order_id, uint64_t update_sequence) {
+		next_order_id_ = next_order_id;
+		update_sequence_ = update_sequence;
 	}
 
+	// Clock policy instance, for injecting time (replay, batching)
+	const BookClock& clock() const { return clock_; }
+	BookClock& clock() { return clock_; }
+
+	// Risk policy instance, for setting limits and reading exposure
+	const Risk& risk() const { return risk_; }
+	Risk& risk() { return risk_; }
+
+	SymbolId symbol() const { return symbol_; }
+	const TickTable& ticks() const { return ticks_; }
+	uint64_t update_sequence() const { return update_sequence_; }
 	size_t order_count() const { return order_count_; }
 	size_t bid_levels() const { return bids_.size(); }
 	size_t ask_levels() const { return asks_.size(); }
 
 	std::vector<OrderEvent> take_events() { return std::move(pending_events_); }
 
+	// Sink that feeds take_events()
+	VectorEventSink default_sink() { return VectorEventSink{pending_events_}; }
+
  private:
-	void match_buy_order(Order& order, OrderEvent& event) {
-		while (!asks_.empty() && order.filled.value < order.quantity.value) {
-			auto& [ask_price, ask_orders] = *asks_.begin();
+	bool accepts(Side side, Price price) const noexcept {
+		return side == Side::Buy ? bids_.accepts(price) : asks_.accepts(price);
+	}
 
-			// Check if we can match
-			if (order.type == OrderType::Market || order.price.ticks >= ask_price.ticks) {
-				if (ask_orders.empty()) {
-					asks_.erase(asks_.begin());
+	static Result<OrderEvent> reject(OrderEvent event, RejectReason reason) {
+		event.type = OrderEventType::Reject;
+		event.reject_reason = reject_reason_text(reason);
+		return Result<OrderEvent>(false, event);
+	}
+
+	// Quantity still to trade, shown and hidden
+	static uint64_t open_of(const Order& order) noexcept {
+		return order.quantity.value - order.filled.value + order.reserve.value;
+	}
+
+	// An iceberg about to rest shows display and holds the rest back
+	static void hide_reserve(Order& order) noexcept {
+		uint64_t open = order.quantity.value - order.filled.value;
+		if (order.display.value > 0 && open > order.display.value) {
+			order.reserve = Quantity{open - order.display.value};
+			order.quantity.value -= order.reserve.value;
+		}
+	}
+
+	// An iceberg's shown slice traded out: show the next one
+	static void next_slice(Order& order) noexcept {
+		Quantity slice{std::min(order.display.value, order.reserve.value)};
+		order.reserve.value -= slice.value;
+		order.quantity.value += slice.value;
+	}
+
+	static bool crosses(Side side, Price limit, Price contra_price) noexcept {
+		return side == Side::Buy ? limit.ticks >= contra_price.ticks
+														 : limit.ticks <= contra_price.ticks;
+	}
+
+	// Whether an order at price would trade against the best contra level
+	bool would_cross(Side side, Price price) const noexcept {
+		if (side == Side::Buy) {
+			return !asks_.empty() && crosses(side, price, asks_.best_price());
+		}
+		return !bids_.empty() && crosses(side, price, bids_.best_price());
+	}
+
+	// Price a market order on side is risk-checked at: the cost of sweeping
+	// quantity through the contra levels, shown and hidden, divided by
+	// quantity and rounded up, so price * quantity covers every level the
+	// sweep reaches, not just the best. With no contra side it is 0, which
+	// is safe: a market order never rests, so what finds nothing to trade
+	// against opens no exposure.
+	Price sweep_price(Side side, Quantity quantity) const {
+		unsigned __int128 cost = 0;
+		uint64_t left = quantity.value;
+		auto add = [&](Price price, const Level& level) {
+			uint64_t take =
+					std::min(left, level.open_quantity().value + level.hidden_quantity().value);
+			uint64_t ticks = price.ticks < 0 ? 0 - static_cast<uint64_t>(price.ticks)
+																			 : static_cast<uint64_t>(price.ticks);
+			cost += static_cast<unsigned __int128>(ticks) * take;
+			left -= take;
+			return left > 0;
+		};
+		if (side == Side::Buy) {
+			asks_.for_each(add);
+		} else {
+			bids_.for_each(add);
+		}
+		if (quantity.value == 0)
+			return Price{0};
+		unsigned __int128 per_unit = (cost + quantity.value - 1) / quantity.value;
+		if (per_unit > static_cast<unsigned __int128>(INT64_MAX))
+			return Price{INT64_MAX};	// Fails any notional limit
+		return Price{static_cast<int64_t>(per_unit)};
+	}
+
+	// Whether the contra side holds the order's whole quantity, shown or
+	// hidden, at prices it accepts: NotFillable if not. Under self-trade
+	// prevention the order's own account does not count: with CancelOldest
+	// those resting orders are cancelled on the way, so they are skipped;
+	// otherwise meeting one would cut the order short, so a FOK that would
+	// reach one before it is filled is rejected as SelfTrade.
+	RejectReason fill_or_kill_check(const Order& order) const {
+		bool guarded = self_trade_ != SelfTradePrevention::None && order.account.value != 0;
+		uint64_t available = 0;
+		RejectReason reason = RejectReason::None;
+		auto count = [&](Price price, const Level& level) {
+			if (!crosses(order.side, order.price, price))
+				return false;
+			if (!guarded) {
+				available += level.open_quantity().value + level.hidden_quantity().value;
+				return available < order.quantity.value;
+			}
+			// Shown quantity trades in queue order; reserves only after it
+			uint64_t hidden = 0;
+			for (const Order& resting : level) {
+				if (resting.account == order.account) {
+					if (self_trade_ != SelfTradePrevention::CancelOldest) {
+						reason = RejectReason::SelfTrade;
+						return false;
+					}
 					continue;
 				}
+				available += open_of(resting);
+				hidden += resting.reserve.value;
+				if (available >= order.quantity.value)
+					return false;
+			}
+			available += hidden;
+			return available < order.quantity.value;
+		};
+		if (order.side == Side::Buy) {
+			asks_.for_each(count);
+		} else {
+			bids_.for_each(count);
+		}
+		if (available >= order.quantity.value)
+			return RejectReason::None;
+		return reason != RejectReason::None ? reason : RejectReason::NotFillable;
+	}
+
+	// Count a level change and, if the sink takes them, publish its new
+	// aggregate (level == nullptr once the level is gone)
+	template <typename Sink>
+	void level_changed(Sink& sink, Side side, Price price, const Level* level) {
+		++update_sequence_;
+		Quantity open = level ? level->open_quantity() : Quantity{0};
+		if (side == Side::Buy) {
+			note_quantity(bids_, price, open);
+		} else {
+			note_quantity(asks_, price, open);
+		}
+		if constexpr (BookUpdateSink<Sink>) {
+			sink(BookUpdate{.sequence = update_sequence_,
+											.price = price,
+											.quantity = open,
+											.symbol = symbol_,
+											.orders = level ? static_cast<uint32_t>(level->size()) : 0u,
+											.side = side});
+		}
+	}
 
-				auto& resting_order = ask_orders.front();
-				Quantity resting_qty{resting_order.quantity.value - resting_order.filled.value};
-				Quantity incoming_qty{order.quantity.value - order.filled.value};
-				Quantity fill_qty{std::min(resting_qty.value, incoming_qty.value)};
+	// Layouts that mirror level quantities (for plan_sweep) hear of each change
+	template <typename Side_>
+	static void note_quantity(Side_& levels, Price price, Quantity open) noexcept {
+		if constexpr (requires { levels.note_quantity(price, open); }) {
+			levels.note_quantity(price, open);
+		}
+	}
 
-				// Execute trade at resting order price
-				order.filled.value += fill_qty.value;
-				resting_order.filled.value += fill_qty.value;
-
-				// Record fill event
-				OrderEvent fill_event{
-						.type = OrderEventType::Fill,
-						.order_id = order.id,
-						.price = ask_price,
-						.quantity = fill_qty,
-						.side = order.side,
-						.order_type = order.type,
-						.timestamp = Timestamp::now(),
-						.fill_info =
-								FillInfo{.filled_quantity = fill_qty,
-												 .remaining_quantity = Quantity{order.quantity.value - order.filled.value},
-												 .fill_price = ask_price,
-												 .fill_time = Timestamp::now()}};
-
-				pending_events_.push_back(fill_event);
-				event.fill_info.filled_quantity.value += fill_qty.value;
-				event.fill_info.fill_price = ask_price;
-
-				// Remove if fully filled
-				if (resting_order.filled.value >= resting_order.quantity.value) {
-					ask_orders.pop_front();
-					--order_count_;
-					if (ask_orders.empty()) {
-						asks_.erase(asks_.begin());
+	// Append a pooled order to the back of its level and index it
+	template <typename Sink>
+	void rest(OrderNode* node, Sink& sink) {
+		const Order& order = node->order;
+		Level* level = order.side == Side::Buy ? bids_.insert(order.price) : asks_.insert(order.price);
+		level->push_back(node);
+		index_.insert(order.id, node);
+		++order_count_;
+		risk_.opened(order.account, order.side, Quantity{open_of(order)});
+		level_changed(sink, order.side, order.price, level);
+	}
+
+	// Detach a resting order from its level (dropping the level if it empties)
+	template <typename Sink>
+	void unlink(OrderNode* node, Sink& sink) {
+		const Order& order = node->order;
+		const Level* level =
+				order.side == Side::Buy ? unlink_from(bids_, node) : unlink_from(asks_, node);
+		index_.erase(order.id);
+		--order_count_;
+		risk_.closed(order.account, order.side, Quantity{open_of(order)});
+		level_changed(sink, order.side, order.price, level);
+	}
+
+	// Returns the level, or nullptr if removing node emptied it
+	template <typename Side_>
+	static const Level* unlink_from(Side_& levels, OrderNode* node) {
+		Level* level = levels.find(node->order.price);
+		level->erase(node);
+		if (level->empty()) {
+			levels.erase(node->order.price);
+			return nullptr;
+		}
+		return level;
+	}
+
+	void release(OrderNode* node) { pool_.deallocate(node); }
+
+	Level* level_of(const Order& order) {
+		return order.side == Side::Buy ? bids_.find(order.price) : asks_.find(order.price);
+	}
+
+	// Hand the best max_levels non-empty levels of one side to out
+	template <typename Side_, typename Out>
+	static void collect_depth(const Side_& levels, size_t max_levels, Out&& out) {
+		size_t count = 0;
+		levels.for_each([&](Price price, const Level& orders) {
+			if (count >= max_levels)
+				return false;
+			if (orders.open_quantity().value > 0) {
+				out(DepthLevel{price, orders.open_quantity(), orders.size()});
+				++count;
+			}
+			return true;
+		});
+	}
+
+	// Trade order against the opposite side; unpriced (market) orders take
+	// any price
+	template <bool Priced, EventSink Sink>
+	void match(Order& order, OrderEvent& event, Sink& sink) {
+		Quantity filled_before = order.filled;
+		if (order.side == Side::Buy) {
+			match_against<Priced>(
+					asks_, order, event, sink,
+					[](Price limit, Price ask_price) { return limit.ticks >= ask_price.ticks; });
+		} else {
+			match_against<Priced>(
+					bids_, order, event, sink,
+					[](Price limit, Price bid_price) { return limit.ticks <= bid_price.ticks; });
+		}
+		risk_.filled(order.account, order.side, order.filled - filled_before);
+	}
+
+	// Self-trade prevention applies to this pair of orders
+	bool self_match(const Order& incoming, const Order& resting) const noexcept {
+		return self_trade_ != SelfTradePrevention::None && incoming.account.value != 0 &&
+					 incoming.account == resting.account;
+	}
+
+	// Unsolicited cancel of quantity from order by self-trade prevention
+	OrderEvent self_trade_cancel(const Order& order, Quantity quantity,
+															 Timestamp timestamp) const noexcept {
+		return OrderEvent{.type = OrderEventType::Cancel,
+											.order_id = order.id,
+											.symbol = symbol_,
+											.account = order.account,
+											.price = order.price,
+											.quantity = quantity,
+											.display_quantity = order.display,
+											.side = order.side,
+											.order_type = order.type,
+											.timestamp = timestamp,
+											.reject_reason = reject_reason_text(RejectReason::SelfTrade)};
+	}
+
+	// The incoming order met one of its own account's orders at the front
+	// of the best contra level; apply the configured prevention instead of
+	// trading. Returns false once the incoming order has nothing left.
+	template <typename Contra, typename Sink>
+	bool prevent_self_trade(Contra& contra, Order& order, const OrderEvent& event, Sink& sink) {
+		Level& level = contra.best();
+		OrderNode* node = level.front_node();
+		Order& resting = node->order;
+		Quantity incoming_open{order.quantity.value - order.filled.value};
+		Quantity resting_open{resting.quantity.value - resting.filled.value};
+
+		switch (self_trade_) {
+			case SelfTradePrevention::None:
+			case SelfTradePrevention::CancelNewest:
+				sink(self_trade_cancel(order, incoming_open, event.timestamp));
+				order.quantity = order.filled;
+				return false;
+
+			case SelfTradePrevention::CancelOldest:
+				sink(self_trade_cancel(resting, Quantity{open_of(resting)}, event.timestamp));
+				unlink(node, sink);
+				release(node);
+				return true;
+
+			case SelfTradePrevention::Decrement: {
+				Quantity cut{std::min(incoming_open.value, resting_open.value)};
+				order.quantity -= cut;
+				if (cut == resting_open && resting.reserve.value == 0) {
+					sink(self_trade_cancel(resting, cut, event.timestamp));
+					unlink(node, sink);
+					release(node);
+				} else {
+					// An iceberg whose slice is gone shows the next one, as after a fill
+					Price price = contra.best_price();
+					level.reduce(cut);
+					resting.quantity -= cut;
+					risk_.closed(resting.account, resting.side, cut);
+					if (cut == resting_open) {
+						level.pop_front();
+						next_slice(resting);
+						level.push_back(node);
 					}
+					level_changed(sink, resting.side, price, &level);
 				}
-			} else {
-				break;	// No more matches possible
+				if (order.filled.value < order.quantity.value)
+					return true;
+				sink(self_trade_cancel(order, cut, event.timestamp));
+				return false;
 			}
 		}
+		return false;
+	}
 
-		event.fill_info.remaining_quantity = Quantity{order.quantity.value - order.filled.value};
+	// Fill of the incoming order against one resting order at price
+	OrderEvent fill_event(const Order& order, const OrderEvent& event, Price price,
+												Quantity quantity) const noexcept {
+		return OrderEvent{
+				.type = OrderEventType::Fill,
+				.order_id = order.id,
+				.symbol = symbol_,
+				.account = order.account,
+				.price = price,
+				.quantity = quantity,
+				.side = order.side,
+				.order_type = order.type,
+				.timestamp = event.timestamp,
+				.fill_info =
+						FillInfo{.filled_quantity = quantity,
+										 .remaining_quantity = Quantity{order.quantity.value - order.filled.value},
+										 .fill_price = price,
+										 .fill_time = event.timestamp}};
 	}
 
-	void match_sell_order(Order& order, OrderEvent& event) {
-		while (!bids_.empty() && order.filled.value < order.quantity.value) {
-			auto& [bid_price, bid_orders] = *bids_.begin();
+	// Flat-layout fast path for orders that take out whole levels: one pass
+	// over the side's quantity mirror says how many levels the order
+	// exhausts, and each of those is drained in a single walk of its queue,
+	// its fills going to the sink as one batch and its removal as one L2
+	// delta. The level the order only dips into is left to match_against.
+	template <bool Priced, typename Contra, EventSink Sink>
+	void sweep_levels(Contra& contra, Order& order, OrderEvent& event, Sink& sink) {
+		std::optional<Price> limit;
+		if constexpr (Priced) {
+			limit = order.price;
+		}
+		// Orders that may meet their own account take the per-order path
+		if (self_trade_ != SelfTradePrevention::None && order.account.value != 0)
+			return;
+		SweepPlan plan = contra.plan_sweep(Quantity{order.quantity.value - order.filled.value}, limit);
+		if (plan.levels == 0)
+			return;
+
+		Side contra_side = order.side == Side::Buy ? Side::Sell : Side::Buy;
+		EventBatcher<Sink> fills(sink);
+		for (size_t i = 0; i < plan.levels; ++i) {
+			Price level_price = contra.best_price();
+			Level& level = contra.best();
+			Quantity level_qty = level.open_quantity();
+			for (OrderNode* node = level.take_all(); node;) {
+				OrderNode* next = node->next;
+				Quantity fill_qty{node->order.quantity.value - node->order.filled.value};
+				order.filled.value += fill_qty.value;
+				fills(fill_event(order, event, level_price, fill_qty));
+				risk_.closed(node->order.account, contra_side, fill_qty);
+				risk_.filled(node->order.account, contra_side, fill_qty);
+				if (node->order.reserve.value > 0) {
+					node->order.filled = node->order.quantity;
+					next_slice(node->order);
+					level.push_back(node);
+				} else {
+					index_.erase(node->order.id);
+					release(node);
+					--order_count_;
+				}
+				node = next;
+			}
+			event.fill_info.filled_quantity.value += level_qty.value;
+			event.fill_info.fill_price = level_price;
+
+			// Icebergs showed new slices: the match loop carries on from here
+			if (!level.empty()) {
+				fills.flush();
+				level_changed(sink, contra_side, level_price, &level);
+				return;
+			}
+
+			contra.erase_best();
+			fills.flush();
+			level_changed(sink, contra_side, level_price, nullptr);
+		}
+	}
+
+	// Walk the contra side best-first while the incoming order crosses. All
+	// fills of the sweep carry the incoming event's timestamp.
+	template <bool Priced, typename Contra, EventSink Sink, typename Crosses>
+	void match_against(Contra& contra, Order& order, OrderEvent& event, Sink& sink,
+										 Crosses crosses) {
+		if constexpr (requires { contra.plan_sweep(Quantity{}, std::optional<Price>{}); }) {
+			sweep_levels<Priced>(contra, order, event, sink);
+		}
+
+		while (!contra.empty() && order.filled.value < order.quantity.value) {
+			Price level_price = contra.best_price();
 
 			// Check if we can match
-			if (order.type == OrderType::Market || order.price.ticks <= bid_price.ticks) {
-				if (bid_orders.empty()) {
-					bids_.erase(bids_.begin());
-					continue;
-				}
+			if (Priced && !crosses(order.price, level_price)) {
+				break;	// No more matches possible
+			}
 
-				auto& resting_order = bid_orders.front();
-				Quantity resting_qty{resting_order.quantity.value - resting_order.filled.value};
-				Quantity incoming_qty{order.quantity.value - order.filled.value};
-				Quantity fill_qty{std::min(resting_qty.value, incoming_qty.value)};
+			auto& level_orders = contra.best();
+			if (level_orders.empty()) {
+				contra.erase_best();
+				continue;
+			}
 
-				// Execute trade at resting order price
-				order.filled.value += fill_qty.value;
-				resting_order.filled.value += fill_qty.value;
-
-				// Record fill event
-				OrderEvent fill_event{
-						.type = OrderEventType::Fill,
-						.order_id = order.id,
-						.price = bid_price,
-						.quantity = fill_qty,
-						.side = order.side,
-						.order_type = order.type,
-						.timestamp = Timestamp::now(),
-						.fill_info =
-								FillInfo{.filled_quantity = fill_qty,
-												 .remaining_quantity = Quantity{order.quantity.value - order.filled.value},
-												 .fill_price = bid_price,
-												 .fill_time = Timestamp::now()}};
-
-				pending_events_.push_back(fill_event);
-				event.fill_info.filled_quantity.value += fill_qty.value;
-				event.fill_info.fill_price = bid_price;
-
-				// Remove if fully filled
-				if (resting_order.filled.value >= resting_order.quantity.value) {
-					bid_orders.pop_front();
+			auto& resting_order = level_orders.front();
+			if (self_match(order, resting_order)) {
+				if (!prevent_self_trade(contra, order, event, sink))
+					break;
+				continue;
+			}
+			Quantity resting_qty{resting_order.quantity.value - resting_order.filled.value};
+			Quantity incoming_qty{order.quantity.value - order.filled.value};
+			Quantity fill_qty{std::min(resting_qty.value, incoming_qty.value)};
+
+			// Execute trade at resting order price
+			order.filled.value += fill_qty.value;
+			resting_order.filled.value += fill_qty.value;
+			level_orders.reduce(fill_qty);
+			risk_.closed(resting_order.account, resting_order.side, fill_qty);
+			risk_.filled(resting_order.account, resting_order.side, fill_qty);
+
+			sink(fill_event(order, event, level_price, fill_qty));
+			event.fill_info.filled_quantity.value += fill_qty.value;
+			event.fill_info.fill_price = level_price;
+
+			// Remove if fully filled; an iceberg instead shows its next slice at
+			// the back of the queue
+			const Level* level_after = &level_orders;
+			if (resting_order.filled.value >= resting_order.quantity.value) {
+				OrderNode* filled = level_orders.pop_front();
+				if (filled->order.reserve.value > 0) {
+					next_slice(filled->order);
+					level_orders.push_back(filled);
+				} else {
+					index_.erase(filled->order.id);
+					release(filled);
 					--order_count_;
-					if (bid_orders.empty()) {
-						bids_.erase(bids_.begin());
+					if (level_orders.empty()) {
+						contra.erase_best();
+						level_after = nullptr;
 					}
 				}
-			} else {
-				break;	// No more matches possible
 			}
+			level_changed(sink, order.side == Side::Buy ? Side::Sell : Side::Buy, level_price,
+										level_after);
 		}
 
 		event.fill_info.remaining_quantity = Quantity{order.quantity.value - order.filled.value};
 	}
 };
 
+// Tree-of-lists book: unbounded price range, one node per level
+using OrderBook = BasicOrderBook<MapPriceLevels>;
+
+// Dense ladder book: O(1) level lookup inside BookConfig's price band
+using LadderOrderBook = BasicOrderBook<LadderPriceLevels>;
+
 }	 // namespace matching_engine::matching
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "../core/tick.hpp"
+#include "../core/types.hpp"
+
+namespace matching_engine::matching {
+
+// Construction parameters shared by every book layout. Layouts ignore the
+// fields they have no use for (the map layout needs none of them).
+struct BookConfig {
+	// Centre of the price ladder; the band spans ladder_ticks around it
+	Price reference_price{10000};	 // 100.00
+	size_t ladder_ticks = 1 << 14;
+
+	// Resting orders the book can hold (node pool and id index are sized once)
+	size_t max_orders = 1 << 16;
+
+	// Instrument stamped on every event the book emits
+	SymbolId symbol{0};
+
+	// Orders of one account meeting each other (see SelfTradePrevention)
+	SelfTradePrevention self_trade = SelfTradePrevention::None;
+
+	// Accounts a per-account risk table has slots for (ids 0 .. n-1)
+	size_t max_accounts = 1024;
+
+	// Valid price increments of the instrument; priced orders off them are
+	// rejected. The default allows every tick.
+	TickTable ticks;
+
+	// Backing for the node pool, order index and ladder arrays, e.g. a
+	// memory::PageArena for huge pages on the engine thread's NUMA node;
+	// nullptr is the global heap. The map layout's per-level tree nodes
+	// always come from the heap.
+	std::pmr::memory_resource* memory = nullptr;
+};
+
+inline std::pmr::memory_resource* book_memory(const BookConfig& config) noexcept {
+	return config.memory ? config.memory : std::pmr::get_default_resource();
+}
+
+// Levels a sweep would exhaust completely, best first, and their total
+// open quantity. The level after them (if it crosses) only fills partially.
+struct SweepPlan {
+	size_t levels = 0;
+	Quantity quantity{0};
+};
+
+namespace detail {
+
+// Sum of n consecutive quantities. Written with vector types, so GCC and
+// Clang emit packed adds for whatever SIMD the target has.
+inline uint64_t sum_quantities(const uint64_t* values, size_t n) noexcept {
+	size_t i = 0;
+	uint64_t sum = 0;
+#if defined(__GNUC__)
+	using Lanes = uint64_t __attribute__((vector_size(32)));
+	Lanes acc{};
+	for (; i + 4 <= n; i += 4) {
+		Lanes lanes;
+		std::memcpy(&lanes, values + i, sizeof(lanes));
+		acc += lanes;
+	}
+	sum = acc[0] + acc[1] + acc[2] + acc[3];
+#endif
+	for (; i < n; ++i) {
+		sum += values[i];
+	}
+	return sum;
+}
+
+}	 // namespace detail
+
+// One side of the book keyed by std::map: a tree node per price level,
+// unbounded price range.
+template <typename Level, Side S>
+class MapPriceLevels {
+	using Compare = std::conditional_t<S == Side::Buy, std::greater<>, std::less<>>;
+
+	std::map<Price, Level, Compare> levels_;
+
+ public:
+	explicit MapPriceLevels(const BookConfig& = {}) {}
+
+	bool empty() const noexcept { return levels_.empty(); }
+	size_t size() const noexcept { return levels_.size(); }
+
+	// Every price is representable
+	bool accepts(Price) const noexcept { return true; }
+
+	// Best level (highest bid / lowest ask); only valid when !empty()
+	Price best_price() const { return levels_.begin()->first; }
+	Level& best() { return levels_.begin()->second; }
+
+	void erase_best() { levels_.erase(levels_.begin()); }
+
+	Level* find(Price price) {
+		auto it = levels_.find(price);
+		return it == levels_.end() ? nullptr : &it->second;
+	}
+
+	// Find or create the level at price
+	Level* insert(Price price) { return &levels_[price]; }
+
+	void erase(Price price) { levels_.erase(price); }
+
+	// Visit levels best-first until f returns false
+	template <typename F>
+	void for_each(F&& f) const {
+		for (const auto& [price, level] : levels_) {
+			if (!f(price, level))
+				break;
+		}
+	}
+};
+
+// One side of the book as a dense price ladder: level i holds price
+// base + i ticks. A two-level occupancy bitmap tracks non-empty levels so
+// that finding the next best level after the current one empties is a
+// couple of word scans instead of a tree walk. Level open quantities are
+// mirrored into a flat array (the book reports them via note_quantity),
+// which lets plan_sweep() add up many levels without visiting them.
+template <typename Level, Side S>
+class LadderPriceLevels {
+	static constexpr size_t WORD_BITS = 64;
+	static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+	int64_t base_ticks_;
+	std::pmr::vector<Level> levels_;
+	std::pmr::vector<uint64_t> occupied_;	 // bit i      <=> levels_[i] non-empty
+	std::pmr::vector<uint64_t> summary_;	 // bit w      <=> occupied_[w] != 0
+	std::pmr::vector<uint64_t> open_;			 // open_[i]   == levels_[i].open_quantity()
+	size_t best_ = NPOS;
+	size_t count_ = 0;
+
+	size_t index_of(Price price) const noexcept {
+		return static_cast<size_t>(price.ticks - base_ticks_);
+	}
+
+	Price price_of(size_t idx) const noexcept {
+		return Price{base_ticks_ + static_cast<int64_t>(idx)};
+	}
+
+	void mark(size_t idx) noexcept {
+		size_t w = idx / WORD_BITS;
+		occupied_[w] |= uint64_t{1} << (idx % WORD_BITS);
+		summary_[w / WORD_BITS] |= uint64_t{1} << (w % WORD_BITS);
+	}
+
+	void unmark(size_t idx) noexcept {
+		size_t w = idx / WORD_BITS;
+		occupied_[w] &= ~(uint64_t{1} << (idx % WORD_BITS));
+		if (occupied_[w] == 0) {
+			summary_[w / WORD_BITS] &= ~(uint64_t{1} << (w % WORD_BITS));
+		}
+	}
+
+	// Highest occupied index strictly below idx, or NPOS
+	size_t scan_down(size_t idx) const noexcept {
+		if (idx == 0)
+			return NPOS;
+		--idx;
+		size_t w = idx / WORD_BITS;
+		uint64_t bits = occupied_[w] & (~uint64_t{0} >> (WORD_BITS - 1 - idx % WORD_BITS));
+		if (bits)
+			return w * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(bits));
+
+		// Fall back to the summary for the next non-empty word below w
+		if (w == 0)
+			return NPOS;
+		size_t sw = (w - 1) / WORD_BITS;
+		uint64_t sbits = summary_[sw] & (~uint64_t{0} >> (WORD_BITS - 1 - (w - 1) % WORD_BITS));
+		for (;;) {
+			if (sbits) {
+				size_t word = sw * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(sbits));
+				return word * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(occupied_[word]));
+			}
+			if (sw == 0)
+				return NPOS;
+			sbits = summary_[--sw];
+		}
+	}
+
+	// Lowest occupied index strictly above idx, or NPOS
+	size_t scan_up(size_t idx) const noexcept {
+		++idx;
+		if (idx >= levels_.size())
+			return NPOS;
+		size_t w = idx / WORD_BITS;
+		uint64_t bits = occupied_[w] & (~uint64_t{0} << (idx % WORD_BITS));
+		if (bits)
+			return w * WORD_BITS + std::countr_zero(bits);
+
+		size_t next = w + 1;
+		if (next >= occupied_.size())
+			return NPOS;
+		size_t sw = next / WORD_BITS;
+		uint64_t sbits = summary_[sw] & (~uint64_t{0} << (next % WORD_BITS));
+		for (;;) {
+			if (sbits) {
+				size_t word = sw * WORD_BITS + std::countr_zero(sbits);
+				return word * WORD_BITS + std::countr_zero(occupied_[word]);
+			}
+			if (++sw >= summary_.size())
+				return NPOS;
+			sbits = summary_[sw];
+		}
+	}
+
+	// Next level in priority order after idx
+	size_t next_worse(size_t idx) const noexcept {
+		return S == Side::Buy ? scan_down(idx) : scan_up(idx);
+	}
+
+	bool better(size_t a, size_t b) const noexcept { return S == Side::Buy ? a > b : a < b; }
+
+ public:
+	explicit LadderPriceLevels(const BookConfig& config = {})
+			: base_ticks_(config.reference_price.ticks - static_cast<int64_t>(config.ladder_ticks / 2)),
+				levels_(config.ladder_ticks, book_memory(config)),
+				occupied_((config.ladder_ticks + WORD_BITS - 1) / WORD_BITS, book_memory(config)),
+				summary_((occupied_.size() + WORD_BITS - 1) / WORD_BITS, book_memory(config)),
+				open_(config.ladder_ticks, book_memory(config)) {}
+
+	bool empty() const noexcept { return count_ == 0; }
+	size_t size() const noexcept { return count_; }
+
+	// Only prices inside [base, base + ladder_ticks) have a slot
+	bool accepts(Price price) const noexcept {
+		return price.ticks >= base_ticks_ && index_of(price) < levels_.size();
+	}
+
+	Price best_price() const { return price_of(best_); }
+	Level& best() { return levels_[best_]; }
+
+	void erase_best() {
+		unmark(best_);
+		--count_;
+		best_ = next_worse(best_);
+	}
+
+	Level* find(Price price) {
+		if (!accepts(price))
+			return nullptr;
+		size_t idx = index_of(price);
+		return levels_[idx].empty() ? nullptr : &levels_[idx];
+	}
+
+	// Find or create the level at price; nullptr outside the band. A newly
+	// created level is marked occupied, so the caller must fill it.
+	Level* insert(Price price) {
+		if (!accepts(price))
+			return nullptr;
+		size_t idx = index_of(price);
+		if (levels_[idx].empty()) {
+			mark(idx);
+			++count_;
+			if (best_ == NPOS || better(idx, best_)) {
+				best_ = idx;
+			}
+		}
+		return &levels_[idx];
+	}
+
+	void erase(Price price) {
+		size_t idx = index_of(price);
+		if (idx == best_) {
+			erase_best();
+			return;
+		}
+		unmark(idx);
+		--count_;
+	}
+
+	template <typename F>
+	void for_each(F&& f) const {
+		for (size_t idx = best_; idx != NPOS; idx = next_worse(idx)) {
+			if (!f(price_of(idx), levels_[idx]))
+				break;
+		}
+	}
+
+	// The level at price now holds quantity open (0 once it is gone)
+	void note_quantity(Price price, Quantity quantity) noexcept {
+		open_[index_of(price)] = quantity.value;
+	}
+
+	// How far an order for quantity would sweep, taking levels best-first
+	// up to and including limit (all of them when there is none). One pass
+	// over the quantity mirror: each 64-level word the sweep clears whole
+	// costs a vector sum and a popcount; only the word where it stops is
+	// walked level by level.
+	SweepPlan plan_sweep(Quantity quantity, std::optional<Price> limit) const noexcept {
+		SweepPlan plan;
+		if (best_ == NPOS || open_[best_] > quantity.value)
+			return plan;
+
+		// Last slot the sweep may reach
+		size_t last = S == Side::Buy ? 0 : levels_.size() - 1;
+		if (limit) {
+			int64_t offset = limit->ticks - base_ticks_;
+			if constexpr (S == Side::Buy) {
+				if (offset > static_cast<int64_t>(best_))
+					return plan;
+				last = static_cast<size_t>(std::max<int64_t>(offset, 0));
+			} else {
+				if (offset < static_cast<int64_t>(best_))
+					return plan;
+				last = std::min(last, static_cast<size_t>(offset));
+			}
+		}
+
+		size_t first = best_;
+		if constexpr (S == Side::Buy) {
+			std::swap(first, last);
+		}
+		for (size_t w = best_ / WORD_BITS;; w = S == Side::Buy ? w - 1 : w + 1) {
+			size_t lo = std::max(first, w * WORD_BITS);
+			size_t hi = std::min(last, w * WORD_BITS + WORD_BITS - 1);
+			uint64_t bits = occupied_[w] & (~uint64_t{0} << (lo % WORD_BITS)) &
+											(~uint64_t{0} >> (WORD_BITS - 1 - hi % WORD_BITS));
+			if (bits) {
+				uint64_t sum = detail::sum_quantities(&open_[lo], hi - lo + 1);
+				if (plan.quantity.value + sum <= quantity.value) {
+					plan.quantity.value += sum;
+					plan.levels += static_cast<size_t>(std::popcount(bits));
+				} else {
+					// The sweep ends inside this word
+					while (bits) {
+						size_t bit = S == Side::Buy ? WORD_BITS - 1 - std::countl_zero(bits)
+																				: static_cast<size_t>(std::countr_zero(bits));
+						uint64_t open = open_[w * WORD_BITS + bit];
+						if (plan.quantity.value + open > quantity.value)
+							break;
+						plan.quantity.value += open;
+						++plan.levels;
+						bits &= ~(uint64_t{1} << bit);
+					}
+					return plan;
+				}
+			}
+			if (w == (S == Side::Buy ? first : last) / WORD_BITS)
+				return plan;
+		}
+	}
+};
+
+}	 // namespace matching_engine::matching
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../core/tick.hpp"
+#include "../core/types.hpp"
+#include "price_levels.hpp"
+
+namespace matching_engine::matching {
+
+// Pre-trade limits of one account
+struct RiskLimits {
+	// Largest |price| * quantity, in ticks, a single order may carry
+	uint64_t max_order_notional = UINT64_MAX;
+
+	// Largest net position, long or short, the account could reach if all
+	// of its open orders on one side filled
+	uint64_t max_position = UINT64_MAX;
+};
+
+// Risk policies for the orderbook. check() runs before an order may trade
+// or rest (replaced is the open quantity a cancel/replace gives back); the
+// book then reports resting quantity appearing (opened) and going away
+// (closed) and executions (filled, per side) so the policy can keep
+// exposure current.
+template <typename R>
+concept RiskPolicy = requires(R& risk, const R& view, AccountId account, Side side, Price price,
+															Quantity quantity) {
+	{ view.check(account, side, price, quantity, quantity) } -> std::same_as<RejectReason>;
+	risk.opened(account, side, quantity);
+	risk.closed(account, side, quantity);
+	risk.filled(account, side, quantity);
+};
+
+// Every order passes and nothing is tracked; compiles away entirely
+struct NoRiskChecks {
+	explicit NoRiskChecks(const BookConfig& = {}) {}
+
+	RejectReason check(AccountId, Side, Price, Quantity, Quantity = Quantity{0}) const noexcept {
+		return RejectReason::None;
+	}
+
+	void opened(AccountId, Side, Quantity) noexcept {}
+	void closed(AccountId, Side, Quantity) noexcept {}
+	void filled(AccountId, Side, Quantity) noexcept {}
+};
+
+// Limits and exposure of every account in one flat array indexed by
+// AccountId: a check is a bounds test, one slot load and a few integer
+// compares, with no lookup structure in between. Accounts start without
+// limits. Positions are not part of book snapshots; restore them with
+// set_position() after recovery.
+class AccountRiskTable {
+	struct Account {
+		RiskLimits limits;
+		int64_t position = 0;		 // Net filled quantity (bought - sold)
+		uint64_t open_buy = 0;	 // Resting quantity, shown and hidden
+		uint64_t open_sell = 0;
+	};
+
+	std::vector<Account> accounts_;
+
+	Account* find(AccountId account) noexcept {
+		return account.value < accounts_.size() ? &accounts_[account.value] : nullptr;
+	}
+
+ public:
+	explicit AccountRiskTable(const BookConfig& config = {}) : accounts_(config.max_accounts) {}
+
+	size_t capacity() const noexcept { return accounts_.size(); }
+
+	RejectReason check(AccountId account, Side side, Price price, Quantity quantity,
+										 Quantity replaced = Quantity{0}) const noexcept {
+		if (account.value >= accounts_.size())
+			return RejectReason::UnknownAccount;
+		const Account& a = accounts_[account.value];
+
+		// |price| * quantity > limit, multiplied out in 128 bits
+		std::optional<uint64_t> notional = checked_notional(price, quantity);
+		if (!notional || *notional > a.limits.max_order_notional)
+			return RejectReason::RiskLimit;
+
+		// Worst case on the order's side: everything open there fills
+		int64_t open = static_cast<int64_t>(quantity.value - replaced.value);
+		int64_t worst = side == Side::Buy ? a.position + static_cast<int64_t>(a.open_buy) + open
+																			: static_cast<int64_t>(a.open_sell) + open - a.position;
+		if (worst > 0 && static_cast<uint64_t>(worst) > a.limits.max_position)
+			return RejectReason::RiskLimit;
+		return RejectReason::None;
+	}
+
+	void opened(AccountId account, Side side, Quantity quantity) noexcept {
+		if (Account* a = find(account)) {
+			(side == Side::Buy ? a->open_buy : a->open_sell) += quantity.value;
+		}
+	}
+
+	void closed(AccountId account, Side side, Quantity quantity) noexcept {
+		if (Account* a = find(account)) {
+			(side == Side::Buy ? a->open_buy : a->open_sell) -= quantity.value;
+		}
+	}
+
+	void filled(AccountId account, Side side, Quantity quantity) noexcept {
+		if (Account* a = find(account)) {
+			int64_t delta = static_cast<int64_t>(quantity.value);
+			a->position += side == Side::Buy ? delta : -delta;
+		}
+	}
+
+	// False if account has no slot
+	bool set_limits(AccountId account, const RiskLimits& limits) noexcept {
+		Account* a = find(account);
+		if (!a)
+			return false;
+		a->limits = limits;
+		return true;
+	}
+
+	bool set_position(AccountId account, int64_t position) noexcept {
+		Account* a = find(account);
+		if (!a)
+			return false;
+		a->position = position;
+		return true;
+	}
+
+	// Accessors below require account < capacity()
+	const RiskLimits& limits(AccountId account) const { return accounts_[account.value].limits; }
+	int64_t position(AccountId account) const { return accounts_[account.value].position; }
+
+	Quantity open_quantity(AccountId account, Side side) const {
+		const Account& a = accounts_[account.value];
+		return Quantity{side == Side::Buy ? a.open_buy : a.open_sell};
+	}
+};
+
+}	 // namespace matching_engine::matching
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "../core/types.hpp"
+#include "orderbook.hpp"
+
+namespace matching_engine::matching {
+
+// Best bid and ask with their sizes, as a fixed 48-byte record for
+// publication through a SeqLock. A side with zero quantity is empty (its
+// price is then 0). sequence is the book's update sequence when the record
+// was taken, comparable with BookUpdate::sequence and DepthSnapshot.
+struct TopOfBook {
+	Price bid{0};
+	Quantity bid_quantity{0};
+	Price ask{0};
+	Quantity ask_quantity{0};
+	uint32_t bid_orders = 0;
+	uint32_t ask_orders = 0;
+	uint64_t sequence = 0;
+
+	bool has_bid() const noexcept { return bid_quantity.value != 0; }
+	bool has_ask() const noexcept { return ask_quantity.value != 0; }
+};
+
+static_assert(std::is_trivially_copyable_v<TopOfBook> && sizeof(TopOfBook) == 48,
+							"TopOfBook must fit one cache line with its SeqLock sequence");
+
+// Current top of book; O(1) on the book's own thread
+template <typename Book>
+TopOfBook top_of_book(const Book& book) {
+	DepthSnapshot<1> depth;
+	book.snapshot_depth(depth);
+	TopOfBook top{.sequence = depth.sequence};
+	if (depth.bid_levels) {
+		top.bid = depth.bids[0].price;
+		top.bid_quantity = depth.bids[0].quantity;
+		top.bid_orders = static_cast<uint32_t>(depth.bids[0].orders);
+	}
+	if (depth.ask_levels) {
+		top.ask = depth.asks[0].price;
+		top.ask_quantity = depth.asks[0].quantity;
+		top.ask_orders = static_cast<uint32_t>(depth.asks[0].orders);
+	}
+	return top;
+}
+
+}	 // namespace matching_engine::matching
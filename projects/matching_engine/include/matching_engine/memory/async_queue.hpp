@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+#include "../scheduler/coro_scheduler.hpp"
+#include "../scheduler/waiter_queue.hpp"
+
+namespace matching_engine::memory {
+
+// Coroutine interface shared by the bounded queues. Derived provides
+// push/pop/full/empty and calls notify_consumer()/notify_producer() after a
+// successful push/pop; this base supplies push_async/pop_async on top.
+// Derived may shadow closed(), and consumer_parked()/producer_parked(),
+// which run after a coroutine queued itself and before it re-checks.
+template <typename Derived, typename T>
+class AsyncQueueBase {
+ protected:
+	// Coroutines parked on a full (producers) or empty (consumers) queue
+	coro::WaiterQueue producers_;
+	coro::WaiterQueue consumers_;
+	std::atomic<bool> closed_{false};
+
+	void notify_consumer() { consumers_.notify_one(); }
+	void notify_producer() { producers_.notify_one(); }
+
+	void consumer_parked() noexcept {}
+	void producer_parked() noexcept {}
+
+ public:
+	// Wake every parked coroutine and stop further parking: pop_async then
+	// yields nullopt once the queue is drained, push_async fails when full.
+	// Synchronous push/pop are unaffected.
+	void close() {
+		closed_.store(true, std::memory_order_seq_cst);
+		consumers_.notify_all();
+		producers_.notify_all();
+	}
+
+	bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+	// Async push awaitable. When the queue is full and the coroutine runs
+	// under a coro::Scheduler, it parks until a pop frees a slot; otherwise
+	// it retries once and reports the outcome.
+	struct PushAwaitable {
+		Derived& buffer;
+		T value;
+		bool result = false;
+		coro::Waiter waiter{};
+
+		bool await_ready() {
+			result = buffer.push(std::move(value));
+			return result;	// If successful, don't suspend
+		}
+
+		bool await_suspend(std::coroutine_handle<> handle) {
+			waiter.scheduler = coro::Executor::current();
+			if (!waiter.scheduler) {
+				return false;	 // Nothing to wake us: retry in await_resume
+			}
+			waiter.handle = handle;
+			buffer.producers_.enqueue(waiter);
+			buffer.producer_parked();
+
+			// Re-check after publishing the waiter so a concurrent pop can't be missed
+			if ((!buffer.full() || buffer.closed()) && buffer.producers_.cancel(waiter)) {
+				return false;
+			}
+			return true;
+		}
+
+		// Withdraw the parked waiter (e.g. on timeout); false if a pop already woke it
+		bool cancel() noexcept { return buffer.producers_.cancel(waiter); }
+
+		bool await_resume() {
+			if (!result) {
+				result = buffer.push(std::move(value));
+			}
+			return result;
+		}
+	};
+
+	// Async pop awaitable; parks on an empty queue like PushAwaitable. On an
+	// open queue nullopt only means another consumer won the race for the
+	// value that woke it; with a single consumer it means closed and drained.
+	struct PopAwaitable {
+		Derived& buffer;
+		std::optional<T> result;
+		coro::Waiter waiter{};
+
+		bool await_ready() {
+			result = buffer.pop();
+			return result.has_value();
+		}
+
+		bool await_suspend(std::coroutine_handle<> handle) {
+			waiter.scheduler = coro::Executor::current();
+			if (!waiter.scheduler) {
+				return false;
+			}
+			waiter.handle = handle;
+			buffer.consumers_.enqueue(waiter);
+			buffer.consumer_parked();
+
+			if ((!buffer.empty() || buffer.closed()) && buffer.consumers_.cancel(waiter)) {
+				return false;
+			}
+			return true;
+		}
+
+		// Withdraw the parked waiter (e.g. on timeout); false if a push already woke it
+		bool cancel() noexcept { return buffer.consumers_.cancel(waiter); }
+
+		std::optional<T> await_resume() {
+			if (!result.has_value()) {
+				result = buffer.pop();
+			}
+			return std::move(result);
+		}
+	};
+
+	// Async interface
+	PushAwaitable push_async(T value) {
+		return PushAwaitable{static_cast<Derived&>(*this), std::move(value)};
+	}
+
+	PopAwaitable pop_async() { return PopAwaitable{static_cast<Derived&>(*this)}; }
+};
+
+}	 // namespace matching_engine::memory
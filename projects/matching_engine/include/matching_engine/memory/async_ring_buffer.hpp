@@ -1,26 +1,68 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
-#include <coroutine>
 #include <optional>
+#include <span>
 
-#include "../scheduler/coro_scheduler.hpp"
+#include "../metrics/metrics.hpp"
+#include "async_queue.hpp"
 
 namespace matching_engine::memory {
 
+// Single-producer/single-consumer ring buffer. Each side keeps a private
+// copy of the other side's index on its own cache line and reloads the
+// shared index only when that copy says full (producer) or empty
+// (consumer), so steady-state transfers touch no remote cache line.
+// The slots are inline: to put them on huge pages near the consumer,
+// construct the ring (or the engine embedding it) with PageArena::make().
 template <typename T, size_t Capacity>
-class AsyncRingBuffer {
+class AsyncRingBuffer : public AsyncQueueBase<AsyncRingBuffer<T, Capacity>, T> {
 	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
 
  private:
 	std::array<T, Capacity> buffer_{};
+
+	// Producer line
 	alignas(64) std::atomic<size_t> write_pos_{0};
+	size_t cached_read_pos_ = 0;
+
+	// Consumer line
 	alignas(64) std::atomic<size_t> read_pos_{0};
+	size_t cached_write_pos_ = 0;
 
 	static constexpr size_t INDEX_MASK = Capacity - 1;
 
+	// Free slots as seen by the producer, refreshing the cache if needed
+	size_t free_slots(size_t write, size_t wanted) noexcept {
+		size_t free = Capacity - (write - cached_read_pos_);
+		if (free < wanted) {
+			cached_read_pos_ = read_pos_.load(std::memory_order_acquire);
+			free = Capacity - (write - cached_read_pos_);
+		}
+		return free;
+	}
+
+	// Filled slots as seen by the consumer, refreshing the cache if needed
+	size_t filled_slots(size_t read, size_t wanted) noexcept {
+		size_t filled = cached_write_pos_ - read;
+		if (filled < wanted) {
+			cached_write_pos_ = write_pos_.load(std::memory_order_acquire);
+			filled = cached_write_pos_ - read;
+		}
+		return filled;
+	}
+
+	// Slots in use after a push, from the producer's cached view of the
+	// read index (an upper bound, and no remote cache line touched)
+	void record_occupancy(size_t write) const noexcept {
+		metrics::record(metrics::Histogram::QueueOccupancy, write - cached_read_pos_);
+	}
+
  public:
+	using value_type = T;
+
 	AsyncRingBuffer() = default;
 
 	// Non-copyable, non-movable
@@ -40,97 +82,74 @@ class AsyncRingBuffer {
 	// Synchronous push
 	bool push(const T& value) noexcept(std::is_nothrow_copy_assignable_v<T>) {
 		auto write = write_pos_.load(std::memory_order_relaxed);
-		auto read = read_pos_.load(std::memory_order_acquire);
-
-		if (write - read >= Capacity) {
+		if (free_slots(write, 1) == 0) {
 			return false;	 // Buffer full
 		}
 
 		buffer_[write & INDEX_MASK] = value;
 		write_pos_.store(write + 1, std::memory_order_release);
+		record_occupancy(write + 1);
+		this->notify_consumer();
 		return true;
 	}
 
 	bool push(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>) {
 		auto write = write_pos_.load(std::memory_order_relaxed);
-		auto read = read_pos_.load(std::memory_order_acquire);
-
-		if (write - read >= Capacity) {
+		if (free_slots(write, 1) == 0) {
 			return false;	 // Buffer full
 		}
 
 		buffer_[write & INDEX_MASK] = std::move(value);
 		write_pos_.store(write + 1, std::memory_order_release);
+		record_occupancy(write + 1);
+		this->notify_consumer();
 		return true;
 	}
 
+	// Push as many of values as fit; one index publish for the whole block.
+	// Returns the number pushed.
+	size_t push_bulk(std::span<const T> values) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+		auto write = write_pos_.load(std::memory_order_relaxed);
+		size_t n = std::min(values.size(), free_slots(write, values.size()));
+		if (n == 0)
+			return 0;
+
+		for (size_t i = 0; i < n; ++i) {
+			buffer_[(write + i) & INDEX_MASK] = values[i];
+		}
+		write_pos_.store(write + n, std::memory_order_release);
+		record_occupancy(write + n);
+		this->notify_consumer();
+		return n;
+	}
+
 	// Synchronous pop
 	std::optional<T> pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
 		auto read = read_pos_.load(std::memory_order_relaxed);
-		auto write = write_pos_.load(std::memory_order_acquire);
-
-		if (read >= write) {
+		if (filled_slots(read, 1) == 0) {
 			return std::nullopt;	// Buffer empty
 		}
 
 		T value = std::move(buffer_[read & INDEX_MASK]);
 		read_pos_.store(read + 1, std::memory_order_release);
+		this->notify_producer();
 		return value;
 	}
 
-	// Async push awaitable
-	struct PushAwaitable {
-		AsyncRingBuffer& buffer;
-		T value;
-		bool result = false;
-
-		bool await_ready() {
-			result = buffer.push(std::move(value));
-			return result;	// If successful, don't suspend
-		}
-
-		void await_suspend(std::coroutine_handle<> handle) {
-			// In a real implementation, we would queue this coroutine
-			// For now, we just resume immediately
-			handle.resume();
-		}
-
-		bool await_resume() {
-			if (!result) {
-				result = buffer.push(std::move(value));
-			}
-			return result;
-		}
-	};
-
-	// Async pop awaitable
-	struct PopAwaitable {
-		AsyncRingBuffer& buffer;
-		std::optional<T> result;
-
-		bool await_ready() {
-			result = buffer.pop();
-			return result.has_value();
-		}
-
-		void await_suspend(std::coroutine_handle<> handle) {
-			// In a real implementation, we would queue this coroutine
-			// For now, we just resume immediately
-			handle.resume();
-		}
+	// Pop up to out.size() values into out; returns the number popped
+	size_t pop_bulk(std::span<T> out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+		auto read = read_pos_.load(std::memory_order_relaxed);
+		size_t n = std::min(out.size(), filled_slots(read, out.size()));
+		if (n == 0)
+			return 0;
 
-		std::optional<T> await_resume() {
-			if (!result.has_value()) {
-				result = buffer.pop();
-			}
-			return std::move(result);
+		for (size_t i = 0; i < n; ++i) {
+			out[i] = std::move(buffer_[(read + i) & INDEX_MASK]);
 		}
-	};
-
-	// Async interface
-	PushAwaitable push_async(T value) { return PushAwaitable{*this, std::move(value)}; }
-
-	PopAwaitable pop_async() { return PopAwaitable{*this}; }
+		read_pos_.store(read + n, std::memory_order_release);
+		this->notify_producer();
+		return n;
+	}
 };
 
 }	 // namespace matching_engine::memory
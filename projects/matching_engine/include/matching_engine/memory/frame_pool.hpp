@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace matching_engine::memory {
+
+// Frame allocators plug into coro::Task through its FrameAllocator
+// parameter. They need static allocate(size) / deallocate(ptr, size).
+
+// Plain global heap, one allocation per coroutine call
+struct HeapFrameAllocator {
+	static void* allocate(size_t size) { return ::operator new(size); }
+	static void deallocate(void* ptr, size_t) noexcept { ::operator delete(ptr); }
+};
+
+// Recycles coroutine frames through thread-local free lists, one per
+// 64-byte size class. A frame released on another thread simply joins that
+// thread's list. Frames above MaxFrame, and releases beyond MaxCached
+// blocks per class, go straight to the heap, so a thread that only frees
+// (e.g. a consumer of migrated tasks) cannot hoard memory without bound.
+template <size_t MaxFrame = 1024, size_t MaxCached = 256>
+class RecyclingFrameAllocator {
+	static constexpr size_t GRANULE = 64;
+	static constexpr size_t CLASSES = MaxFrame / GRANULE;
+	static_assert(MaxFrame % GRANULE == 0, "MaxFrame must be a multiple of 64");
+
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct FreeLists {
+		std::array<FreeBlock*, CLASSES> heads{};
+		std::array<size_t, CLASSES> counts{};
+		size_t heap_allocations = 0;
+
+		FreeLists() = default;
+		FreeLists(const FreeLists&) = delete;
+		FreeLists& operator=(const FreeLists&) = delete;
+
+		~FreeLists() {
+			for (FreeBlock* head : heads) {
+				while (head) {
+					FreeBlock* next = head->next;
+					::operator delete(head);
+					head = next;
+				}
+			}
+		}
+	};
+
+	static FreeLists& lists() noexcept {
+		static thread_local FreeLists instance;
+		return instance;
+	}
+
+	static size_t class_of(size_t size) noexcept { return (size + GRANULE - 1) / GRANULE - 1; }
+
+ public:
+	static void* allocate(size_t size) {
+		auto& free = lists();
+		if (size <= MaxFrame) {
+			size_t cls = class_of(size);
+			if (FreeBlock* block = free.heads[cls]) {
+				free.heads[cls] = block->next;
+				--free.counts[cls];
+				return block;
+			}
+			// Round up so the block can serve any frame of its class later
+			size = (cls + 1) * GRANULE;
+		}
+		++free.heap_allocations;
+		return ::operator new(size);
+	}
+
+	static void deallocate(void* ptr, size_t size) noexcept {
+		if (size <= MaxFrame) {
+			auto& free = lists();
+			size_t cls = class_of(size);
+			if (free.counts[cls] < MaxCached) {
+				auto* block = static_cast<FreeBlock*>(ptr);
+				block->next = free.heads[cls];
+				free.heads[cls] = block;
+				++free.counts[cls];
+				return;
+			}
+		}
+		::operator delete(ptr);
+	}
+
+	// Frames this thread had to take from the heap (for tests and profiling)
+	static size_t heap_allocations() noexcept { return lists().heap_allocations; }
+};
+
+}	 // namespace matching_engine::memory
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "async_queue.hpp"
+
+namespace matching_engine::memory {
+
+// Bounded multi-producer/multi-consumer queue (Vyukov). Each slot carries a
+// sequence number that says whose turn it is: producers claim a slot by CAS
+// on enqueue_pos_ when seq == pos, consumers when seq == pos + 1. Same
+// surface as AsyncRingBuffer, so it also serves as the MPSC option.
+//
+// Slots are published and released out of order, so a parked coroutine is
+// woken only once the slot it waits on is ready: every push/pop wakes one
+// parked consumer if the head holds a value and one parked producer if the
+// tail is free. With a single consumer (producer) a woken pop_async
+// (push_async) therefore always succeeds.
+template <typename T, size_t Capacity>
+class MpmcRingBuffer : public AsyncQueueBase<MpmcRingBuffer<T, Capacity>, T> {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+								"Capacity must be a power of 2 (>= 2)");
+
+	struct Slot {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	static constexpr size_t INDEX_MASK = Capacity - 1;
+
+	std::array<Slot, Capacity> slots_;
+	alignas(64) std::atomic<size_t> enqueue_pos_{0};
+	alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+	// Claim the next writable slot, or nullptr when full
+	Slot* claim_for_push() noexcept {
+		size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+		for (;;) {
+			Slot& slot = slots_[pos & INDEX_MASK];
+			size_t seq = slot.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					return &slot;
+			} else if (diff < 0) {
+				return nullptr;	 // Slot still holds an unconsumed value
+			} else {
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void publish(Slot* slot) noexcept {
+		size_t pos = slot->sequence.load(std::memory_order_relaxed);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		wake_ready();
+	}
+
+	// Wake a parked consumer if the head holds a value and a parked producer
+	// if the tail is free; checked once a waiter is found, since a running
+	// consumer may have emptied the head in between
+	void wake_ready() {
+		this->consumers_.notify_one_if([this] { return !empty(); });
+		this->producers_.notify_one_if([this] { return !full(); });
+	}
+
+ public:
+	using value_type = T;
+
+	MpmcRingBuffer() {
+		for (size_t i = 0; i < Capacity; ++i) {
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Non-copyable, non-movable
+	MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+	MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+	// Approximate under concurrent use: counts slots a producer has claimed
+	// but not yet published
+	size_t size() const noexcept {
+		auto enq = enqueue_pos_.load(std::memory_order_acquire);
+		auto deq = dequeue_pos_.load(std::memory_order_acquire);
+		return enq > deq ? enq - deq : 0;
+	}
+
+	// Whether pop() would find nothing published at the head. Unlike size(),
+	// a claimed but unpublished slot counts as empty, so a parking consumer's
+	// re-check cannot be fooled into a pop that comes back empty.
+	bool empty() const noexcept {
+		size_t pos = dequeue_pos_.load(std::memory_order_acquire);
+		for (;;) {
+			size_t seq = slots_[pos & INDEX_MASK].sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff <= 0)
+				return diff < 0;
+			pos = dequeue_pos_.load(std::memory_order_acquire);	 // Another consumer took it
+		}
+	}
+
+	// Whether push() would find no free slot at the tail; a slot a consumer
+	// has claimed but not yet released still counts as taken
+	bool full() const noexcept {
+		size_t pos = enqueue_pos_.load(std::memory_order_acquire);
+		for (;;) {
+			size_t seq = slots_[pos & INDEX_MASK].sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff <= 0)
+				return diff < 0;
+			pos = enqueue_pos_.load(std::memory_order_acquire);	 // Another producer took it
+		}
+	}
+
+	bool push(const T& value) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+		Slot* slot = claim_for_push();
+		if (!slot)
+			return false;
+		slot->value = value;
+		publish(slot);
+		return true;
+	}
+
+	bool push(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>) {
+		Slot* slot = claim_for_push();
+		if (!slot)
+			return false;
+		slot->value = std::move(value);
+		publish(slot);
+		return true;
+	}
+
+	std::optional<T> pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+		size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+		Slot* slot;
+		for (;;) {
+			slot = &slots_[pos & INDEX_MASK];
+			size_t seq = slot->sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				return std::nullopt;	// Nothing published at pos yet
+			} else {
+				pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+
+		T value = std::move(slot->value);
+		slot->sequence.store(pos + INDEX_MASK + 1, std::memory_order_release);
+		wake_ready();
+		return value;
+	}
+
+	// Slot-by-slot bulk forms (every slot is claimed individually anyway)
+	size_t push_bulk(std::span<const T> values) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+		size_t n = 0;
+		while (n < values.size() && push(values[n])) {
+			++n;
+		}
+		return n;
+	}
+
+	size_t pop_bulk(std::span<T> out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+		size_t n = 0;
+		while (n < out.size()) {
+			auto value = pop();
+			if (!value)
+				break;
+			out[n++] = std::move(*value);
+		}
+		return n;
+	}
+};
+
+}	 // namespace matching_engine::memory
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace matching_engine::memory {
+
+// Fixed-capacity slab of T. All slots are allocated once up front and
+// recycled through an intrusive free list, so allocate/deallocate never
+// touch the global heap. The slab itself comes from a memory_resource (the
+// default one unless given, e.g. a PageArena for huge pages). Objects still
+// live when the pool is destroyed are released without running their
+// destructors.
+template <typename T>
+class ObjectPool {
+	union Slot {
+		Slot* next_free;
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	std::pmr::memory_resource* memory_;
+	Slot* slots_;
+	size_t capacity_;
+	size_t in_use_ = 0;
+	Slot* free_list_ = nullptr;
+
+ public:
+	explicit ObjectPool(size_t capacity, std::pmr::memory_resource* memory = nullptr)
+			: memory_(memory ? memory : std::pmr::get_default_resource()),
+				slots_(static_cast<Slot*>(memory_->allocate(capacity * sizeof(Slot), alignof(Slot)))),
+				capacity_(capacity) {
+		// Thread the free list front to back so early allocations are adjacent
+		for (size_t i = capacity; i-- > 0;) {
+			slots_[i].next_free = free_list_;
+			free_list_ = &slots_[i];
+		}
+	}
+
+	// Non-copyable, non-movable (handed-out pointers point into the slab)
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	~ObjectPool() { memory_->deallocate(slots_, capacity_ * sizeof(Slot), alignof(Slot)); }
+
+	size_t capacity() const noexcept { return capacity_; }
+	size_t size() const noexcept { return in_use_; }
+	bool full() const noexcept { return free_list_ == nullptr; }
+
+	// Construct a T in a free slot; nullptr when exhausted
+	template <typename... Args>
+	T* allocate(Args&&... args) {
+		if (!free_list_)
+			return nullptr;
+		Slot* slot = free_list_;
+		free_list_ = slot->next_free;
+		++in_use_;
+		return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+	}
+
+	void deallocate(T* ptr) noexcept {
+		ptr->~T();
+		Slot* slot = reinterpret_cast<Slot*>(ptr);
+		slot->next_free = free_list_;
+		free_list_ = slot;
+		--in_use_;
+	}
+};
+
+}	 // namespace matching_engine::memory
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace matching_engine::memory {
+
+// Page size a PageArena asks the kernel for
+enum class PageSize : uint8_t {
+	Normal,	 // 4 KB
+	Huge2M,
+	Huge1G,
+};
+
+// What a mapping actually got. HugeTlb pages need pages reserved up front
+// (vm.nr_hugepages, or hugepagesz=1G at boot); without them the arena falls
+// back to a 2 MB aligned mapping advised for transparent huge pages, which
+// the kernel backs with huge pages when it can.
+enum class PageBacking : uint8_t {
+	Normal,
+	Transparent,
+	Huge2M,
+	Huge1G,
+};
+
+struct PagePolicy {
+	static constexpr int LOCAL_NODE = -1;	 // NUMA node of the thread that maps
+	static constexpr int ANY_NODE = -2;		 // No binding, plain first touch
+
+	PageSize pages = PageSize::Huge2M;
+	int numa_node = LOCAL_NODE;
+	size_t chunk_bytes = size_t{2} << 20;	 // Least the arena maps at a time
+};
+
+// NUMA node of the CPU the calling thread runs on (0 when unknown)
+inline int current_numa_node() noexcept {
+	unsigned cpu = 0;
+	unsigned node = 0;
+	if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+		return 0;
+	return static_cast<int>(node);
+}
+
+// Monotonic memory_resource over anonymous mappings with the page size and
+// NUMA placement of a PagePolicy. Every chunk is bound to its node with
+// mbind() and then written once, page by page, from the thread that maps
+// it, so pages are faulted in there and not on the fast path. Create the
+// arena on the thread that will use the memory (e.g. the pinned engine
+// thread) to get LOCAL_NODE right.
+//
+// Deallocation is a no-op; memory goes back when the arena is destroyed.
+// That suits things sized once at construction: book node pools, order
+// indexes, price ladders (BookConfig::memory) and ring buffers, whose slots
+// are inline and so land on the arena by constructing the ring, or its
+// owner, with make(). Not thread-safe.
+class PageArena final : public std::pmr::memory_resource {
+	struct Chunk {
+		void* base;
+		size_t bytes;
+	};
+
+	PagePolicy policy_;
+	std::vector<Chunk> chunks_;
+	std::byte* cursor_ = nullptr;
+	std::byte* end_ = nullptr;
+	size_t used_ = 0;
+	PageBacking backing_ = PageBacking::Huge1G;	 // Worst backing of any chunk so far
+	bool bound_ = true;
+
+	static constexpr size_t SMALL_PAGE = size_t{4} << 10;
+	static constexpr size_t HUGE_2M = size_t{2} << 20;
+	static constexpr size_t HUGE_1G = size_t{1} << 30;
+
+	static size_t round_up(size_t n, size_t to) noexcept { return (n + to - 1) / to * to; }
+
+	// No MAP_NORESERVE: a hugetlb mapping must fail here, not SIGBUS on first
+	// touch, when the reserved pool is short
+	static void* map_anonymous(size_t bytes, int extra_flags) noexcept {
+		void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags,
+										 -1, 0);
+		return p == MAP_FAILED ? nullptr : p;
+	}
+
+	// 2 MB aligned mapping (over-map, trim both ends) advised for THP
+	static void* map_transparent(size_t bytes) noexcept {
+		auto* raw = static_cast<std::byte*>(map_anonymous(bytes + HUGE_2M, 0));
+		if (!raw)
+			return nullptr;
+		auto addr = reinterpret_cast<uintptr_t>(raw);
+		auto* aligned = reinterpret_cast<std::byte*>(round_up(addr, HUGE_2M));
+		if (size_t head = static_cast<size_t>(aligned - raw)) {
+			::munmap(raw, head);
+		}
+		if (size_t tail = HUGE_2M - static_cast<size_t>(aligned - raw)) {
+			::munmap(aligned + bytes, tail);
+		}
+		::madvise(aligned, bytes, MADV_HUGEPAGE);
+		return aligned;
+	}
+
+	// Map at least bytes with the best backing available; records it
+	Chunk map_chunk(size_t bytes) {
+		void* base = nullptr;
+		size_t size = 0;
+		PageBacking backing = PageBacking::Normal;
+
+		if (policy_.pages == PageSize::Huge1G) {
+			size = round_up(bytes, HUGE_1G);
+			base = map_anonymous(size, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT));
+			backing = PageBacking::Huge1G;
+		}
+		if (!base && policy_.pages != PageSize::Normal) {
+			size = round_up(bytes, HUGE_2M);
+			base = map_anonymous(size, MAP_HUGETLB | (21 << MAP_HUGE_SHIFT));
+			backing = PageBacking::Huge2M;
+		}
+		if (!base && policy_.pages != PageSize::Normal) {
+			size = round_up(bytes, HUGE_2M);
+			base = map_transparent(size);
+			backing = PageBacking::Transparent;
+		}
+		if (!base) {
+			size = round_up(bytes, SMALL_PAGE);
+			base = map_anonymous(size, 0);
+			backing = PageBacking::Normal;
+		}
+		if (!base)
+			throw std::bad_alloc();
+
+		if (policy_.numa_node != PagePolicy::ANY_NODE) {
+			int node = policy_.numa_node == PagePolicy::LOCAL_NODE ? current_numa_node()
+																														 : policy_.numa_node;
+			unsigned long mask[4] = {};
+			if (node >= 0 && node < static_cast<int>(sizeof(mask) * 8)) {
+				mask[node / 64] = 1ul << (node % 64);
+				long rc = ::syscall(SYS_mbind, base, size, MPOL_BIND, mask, sizeof(mask) * 8, 0);
+				bound_ &= rc == 0;
+			} else {
+				bound_ = false;
+			}
+		}
+
+		// First touch: fault every page in here, on the bound node
+		auto* bytes_ptr = static_cast<volatile std::byte*>(base);
+		for (size_t at = 0; at < size; at += SMALL_PAGE) {
+			bytes_ptr[at] = std::byte{0};
+		}
+
+		if (backing < backing_) {
+			backing_ = backing;
+		}
+		chunks_.push_back(Chunk{base, size});
+		return chunks_.back();
+	}
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		auto at = reinterpret_cast<uintptr_t>(cursor_);
+		auto* p = reinterpret_cast<std::byte*>(round_up(at, alignment));
+		if (!cursor_ || p + bytes > end_) {
+			Chunk chunk = map_chunk(std::max(bytes + alignment, policy_.chunk_bytes));
+			cursor_ = static_cast<std::byte*>(chunk.base);
+			end_ = cursor_ + chunk.bytes;
+			at = reinterpret_cast<uintptr_t>(cursor_);
+			p = reinterpret_cast<std::byte*>(round_up(at, alignment));
+		}
+		used_ += static_cast<size_t>(p + bytes - cursor_);
+		cursor_ = p + bytes;
+		return p;
+	}
+
+	void do_deallocate(void*, size_t, size_t) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+ public:
+	// Destroys what make() built, leaving the memory to the arena
+	struct Destroy {
+		template <typename T>
+		void operator()(T* p) const noexcept {
+			p->~T();
+		}
+	};
+
+	template <typename T>
+	using Ptr = std::unique_ptr<T, Destroy>;
+
+	// reserve_bytes > 0 maps (and touches) the first chunk right away
+	explicit PageArena(const PagePolicy& policy = {}, size_t reserve_bytes = 0) : policy_(policy) {
+		if (reserve_bytes) {
+			Chunk chunk = map_chunk(std::max(reserve_bytes, policy_.chunk_bytes));
+			cursor_ = static_cast<std::byte*>(chunk.base);
+			end_ = cursor_ + chunk.bytes;
+		}
+	}
+
+	// Allocations point into the mappings
+	PageArena(const PageArena&) = delete;
+	PageArena& operator=(const PageArena&) = delete;
+
+	~PageArena() override {
+		for (const Chunk& chunk : chunks_) {
+			::munmap(chunk.base, chunk.bytes);
+		}
+	}
+
+	// Construct a T on the arena; must not outlive it
+	template <typename T, typename... Args>
+	Ptr<T> make(Args&&... args) {
+		void* p = allocate(sizeof(T), alignof(T));
+		return Ptr<T>(::new (p) T(std::forward<Args>(args)...));
+	}
+
+	const PagePolicy& policy() const noexcept { return policy_; }
+
+	// Worst backing any chunk got (Huge1G until the first chunk is mapped)
+	PageBacking backing() const noexcept { return backing_; }
+
+	// Every chunk was bound to the policy's node (true for ANY_NODE)
+	bool numa_bound() const noexcept { return bound_; }
+
+	size_t used_bytes() const noexcept { return used_; }
+	size_t mapped_bytes() const noexcept {
+		size_t total = 0;
+		for (const Chunk& chunk : chunks_) {
+			total += chunk.bytes;
+		}
+		return total;
+	}
+};
+
+}	 // namespace matching_engine::memory
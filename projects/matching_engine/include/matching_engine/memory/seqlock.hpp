@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace matching_engine::memory {
+
+// Single-writer, multi-reader sequence lock over a small trivially copyable
+// T. The writer makes the sequence odd, stores the value, then makes it even
+// again; a reader copies the value between two reads of the sequence and
+// keeps the copy only if both were the same even number. Readers never
+// write shared memory, so any number of them poll without slowing each
+// other or the writer down.
+//
+// The value is stored as relaxed atomic words rather than a plain T, so a
+// read that overlaps a write is a discarded copy instead of a data race.
+// Sequence and value share one cache line when T fits in 56 bytes.
+template <typename T>
+class SeqLock {
+	static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+
+	static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	alignas(64) std::atomic<uint64_t> sequence_{0};
+	std::array<std::atomic<uint64_t>, WORDS> words_{};
+
+ public:
+	SeqLock() = default;
+	explicit SeqLock(const T& initial) noexcept { store(initial); }
+
+	SeqLock(const SeqLock&) = delete;
+	SeqLock& operator=(const SeqLock&) = delete;
+
+	// Writer thread only
+	void store(const T& value) noexcept {
+		std::array<uint64_t, WORDS> buffer{};
+		std::memcpy(buffer.data(), &value, sizeof(T));
+
+		uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+		sequence_.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < WORDS; ++i) {
+			words_[i].store(buffer[i], std::memory_order_relaxed);
+		}
+		sequence_.store(sequence + 2, std::memory_order_release);
+	}
+
+	// One wait-free attempt: false if a write was in progress or completed
+	// while copying, in which case out is unspecified
+	bool try_load(T& out) const noexcept {
+		uint64_t before = sequence_.load(std::memory_order_acquire);
+		if (before & 1)
+			return false;
+		std::array<uint64_t, WORDS> buffer;
+		for (size_t i = 0; i < WORDS; ++i) {
+			buffer[i] = words_[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence_.load(std::memory_order_relaxed) != before)
+			return false;
+		// Trivially copyable, though maybe not trivial (default member initializers)
+		std::memcpy(static_cast<void*>(&out), buffer.data(), sizeof(T));
+		return true;
+	}
+
+	// Retry until a consistent copy is read; never blocks the writer
+	T load() const noexcept {
+		T out;
+		while (!try_load(out)) {
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#endif
+		}
+		return out;
+	}
+
+	// Completed writes so far (sequence / 2); cheap change detection
+	uint64_t version() const noexcept { return sequence_.load(std::memory_order_acquire) / 2; }
+};
+
+}	 // namespace matching_engine::memory
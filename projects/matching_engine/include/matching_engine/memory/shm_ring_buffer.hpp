@@ -0,0 +1,403 @@
+#pragma once
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+#include "../metrics/metrics.hpp"
+#include "async_queue.hpp"
+
+namespace matching_engine::memory {
+
+// Cross-process wakeup word, on its own cache line of the segment. Sleepers
+// register, re-check their condition and FUTEX_WAIT on sequence; a notifier
+// publishes its state change and only bumps sequence and FUTEX_WAKEs when
+// someone is registered, so a handoff with nobody asleep makes no syscall.
+// The futexes are shared (not FUTEX_PRIVATE), as the peers are processes.
+struct alignas(64) ShmSignal {
+	std::atomic<uint32_t> sequence{0};
+	std::atomic<uint32_t> sleepers{0};
+
+	void notify() noexcept {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleepers.load(std::memory_order_relaxed) == 0)
+			return;
+		sequence.fetch_add(1, std::memory_order_release);
+		::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAKE, INT_MAX, nullptr,
+							nullptr, 0);
+	}
+
+	// Sleep until notified, unless ready() already holds. Wakes may be
+	// spurious; timeout (relative) may be nullptr.
+	template <typename Ready>
+	void wait(Ready&& ready, const timespec* timeout) noexcept {
+		sleepers.fetch_add(1, std::memory_order_seq_cst);
+		uint32_t seen = sequence.load(std::memory_order_acquire);
+		if (!ready()) {
+			::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAIT, seen, timeout,
+								nullptr, 0);
+		}
+		sleepers.fetch_sub(1, std::memory_order_relaxed);
+	}
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == 4,
+							"Futex words must be plain 32-bit integers");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+							"Shared indices must be address-free (lock-free) atomics");
+
+// Start of every segment. The creator fills it in and stores version last,
+// so a peer that opens the segment early sees it as not (yet) valid.
+struct alignas(64) ShmRingHeader {
+	static constexpr std::array<char, 8> MAGIC{'M', 'E', 'S', 'H', 'R', 'N', 'G', '1'};
+	static constexpr uint32_t VERSION = 1;
+
+	std::array<char, 8> magic;
+	std::atomic<uint32_t> version;
+	uint32_t slot_size;
+	uint32_t slot_align;
+	uint64_t capacity;
+	std::atomic<uint32_t> closed;
+
+	bool valid(uint32_t size, uint32_t align, uint64_t slots) const noexcept {
+		return version.load(std::memory_order_acquire) == VERSION && magic == MAGIC &&
+					 slot_size == size && slot_align == align && capacity == slots;
+	}
+};
+
+// Which end of the ring a process holds. It decides which side's parked
+// coroutines the handle's watcher thread wakes on the peer's behalf.
+enum class ShmRole : uint8_t {
+	Producer,
+	Consumer,
+};
+
+// AsyncRingBuffer laid out in a named POSIX shared-memory segment, for an
+// SPSC handoff between processes (gateway -> engine -> publisher). The
+// segment holds the header, both indices, the two wakeup words and the
+// slots; each process maps it and keeps its cached copy of the other
+// side's index locally, so steady-state transfers cost the same as in
+// process. T must be trivially copyable (e.g. PackedOrderEvent).
+//
+// push_async/pop_async work across processes: each handle runs a watcher
+// thread that sleeps until one of its own role's coroutines parks, then
+// on the peer's futex, and hands the wakeup to the local WaiterQueue. The
+// thread costs nothing while no coroutine is parked. Threads that do not
+// run coroutines can block in wait_readable()/wait_writable() instead.
+//
+// Either side may create() the segment; the other open()s it and gets
+// nullptr until the creator is done, so it can retry. The segment outlives
+// the handles until unlink(). close() is shared: it stops both sides.
+template <typename T, size_t Capacity>
+class ShmRingBuffer : public AsyncQueueBase<ShmRingBuffer<T, Capacity>, T> {
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
+	static_assert(std::is_trivially_copyable_v<T>, "Slots are shared between processes");
+
+	using Base = AsyncQueueBase<ShmRingBuffer<T, Capacity>, T>;
+	friend Base;
+
+ public:
+	using value_type = T;
+
+	struct Layout {
+		ShmRingHeader header;
+		alignas(64) std::atomic<uint64_t> write_pos;
+		alignas(64) std::atomic<uint64_t> read_pos;
+		ShmSignal readable;	 // Producer -> sleeping consumers
+		ShmSignal writable;	 // Consumer -> sleeping producers
+		alignas(64) std::array<T, Capacity> slots;
+	};
+
+ private:
+	static constexpr uint64_t INDEX_MASK = Capacity - 1;
+
+	Layout* shm_;
+	ShmRole role_;
+
+	// Producer line
+	alignas(64) uint64_t cached_read_pos_ = 0;
+
+	// Consumer line
+	alignas(64) uint64_t cached_write_pos_ = 0;
+
+	// Watcher thread state
+	alignas(64) std::atomic<uint32_t> parks_{0};	// Bumped when a local coroutine parks
+	std::atomic<bool> stopping_{false};
+	std::thread watcher_;
+
+	ShmRingBuffer(Layout* shm, ShmRole role) : shm_(shm), role_(role) {
+		cached_read_pos_ = shm_->read_pos.load(std::memory_order_acquire);
+		cached_write_pos_ = shm_->write_pos.load(std::memory_order_acquire);
+		watcher_ = std::thread([this] { watch(); });
+	}
+
+	size_t free_slots(uint64_t write, size_t wanted) noexcept {
+		size_t free = Capacity - static_cast<size_t>(write - cached_read_pos_);
+		if (free < wanted) {
+			cached_read_pos_ = shm_->read_pos.load(std::memory_order_acquire);
+			free = Capacity - static_cast<size_t>(write - cached_read_pos_);
+		}
+		return free;
+	}
+
+	size_t filled_slots(uint64_t read, size_t wanted) noexcept {
+		size_t filled = static_cast<size_t>(cached_write_pos_ - read);
+		if (filled < wanted) {
+			cached_write_pos_ = shm_->write_pos.load(std::memory_order_acquire);
+			filled = static_cast<size_t>(cached_write_pos_ - read);
+		}
+		return filled;
+	}
+
+	void published(uint64_t write) noexcept {
+		shm_->write_pos.store(write, std::memory_order_release);
+		metrics::record(metrics::Histogram::QueueOccupancy, write - cached_read_pos_);
+		shm_->readable.notify();
+		this->notify_consumer();
+	}
+
+	void consumed(uint64_t read) noexcept {
+		shm_->read_pos.store(read, std::memory_order_release);
+		shm_->writable.notify();
+		this->notify_producer();
+	}
+
+	// AsyncQueueBase hooks: a coroutine of this handle's role just parked
+	void consumer_parked() noexcept {
+		if (role_ == ShmRole::Consumer) {
+			wake_watcher();
+		}
+	}
+
+	void producer_parked() noexcept {
+		if (role_ == ShmRole::Producer) {
+			wake_watcher();
+		}
+	}
+
+	void wake_watcher() noexcept {
+		parks_.fetch_add(1, std::memory_order_release);
+		parks_.notify_one();
+	}
+
+	bool role_ready() const noexcept {
+		return closed() || (role_ == ShmRole::Consumer ? !empty() : !full());
+	}
+
+	// Forward the peer's wakeups to parked local coroutines of our role
+	void watch() {
+		ShmSignal& signal = role_ == ShmRole::Consumer ? shm_->readable : shm_->writable;
+		coro::WaiterQueue& local = role_ == ShmRole::Consumer ? this->consumers_ : this->producers_;
+		auto ready = [this] { return stopping_.load(std::memory_order_acquire) || role_ready(); };
+
+		for (;;) {
+			uint32_t parks = parks_.load(std::memory_order_acquire);
+			if (stopping_.load(std::memory_order_acquire))
+				return;
+			if (!local.has_waiters()) {
+				parks_.wait(parks, std::memory_order_acquire);
+				continue;
+			}
+
+			signal.wait(ready, nullptr);
+			if (stopping_.load(std::memory_order_acquire))
+				return;
+			if (closed()) {
+				Base::close();	// Local flag and every parked coroutine
+			} else if (role_ready()) {
+				local.notify_one();
+			}
+		}
+	}
+
+	template <typename Ready>
+	static bool sleep_until_ready(ShmSignal& signal, Ready&& ready,
+														 std::chrono::nanoseconds timeout) {
+		auto deadline = std::chrono::steady_clock::now() + timeout;
+		while (!ready()) {
+			auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					deadline - std::chrono::steady_clock::now());
+			if (left.count() <= 0)
+				return false;
+			timespec ts{.tv_sec = static_cast<time_t>(left.count() / 1'000'000'000),
+									.tv_nsec = static_cast<long>(left.count() % 1'000'000'000)};
+			signal.wait(ready, &ts);
+		}
+		return true;
+	}
+
+	static constexpr uint32_t SLOT_SIZE = sizeof(T);
+	static constexpr uint32_t SLOT_ALIGN = alignof(T);
+
+ public:
+	// New segment under name ("/something"); nullptr if it already exists
+	// or cannot be created
+	static std::unique_ptr<ShmRingBuffer> create(const char* name, ShmRole role) {
+		int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+		if (fd < 0)
+			return nullptr;
+		if (::ftruncate(fd, sizeof(Layout)) != 0) {
+			::close(fd);
+			::shm_unlink(name);
+			return nullptr;
+		}
+		void* map = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+										 fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED) {
+			::shm_unlink(name);
+			return nullptr;
+		}
+
+		auto* shm = ::new (map) Layout{};
+		shm->header.magic = ShmRingHeader::MAGIC;
+		shm->header.slot_size = SLOT_SIZE;
+		shm->header.slot_align = SLOT_ALIGN;
+		shm->header.capacity = Capacity;
+		shm->header.version.store(ShmRingHeader::VERSION, std::memory_order_release);
+		return std::unique_ptr<ShmRingBuffer>(new ShmRingBuffer(shm, role));
+	}
+
+	// Map an existing segment; nullptr when it is missing, still being
+	// created, or laid out for another version, slot type or capacity
+	static std::unique_ptr<ShmRingBuffer> open(const char* name, ShmRole role) {
+		int fd = ::shm_open(name, O_RDWR | O_CLOEXEC, 0);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || st.st_size != static_cast<off_t>(sizeof(Layout))) {
+			::close(fd);
+			return nullptr;
+		}
+		void* map = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+										 fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED)
+			return nullptr;
+
+		auto* shm = static_cast<Layout*>(map);
+		if (!shm->header.valid(SLOT_SIZE, SLOT_ALIGN, Capacity)) {
+			::munmap(map, sizeof(Layout));
+			return nullptr;
+		}
+		return std::unique_ptr<ShmRingBuffer>(new ShmRingBuffer(shm, role));
+	}
+
+	// Remove the name; mapped handles keep working
+	static bool unlink(const char* name) noexcept { return ::shm_unlink(name) == 0; }
+
+	ShmRingBuffer(const ShmRingBuffer&) = delete;
+	ShmRingBuffer& operator=(const ShmRingBuffer&) = delete;
+
+	~ShmRingBuffer() {
+		stopping_.store(true, std::memory_order_seq_cst);
+		wake_watcher();
+		(role_ == ShmRole::Consumer ? shm_->readable : shm_->writable).notify();
+		watcher_.join();
+		::munmap(shm_, sizeof(Layout));
+	}
+
+	ShmRole role() const noexcept { return role_; }
+
+	size_t size() const noexcept {
+		auto write = shm_->write_pos.load(std::memory_order_acquire);
+		auto read = shm_->read_pos.load(std::memory_order_acquire);
+		return static_cast<size_t>(write - read);
+	}
+
+	bool empty() const noexcept { return size() == 0; }
+
+	bool full() const noexcept { return size() >= Capacity; }
+
+	// Shared with the peer: either side closing wakes and stops both
+	void close() {
+		shm_->header.closed.store(1, std::memory_order_seq_cst);
+		shm_->readable.notify();
+		shm_->writable.notify();
+		Base::close();
+	}
+
+	bool closed() const noexcept { return shm_->header.closed.load(std::memory_order_acquire) != 0; }
+
+	bool push(const T& value) noexcept {
+		auto write = shm_->write_pos.load(std::memory_order_relaxed);
+		if (free_slots(write, 1) == 0) {
+			return false;	 // Buffer full
+		}
+
+		shm_->slots[write & INDEX_MASK] = value;
+		published(write + 1);
+		return true;
+	}
+
+	// Push as many of values as fit with one index publish; returns the count
+	size_t push_bulk(std::span<const T> values) noexcept {
+		auto write = shm_->write_pos.load(std::memory_order_relaxed);
+		size_t n = std::min(values.size(), free_slots(write, values.size()));
+		if (n == 0)
+			return 0;
+
+		for (size_t i = 0; i < n; ++i) {
+			shm_->slots[(write + i) & INDEX_MASK] = values[i];
+		}
+		published(write + n);
+		return n;
+	}
+
+	std::optional<T> pop() noexcept {
+		auto read = shm_->read_pos.load(std::memory_order_relaxed);
+		if (filled_slots(read, 1) == 0) {
+			return std::nullopt;	// Buffer empty
+		}
+
+		T value = shm_->slots[read & INDEX_MASK];
+		consumed(read + 1);
+		return value;
+	}
+
+	// Pop up to out.size() values into out; returns the number popped
+	size_t pop_bulk(std::span<T> out) noexcept {
+		auto read = shm_->read_pos.load(std::memory_order_relaxed);
+		size_t n = std::min(out.size(), filled_slots(read, out.size()));
+		if (n == 0)
+			return 0;
+
+		for (size_t i = 0; i < n; ++i) {
+			out[i] = shm_->slots[(read + i) & INDEX_MASK];
+		}
+		consumed(read + n);
+		return n;
+	}
+
+	// Block the calling thread until pop() can succeed or the ring is
+	// closed; false on timeout
+	bool wait_readable(std::chrono::nanoseconds timeout) {
+		return sleep_until_ready(shm_->readable, [this] { return !empty() || closed(); }, timeout);
+	}
+
+	// Block the calling thread until push() can succeed or the ring is
+	// closed; false on timeout
+	bool wait_writable(std::chrono::nanoseconds timeout) {
+		return sleep_until_ready(shm_->writable, [this] { return !full() || closed(); }, timeout);
+	}
+};
+
+}	 // namespace matching_engine::memory
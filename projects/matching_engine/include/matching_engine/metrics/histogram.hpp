@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace matching_engine::metrics {
+
+struct HistogramSnapshot;
+
+// Log-bucketed histogram in the style of HdrHistogram: values below
+// 2 * SUB_BUCKETS get a bucket each, and every power of two above that is
+// split into SUB_BUCKETS linear buckets, so a recorded value is known to
+// within 1/16 over the whole uint64_t range in under 8 KiB.
+//
+// One thread records; any thread may read at the same time. Counts are
+// atomics updated with a relaxed load and store (no read-modify-write, no
+// lock), so recording costs a few plain moves and a reader sees each count
+// at most one record late.
+class LogHistogram {
+ public:
+	static constexpr unsigned SUB_BUCKET_BITS = 4;
+	static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+	static constexpr size_t BUCKETS = (65 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+	static constexpr size_t bucket_of(uint64_t value) noexcept {
+		unsigned width = static_cast<unsigned>(std::bit_width(value));
+		if (width <= SUB_BUCKET_BITS)
+			return static_cast<size_t>(value);
+		unsigned shift = width - SUB_BUCKET_BITS - 1;
+		return shift * SUB_BUCKETS + static_cast<size_t>(value >> shift);
+	}
+
+	// Range of values counted in bucket
+	static constexpr uint64_t lowest_in(size_t bucket) noexcept {
+		if (bucket < 2 * SUB_BUCKETS)
+			return bucket;
+		size_t shift = bucket / SUB_BUCKETS - 1;
+		return static_cast<uint64_t>(bucket - shift * SUB_BUCKETS) << shift;
+	}
+
+	static constexpr uint64_t highest_in(size_t bucket) noexcept {
+		return bucket + 1 < BUCKETS ? lowest_in(bucket + 1) - 1 : UINT64_MAX;
+	}
+
+	void record(uint64_t value) noexcept {
+		bump(counts_[bucket_of(value)], 1);
+		bump(total_, 1);
+		bump(sum_, value);
+		if (value > max_.load(std::memory_order_relaxed)) {
+			max_.store(value, std::memory_order_relaxed);
+		}
+	}
+
+	uint64_t count() const noexcept { return total_.load(std::memory_order_relaxed); }
+
+	// Add this histogram's counts to out
+	void merge_into(HistogramSnapshot& out) const noexcept;
+
+ private:
+	std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+	std::atomic<uint64_t> total_{0};
+	std::atomic<uint64_t> sum_{0};
+	std::atomic<uint64_t> max_{0};
+
+	// Single writer: no lock prefix needed
+	static void bump(std::atomic<uint64_t>& slot, uint64_t n) noexcept {
+		slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+};
+
+// Plain copy of one or more merged histograms, for reporting
+struct HistogramSnapshot {
+	std::array<uint64_t, LogHistogram::BUCKETS> counts{};
+	uint64_t total = 0;
+	uint64_t sum = 0;
+	uint64_t max = 0;
+
+	double mean() const noexcept {
+		return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0;
+	}
+
+	// Upper end of the bucket holding quantile q (0..1), capped at max; 0
+	// when nothing was recorded
+	uint64_t percentile(double q) const noexcept {
+		if (total == 0)
+			return 0;
+		auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * total));
+		rank = std::max<uint64_t>(rank, 1);
+		uint64_t seen = 0;
+		for (size_t i = 0; i < counts.size(); ++i) {
+			seen += counts[i];
+			if (seen >= rank)
+				return std::min(LogHistogram::highest_in(i), max);
+		}
+		return max;
+	}
+};
+
+inline void LogHistogram::merge_into(HistogramSnapshot& out) const noexcept {
+	for (size_t i = 0; i < BUCKETS; ++i) {
+		out.counts[i] += counts_[i].load(std::memory_order_relaxed);
+	}
+	out.total += total_.load(std::memory_order_relaxed);
+	out.sum += sum_.load(std::memory_order_relaxed);
+	out.max = std::max(out.max, max_.load(std::memory_order_relaxed));
+}
+
+}	 // namespace matching_engine::metrics
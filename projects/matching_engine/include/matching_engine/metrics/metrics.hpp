@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../core/clock.hpp"
+#include "histogram.hpp"
+
+// Instrumentation switch, normally set by the MATCHING_ENGINE_METRICS CMake
+// option. Off, every hook below is an empty inline function and the engine
+// compiles to exactly what it was without them.
+#ifndef MATCHING_ENGINE_METRICS
+#define MATCHING_ENGINE_METRICS 0
+#endif
+
+namespace matching_engine::metrics {
+
+inline constexpr bool enabled = MATCHING_ENGINE_METRICS != 0;
+
+// What the engine measures, one histogram each
+enum class Histogram : uint8_t {
+	OrderToAck,			 // ns from an inbound event reaching the book to its ack
+	FillsPerOrder,	 // Fill events produced by one inbound event
+	QueueOccupancy,	 // AsyncRingBuffer slots in use after a push
+	SubmitAwait,		 // ns spent in SubmitOrderAwaitable
+	BatchAwait,			 // ns spent in BatchAwaitable
+	Count
+};
+
+enum class Counter : uint8_t {
+	Events,		// Inbound events processed
+	Fills,		// Fill events produced
+	Rejects,	// Inbound events rejected
+	Count
+};
+
+inline constexpr size_t HISTOGRAMS = static_cast<size_t>(Histogram::Count);
+inline constexpr size_t COUNTERS = static_cast<size_t>(Counter::Count);
+
+// One thread's slots; only that thread writes them
+struct ThreadMetrics {
+	std::array<LogHistogram, HISTOGRAMS> histograms;
+	std::array<std::atomic<uint64_t>, COUNTERS> counters{};
+
+	void record(Histogram which, uint64_t value) noexcept {
+		histograms[static_cast<size_t>(which)].record(value);
+	}
+
+	void count(Counter which, uint64_t n) noexcept {
+		auto& slot = counters[static_cast<size_t>(which)];
+		slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+};
+
+// Totals over every thread that recorded so far
+struct Snapshot {
+	std::array<HistogramSnapshot, HISTOGRAMS> histograms{};
+	std::array<uint64_t, COUNTERS> counters{};
+	size_t threads = 0;
+
+	const HistogramSnapshot& operator[](Histogram which) const {
+		return histograms[static_cast<size_t>(which)];
+	}
+	uint64_t operator[](Counter which) const { return counters[static_cast<size_t>(which)]; }
+};
+
+// Per-thread slots, created the first time a thread records and kept after
+// it exits so totals never go backwards. The mutex guards only the list of
+// threads: a thread takes it once to register, and snapshot() takes it to
+// walk the list while reading the slots with relaxed loads. Recording never
+// waits on a reader.
+class Registry {
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<ThreadMetrics>> threads_;
+
+ public:
+	static Registry& instance() {
+		static Registry registry;
+		return registry;
+	}
+
+	// Calling thread's slots
+	ThreadMetrics& local() {
+		thread_local ThreadMetrics* slots = nullptr;
+		if (!slots) {
+			auto owned = std::make_unique<ThreadMetrics>();
+			slots = owned.get();
+			std::lock_guard lock(mutex_);
+			threads_.push_back(std::move(owned));
+		}
+		return *slots;
+	}
+
+	Snapshot snapshot() {
+		Snapshot out;
+		std::lock_guard lock(mutex_);
+		for (const auto& thread : threads_) {
+			for (size_t i = 0; i < HISTOGRAMS; ++i) {
+				thread->histograms[i].merge_into(out.histograms[i]);
+			}
+			for (size_t i = 0; i < COUNTERS; ++i) {
+				out.counters[i] += thread->counters[i].load(std::memory_order_relaxed);
+			}
+		}
+		out.threads = threads_.size();
+		return out;
+	}
+};
+
+// Hooks used by the engine
+
+inline uint64_t now_ns() noexcept { return TscClock{}.now().nanoseconds; }
+
+inline void record(Histogram which, uint64_t value) noexcept {
+	if constexpr (enabled) {
+		Registry::instance().local().record(which, value);
+	}
+}
+
+inline void count(Counter which, uint64_t n = 1) noexcept {
+	if constexpr (enabled) {
+		Registry::instance().local().count(which, n);
+	}
+}
+
+// Records the nanoseconds between construction and destruction
+class ScopedTimer {
+	[[maybe_unused]] Histogram which_;
+	[[maybe_unused]] uint64_t start_ = 0;
+
+ public:
+	explicit ScopedTimer(Histogram which) noexcept : which_(which) {
+		if constexpr (enabled) {
+			start_ = now_ns();
+		}
+	}
+
+	~ScopedTimer() {
+		if constexpr (enabled) {
+			record(which_, now_ns() - start_);
+		}
+	}
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+inline Snapshot snapshot() { return Registry::instance().snapshot(); }
+
+// Hands a fresh snapshot to report every interval from its own thread,
+// until destroyed. The hot threads never see it.
+class PeriodicExporter {
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	bool stop_ = false;
+	std::thread thread_;
+
+ public:
+	PeriodicExporter(std::chrono::milliseconds interval,
+									 std::function<void(const Snapshot&)> report)
+			: thread_([this, interval, report = std::move(report)] {
+					std::unique_lock lock(mutex_);
+					while (!wakeup_.wait_for(lock, interval, [this] { return stop_; })) {
+						lock.unlock();
+						report(snapshot());
+						lock.lock();
+					}
+				}) {}
+
+	PeriodicExporter(const PeriodicExporter&) = delete;
+	PeriodicExporter& operator=(const PeriodicExporter&) = delete;
+
+	~PeriodicExporter() {
+		{
+			std::lock_guard lock(mutex_);
+			stop_ = true;
+		}
+		wakeup_.notify_all();
+		thread_.join();
+	}
+};
+
+}	 // namespace matching_engine::metrics
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/clock.hpp"
+#include "../core/packed_event.hpp"
+#include "../core/types.hpp"
+#include "../matching/async_engine.hpp"
+#include "../matching/orderbook.hpp"
+#include "../scheduler/coro_scheduler.hpp"
+#include "../scheduler/thread_pool.hpp"
+#include "journal.hpp"
+
+namespace matching_engine::persistence {
+
+// What one book did over a backtest
+struct BookReplayStats {
+	SymbolId symbol{0};
+	size_t events = 0;		// Inbound records applied
+	size_t rejects = 0;		// Of those, rejected by the book
+	size_t fills = 0;
+	uint64_t volume = 0;						// Sum of fill quantities
+	double notional_ticks = 0;			// Sum of fill price (ticks) * quantity
+	Timestamp first_event{0};				// Recorded time of the first and last record
+	Timestamp last_event{0};
+	size_t resting_orders = 0;			// Left in the book at the end
+	std::optional<Price> best_bid;
+	std::optional<Price> best_ask;
+	uint64_t replay_ns = 0;					// Wall time the worker spent on this book
+	std::vector<OrderEvent> fill_log;	// Every fill, when BacktestOptions::keep_fills
+
+	double vwap_ticks() const noexcept {
+		return volume ? notional_ticks / static_cast<double>(volume) : 0;
+	}
+};
+
+struct BacktestReport {
+	std::vector<BookReplayStats> books;	 // One per symbol, by symbol id
+	size_t workers = 0;
+	size_t events = 0;
+	size_t rejects = 0;
+	size_t fills = 0;
+	uint64_t volume = 0;
+	double notional_ticks = 0;
+	size_t skipped = 0;				// Capture records that are not inbound events
+	uint64_t elapsed_ns = 0;	// Wall time of the parallel replay
+
+	double events_per_second() const noexcept {
+		return elapsed_ns ? static_cast<double>(events) * 1e9 / static_cast<double>(elapsed_ns) : 0;
+	}
+};
+
+struct BacktestOptions {
+	matching::BookConfig book;	// For symbols without their own set_config()
+	bool keep_fills = false;	// Collect every fill into BookReplayStats::fill_log
+};
+
+// Historical replay of captured order flow across many books at once.
+// Capture files are journals (see JournalWriter), possibly holding several
+// symbols each; add_capture() maps one and files its inbound records under
+// their symbol without copying them. run() then replays every symbol's
+// records through its own fresh book on a ThreadPool, one task per book,
+// largest books first so the long ones do not end up last on an otherwise
+// idle pool.
+//
+// Each book runs on a ReplayClock set to every record's recorded time, and
+// sees its records in capture order (files in the order they were added),
+// so a book's fills, ids and final state do not depend on the number of
+// workers or on which worker picked it up. A book is touched by one task
+// only, so the tasks share nothing but their read-only slice of the maps.
+template <typename Book = matching::BasicOrderBook<matching::MapPriceLevels, ReplayClock>>
+class BacktestRunner {
+	struct Partition {
+		SymbolId symbol;
+		std::vector<const PackedOrderEvent*> records;
+	};
+
+	std::vector<std::unique_ptr<JournalReader>> captures_;
+	std::vector<Partition> partitions_;
+	std::unordered_map<uint32_t, size_t> partition_of_;	 // Symbol id -> partitions_ index
+	std::unordered_map<uint32_t, matching::BookConfig> configs_;
+	size_t records_ = 0;
+	size_t skipped_ = 0;
+
+	// Fills into the book's stats, counted as they happen
+	struct StatsSink {
+		BookReplayStats& stats;
+		bool keep;
+
+		void operator()(const OrderEvent& event) {
+			if (event.type != OrderEventType::Fill)
+				return;
+			++stats.fills;
+			stats.volume += event.quantity.value;
+			stats.notional_ticks +=
+					static_cast<double>(event.price.ticks) * static_cast<double>(event.quantity.value);
+			if (keep) {
+				stats.fill_log.push_back(event);
+			}
+		}
+
+		void operator()(std::span<const OrderEvent> events) {
+			for (const OrderEvent& event : events) {
+				(*this)(event);
+			}
+		}
+	};
+
+	static bool inbound(OrderEventType type) noexcept {
+		return type == OrderEventType::New || type == OrderEventType::Cancel ||
+					 type == OrderEventType::Modify;
+	}
+
+	coro::Task<void> replay_book(const Partition& partition, matching::BookConfig config,
+															 bool keep_fills, BookReplayStats& stats) {
+		auto start = std::chrono::steady_clock::now();
+		config.symbol = partition.symbol;
+		// Built on the worker, so the book's pools are first touched there
+		auto engine = std::make_unique<matching::SyncMatchingEngine<Book>>(config);
+		StatsSink sink{stats, keep_fills};
+
+		stats.symbol = partition.symbol;
+		for (const PackedOrderEvent* record : partition.records) {
+			OrderEvent event = record->to_event();
+			if constexpr (requires { engine->orderbook().clock().set(event.timestamp); }) {
+				engine->orderbook().clock().set(event.timestamp);
+			}
+			stats.rejects += engine->process_event(event, sink).is_err();
+		}
+		stats.events = partition.records.size();
+		if (!partition.records.empty()) {
+			stats.first_event = Timestamp{partition.records.front()->timestamp_ns};
+			stats.last_event = Timestamp{partition.records.back()->timestamp_ns};
+		}
+		stats.resting_orders = engine->orderbook().order_count();
+		stats.best_bid = engine->get_best_bid();
+		stats.best_ask = engine->get_best_ask();
+		engine.reset();
+		stats.replay_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+																								std::chrono::steady_clock::now() - start)
+																								.count());
+		co_return;
+	}
+
+ public:
+	BacktestRunner() = default;
+
+	// Partitions point into the mapped captures
+	BacktestRunner(const BacktestRunner&) = delete;
+	BacktestRunner& operator=(const BacktestRunner&) = delete;
+
+	// Map a capture and partition its records by symbol; false when the
+	// file is missing or not a journal. Only between runs.
+	bool add_capture(const char* path) {
+		auto reader = JournalReader::open(path);
+		if (!reader)
+			return false;
+		for (const PackedOrderEvent& record : reader->records()) {
+			if (!inbound(record.type)) {
+				++skipped_;
+				continue;
+			}
+			auto [it, added] = partition_of_.try_emplace(record.symbol_id, partitions_.size());
+			if (added) {
+				partitions_.push_back(Partition{.symbol = SymbolId{record.symbol_id}});
+			}
+			partitions_[it->second].records.push_back(&record);
+			++records_;
+		}
+		captures_.push_back(std::move(reader));
+		return true;
+	}
+
+	// Book settings for one symbol (config.symbol is overwritten)
+	void set_config(SymbolId symbol, const matching::BookConfig& config) {
+		configs_[symbol.value] = config;
+	}
+
+	size_t capture_count() const noexcept { return captures_.size(); }
+	size_t book_count() const noexcept { return partitions_.size(); }
+	size_t record_count() const noexcept { return records_; }
+
+	// Replay every book on pool and wait for all of them. Also waits out any
+	// other work queued on the pool. Can be run again (fresh books each time).
+	BacktestReport run(coro::ThreadPool& pool, const BacktestOptions& options = {}) {
+		BacktestReport report;
+		report.workers = pool.size();
+		report.skipped = skipped_;
+		report.books.resize(partitions_.size());
+
+		std::vector<size_t> order(partitions_.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			return partitions_[a].records.size() > partitions_[b].records.size();
+		});
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<coro::Task<void>> tasks;
+		tasks.reserve(order.size());
+		for (size_t i : order) {
+			const Partition& partition = partitions_[i];
+			auto config = configs_.find(partition.symbol.value);
+			const auto& book = config == configs_.end() ? options.book : config->second;
+			tasks.push_back(replay_book(partition, book, options.keep_fills, report.books[i]));
+			pool.spawn(tasks.back());
+		}
+		pool.wait_idle();
+		report.elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+																									std::chrono::steady_clock::now() - start)
+																									.count());
+		tasks.clear();
+
+		std::sort(report.books.begin(), report.books.end(),
+							[](const BookReplayStats& a, const BookReplayStats& b) {
+								return a.symbol < b.symbol;
+							});
+		for (const BookReplayStats& book : report.books) {
+			report.events += book.events;
+			report.rejects += book.rejects;
+			report.fills += book.fills;
+			report.volume += book.volume;
+			report.notional_ticks += book.notional_ticks;
+		}
+		return report;
+	}
+};
+
+}	 // namespace matching_engine::persistence
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/packed_event.hpp"
+#include "../core/types.hpp"
+#include "../matching/event_sink.hpp"
+#include "../memory/async_ring_buffer.hpp"
+
+namespace matching_engine::persistence {
+
+namespace detail {
+
+// write() until everything is out, retrying short writes and EINTR
+inline bool write_fully(int fd, const void* data, size_t bytes) noexcept {
+	auto* cursor = static_cast<const char*>(data);
+	while (bytes > 0) {
+		ssize_t n = ::write(fd, cursor, bytes);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		cursor += n;
+		bytes -= static_cast<size_t>(n);
+	}
+	return true;
+}
+
+}	 // namespace detail
+
+// On-disk layout: one JournalHeader, then PackedOrderEvent records back to
+// back. Records are the inbound events (New / Cancel / Modify) stamped with
+// the time the book assigned them, so replaying them through a ReplayClock
+// book reproduces ids, priorities and fill timestamps exactly. Rejected
+// inbound events are journaled too, since a rejected New still consumes an
+// order id. Records are numbered from base_sequence, which is non-zero
+// once compact_journal() dropped a prefix already covered by a snapshot.
+struct alignas(64) JournalHeader {
+	static constexpr std::array<char, 8> MAGIC{'M', 'E', 'J', 'R', 'N', 'L', '0', '1'};
+	static constexpr uint32_t VERSION = 3;
+
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t base_sequence;
+
+	bool valid() const noexcept {
+		return magic == MAGIC && version == VERSION && record_size == sizeof(PackedOrderEvent);
+	}
+};
+
+static_assert(sizeof(JournalHeader) == 64, "Records must start on a cache line");
+
+struct JournalOptions {
+	size_t max_batch = 4096;										// Records per write + sync
+	std::chrono::microseconds idle_wait{200};		// Writer poll period when idle
+	bool sync = true;														// fdatasync after each batch
+};
+
+// Append-only journal writer. append() runs on the matching thread and only
+// copies the record into an SPSC ring; a background thread drains the ring
+// in batches, writes each batch with one write() and makes it durable with
+// one fdatasync (group commit). durable() tells how many records reached
+// the disk, so acknowledgements can wait for it.
+class JournalWriter {
+	static constexpr size_t RING_SIZE = 1 << 14;
+
+	int fd_;
+	uint64_t start_position_;	 // Journal position when this writer opened
+	JournalOptions options_;
+	memory::AsyncRingBuffer<PackedOrderEvent, RING_SIZE> ring_;
+	uint64_t appended_ = 0;	 // Producer side only
+	std::atomic<uint64_t> durable_{0};
+	std::atomic<bool> failed_{false};
+	std::atomic<bool> stop_{false};
+	std::thread writer_;
+
+	void run() {
+		std::vector<PackedOrderEvent> batch(options_.max_batch);
+		for (;;) {
+			size_t n = ring_.pop_bulk(batch);
+			if (n == 0) {
+				if (stop_.load(std::memory_order_acquire) && ring_.empty())
+					break;
+				std::this_thread::sleep_for(options_.idle_wait);
+				continue;
+			}
+
+			// Top the batch up with whatever arrived meanwhile
+			while (n < batch.size()) {
+				size_t more = ring_.pop_bulk(std::span(batch).subspan(n));
+				if (more == 0)
+					break;
+				n += more;
+			}
+
+			if (failed_.load(std::memory_order_relaxed))
+				continue;	 // Keep draining so append() never blocks forever
+			if (!detail::write_fully(fd_, batch.data(), n * sizeof(PackedOrderEvent)) ||
+					(options_.sync && ::fdatasync(fd_) != 0)) {
+				failed_.store(true, std::memory_order_release);
+				continue;
+			}
+			durable_.fetch_add(n, std::memory_order_release);
+		}
+	}
+
+	JournalWriter(int fd, uint64_t start_position, const JournalOptions& options)
+			: fd_(fd), start_position_(start_position), options_(options) {
+		writer_ = std::thread([this] { run(); });
+	}
+
+ public:
+	// Open (creating if needed) a journal for appending; nullptr on failure
+	// or when an existing file is not a journal. A torn final record left by
+	// a crash is cut off so new records stay aligned.
+	static std::unique_ptr<JournalWriter> open(const char* path, const JournalOptions& options = {}) {
+		int fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st;
+		if (::fstat(fd, &st) != 0) {
+			::close(fd);
+			return nullptr;
+		}
+		uint64_t position = 0;
+		if (st.st_size == 0) {
+			JournalHeader header{.magic = JournalHeader::MAGIC,
+													 .version = JournalHeader::VERSION,
+													 .record_size = sizeof(PackedOrderEvent),
+													 .base_sequence = 0};
+			if (::write(fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+				::close(fd);
+				return nullptr;
+			}
+		} else {
+			JournalHeader header;
+			int rfd = ::open(path, O_RDONLY | O_CLOEXEC);
+			bool valid = rfd >= 0 && ::read(rfd, &header, sizeof(header)) == sizeof(header) &&
+									 header.valid();
+			if (rfd >= 0) {
+				::close(rfd);
+			}
+			auto size = static_cast<size_t>(st.st_size);
+			size_t whole = size - (size - sizeof(header)) % sizeof(PackedOrderEvent);
+			if (!valid || (whole != size && ::ftruncate(fd, static_cast<off_t>(whole)) != 0)) {
+				::close(fd);
+				return nullptr;
+			}
+			position = header.base_sequence + (whole - sizeof(header)) / sizeof(PackedOrderEvent);
+		}
+		return std::unique_ptr<JournalWriter>(new JournalWriter(fd, position, options));
+	}
+
+	JournalWriter(const JournalWriter&) = delete;
+	JournalWriter& operator=(const JournalWriter&) = delete;
+
+	// Drains everything appended so far, syncs it and closes the file
+	~JournalWriter() {
+		stop_.store(true, std::memory_order_release);
+		writer_.join();
+		::close(fd_);
+	}
+
+	// Queue one record; waits (yielding) only if the writer fell a whole
+	// ring behind. Returns the record's 1-based sequence in this session, or
+	// 0 without journaling it if the event cannot be packed losslessly.
+	uint64_t append(const OrderEvent& event) {
+		if (!PackedOrderEvent::packable(event))
+			return 0;
+		PackedOrderEvent packed = PackedOrderEvent::from_event(event);
+		while (!ring_.push(packed)) {
+			std::this_thread::yield();
+		}
+		return ++appended_;
+	}
+
+	uint64_t appended() const noexcept { return appended_; }
+
+	// Journal-wide sequence the next record will get; a snapshot taken now
+	// covers everything below it
+	uint64_t position() const noexcept { return start_position_ + appended_; }
+
+	// Records of this session known to be on disk
+	uint64_t durable() const noexcept { return durable_.load(std::memory_order_acquire); }
+
+	// Block until record sequence is durable; false if the journal failed
+	bool wait_durable(uint64_t sequence) const {
+		while (durable() < sequence) {
+			if (failed())
+				return false;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	// A write or sync failed; later records are dropped, not retried
+	bool failed() const noexcept { return failed_.load(std::memory_order_acquire); }
+};
+
+// Read-only, memory-mapped view of a journal. A torn final record (crash
+// mid-write) is ignored.
+class JournalReader {
+	void* map_ = nullptr;
+	size_t map_size_ = 0;
+	uint64_t base_sequence_ = 0;
+	std::span<const PackedOrderEvent> records_;
+
+	JournalReader() = default;
+
+ public:
+	// nullptr when the file is missing or not a journal
+	static std::unique_ptr<JournalReader> open(const char* path) {
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(JournalHeader))) {
+			::close(fd);
+			return nullptr;
+		}
+
+		auto size = static_cast<size_t>(st.st_size);
+		void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED)
+			return nullptr;
+		::madvise(map, size, MADV_SEQUENTIAL);
+
+		std::unique_ptr<JournalReader> reader(new JournalReader());
+		reader->map_ = map;
+		reader->map_size_ = size;
+		const auto* header = static_cast<const JournalHeader*>(map);
+		if (!header->valid())
+			return nullptr;
+		reader->base_sequence_ = header->base_sequence;
+
+		size_t count = (size - sizeof(JournalHeader)) / sizeof(PackedOrderEvent);
+		reader->records_ = std::span<const PackedOrderEvent>(
+				reinterpret_cast<const PackedOrderEvent*>(static_cast<const char*>(map) +
+																									sizeof(JournalHeader)),
+				count);
+		return reader;
+	}
+
+	JournalReader(const JournalReader&) = delete;
+	JournalReader& operator=(const JournalReader&) = delete;
+
+	~JournalReader() {
+		if (map_) {
+			::munmap(map_, map_size_);
+		}
+	}
+
+	std::span<const PackedOrderEvent> records() const noexcept { return records_; }
+	size_t size() const noexcept { return records_.size(); }
+
+	// Sequence of records()[0], and one past the last record
+	uint64_t base_sequence() const noexcept { return base_sequence_; }
+	uint64_t end_sequence() const noexcept { return base_sequence_ + records_.size(); }
+
+	// Every record from sequence on is still here (not compacted away)
+	bool covers(uint64_t sequence) const noexcept { return sequence >= base_sequence_; }
+
+	// Records from sequence on (the tail after a snapshot); empty when
+	// sequence is past the end, everything when it predates the base.
+	// Records before base_sequence() are gone, so callers rebuilding state
+	// from sequence must check covers(sequence) first.
+	std::span<const PackedOrderEvent> records_from(uint64_t sequence) const noexcept {
+		if (sequence <= base_sequence_)
+			return records_;
+		if (sequence >= end_sequence())
+			return {};
+		return records_.subspan(static_cast<size_t>(sequence - base_sequence_));
+	}
+};
+
+// Drop the records before sequence (already covered by a durable snapshot)
+// by rewriting the tail to path.tmp and renaming it over path. Run it with
+// no writer open on path, e.g. at startup after recovery.
+inline bool compact_journal(const char* path, uint64_t sequence) {
+	auto reader = JournalReader::open(path);
+	if (!reader)
+		return false;
+	auto tail = reader->records_from(sequence);
+
+	std::string tmp = std::string(path) + ".tmp";
+	int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return false;
+	JournalHeader header{.magic = JournalHeader::MAGIC,
+											 .version = JournalHeader::VERSION,
+											 .record_size = sizeof(PackedOrderEvent),
+											 .base_sequence = reader->end_sequence() - tail.size()};
+	bool ok = detail::write_fully(fd, &header, sizeof(header)) &&
+						detail::write_fully(fd, tail.data(), tail.size_bytes()) && ::fsync(fd) == 0;
+	::close(fd);
+	reader.reset();
+	if (!ok || ::rename(tmp.c_str(), path) != 0) {
+		::unlink(tmp.c_str());
+		return false;
+	}
+	return true;
+}
+
+// Process an inbound event and journal it with the timestamp the book gave it
+template <typename Engine, matching::EventSink Sink>
+Result<OrderEvent> process_journaled(Engine& engine, JournalWriter& journal,
+																		 const OrderEvent& inbound, Sink&& sink) {
+	auto result = engine.process_event(inbound, sink);
+	OrderEvent record = inbound;
+	record.timestamp = result.value().timestamp;
+	journal.append(record);
+	return result;
+}
+
+// Rebuild a book by feeding records back through engine. When the book's
+// clock can be set (ReplayClock) every event runs at its recorded time, so
+// the result matches the original run; fills go to sink (discarded by
+// default). Returns the number of records applied.
+template <typename Engine, matching::EventSink Sink = matching::NullEventSink>
+size_t replay(std::span<const PackedOrderEvent> records, Engine& engine, Sink&& sink = {}) {
+	for (const PackedOrderEvent& record : records) {
+		OrderEvent event = record.to_event();
+		if constexpr (requires { engine.orderbook().clock().set(event.timestamp); }) {
+			engine.orderbook().clock().set(event.timestamp);
+		}
+		engine.process_event(event, sink);
+	}
+	return records.size();
+}
+
+}	 // namespace matching_engine::persistence
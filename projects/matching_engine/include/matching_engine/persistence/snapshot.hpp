@@ -0,0 +1,316 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../core/types.hpp"
+#include "../matching/order_queue.hpp"
+#include "journal.hpp"
+
+namespace matching_engine::persistence {
+
+// On-disk layout: one SnapshotHeader, then order_count SnapshotOrder
+// records in rebuild order (see BasicOrderBook::for_each_order).
+// journal_sequence is the first journal record the snapshot does not
+// include, so recovery replays records_from(journal_sequence).
+struct alignas(64) SnapshotHeader {
+	static constexpr std::array<char, 8> MAGIC{'M', 'E', 'S', 'N', 'A', 'P', '0', '1'};
+	static constexpr uint32_t VERSION = 3;
+
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t symbol;
+	uint64_t journal_sequence;
+	uint64_t next_order_id;
+	uint64_t update_sequence;
+	uint64_t order_count;
+
+	bool valid() const noexcept { return magic == MAGIC && version == VERSION; }
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "Orders must start on a cache line");
+
+// One resting order, flattened
+struct SnapshotOrder {
+	uint64_t id;
+	int64_t price_ticks;
+	uint64_t quantity;
+	uint64_t filled;
+	uint64_t timestamp_ns;
+	uint64_t display;
+	uint64_t reserve;
+	uint32_t account;
+	Side side;
+	OrderType type;
+
+	static SnapshotOrder from_order(const matching::Order& order) noexcept {
+		return SnapshotOrder{.id = order.id.value,
+												 .price_ticks = order.price.ticks,
+												 .quantity = order.quantity.value,
+												 .filled = order.filled.value,
+												 .timestamp_ns = order.timestamp.nanoseconds,
+												 .display = order.display.value,
+												 .reserve = order.reserve.value,
+												 .account = order.account.value,
+												 .side = order.side,
+												 .type = order.type};
+	}
+
+	matching::Order to_order() const noexcept {
+		return matching::Order{.id = OrderId{id},
+													 .price = Price{price_ticks},
+													 .quantity = Quantity{quantity},
+													 .filled = Quantity{filled},
+													 .side = side,
+													 .type = type,
+													 .timestamp = Timestamp{timestamp_ns},
+													 .display = Quantity{display},
+													 .reserve = Quantity{reserve},
+													 .account = AccountId{account}};
+	}
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotOrder>, "SnapshotOrder must be memcpy-able");
+
+// A book's state captured at one point of the event stream
+struct BookSnapshot {
+	SnapshotHeader header;
+	std::vector<SnapshotOrder> orders;
+};
+
+// Copy book's resting orders into buffer-backed snapshot. This is the only
+// part that runs on the matching thread: one pass over the book into a flat
+// array, with no I/O. journal_sequence is JournalWriter::position() at the
+// same point. Passing a previous snapshot's vector back in reuses its
+// capacity.
+template <typename Book>
+BookSnapshot capture_snapshot(const Book& book, uint64_t journal_sequence,
+															std::vector<SnapshotOrder> buffer = {}) {
+	buffer.clear();
+	buffer.reserve(book.order_count());
+	book.for_each_order(
+			[&](const matching::Order& order) { buffer.push_back(SnapshotOrder::from_order(order)); });
+
+	BookSnapshot snapshot{.header = SnapshotHeader{.magic = SnapshotHeader::MAGIC,
+																								 .version = SnapshotHeader::VERSION,
+																								 .symbol = book.symbol().value,
+																								 .journal_sequence = journal_sequence,
+																								 .next_order_id = book.next_order_id(),
+																								 .update_sequence = book.update_sequence(),
+																								 .order_count = buffer.size()},
+												.orders = std::move(buffer)};
+	return snapshot;
+}
+
+// Write snapshot durably: path.tmp, fsync, rename over path, fsync the
+// directory, so a crash leaves either the old or the new snapshot
+inline bool write_snapshot(const BookSnapshot& snapshot, const char* path) {
+	std::string tmp = std::string(path) + ".tmp";
+	int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return false;
+	bool ok = detail::write_fully(fd, &snapshot.header, sizeof(snapshot.header)) &&
+						detail::write_fully(fd, snapshot.orders.data(),
+																snapshot.orders.size() * sizeof(SnapshotOrder)) &&
+						::fsync(fd) == 0;
+	::close(fd);
+	if (!ok || ::rename(tmp.c_str(), path) != 0) {
+		::unlink(tmp.c_str());
+		return false;
+	}
+
+	std::string dir = std::string(path);
+	auto slash = dir.find_last_of('/');
+	dir = slash == std::string::npos ? "." : dir.substr(0, slash == 0 ? 1 : slash);
+	int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (dfd >= 0) {
+		::fsync(dfd);
+		::close(dfd);
+	}
+	return true;
+}
+
+// Writes captured snapshots on a background thread. submit() never blocks
+// on I/O: if a write is still in flight, the pending snapshot is replaced
+// by the newer one (only the latest matters for recovery).
+class SnapshotWriter {
+	std::string path_;
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	std::optional<BookSnapshot> pending_;
+	bool stop_ = false;
+	std::atomic<uint64_t> written_sequence_{0};
+	std::atomic<size_t> failures_{0};
+	std::thread thread_;
+
+	void run() {
+		std::unique_lock lock(mutex_);
+		for (;;) {
+			wakeup_.wait(lock, [this] { return pending_.has_value() || stop_; });
+			if (!pending_)
+				break;
+			BookSnapshot snapshot = std::move(*pending_);
+			pending_.reset();
+			lock.unlock();
+
+			if (write_snapshot(snapshot, path_.c_str())) {
+				written_sequence_.store(snapshot.header.journal_sequence, std::memory_order_release);
+			} else {
+				failures_.fetch_add(1, std::memory_order_relaxed);
+			}
+			lock.lock();
+		}
+	}
+
+ public:
+	explicit SnapshotWriter(std::string path) : path_(std::move(path)), thread_([this] { run(); }) {}
+
+	SnapshotWriter(const SnapshotWriter&) = delete;
+	SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+	// Writes whatever is still pending, then joins
+	~SnapshotWriter() {
+		{
+			std::lock_guard lock(mutex_);
+			stop_ = true;
+		}
+		wakeup_.notify_one();
+		thread_.join();
+	}
+
+	void submit(BookSnapshot snapshot) {
+		{
+			std::lock_guard lock(mutex_);
+			pending_ = std::move(snapshot);
+		}
+		wakeup_.notify_one();
+	}
+
+	// journal_sequence of the newest snapshot on disk; journal records
+	// below it may be compacted away
+	uint64_t written_sequence() const noexcept {
+		return written_sequence_.load(std::memory_order_acquire);
+	}
+
+	size_t failures() const noexcept { return failures_.load(std::memory_order_relaxed); }
+};
+
+// Memory-mapped snapshot file
+class SnapshotReader {
+	void* map_ = nullptr;
+	size_t map_size_ = 0;
+	const SnapshotHeader* header_ = nullptr;
+	std::span<const SnapshotOrder> orders_;
+
+	SnapshotReader() = default;
+
+ public:
+	// nullptr when missing, not a snapshot, or shorter than its header says
+	static std::unique_ptr<SnapshotReader> open(const char* path) {
+		int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+			::close(fd);
+			return nullptr;
+		}
+
+		auto size = static_cast<size_t>(st.st_size);
+		void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED)
+			return nullptr;
+
+		std::unique_ptr<SnapshotReader> reader(new SnapshotReader());
+		reader->map_ = map;
+		reader->map_size_ = size;
+		reader->header_ = static_cast<const SnapshotHeader*>(map);
+		size_t available = (size - sizeof(SnapshotHeader)) / sizeof(SnapshotOrder);
+		if (!reader->header_->valid() || reader->header_->order_count > available)
+			return nullptr;
+
+		reader->orders_ = std::span<const SnapshotOrder>(
+				reinterpret_cast<const SnapshotOrder*>(static_cast<const char*>(map) +
+																							 sizeof(SnapshotHeader)),
+				static_cast<size_t>(reader->header_->order_count));
+		return reader;
+	}
+
+	SnapshotReader(const SnapshotReader&) = delete;
+	SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+	~SnapshotReader() {
+		if (map_) {
+			::munmap(map_, map_size_);
+		}
+	}
+
+	const SnapshotHeader& header() const noexcept { return *header_; }
+	std::span<const SnapshotOrder> orders() const noexcept { return orders_; }
+};
+
+// Load a snapshot into an empty book; false if any order does not fit
+template <typename Book>
+bool restore_snapshot(const SnapshotReader& snapshot, Book& book) {
+	if (book.order_count() != 0)
+		return false;
+	for (const SnapshotOrder& order : snapshot.orders()) {
+		if (!book.restore_order(order.to_order()))
+			return false;
+	}
+	book.restore_counters(snapshot.header().next_order_id, snapshot.header().update_sequence);
+	return true;
+}
+
+// Startup: load the latest snapshot if there is one, then replay only the
+// journal tail it does not cover. Journal records for other symbols are
+// skipped. Returns the number of journal records replayed, or nullopt if
+// the snapshot exists but could not be applied, or if the journal was
+// compacted past it (with no usable snapshot that is anything past 0):
+// the orders in the gap are gone. A risk policy gets its resting exposure
+// back with the orders, but not its filled positions from before the
+// snapshot (see AccountRiskTable::set_position).
+template <typename Engine>
+std::optional<size_t> recover(Engine& engine, const char* snapshot_path, const char* journal_path) {
+	uint64_t from = 0;
+	if (auto snapshot = SnapshotReader::open(snapshot_path)) {
+		if (!restore_snapshot(*snapshot, engine.orderbook()))
+			return std::nullopt;
+		from = snapshot->header().journal_sequence;
+	}
+
+	auto journal = JournalReader::open(journal_path);
+	if (!journal)
+		return 0;
+	if (!journal->covers(from))
+		return std::nullopt;
+
+	SymbolId symbol = engine.orderbook().symbol();
+	size_t replayed = 0;
+	for (const PackedOrderEvent& record : journal->records_from(from)) {
+		if (record.symbol_id != symbol.value)
+			continue;
+		replay(std::span(&record, 1), engine);
+		++replayed;
+	}
+	return replayed;
+}
+
+}	 // namespace matching_engine::persistence
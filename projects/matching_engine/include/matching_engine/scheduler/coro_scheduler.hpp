@@ -1,35 +1,404 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
 #include <coroutine>
+#include <deque>
 #include <exception>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
+#include "../memory/frame_pool.hpp"
+#include "timer_wheel.hpp"
+
 namespace matching_engine::coro {
 
+// Frame allocator used by Task unless a Task type names another one
+using DefaultFrameAllocator = memory::RecyclingFrameAllocator<>;
+
 // Forward declaration
-template <typename T>
+template <typename T = void, typename FrameAllocator = DefaultFrameAllocator>
 class Task;
 
-// Yield control back to caller
+// Something that can resume a coroutine later: the single-threaded
+// Scheduler below, or a worker of a ThreadPool. Parked coroutines remember
+// the executor they were running on and are handed back to it when woken.
+class Executor {
+ protected:
+	static inline thread_local Executor* current_ = nullptr;
+
+ public:
+	virtual ~Executor() = default;
+
+	// Executor driving the calling thread, or nullptr outside any run loop
+	static Executor* current() noexcept { return current_; }
+
+	// Queue handle to be resumed; callable from any thread
+	virtual void schedule(std::coroutine_handle<> handle) = 0;
+
+	// Timer wheel this executor drives on steady_now_ns() time, or nullptr.
+	// Only coroutines running on the executor may touch it.
+	virtual TimerWheel* timers() noexcept { return nullptr; }
+
+	// Queue a task's first resumption; the caller keeps the Task alive
+	template <typename Task>
+	void spawn(Task& task) {
+		schedule(task.handle());
+	}
+};
+
+// Time base for executor timer wheels: steady_clock in nanoseconds
+inline uint64_t steady_now_ns() noexcept {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+																	 std::chrono::steady_clock::now().time_since_epoch())
+																	 .count());
+}
+
+// Ready queue for coroutines woken by another party (e.g. a ring buffer
+// that gained data) or yielding their turn. schedule() may be called from
+// any thread; the queue is drained by whichever thread calls run(),
+// run_until_idle() or block_on(), which also becomes the executor that
+// coroutines suspending there will be woken on.
+//
+// The scheduler also owns a TimerWheel (1 us ticks) for sleep_for() and
+// with_timeout(). The run loop advances it before taking each coroutine
+// and, when nothing is ready, sleeps only until the next timer is due.
+// Only one thread should drive a given scheduler at a time.
+class Scheduler final : public Executor {
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	std::deque<std::coroutine_handle<>> ready_;
+	size_t sleeping_ = 0;	 // Threads blocked in wakeup_, guarded by mutex_
+	bool stop_requested_ = false;
+	TimerWheel timers_{1'000, steady_now_ns()};	 // Touched only by the driving thread
+
+	// Resume ready coroutines until done() holds. With Block, an empty queue
+	// sleeps until schedule() or stop(); otherwise it returns. Returns how
+	// many coroutines ran.
+	template <bool Block, typename Done>
+	size_t drive(Done&& done) {
+		Executor* previous = std::exchange(current_, this);
+		size_t resumed = 0;
+		while (!done()) {
+			if (!timers_.empty()) {
+				timers_.advance(steady_now_ns());	 // Expired timers schedule() their coroutines
+			}
+			std::coroutine_handle<> next;
+			{
+				std::unique_lock lock(mutex_);
+				if (ready_.empty()) {
+					if constexpr (!Block) {
+						break;
+					} else {
+						if (stop_requested_)
+							break;
+						++sleeping_;
+						auto woken = [this] { return !ready_.empty() || stop_requested_; };
+						if (auto deadline = timers_.next_deadline_ns()) {
+							wakeup_.wait_until(lock,
+																 std::chrono::steady_clock::time_point(
+																		 std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+																				 std::chrono::nanoseconds(*deadline))),
+																 woken);
+						} else {
+							wakeup_.wait(lock, woken);
+						}
+						--sleeping_;
+						continue;
+					}
+				}
+				next = ready_.front();
+				ready_.pop_front();
+			}
+			next.resume();
+			++resumed;
+		}
+		current_ = previous;
+		return resumed;
+	}
+
+ public:
+	void schedule(std::coroutine_handle<> handle) override {
+		bool wake;
+		{
+			std::lock_guard lock(mutex_);
+			ready_.push_back(handle);
+			wake = sleeping_ != 0;
+		}
+		if (wake) {
+			wakeup_.notify_one();
+		}
+	}
+
+	// Resume ready coroutines until none are left; returns how many ran
+	size_t run_until_idle() {
+		return drive<false>([] { return false; });
+	}
+
+	// Resume coroutines, sleeping while the queue is empty, until stop()
+	size_t run() {
+		return drive<true>([] { return false; });
+	}
+
+	TimerWheel* timers() noexcept override { return &timers_; }
+
+	// Make run() return once the queue drains; callable from any thread.
+	// The request is sticky: later run() calls return as soon as idle.
+	void stop() {
+		{
+			std::lock_guard lock(mutex_);
+			stop_requested_ = true;
+		}
+		wakeup_.notify_all();
+	}
+
+	// Drive task to completion on this scheduler, sleeping while it is
+	// parked on something another thread will wake, then return its result
+	template <typename Task>
+	decltype(auto) block_on(Task& task) {
+		if (!task.done()) {
+			schedule(task.handle());
+			drive<true>([&task] { return task.done(); });
+		}
+		return task.get_result();
+	}
+};
+
+// Give up the thread: on an executor the coroutine goes to the back of its
+// ready queue; elsewhere control simply returns to whoever resumed it
 struct Yield {
 	bool await_ready() const noexcept { return false; }
-	void await_suspend(std::coroutine_handle<>) const noexcept {}
+
+	void await_suspend(std::coroutine_handle<> handle) const {
+		if (Executor* executor = Executor::current()) {
+			executor->schedule(handle);
+		}
+	}
+
+	void await_resume() const noexcept {}
+};
+
+// co_await sleep_until(t) / sleep_for(d): park on the executor's timer
+// wheel until the deadline. The timer node lives in the awaitable (so in
+// the coroutine frame): sleeping never allocates, and destroying a
+// sleeping coroutine disarms it. On an executor without a wheel (or none)
+// the thread itself sleeps.
+class SleepAwaitable {
+	uint64_t deadline_ns_;
+	TimerNode node_{};
+	TimerWheel* wheel_ = nullptr;
+	Executor* executor_ = nullptr;
+	std::coroutine_handle<> handle_;
+
+	static void wake(TimerNode& node) {
+		auto* self = static_cast<SleepAwaitable*>(node.context);
+		self->executor_->schedule(self->handle_);
+	}
+
+ public:
+	explicit SleepAwaitable(uint64_t deadline_ns) noexcept : deadline_ns_(deadline_ns) {}
+
+	// The wheel links to node_: the awaitable must stay put
+	SleepAwaitable(const SleepAwaitable&) = delete;
+	SleepAwaitable& operator=(const SleepAwaitable&) = delete;
+
+	~SleepAwaitable() {
+		if (wheel_) {
+			wheel_->cancel(node_);
+		}
+	}
+
+	bool await_ready() const noexcept { return deadline_ns_ <= steady_now_ns(); }
+
+	bool await_suspend(std::coroutine_handle<> handle) {
+		executor_ = Executor::current();
+		wheel_ = executor_ ? executor_->timers() : nullptr;
+		if (!wheel_) {
+			uint64_t now = steady_now_ns();
+			if (deadline_ns_ > now) {
+				std::this_thread::sleep_for(std::chrono::nanoseconds(deadline_ns_ - now));
+			}
+			return false;
+		}
+		handle_ = handle;
+		node_.callback = &wake;
+		node_.context = this;
+		wheel_->schedule(node_, deadline_ns_);
+		return true;
+	}
+
 	void await_resume() const noexcept {}
 };
 
+inline SleepAwaitable sleep_until(std::chrono::steady_clock::time_point deadline) noexcept {
+	return SleepAwaitable{static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count())};
+}
+
+template <typename Rep, typename Period>
+SleepAwaitable sleep_for(std::chrono::duration<Rep, Period> duration) noexcept {
+	return SleepAwaitable{
+			steady_now_ns() +
+			static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count())};
+}
+
+// A parking awaitable that can withdraw itself: cancel() returns true if
+// the waiter was still parked (nobody else will resume it)
+template <typename A>
+concept CancellableAwaitable = requires(A& awaitable, std::coroutine_handle<> handle) {
+	{ awaitable.await_ready() } -> std::convertible_to<bool>;
+	{ awaitable.await_suspend(handle) } -> std::same_as<bool>;
+	{ awaitable.cancel() } -> std::same_as<bool>;
+};
+
+// co_await with_timeout(queue.pop_async(), 5ms): if the inner awaitable is
+// still parked at the deadline it is cancelled and resumed, and its
+// await_resume() reports the outcome as usual (pop_async yields nullopt,
+// push_async false, unless the retry succeeds). Without a timer wheel the
+// wait is unbounded.
+template <CancellableAwaitable Awaitable>
+class TimeoutAwaitable {
+	Awaitable inner_;
+	uint64_t deadline_ns_;
+	TimerNode node_{};
+	TimerWheel* wheel_ = nullptr;
+	Executor* executor_ = nullptr;
+	std::coroutine_handle<> handle_;
+
+	static void expire(TimerNode& node) {
+		auto* self = static_cast<TimeoutAwaitable*>(node.context);
+		if (self->inner_.cancel()) {
+			self->executor_->schedule(self->handle_);
+		}
+	}
+
+ public:
+	TimeoutAwaitable(Awaitable inner, uint64_t deadline_ns)
+			: inner_(std::move(inner)), deadline_ns_(deadline_ns) {}
+
+	TimeoutAwaitable(const TimeoutAwaitable&) = delete;
+	TimeoutAwaitable& operator=(const TimeoutAwaitable&) = delete;
+
+	~TimeoutAwaitable() {
+		if (wheel_) {
+			wheel_->cancel(node_);
+		}
+	}
+
+	bool await_ready() { return inner_.await_ready(); }
+
+	// Arm the timer before parking so a wake-up can never race ahead of it
+	bool await_suspend(std::coroutine_handle<> handle) {
+		executor_ = Executor::current();
+		wheel_ = executor_ ? executor_->timers() : nullptr;
+		if (wheel_) {
+			handle_ = handle;
+			node_.callback = &expire;
+			node_.context = this;
+			wheel_->schedule(node_, deadline_ns_);
+		}
+		if (inner_.await_suspend(handle)) {
+			return true;
+		}
+		if (wheel_) {
+			wheel_->cancel(node_);
+		}
+		return false;
+	}
+
+	decltype(auto) await_resume() {
+		if (wheel_) {
+			wheel_->cancel(node_);
+		}
+		return inner_.await_resume();
+	}
+};
+
+template <CancellableAwaitable Awaitable, typename Rep, typename Period>
+TimeoutAwaitable<Awaitable> with_timeout(Awaitable awaitable, std::chrono::duration<Rep, Period> timeout) {
+	return TimeoutAwaitable<Awaitable>{
+			std::move(awaitable),
+			steady_now_ns() +
+					static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count())};
+}
+
+// co_await schedule_on(executor) moves the rest of the coroutine onto
+// executor (e.g. the pool worker that owns a book)
+struct ScheduleOn {
+	Executor& executor;
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const { executor.schedule(handle); }
+	void await_resume() const noexcept {}
+};
+
+inline ScheduleOn schedule_on(Executor& executor) noexcept { return ScheduleOn{executor}; }
+
+// Continuation bookkeeping shared by all Task promises. The awaiting
+// coroutine starts the child inline; whichever of the two reaches the
+// handoff second decides who resumes the caller:
+//   - the child finished before await_suspend returned: await_suspend
+//     returns false and the caller simply continues (no stack growth, even
+//     in builds where symmetric transfer is not compiled to a tail call);
+//   - the child suspended first (e.g. parked on a queue): final_suspend
+//     later transfers control straight to the caller.
+class TaskPromiseBase {
+	std::coroutine_handle<> continuation_;
+	std::atomic<bool> handed_off_{false};
+
+	struct FinalAwaiter {
+		bool await_ready() const noexcept { return false; }
+
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+			auto& promise = self.promise();
+			if (promise.handed_off_.exchange(true, std::memory_order_acq_rel) && promise.continuation_) {
+				return promise.continuation_;
+			}
+			return std::noop_coroutine();
+		}
+
+		void await_resume() const noexcept {}
+	};
+
+ public:
+	std::suspend_always initial_suspend() noexcept { return {}; }
+	FinalAwaiter final_suspend() noexcept { return {}; }
+
+	// Run the not-yet-started task owning this promise on behalf of caller.
+	// Returns true if caller must suspend (final_suspend will resume it).
+	template <typename Promise>
+	static bool start_awaited(std::coroutine_handle<Promise> self,
+														std::coroutine_handle<> caller) noexcept {
+		self.promise().continuation_ = caller;
+		self.resume();
+		return !self.promise().handed_off_.exchange(true, std::memory_order_acq_rel);
+	}
+};
+
+// Routes the coroutine frame allocation through FrameAllocator (the
+// compiler looks these up on the promise type)
+template <typename FrameAllocator>
+struct FrameAllocated {
+	static void* operator new(size_t size) { return FrameAllocator::allocate(size); }
+	static void operator delete(void* ptr, size_t size) noexcept {
+		FrameAllocator::deallocate(ptr, size);
+	}
+};
+
 // Promise type for Task<T>
-template <typename T>
-class TaskPromise {
+template <typename T, typename FrameAllocator>
+class TaskPromise : public TaskPromiseBase, public FrameAllocated<FrameAllocator> {
 	std::optional<T> result_;
 	std::exception_ptr exception_;
 
  public:
-	Task<T> get_return_object() noexcept;
-
-	std::suspend_always initial_suspend() noexcept { return {}; }
-	std::suspend_always final_suspend() noexcept { return {}; }
+	Task<T, FrameAllocator> get_return_object() noexcept;
 
 	void return_value(T value) noexcept(std::is_nothrow_move_constructible_v<T>) {
 		result_ = std::move(value);
@@ -46,15 +415,13 @@ class TaskPromise {
 };
 
 // Specialization for void
-template <>
-class TaskPromise<void> {
+template <typename FrameAllocator>
+class TaskPromise<void, FrameAllocator> : public TaskPromiseBase,
+																					public FrameAllocated<FrameAllocator> {
 	std::exception_ptr exception_;
 
  public:
-	Task<void> get_return_object() noexcept;
-
-	std::suspend_always initial_suspend() noexcept { return {}; }
-	std::suspend_always final_suspend() noexcept { return {}; }
+	Task<void, FrameAllocator> get_return_object() noexcept;
 
 	void return_void() noexcept {}
 
@@ -67,11 +434,13 @@ class TaskPromise<void> {
 	}
 };
 
-// Task<T> represents a coroutine that returns T
-template <typename T = void>
+// Task<T> represents a coroutine that returns T. FrameAllocator supplies
+// the coroutine frame; the default recycles frames per thread, and
+// memory::HeapFrameAllocator restores plain operator new.
+template <typename T, typename FrameAllocator>
 class Task {
  public:
-	using promise_type = TaskPromise<T>;
+	using promise_type = TaskPromise<T, FrameAllocator>;
 	using handle_type = std::coroutine_handle<promise_type>;
 
  private:
@@ -122,22 +491,23 @@ class Task {
 		return handle_.promise().result();
 	}
 
+	// Coroutine handle, for handing the task to a scheduler
+	handle_type handle() const noexcept { return handle_; }
+
 	// Awaitable interface (allows co_await on Task)
-	bool await_ready() const noexcept { return false; }
+	bool await_ready() const noexcept { return !handle_ || handle_.done(); }
 
-	void await_suspend(std::coroutine_handle<> caller) noexcept {
-		// When this task is awaited, we need to resume it
-		// For simplicity, we just mark it as ready to run
+	// Start the child now; see TaskPromiseBase for who resumes the caller
+	bool await_suspend(std::coroutine_handle<> caller) noexcept {
+		return TaskPromiseBase::start_awaited(handle_, caller);
 	}
 
 	T await_resume() {
 		if (!handle_) {
 			throw std::runtime_error("Task has no coroutine handle");
 		}
-
-		// Run the coroutine to completion
-		while (!handle_.done()) {
-			handle_.resume();
+		if (!handle_.done()) {
+			throw std::runtime_error("Task resumed before awaited task completed");
 		}
 
 		return handle_.promise().result();
@@ -145,10 +515,10 @@ class Task {
 };
 
 // Specialization for void
-template <>
-class Task<void> {
+template <typename FrameAllocator>
+class Task<void, FrameAllocator> {
  public:
-	using promise_type = TaskPromise<void>;
+	using promise_type = TaskPromise<void, FrameAllocator>;
 	using handle_type = std::coroutine_handle<promise_type>;
 
  private:
@@ -196,17 +566,20 @@ class Task<void> {
 		handle_.promise().result();
 	}
 
-	bool await_ready() const noexcept { return false; }
+	handle_type handle() const noexcept { return handle_; }
 
-	void await_suspend(std::coroutine_handle<> caller) noexcept {}
+	bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+	bool await_suspend(std::coroutine_handle<> caller) noexcept {
+		return TaskPromiseBase::start_awaited(handle_, caller);
+	}
 
 	void await_resume() {
 		if (!handle_) {
 			throw std::runtime_error("Task has no coroutine handle");
 		}
-
-		while (!handle_.done()) {
-			handle_.resume();
+		if (!handle_.done()) {
+			throw std::runtime_error("Task resumed before awaited task completed");
 		}
 
 		handle_.promise().result();
@@ -214,13 +587,16 @@ class Task<void> {
 };
 
 // Implementation of get_return_object
-template <typename T>
-inline Task<T> TaskPromise<T>::get_return_object() noexcept {
-	return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+template <typename T, typename FrameAllocator>
+inline Task<T, FrameAllocator> TaskPromise<T, FrameAllocator>::get_return_object() noexcept {
+	return Task<T, FrameAllocator>{
+			std::coroutine_handle<TaskPromise<T, FrameAllocator>>::from_promise(*this)};
 }
 
-inline Task<void> TaskPromise<void>::get_return_object() noexcept {
-	return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+template <typename FrameAllocator>
+inline Task<void, FrameAllocator> TaskPromise<void, FrameAllocator>::get_return_object() noexcept {
+	return Task<void, FrameAllocator>{
+			std::coroutine_handle<TaskPromise<void, FrameAllocator>>::from_promise(*this)};
 }
 
 }	 // namespace matching_engine::coro
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "coro_scheduler.hpp"
+
+namespace matching_engine::coro {
+
+// Fixed set of worker threads running coroutines. Each worker owns two
+// queues: a stealable deque (the owner takes from the back for locality,
+// idle workers steal from the front) and a pinned queue nobody else
+// touches. Work handed to the pool itself lands in a stealable deque;
+// work handed to worker(i) is pinned there, along with everything that
+// coroutine later yields or parks on, so a book driven from a pinned
+// coroutine stays single-threaded while the rest of the load spreads.
+class ThreadPool final : public Executor {
+	class Worker final : public Executor {
+		friend class ThreadPool;
+
+		ThreadPool& pool_;
+		size_t index_;
+		std::mutex mutex_;	// Guards both queues and sleeping_
+		std::condition_variable wakeup_;
+		std::deque<std::coroutine_handle<>> stealable_;
+		std::deque<std::coroutine_handle<>> pinned_;
+		std::atomic<bool> sleeping_{false};
+
+	 public:
+		Worker(ThreadPool& pool, size_t index) : pool_(pool), index_(index) {}
+
+		void schedule(std::coroutine_handle<> handle) override {
+			pool_.active_.fetch_add(1, std::memory_order_relaxed);
+			{
+				std::lock_guard lock(mutex_);
+				pinned_.push_back(handle);
+			}
+			wakeup_.notify_one();
+		}
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::vector<std::thread> threads_;
+	std::atomic<size_t> stealable_count_{0};	// Handles in all stealable deques
+	std::atomic<size_t> active_{0};						// Queued or running handles
+	std::atomic<size_t> next_worker_{0};
+	std::atomic<bool> stop_{false};
+
+	std::mutex idle_mutex_;
+	std::condition_variable idle_;
+
+	static inline thread_local Worker* this_worker_ = nullptr;
+
+	// Stealable work was published: wake one sleeping worker, if any. The
+	// seq_cst count increment pairs with the sleeper's seq_cst flag store.
+	void wake_one() {
+		for (auto& worker : workers_) {
+			if (worker->sleeping_.load()) {
+				{
+					std::lock_guard lock(worker->mutex_);
+				}
+				worker->wakeup_.notify_one();
+				return;
+			}
+		}
+	}
+
+	// Next handle for worker, and the executor it should run under
+	bool take(Worker& worker, std::coroutine_handle<>& handle, Executor*& executor) {
+		{
+			std::lock_guard lock(worker.mutex_);
+			if (!worker.pinned_.empty()) {
+				handle = worker.pinned_.front();
+				worker.pinned_.pop_front();
+				executor = &worker;
+				return true;
+			}
+			if (!worker.stealable_.empty()) {
+				handle = worker.stealable_.back();
+				worker.stealable_.pop_back();
+				stealable_count_.fetch_sub(1);
+				executor = this;
+				return true;
+			}
+		}
+
+		if (stealable_count_.load() == 0)
+			return false;
+
+		// Steal the oldest handle from the first victim that has one
+		for (size_t i = 1; i < workers_.size(); ++i) {
+			Worker& victim = *workers_[(worker.index_ + i) % workers_.size()];
+			std::lock_guard lock(victim.mutex_);
+			if (!victim.stealable_.empty()) {
+				handle = victim.stealable_.front();
+				victim.stealable_.pop_front();
+				stealable_count_.fetch_sub(1);
+				executor = this;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void finished_one() {
+		if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			{
+				std::lock_guard lock(idle_mutex_);
+			}
+			idle_.notify_all();
+		}
+	}
+
+	void run_worker(Worker& worker) {
+		this_worker_ = &worker;
+		for (;;) {
+			std::coroutine_handle<> handle;
+			Executor* executor = nullptr;
+			if (take(worker, handle, executor)) {
+				current_ = executor;
+				handle.resume();
+				current_ = nullptr;
+				finished_one();
+				continue;
+			}
+
+			std::unique_lock lock(worker.mutex_);
+			worker.sleeping_.store(true);
+			worker.wakeup_.wait(lock, [&] {
+				return !worker.pinned_.empty() || stealable_count_.load() != 0 || stop_.load();
+			});
+			worker.sleeping_.store(false, std::memory_order_relaxed);
+			if (stop_.load() && worker.pinned_.empty() && stealable_count_.load() == 0)
+				break;
+		}
+		this_worker_ = nullptr;
+	}
+
+ public:
+	explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+		if (threads == 0) {
+			threads = 1;
+		}
+		workers_.reserve(threads);
+		for (size_t i = 0; i < threads; ++i) {
+			workers_.push_back(std::make_unique<Worker>(*this, i));
+		}
+		threads_.reserve(threads);
+		for (auto& worker : workers_) {
+			threads_.emplace_back([this, w = worker.get()] { run_worker(*w); });
+		}
+	}
+
+	// Non-copyable, non-movable (workers hold a reference to the pool)
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Finishes queued and running work, then joins the workers. Coroutines
+	// still parked at this point are never resumed.
+	~ThreadPool() {
+		wait_idle();
+		stop_.store(true);
+		for (auto& worker : workers_) {
+			{
+				std::lock_guard lock(worker->mutex_);
+			}
+			worker->wakeup_.notify_all();
+		}
+		for (auto& thread : threads_) {
+			thread.join();
+		}
+	}
+
+	size_t size() const noexcept { return workers_.size(); }
+
+	// Executor that pins coroutines to worker i
+	Executor& worker(size_t i) noexcept { return *workers_[i]; }
+
+	// Stealable submission: onto the calling worker's own deque when called
+	// from inside the pool, otherwise round-robin across workers
+	void schedule(std::coroutine_handle<> handle) override {
+		active_.fetch_add(1, std::memory_order_relaxed);
+		Worker* target = this_worker_ && &this_worker_->pool_ == this
+												 ? this_worker_
+												 : workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+																		workers_.size()]
+															 .get();
+		{
+			std::lock_guard lock(target->mutex_);
+			target->stealable_.push_back(handle);
+		}
+		stealable_count_.fetch_add(1);
+		wake_one();
+	}
+
+	// Block until nothing is queued or running. Coroutines parked on a
+	// waiter queue do not count, so this also returns when all are parked.
+	void wait_idle() {
+		std::unique_lock lock(idle_mutex_);
+		idle_.wait(lock, [this] { return active_.load(std::memory_order_acquire) == 0; });
+	}
+};
+
+}	 // namespace matching_engine::coro
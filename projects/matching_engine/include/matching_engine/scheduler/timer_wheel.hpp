@@ -0,0 +1,280 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace matching_engine::coro {
+
+// A pending timeout, embedded in whatever owns it (an order, a session,
+// the awaitable of a sleeping coroutine), so arming a timer never
+// allocates. callback runs on the thread calling TimerWheel::advance(),
+// after the node has been disarmed; it may re-arm the node or touch any
+// other timer. A node must outlive its time on the wheel (cancel it or let
+// it fire before destroying it).
+struct TimerNode {
+	using Callback = void (*)(TimerNode&);
+
+	Callback callback = nullptr;
+	void* context = nullptr;	// Free for the owner, e.g. back to the enclosing object
+	uint64_t deadline_ns = 0;
+
+	bool armed() const noexcept { return bucket_ != kUnarmed; }
+
+ private:
+	friend class TimerWheel;
+	static constexpr uint16_t kUnarmed = std::numeric_limits<uint16_t>::max();
+
+	TimerNode* prev_ = nullptr;
+	TimerNode* next_ = nullptr;
+	uint64_t expiry_tick_ = 0;
+	uint16_t bucket_ = kUnarmed;
+};
+
+// Hierarchical timing wheel: kLevels levels of 64 slots, level k slot s
+// holding timers whose expiry tick first differs from the current tick in
+// base-64 digit k, where it equals s. schedule() and cancel() are O(1)
+// (one intrusive list link plus a bit in the level's occupancy word);
+// advance() walks only to ticks where a slot becomes due, found from the
+// occupancy words, so idle stretches cost nothing. When time reaches a
+// higher-level slot its timers cascade into lower levels, each timer
+// moving at most kLevels times over its life.
+//
+// Timers fire no earlier than their deadline and at most one tick late,
+// in deadline order across ticks (order within one tick is unspecified).
+// With the default 1 us tick, eight levels span 2^48 ticks (about 8.9
+// years); anything further out waits on an overflow list that is
+// re-examined once per top-level turn.
+//
+// Single-threaded: the owner (e.g. coro::Scheduler) calls everything from
+// its own thread.
+class TimerWheel {
+	static constexpr unsigned kSlotBits = 6;
+	static constexpr size_t kSlots = size_t{1} << kSlotBits;
+	static constexpr size_t kLevels = 8;
+
+	// Bucket indices past the wheel proper
+	static constexpr uint16_t kDue = kLevels * kSlots;	// Already expired, fire on next advance()
+	static constexpr uint16_t kOverflow = kDue + 1;		 // Beyond the top level
+	static constexpr uint16_t kFiring = kDue + 2;			 // Detached, callbacks in progress
+
+	struct Bucket {
+		TimerNode* head = nullptr;
+		TimerNode* tail = nullptr;
+	};
+
+	std::array<Bucket, kLevels * kSlots + 3> buckets_{};
+	std::array<uint64_t, kLevels> occupied_{};	// Bit s of level k: slot s is non-empty
+	uint64_t tick_ns_;
+	uint64_t now_;	// Current tick
+	size_t size_ = 0;
+
+	static constexpr uint64_t below(size_t level) noexcept {
+		return level * kSlotBits >= 64 ? ~uint64_t{0} : (uint64_t{1} << (level * kSlotBits)) - 1;
+	}
+
+	static constexpr size_t digit(uint64_t tick, size_t level) noexcept {
+		return (tick >> (level * kSlotBits)) & (kSlots - 1);
+	}
+
+	void push_back(uint16_t bucket, TimerNode& node) noexcept {
+		Bucket& b = buckets_[bucket];
+		node.bucket_ = bucket;
+		node.prev_ = b.tail;
+		node.next_ = nullptr;
+		if (b.tail) {
+			b.tail->next_ = &node;
+		} else {
+			b.head = &node;
+		}
+		b.tail = &node;
+		if (bucket < kDue) {
+			occupied_[bucket / kSlots] |= uint64_t{1} << (bucket % kSlots);
+		}
+	}
+
+	void unlink(TimerNode& node) noexcept {
+		Bucket& b = buckets_[node.bucket_];
+		if (node.prev_) {
+			node.prev_->next_ = node.next_;
+		} else {
+			b.head = node.next_;
+		}
+		if (node.next_) {
+			node.next_->prev_ = node.prev_;
+		} else {
+			b.tail = node.prev_;
+		}
+		if (node.bucket_ < kDue && !b.head) {
+			occupied_[node.bucket_ / kSlots] &= ~(uint64_t{1} << (node.bucket_ % kSlots));
+		}
+		node.prev_ = node.next_ = nullptr;
+		node.bucket_ = TimerNode::kUnarmed;
+	}
+
+	// Detach a whole bucket, returning its first node (still linked by next_)
+	TimerNode* take(uint16_t bucket) noexcept {
+		Bucket& b = buckets_[bucket];
+		TimerNode* first = b.head;
+		b.head = b.tail = nullptr;
+		if (bucket < kDue) {
+			occupied_[bucket / kSlots] &= ~(uint64_t{1} << (bucket % kSlots));
+		}
+		return first;
+	}
+
+	// File node by its expiry relative to now_
+	void place(TimerNode& node) noexcept {
+		uint64_t expiry = node.expiry_tick_;
+		if (expiry <= now_) {
+			push_back(kDue, node);
+			return;
+		}
+		size_t level = (std::bit_width(expiry ^ now_) - 1) / kSlotBits;
+		if (level >= kLevels) {
+			push_back(kOverflow, node);
+			return;
+		}
+		push_back(static_cast<uint16_t>(level * kSlots + digit(expiry, level)), node);
+	}
+
+	void replace_all(TimerNode* node) noexcept {
+		while (node) {
+			TimerNode* next = node->next_;
+			place(*node);
+			node = next;
+		}
+	}
+
+	// First tick after now_ at which some slot comes due, or nullopt when
+	// only the due list (or nothing) is left
+	std::optional<uint64_t> next_event() const noexcept {
+		for (size_t level = 0; level < kLevels; ++level) {
+			size_t current = digit(now_, level);
+			uint64_t later = current + 1 == kSlots ? 0 : occupied_[level] & (~uint64_t{0} << (current + 1));
+			if (later) {
+				uint64_t slot = static_cast<uint64_t>(std::countr_zero(later));
+				return (now_ & ~below(level + 1)) | (slot << (level * kSlotBits));
+			}
+		}
+		if (buckets_[kOverflow].head) {
+			return (now_ | below(kLevels)) + 1;
+		}
+		return std::nullopt;
+	}
+
+	// now_ just reached an event tick: cascade every slot starting here,
+	// highest level first, so cascaded timers land in slots handled below
+	void cascade() noexcept {
+		if ((now_ & below(kLevels)) == 0) {
+			replace_all(take(kOverflow));
+		}
+		for (size_t level = kLevels - 1; level > 0; --level) {
+			if ((now_ & below(level)) != 0)
+				continue;
+			auto bucket = static_cast<uint16_t>(level * kSlots + digit(now_, level));
+			if (buckets_[bucket].head) {
+				replace_all(take(bucket));
+			}
+		}
+		// Level 0 slot of now_: expired, same as the due list
+		auto bucket = static_cast<uint16_t>(digit(now_, 0));
+		for (TimerNode* node = take(bucket); node;) {
+			TimerNode* next = node->next_;
+			push_back(kDue, *node);
+			node = next;
+		}
+	}
+
+	// Run the callbacks of everything on the due list. Nodes move to the
+	// firing list first, so callbacks can cancel each other; timers they
+	// schedule at or before now_ wait for the next advance().
+	size_t fire_due() {
+		size_t fired = 0;
+		for (TimerNode* node = take(kDue); node;) {
+			TimerNode* next = node->next_;
+			push_back(kFiring, *node);
+			node = next;
+		}
+		while (TimerNode* node = buckets_[kFiring].head) {
+			unlink(*node);
+			--size_;
+			++fired;
+			node->callback(*node);
+		}
+		return fired;
+	}
+
+ public:
+	// tick_ns is the resolution; start_ns the time the wheel starts at
+	explicit TimerWheel(uint64_t tick_ns = 1'000, uint64_t start_ns = 0) noexcept
+			: tick_ns_(tick_ns ? tick_ns : 1), now_(start_ns / tick_ns_) {}
+
+	// Armed nodes belong to this wheel: not copyable, not movable
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	size_t size() const noexcept { return size_; }
+	bool empty() const noexcept { return size_ == 0; }
+	uint64_t tick_ns() const noexcept { return tick_ns_; }
+
+	// Time the wheel has advanced to
+	uint64_t now_ns() const noexcept { return now_ * tick_ns_; }
+
+	// Arm node to fire at deadline_ns (re-arming an armed node moves it).
+	// A deadline already passed fires on the next advance().
+	void schedule(TimerNode& node, uint64_t deadline_ns) noexcept {
+		if (node.armed()) {
+			unlink(node);
+			--size_;
+		}
+		node.deadline_ns = deadline_ns;
+		node.expiry_tick_ = deadline_ns / tick_ns_ + (deadline_ns % tick_ns_ != 0);
+		place(node);
+		++size_;
+	}
+
+	// Disarm node; false if it was not armed (already fired or never set)
+	bool cancel(TimerNode& node) noexcept {
+		if (!node.armed())
+			return false;
+		unlink(node);
+		--size_;
+		return true;
+	}
+
+	// Move time forward to now_ns (never backwards), firing every timer
+	// that expires on the way. Returns how many fired.
+	size_t advance(uint64_t now_ns) {
+		uint64_t target = now_ns / tick_ns_;
+		size_t fired = fire_due();
+		while (now_ < target) {
+			auto next = next_event();
+			if (!next || *next > target) {
+				now_ = target;
+				break;
+			}
+			now_ = *next;
+			cascade();
+			fired += fire_due();
+		}
+		return fired;
+	}
+
+	// Earliest time advance() could fire something: exact for timers within
+	// 64 ticks, otherwise the (earlier) time their slot cascades. nullopt
+	// when nothing is armed.
+	std::optional<uint64_t> next_deadline_ns() const noexcept {
+		if (buckets_[kDue].head)
+			return now_ns();
+		auto next = next_event();
+		if (!next)
+			return std::nullopt;
+		return *next * tick_ns_;
+	}
+};
+
+}	 // namespace matching_engine::coro
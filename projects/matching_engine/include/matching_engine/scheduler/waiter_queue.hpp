@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+
+#include "coro_scheduler.hpp"
+
+namespace matching_engine::coro {
+
+// A coroutine parked on some condition. Lives inside the awaitable (and so
+// inside the coroutine frame), which makes parking allocation-free.
+struct Waiter {
+	std::coroutine_handle<> handle;
+	Executor* scheduler = nullptr;	// Where to resume it
+	Waiter* prev = nullptr;
+	Waiter* next = nullptr;
+	bool queued = false;
+};
+
+// Intrusive FIFO of parked coroutines guarded by a tiny spin lock. Wakers
+// check the atomic count first, so the common no-waiter case costs a single
+// load and never takes the lock.
+//
+// Lost-wakeup protocol: a waiter enqueues itself, then re-checks its
+// condition and calls cancel() if it no longer needs to sleep; a waker
+// publishes its state change, then calls notify_one(). Both sides issue a
+// seq_cst fence between the two steps.
+class WaiterQueue {
+	std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+	std::atomic<size_t> count_{0};
+	Waiter* head_ = nullptr;
+	Waiter* tail_ = nullptr;
+
+	void acquire() noexcept {
+		while (lock_.test_and_set(std::memory_order_acquire)) {
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#endif
+		}
+	}
+
+	void release() noexcept { lock_.clear(std::memory_order_release); }
+
+	void unlink(Waiter* waiter) noexcept {
+		if (waiter->prev) {
+			waiter->prev->next = waiter->next;
+		} else {
+			head_ = waiter->next;
+		}
+		if (waiter->next) {
+			waiter->next->prev = waiter->prev;
+		} else {
+			tail_ = waiter->prev;
+		}
+		waiter->prev = waiter->next = nullptr;
+		waiter->queued = false;
+		count_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+ public:
+	bool has_waiters() const noexcept {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		return count_.load(std::memory_order_relaxed) != 0;
+	}
+
+	void enqueue(Waiter& waiter) noexcept {
+		acquire();
+		waiter.prev = tail_;
+		waiter.next = nullptr;
+		waiter.queued = true;
+		if (tail_) {
+			tail_->next = &waiter;
+		} else {
+			head_ = &waiter;
+		}
+		tail_ = &waiter;
+		count_.fetch_add(1, std::memory_order_relaxed);
+		release();
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+
+	// Withdraw a waiter that decided not to sleep. Returns false if a waker
+	// already claimed it, in which case it will be resumed and must suspend.
+	bool cancel(Waiter& waiter) noexcept {
+		acquire();
+		bool was_queued = waiter.queued;
+		if (was_queued) {
+			unlink(&waiter);
+		}
+		release();
+		return was_queued;
+	}
+
+	// Hand the oldest waiter to its executor; returns false if none
+	bool notify_one() {
+		if (!has_waiters())
+			return false;
+
+		acquire();
+		Waiter* waiter = head_;
+		if (waiter) {
+			unlink(waiter);
+		}
+		release();
+
+		if (!waiter)
+			return false;
+		waiter->scheduler->schedule(waiter->handle);
+		return true;
+	}
+
+	// notify_one() only if ready() holds once a waiter is found. ready() runs
+	// under the lock, so it sees the state after that waiter re-checked its
+	// condition (use it when the state can go stale between check and wake).
+	template <typename Ready>
+	bool notify_one_if(Ready&& ready) {
+		if (!has_waiters())
+			return false;
+
+		acquire();
+		Waiter* waiter = head_;
+		if (waiter && ready()) {
+			unlink(waiter);
+		} else {
+			waiter = nullptr;
+		}
+		release();
+
+		if (!waiter)
+			return false;
+		waiter->scheduler->schedule(waiter->handle);
+		return true;
+	}
+
+	void notify_all() {
+		while (notify_one()) {
+		}
+	}
+};
+
+}	 // namespace matching_engine::coro
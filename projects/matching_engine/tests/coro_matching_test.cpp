@@ -1,11 +1,32 @@
 #include <fmt/color.h>
 #include <fmt/core.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <thread>
 #include <vector>
 
+#include "matching_engine/core/clock.hpp"
+#include "matching_engine/core/packed_event.hpp"
+#include "matching_engine/core/tick.hpp"
 #include "matching_engine/matching/async_engine.hpp"
+#include "matching_engine/matching/multi_symbol_engine.hpp"
+#include "matching_engine/memory/page_arena.hpp"
+#include "matching_engine/memory/shm_ring_buffer.hpp"
+#include "matching_engine/persistence/backtest.hpp"
+#include "matching_engine/persistence/journal.hpp"
+#include "matching_engine/persistence/snapshot.hpp"
 #include "matching_engine/scheduler/coro_scheduler.hpp"
+#include "matching_engine/scheduler/thread_pool.hpp"
+#include "matching_engine/scheduler/timer_wheel.hpp"
 
 using namespace matching_engine;
 using namespace matching_engine::matching;
@@ -160,6 +181,22 @@ coro::Task<void> test_batch_processing() {
 	fmt::print("  Orderbook: {} orders, {} bid levels, {} ask levels\n", book.order_count(),
 						 book.bid_levels(), book.ask_levels());
 
+	// Per-order acks: one slot per order, in order, rejects included
+	std::vector<OrderEvent> more{
+			OrderEvent{.type = OrderEventType::New, .price = Price::from_double(90.0),
+								 .quantity = Quantity{3}, .side = Side::Buy},
+			OrderEvent{.type = OrderEventType::Cancel, .order_id = OrderId{999999}}};
+	std::vector<OrderEvent> acks(more.size());
+	size_t accepted = co_await engine.process_batch_async(more, acks);
+	bool acks_ok = accepted == 1 && acks[0].type == OrderEventType::New &&
+								 acks[0].order_id.value != 0 && acks[0].price == more[0].price &&
+								 acks[1].type == OrderEventType::Reject;
+	if (acks_ok) {
+		fmt::print(fg(fmt::color::green), "✓ Batch acks line up with orders\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Batch acks do not match orders\n");
+	}
+
 	co_return;
 }
 
@@ -276,38 +313,2651 @@ coro::Task<void> test_ring_buffer_async() {
 	co_return;
 }
 
-int main() {
-	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
-						 "\n╔══════════════════════════════════════╗\n");
-	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
-						 "║  Coroutine Matching Engine Tests    ║\n");
-	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
-						 "╚══════════════════════════════════════╝\n");
+// Test 6: Price-ladder book matches the map book
+coro::Task<void> test_ladder_orderbook() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 6: Price Ladder OrderBook ===\n");
+
+	SyncMatchingEngine<OrderBook> map_engine;
+	SyncMatchingEngine<LadderOrderBook> ladder_engine(
+			BookConfig{.reference_price = Price::from_double(100.0), .ladder_ticks = 1024});
+
+	// Same flow through both books
+	size_t fills = 0;
+	for (int i = 0; i < 200; ++i) {
+		Price price = Price{10000 + (i * 7) % 40 - 20};
+		Quantity qty{static_cast<uint64_t>(1 + i % 9)};
+		Side side = (i % 3 == 0) ? Side::Buy : Side::Sell;
+		OrderType type = (i % 17 == 0) ? OrderType::Market : OrderType::Limit;
+
+		map_engine.add_order(price, qty, side, type);
+		ladder_engine.add_order(price, qty, side, type);
+		fills += ladder_engine.take_events().size();
+		map_engine.take_events();
+	}
 
-	// Run all tests
-	auto test1 = test_async_order_submission();
-	while (!test1.done()) {
-		test1.resume();
+	auto map_depth = map_engine.get_market_depth(20);
+	auto ladder_depth = ladder_engine.get_market_depth(20);
+
+	bool same = map_engine.get_best_bid() == ladder_engine.get_best_bid() &&
+							map_engine.get_best_ask() == ladder_engine.get_best_ask() &&
+							map_engine.orderbook().order_count() == ladder_engine.orderbook().order_count() &&
+							map_engine.orderbook().bid_levels() == ladder_engine.orderbook().bid_levels() &&
+							map_engine.orderbook().ask_levels() == ladder_engine.orderbook().ask_levels() &&
+							map_depth.bid_levels() == ladder_depth.bid_levels() &&
+							map_depth.ask_levels() == ladder_depth.ask_levels();
+	for (size_t i = 0; same && i < map_depth.bid_levels(); ++i) {
+		same = map_depth.bid(i)->price == ladder_depth.bid(i)->price &&
+					 map_depth.bid(i)->quantity == ladder_depth.bid(i)->quantity;
+	}
+	for (size_t i = 0; same && i < map_depth.ask_levels(); ++i) {
+		same = map_depth.ask(i)->price == ladder_depth.ask(i)->price &&
+					 map_depth.ask(i)->quantity == ladder_depth.ask(i)->quantity;
 	}
 
-	auto test2 = test_producer_consumer();
-	while (!test2.done()) {
-		test2.resume();
+	if (same) {
+		fmt::print(fg(fmt::color::green), "✓ Ladder book state matches map book ({} fills)\n", fills);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Ladder book diverged from map book\n");
 	}
 
-	auto test3 = test_batch_processing();
-	while (!test3.done()) {
-		test3.resume();
+	// Limit orders outside the band cannot rest and are rejected
+	auto rejected = ladder_engine.add_order(Price::from_double(500.0), Quantity{1}, Side::Buy);
+	if (rejected.is_err() && rejected.value().type == OrderEventType::Reject) {
+		fmt::print(fg(fmt::color::green), "✓ Out-of-band limit order rejected\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Out-of-band limit order accepted\n");
 	}
 
-	auto test4 = test_market_depth_monitoring();
-	while (!test4.done()) {
-		test4.resume();
+	co_return;
+}
+
+// Test 7: O(1) cancel and modify by OrderId
+template <typename Book>
+bool run_cancel_modify_checks() {
+	SyncMatchingEngine<Book> engine(BookConfig{.max_orders = 8});
+
+	auto a = engine.add_order(Price::from_double(100.0), Quantity{10}, Side::Buy).value().order_id;
+	auto b = engine.add_order(Price::from_double(100.0), Quantity{20}, Side::Buy).value().order_id;
+	auto c = engine.add_order(Price::from_double(99.5), Quantity{30}, Side::Buy).value().order_id;
+
+	// Cancel the head of the best level; b keeps the level alive
+	bool ok = engine.cancel_order(a).is_ok() && engine.orderbook().order_count() == 2 &&
+						engine.get_best_bid() == Price::from_double(100.0);
+
+	// Cancelling twice is rejected
+	ok = ok && engine.cancel_order(a).is_err();
+
+	// Reprice c above b: c now leads the book
+	ok = ok && engine.modify_order(c, Price::from_double(100.5), Quantity{30}).is_ok() &&
+			 engine.get_best_bid() == Price::from_double(100.5) && engine.orderbook().bid_levels() == 2;
+
+	// Shrink b in place, then sell through both bids
+	ok = ok && engine.modify_order(b, Price::from_double(100.0), Quantity{5}).is_ok();
+	auto sell = engine.add_order(Price::from_double(100.0), Quantity{35}, Side::Sell);
+	ok = ok && sell.value().fill_info.filled_quantity.value == 35 &&
+			 engine.orderbook().order_count() == 0 && !engine.get_best_bid();
+
+	// Filled orders are gone from the index
+	ok = ok && engine.cancel_order(b).is_err();
+
+	// The pool recycles nodes: many add/cancel cycles within max_orders
+	for (int i = 0; ok && i < 100; ++i) {
+		auto id = engine.add_order(Price::from_double(101.0), Quantity{1}, Side::Sell).value().order_id;
+		ok = engine.cancel_order(id).is_ok();
 	}
+	return ok && engine.orderbook().order_count() == 0 && engine.orderbook().ask_levels() == 0;
+}
 
-	auto test5 = test_ring_buffer_async();
-	while (!test5.done()) {
-		test5.resume();
+coro::Task<void> test_cancel_modify() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 7: Cancel / Modify ===\n");
+
+	if (run_cancel_modify_checks<OrderBook>()) {
+		fmt::print(fg(fmt::color::green), "✓ Map book cancel/modify\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Map book cancel/modify\n");
+	}
+
+	if (run_cancel_modify_checks<LadderOrderBook>()) {
+		fmt::print(fg(fmt::color::green), "✓ Ladder book cancel/modify\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Ladder book cancel/modify\n");
+	}
+
+	// Cancels travel through the async engine as events
+	AsyncMatchingEngine<> engine;
+	OrderEvent bid{.type = OrderEventType::New,
+								 .price = Price::from_double(100.0),
+								 .quantity = Quantity{10},
+								 .side = Side::Buy};
+	auto placed = co_await engine.submit_order_async(bid);
+	OrderEvent cancel{.type = OrderEventType::Cancel, .order_id = placed.value().order_id};
+	auto cancelled = co_await engine.submit_order_async(cancel);
+
+	if (cancelled.is_ok() && cancelled.value().type == OrderEventType::Cancel &&
+			!engine.engine().get_best_bid()) {
+		fmt::print(fg(fmt::color::green), "✓ Async cancel removed order {}\n",
+							 cancelled.value().order_id.value);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Async cancel failed\n");
+	}
+
+	co_return;
+}
+
+// Test 8: Fills delivered through caller-supplied sinks
+coro::Task<void> test_event_sinks() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 8: Event Sinks ===\n");
+
+	OrderBook book;
+	for (int i = 0; i < 5; ++i) {
+		book.add_order(Price::from_double(100.0 + i * 0.01), Quantity{10}, Side::Sell);
+	}
+
+	// Lambda sink sees each fill as it is produced
+	uint64_t filled = 0;
+	size_t fills = 0;
+	auto sink = [&](const OrderEvent& event) {
+		++fills;
+		filled += event.fill_info.filled_quantity.value;
+	};
+	book.add_order(Price::from_double(101.0), Quantity{45}, Side::Buy, OrderType::Limit, sink);
+
+	if (fills == 5 && filled == 45 && book.take_events().empty()) {
+		fmt::print(fg(fmt::color::green), "✓ Lambda sink received {} fills, nothing buffered\n", fills);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Lambda sink saw {} fills\n", fills);
+	}
+
+	// Ring buffer sink fills slots directly
+	memory::AsyncRingBuffer<OrderEvent, 4> ring;
+	RingBufferEventSink ring_sink{ring};
+	book.add_order(Price::from_double(99.0), Quantity{10}, Side::Sell, OrderType::Limit, ring_sink);
+	for (int i = 0; i < 6; ++i) {
+		book.add_order(Price::from_double(100.0), Quantity{1}, Side::Buy, OrderType::Limit, ring_sink);
+	}
+
+	if (ring.size() == 4 && ring_sink.dropped == 2) {
+		fmt::print(fg(fmt::color::green), "✓ Ring sink queued {} fills, dropped {} on overflow\n",
+							 ring.size(), ring_sink.dropped);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Ring sink queued {}, dropped {}\n", ring.size(),
+							 ring_sink.dropped);
+	}
+
+	co_return;
+}
+
+// Test 9: Packed 64-byte event records
+coro::Task<void> test_packed_events() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 9: Packed Event Records ===\n");
+
+	OrderBook book;
+	book.add_order(Price::from_double(100.0), Quantity{10}, Side::Sell);
+	auto taker = book.add_order(Price::from_double(100.5), Quantity{15}, Side::Buy);
+	auto fills = book.take_events();
+	auto rejected = book.cancel_order(OrderId{999});
+
+	bool ok = true;
+	for (const OrderEvent& original : {taker.value(), fills.at(0), rejected.value()}) {
+		auto round = PackedOrderEvent::from_event(original).to_event();
+		ok = ok && round.type == original.type && round.order_id == original.order_id &&
+				 round.price == original.price && round.quantity == original.quantity &&
+				 round.side == original.side && round.timestamp == original.timestamp &&
+				 round.fill_info.filled_quantity == original.fill_info.filled_quantity &&
+				 round.fill_info.remaining_quantity == original.fill_info.remaining_quantity &&
+				 round.fill_info.fill_price == original.fill_info.fill_price &&
+				 round.reject_reason.has_value() == original.reject_reason.has_value();
+	}
+	ok = ok && PackedOrderEvent::from_event(rejected.value()).reject_reason ==
+								 RejectReason::UnknownOrder;
+
+	if (ok) {
+		fmt::print(fg(fmt::color::green), "✓ New/Fill/Reject round-trip through {}-byte records\n",
+							 sizeof(PackedOrderEvent));
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Packed round-trip lost information\n");
+	}
+
+	// The ring sink packs on the way into a PackedOrderEvent buffer
+	memory::AsyncRingBuffer<PackedOrderEvent, 16> ring;
+	RingBufferEventSink sink{ring};
+	book.add_order(Price::from_double(99.0), Quantity{5}, Side::Sell, OrderType::Market, sink);
+	auto packed = ring.pop();
+	if (packed && packed->type == OrderEventType::Fill && packed->fill.filled_quantity == 5) {
+		fmt::print(fg(fmt::color::green), "✓ Packed fill queued at {:.2f}\n",
+							 Price{packed->fill.price_ticks}.to_double());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Packed ring sink\n");
+	}
+
+	// Offsets and peaks at the edge of 32 bits round-trip; one past is
+	// refused instead of truncated
+	int64_t far = int64_t{1} << 40;
+	OrderEvent edge{.type = OrderEventType::Cancel, .price = Price{far}};
+	edge.fill_info = FillInfo{.filled_quantity = Quantity{1}, .fill_price = Price{far + INT32_MAX}};
+	OrderEvent unfilled{.type = OrderEventType::New, .price = Price{far}};
+	OrderEvent peak{.type = OrderEventType::New,
+									.display_quantity = Quantity{UINT32_MAX},
+									.order_type = OrderType::Iceberg};
+	bool boundary = true;
+	for (const OrderEvent& original : {edge, unfilled, peak}) {
+		auto round = PackedOrderEvent::from_event(original).to_event();
+		boundary = boundary && PackedOrderEvent::packable(original) &&
+							 round.fill_info.fill_price == original.fill_info.fill_price &&
+							 round.display_quantity == original.display_quantity;
+	}
+	OrderEvent too_far = edge;
+	too_far.fill_info.fill_price = Price{far - INT32_MAX - 1};
+	OrderEvent too_tall = peak;
+	too_tall.display_quantity = Quantity{uint64_t{UINT32_MAX} + 1};
+	boundary = boundary && !PackedOrderEvent::packable(too_far) &&
+						 !PackedOrderEvent::packable(too_tall);
+
+	memory::AsyncRingBuffer<PackedOrderEvent, 16> edge_ring;
+	RingBufferEventSink edge_sink{edge_ring};
+	edge_sink(too_tall);
+	boundary = boundary && edge_sink.dropped == 1 && edge_ring.size() == 0;
+
+	if (boundary) {
+		fmt::print(fg(fmt::color::green), "✓ 32-bit offset/peak boundaries round-trip, beyond refused\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Packed record truncated an out-of-range offset or peak\n");
+	}
+
+	co_return;
+}
+
+// Test 10: Pluggable clock policies
+coro::Task<void> test_clock_policies() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 10: Clock Policies ===\n");
+
+	// Replay clock: every event of a sweep carries the injected time
+	BasicOrderBook<MapPriceLevels, ReplayClock> book;
+	book.clock().set(Timestamp{1'000});
+	for (int i = 0; i < 3; ++i) {
+		book.add_order(Price::from_double(100.0 + i * 0.01), Quantity{10}, Side::Sell);
+	}
+	book.clock().advance(500);
+	auto taker = book.add_order(Price::from_double(101.0), Quantity{30}, Side::Buy);
+	auto fills = book.take_events();
+
+	bool deterministic = taker.value().timestamp == Timestamp{1'500} && fills.size() == 3;
+	for (const auto& fill : fills) {
+		deterministic = deterministic && fill.timestamp == Timestamp{1'500} &&
+										fill.fill_info.fill_time == Timestamp{1'500};
+	}
+	if (deterministic) {
+		fmt::print(fg(fmt::color::green), "✓ Replay clock stamps sweep of {} fills at t=1500ns\n",
+							 fills.size());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Replay clock timestamps diverged\n");
+	}
+
+	// Cached clock only moves on refresh()
+	AsyncMatchingEngine<1024, BasicOrderBook<MapPriceLevels, CachedClock<TscClock>>> engine;
+	std::vector<OrderEvent> batch(4, OrderEvent{.type = OrderEventType::New,
+																							.price = Price::from_double(100.0),
+																							.quantity = Quantity{1},
+																							.side = Side::Buy});
+	co_await engine.process_batch_async(std::span(batch));
+	auto& clock = engine.engine().orderbook().clock();
+	Timestamp before = clock.now();
+	Timestamp again = clock.now();
+	clock.refresh();
+
+	TscClock tsc;
+	Timestamp t0 = tsc.now();
+	Timestamp t1 = tsc.now();
+
+	if (before == again && clock.now() >= before && t1 >= t0) {
+		fmt::print(fg(fmt::color::green), "✓ Cached clock held between refreshes, TSC monotonic\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Cached/TSC clock misbehaved\n");
+	}
+
+	co_return;
+}
+
+// Test 11: Coroutines park on a full/empty ring buffer instead of spinning
+coro::Task<int> parked_consumer(memory::AsyncRingBuffer<int, 4>& ring, int count) {
+	int sum = 0;
+	for (int i = 0; i < count; ++i) {
+		auto value = co_await ring.pop_async();
+		sum += value.value_or(-1000);
+	}
+	co_return sum;
+}
+
+coro::Task<int> parked_producer(memory::AsyncRingBuffer<int, 4>& ring, int count) {
+	int sent = 0;
+	for (int i = 0; i < count; ++i) {
+		if (co_await ring.push_async(i)) {
+			++sent;
+		}
+	}
+	co_return sent;
+}
+
+coro::Task<size_t> event_waiter(AsyncMatchingEngine<>& engine, size_t count) {
+	size_t fills = 0;
+	for (size_t i = 0; i < count; ++i) {
+		auto event = co_await engine.get_event_async();
+		if (event && event->type == OrderEventType::Fill) {
+			++fills;
+		}
+	}
+	co_return fills;
+}
+
+coro::Task<void> test_parking_awaitables() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 11: Parking Ring Buffer Awaitables ===\n");
+
+	coro::Scheduler scheduler;
+	memory::AsyncRingBuffer<int, 4> ring;
+
+	// Consumer starts first and parks on the empty buffer
+	auto consumer = parked_consumer(ring, 16);
+	scheduler.schedule(consumer.handle());
+	scheduler.run_until_idle();
+	bool parked = !consumer.done();
+
+	// Producer overruns the 4-slot buffer and parks in turn; the two
+	// hand off until both finish
+	auto producer = parked_producer(ring, 16);
+	scheduler.schedule(producer.handle());
+	size_t resumptions = scheduler.run_until_idle();
+
+	if (parked && consumer.done() && producer.done() && producer.get_result() == 16 &&
+			consumer.get_result() == 120) {
+		fmt::print(fg(fmt::color::green), "✓ 16 values through 4 slots with {} scheduler resumptions\n",
+							 resumptions);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Parked producer/consumer did not complete\n");
+	}
+
+	// get_event_async consumers sleep until a fill is queued
+	AsyncMatchingEngine<> engine;
+	auto waiter = event_waiter(engine, 2);
+	scheduler.schedule(waiter.handle());
+	size_t idle_runs = scheduler.run_until_idle();
+	idle_runs += scheduler.run_until_idle();	// Nothing is ready: costs nothing
+
+	OrderEvent ask{.type = OrderEventType::New,
+								 .price = Price::from_double(100.0),
+								 .quantity = Quantity{10},
+								 .side = Side::Sell};
+	OrderEvent bid{.type = OrderEventType::New,
+								 .price = Price::from_double(100.0),
+								 .quantity = Quantity{5},
+								 .side = Side::Buy};
+	co_await engine.submit_order_async(ask);
+	co_await engine.submit_order_async(bid);
+	co_await engine.submit_order_async(bid);
+	scheduler.run_until_idle();
+
+	if (idle_runs == 1 && waiter.done() && waiter.get_result() == 2) {
+		fmt::print(fg(fmt::color::green), "✓ get_event_async waiter woke only for its 2 fills\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ get_event_async waiter (idle runs {})\n", idle_runs);
+	}
+
+	co_return;
+}
+
+// Test 12: Multi-producer/multi-consumer ring buffer
+coro::Task<void> test_mpmc_ring_buffer() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 12: MPMC Ring Buffer ===\n");
+
+	constexpr int kProducers = 4;
+	constexpr int kPerProducer = 20000;
+
+	memory::MpmcRingBuffer<uint64_t, 256> ring;
+	std::atomic<uint64_t> consumed_sum{0};
+	std::atomic<int> consumed{0};
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < kProducers; ++p) {
+		threads.emplace_back([&ring, p] {
+			for (int i = 0; i < kPerProducer; ++i) {
+				uint64_t value = static_cast<uint64_t>(p) * kPerProducer + i;
+				while (!ring.push(value)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (int c = 0; c < 2; ++c) {
+		threads.emplace_back([&] {
+			while (consumed.load() < kProducers * kPerProducer) {
+				if (auto value = ring.pop()) {
+					consumed_sum += *value;
+					++consumed;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	uint64_t n = kProducers * kPerProducer;
+	if (consumed.load() == static_cast<int>(n) && consumed_sum.load() == n * (n - 1) / 2) {
+		fmt::print(fg(fmt::color::green), "✓ {} values from {} producers, none lost or duplicated\n",
+							 n, kProducers);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ MPMC lost values: {} of {}\n", consumed.load(), n);
+	}
+
+	// A single pop_async consumer never gets nullopt while the queue is open,
+	// even when it re-checks while producers hold claimed, unpublished slots
+	{
+		memory::MpmcRingBuffer<uint64_t, 16> parking;
+		coro::Scheduler scheduler;
+		auto consumer = [](memory::MpmcRingBuffer<uint64_t, 16>& queue,
+											 uint64_t expected) -> coro::Task<std::pair<uint64_t, uint64_t>> {
+			uint64_t received = 0;
+			uint64_t spurious = 0;
+			while (received < expected) {
+				if (co_await queue.pop_async()) {
+					++received;
+				} else if (!queue.closed()) {
+					++spurious;
+				} else {
+					break;
+				}
+			}
+			co_return std::pair{received, spurious};
+		};
+		auto task = consumer(parking, n);
+		std::vector<std::thread> producers;
+		for (int p = 0; p < kProducers; ++p) {
+			producers.emplace_back([&parking] {
+				for (int i = 0; i < kPerProducer; ++i) {
+					while (!parking.push(static_cast<uint64_t>(i))) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		auto [received, spurious] = scheduler.block_on(task);
+		for (auto& t : producers) {
+			t.join();
+		}
+		if (received == n && spurious == 0) {
+			fmt::print(fg(fmt::color::green), "✓ Parked pop_async consumer took all {} values, no empty wakeups\n",
+								 received);
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ pop_async consumer: {} values, {} nullopt on an open queue\n",
+								 received, spurious);
+		}
+	}
+
+	// The engine runs unchanged over the MPMC queue
+	AsyncMatchingEngine<1024, OrderBook, memory::MpmcRingBuffer> engine;
+	OrderEvent ask{.type = OrderEventType::New,
+								 .price = Price::from_double(100.0),
+								 .quantity = Quantity{10},
+								 .side = Side::Sell};
+	OrderEvent bid = ask;
+	bid.side = Side::Buy;
+	co_await engine.submit_order_async(ask);
+	co_await engine.submit_order_async(bid);
+	auto fill = co_await engine.get_event_async();
+
+	if (fill && fill->type == OrderEventType::Fill && fill->quantity.value == 10) {
+		fmt::print(fg(fmt::color::green), "✓ AsyncMatchingEngine over MpmcRingBuffer\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ AsyncMatchingEngine over MpmcRingBuffer\n");
+	}
+
+	co_return;
+}
+
+// Test 13: Bulk ring buffer transfers
+coro::Task<void> test_bulk_ring_buffer() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 13: Bulk Ring Buffer Transfers ===\n");
+
+	memory::AsyncRingBuffer<int, 8> ring;
+	std::array<int, 12> input{};
+	for (int i = 0; i < 12; ++i) {
+		input[i] = i;
+	}
+
+	size_t pushed = ring.push_bulk(input);
+	std::array<int, 5> out{};
+	size_t popped = ring.pop_bulk(out);
+	size_t pushed_again = ring.push_bulk(std::span<const int>(input).subspan(8));
+
+	if (pushed == 8 && popped == 5 && out[0] == 0 && out[4] == 4 && pushed_again == 4 &&
+			ring.size() == 7) {
+		fmt::print(fg(fmt::color::green), "✓ push_bulk/pop_bulk stop at capacity and wrap\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Bulk transfer counts: pushed={} popped={} again={}\n",
+							 pushed, popped, pushed_again);
+	}
+
+	// Drain order survives the wrap
+	std::array<int, 16> rest{};
+	size_t drained = ring.pop_bulk(rest);
+	bool in_order = drained == 7;
+	for (size_t i = 0; in_order && i < drained; ++i) {
+		in_order = rest[i] == static_cast<int>(i + 5);
+	}
+	if (in_order && ring.empty()) {
+		fmt::print(fg(fmt::color::green), "✓ Bulk drain preserves FIFO order\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Bulk drain out of order\n");
+	}
+
+	// A batch sweep publishes its fills in blocks and get_events_async
+	// drains them in one call
+	AsyncMatchingEngine<1024> engine;
+	std::vector<OrderEvent> batch;
+	for (int i = 0; i < 100; ++i) {
+		batch.push_back(OrderEvent{.type = OrderEventType::New,
+															 .price = Price::from_double(100.0),
+															 .quantity = Quantity{1},
+															 .side = Side::Sell});
+	}
+	batch.push_back(OrderEvent{.type = OrderEventType::New,
+														 .price = Price::from_double(100.0),
+														 .quantity = Quantity{100},
+														 .side = Side::Buy});
+	co_await engine.process_batch_async(batch);
+
+	std::array<OrderEvent, 128> events{};
+	size_t received = co_await engine.get_events_async(events);
+	if (received == 100 && events[99].type == OrderEventType::Fill && engine.dropped_events() == 0) {
+		fmt::print(fg(fmt::color::green), "✓ Batch fills published in bulk and drained at once\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Bulk event drain: received {}\n", received);
+	}
+}
+
+// Test 14: Scheduler run loops, Yield and deep await chains
+coro::Task<uint64_t> nested_sum(int depth) {
+	if (depth == 0) {
+		co_return 0;
+	}
+	co_return depth + co_await nested_sum(depth - 1);
+}
+
+coro::Task<void> yielding_worker(std::vector<int>& trace, int id, int turns) {
+	for (int i = 0; i < turns; ++i) {
+		trace.push_back(id);
+		co_await coro::Yield{};
+	}
+}
+
+coro::Task<void> test_scheduler_run_loops() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 14: Scheduler Run Loops ===\n");
+
+	// Nested awaits unwind through the continuation handoff
+	coro::Scheduler scheduler;
+	constexpr int kDepth = 2000;
+	auto chain = nested_sum(kDepth);
+	uint64_t sum = scheduler.block_on(chain);
+	if (sum == uint64_t{kDepth} * (kDepth + 1) / 2) {
+		fmt::print(fg(fmt::color::green), "✓ {}-deep await chain returned {}\n", kDepth, sum);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Deep await chain returned {}\n", sum);
+	}
+
+	// Yield requeues onto the scheduler, so workers take turns
+	std::vector<int> trace;
+	auto a = yielding_worker(trace, 1, 3);
+	auto b = yielding_worker(trace, 2, 3);
+	scheduler.spawn(a);
+	scheduler.spawn(b);
+	scheduler.run_until_idle();
+	if (a.done() && b.done() && trace == std::vector<int>{1, 2, 1, 2, 1, 2}) {
+		fmt::print(fg(fmt::color::green), "✓ Yielding workers interleaved round-robin\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Yield did not interleave workers\n");
+	}
+
+	// run() sleeps while a consumer is parked and wakes when another thread
+	// produces; stop() ends it once the queue drains
+	memory::AsyncRingBuffer<int, 4> ring;
+	int received = 0;
+	auto consumer = [](memory::AsyncRingBuffer<int, 4>& ring, int& received,
+										 coro::Scheduler& scheduler) -> coro::Task<void> {
+		for (int i = 0; i < 8; ++i) {
+			auto value = co_await ring.pop_async();
+			if (value) {
+				++received;
+			}
+		}
+		scheduler.stop();
+	}(ring, received, scheduler);
+	scheduler.spawn(consumer);
+
+	std::thread producer([&ring] {
+		for (int i = 0; i < 8; ++i) {
+			while (!ring.push(i)) {
+				std::this_thread::yield();
+			}
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	});
+	scheduler.run();
+	producer.join();
+
+	if (consumer.done() && received == 8) {
+		fmt::print(fg(fmt::color::green), "✓ run() slept until cross-thread pushes woke the consumer\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ run() consumer received {}\n", received);
+	}
+	co_return;
+}
+
+// Test 15: Work-stealing thread pool with pinned engines
+coro::Task<void> pinned_engine_session(coro::ThreadPool& pool, size_t worker,
+																			 AsyncMatchingEngine<1024>& engine, bool& stayed_pinned,
+																			 size_t& fills) {
+	co_await coro::schedule_on(pool.worker(worker));
+	auto owner = std::this_thread::get_id();
+	stayed_pinned = true;
+
+	for (int i = 0; i < 50; ++i) {
+		OrderEvent ask{.type = OrderEventType::New,
+									 .price = Price::from_double(100.0),
+									 .quantity = Quantity{1},
+									 .side = Side::Sell};
+		OrderEvent bid = ask;
+		bid.side = Side::Buy;
+		co_await engine.submit_order_async(ask);
+		co_await engine.submit_order_async(bid);
+		co_await coro::Yield{};
+		stayed_pinned = stayed_pinned && std::this_thread::get_id() == owner;
+		if (co_await engine.get_event_async()) {
+			++fills;
+		}
+	}
+}
+
+coro::Task<void> stealable_job(std::atomic<int>& done, int yields) {
+	for (int i = 0; i < yields; ++i) {
+		co_await coro::Yield{};
+	}
+	done.fetch_add(1);
+}
+
+coro::Task<void> test_thread_pool() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 15: Work-Stealing Thread Pool ===\n");
+
+	coro::ThreadPool pool(3);
+
+	// Two books, each owned by its own worker
+	AsyncMatchingEngine<1024> engine_a;
+	AsyncMatchingEngine<1024> engine_b;
+	bool pinned_a = false;
+	bool pinned_b = false;
+	size_t fills_a = 0;
+	size_t fills_b = 0;
+	auto session_a = pinned_engine_session(pool, 0, engine_a, pinned_a, fills_a);
+	auto session_b = pinned_engine_session(pool, 1, engine_b, pinned_b, fills_b);
+	pool.spawn(session_a);
+	pool.spawn(session_b);
+
+	// Unpinned work spreads over whichever workers are free
+	constexpr int kJobs = 200;
+	std::atomic<int> jobs_done{0};
+	std::vector<coro::Task<void>> jobs;
+	jobs.reserve(kJobs);
+	for (int i = 0; i < kJobs; ++i) {
+		jobs.push_back(stealable_job(jobs_done, 3));
+		pool.spawn(jobs.back());
+	}
+
+	pool.wait_idle();
+
+	if (session_a.done() && session_b.done() && pinned_a && pinned_b && fills_a == 50 &&
+			fills_b == 50) {
+		fmt::print(fg(fmt::color::green), "✓ Pinned engines stayed on their workers ({} + {} fills)\n",
+							 fills_a, fills_b);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Pinned engine sessions moved or lost fills\n");
+	}
+
+	if (jobs_done.load() == kJobs) {
+		fmt::print(fg(fmt::color::green), "✓ {} stealable jobs completed on {} workers\n", kJobs,
+							 pool.size());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Only {} of {} jobs completed\n", jobs_done.load(), kJobs);
+	}
+	co_return;
+}
+
+// Test 16: Recycled coroutine frames
+coro::Task<int, memory::HeapFrameAllocator> heap_framed_answer() {
+	co_return 42;
+}
+
+coro::Task<void> test_frame_recycling() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 16: Coroutine Frame Recycling ===\n");
+
+	AsyncMatchingEngine<1024> engine;
+	OrderEvent ask{.type = OrderEventType::New,
+								 .price = Price::from_double(100.0),
+								 .quantity = Quantity{1},
+								 .side = Side::Sell};
+	OrderEvent bid = ask;
+	bid.side = Side::Buy;
+
+	// Warm each size class once, then count heap hits over many calls
+	co_await engine.submit_order_async(ask);
+	co_await engine.get_best_ask_async();
+	co_await engine.submit_order_async(bid);
+	co_await engine.get_event_async();
+
+	using Frames = coro::DefaultFrameAllocator;
+	size_t before = Frames::heap_allocations();
+	for (int i = 0; i < 1000; ++i) {
+		co_await engine.submit_order_async(ask);
+		co_await engine.get_best_ask_async();
+		co_await engine.submit_order_async(bid);
+		co_await engine.get_event_async();
+	}
+	size_t heap_hits = Frames::heap_allocations() - before;
+
+	if (heap_hits == 0) {
+		fmt::print(fg(fmt::color::green), "✓ 4000 async calls reused recycled frames (0 heap hits)\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ {} frame allocations reached the heap\n", heap_hits);
+	}
+
+	int answer = co_await heap_framed_answer();
+	if (answer == 42) {
+		fmt::print(fg(fmt::color::green), "✓ Task with HeapFrameAllocator awaited normally\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ HeapFrameAllocator task returned {}\n", answer);
+	}
+}
+
+// Test 17: Multi-symbol engine sharded over a thread pool
+coro::Task<void> test_multi_symbol_engine() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 17: Multi-Symbol Sharded Engine ===\n");
+
+	constexpr uint32_t kSymbols = 64;
+	coro::ThreadPool pool(2);
+	MultiSymbolEngine<OrderBook, 1024, 8192> engine(pool, 4);
+
+	BookConfig small{.ladder_ticks = 1 << 10, .max_orders = 256};
+	for (uint32_t s = 0; s < kSymbols; ++s) {
+		engine.add_symbol(SymbolId{s}, small);
+	}
+	engine.start();
+
+	// A resting ask and a crossing bid per symbol, plus one unknown symbol
+	for (uint32_t s = 0; s < kSymbols; ++s) {
+		OrderEvent ask{.type = OrderEventType::New,
+									 .symbol = SymbolId{s},
+									 .price = Price::from_double(100.0),
+									 .quantity = Quantity{5},
+									 .side = Side::Sell};
+		OrderEvent bid = ask;
+		bid.side = Side::Buy;
+		while (!engine.submit(ask)) {
+			std::this_thread::yield();
+		}
+		while (!engine.submit(bid)) {
+			std::this_thread::yield();
+		}
+	}
+	engine.submit(OrderEvent{.type = OrderEventType::New,
+													 .symbol = SymbolId{kSymbols + 7},
+													 .price = Price::from_double(100.0),
+													 .quantity = Quantity{1}});
+	engine.stop();
+
+	size_t acks = 0;
+	size_t unknown = 0;
+	std::vector<int> fills_per_symbol(kSymbols, 0);
+	while (auto event = engine.poll()) {
+		if (event->type == OrderEventType::Fill && event->symbol.value < kSymbols) {
+			++fills_per_symbol[event->symbol.value];
+		} else if (event->type == OrderEventType::New) {
+			++acks;
+		} else if (event->type == OrderEventType::Reject) {
+			++unknown;
+		}
+	}
+
+	bool one_fill_each = std::all_of(fills_per_symbol.begin(), fills_per_symbol.end(),
+																		[](int n) { return n == 1; });
+	if (one_fill_each && acks == 2 * kSymbols && unknown == 1 && engine.dropped_events() == 0) {
+		fmt::print(fg(fmt::color::green), "✓ {} symbols over {} shards: merged {} acks and {} fills\n",
+							 kSymbols, engine.shard_count(), acks, kSymbols);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Multi-symbol routing: acks={} unknown={} dropped={}\n", acks,
+							 unknown, engine.dropped_events());
+	}
+
+	// Symbols really spread: no shard owns everything
+	std::vector<int> per_shard(engine.shard_count(), 0);
+	for (uint32_t s = 0; s < kSymbols; ++s) {
+		++per_shard[engine.shard_for(SymbolId{s})];
+	}
+	if (*std::max_element(per_shard.begin(), per_shard.end()) < static_cast<int>(kSymbols)) {
+		fmt::print(fg(fmt::color::green), "✓ Symbol hash spreads books across shards\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ All symbols hashed to one shard\n");
+	}
+	co_return;
+}
+
+// Test 18: Incrementally maintained depth
+template <typename Book>
+bool depth_matches_orders(const Book& book) {
+	// Every level's running total must equal a fresh walk of its orders
+	bool consistent = true;
+	for (Side side : {Side::Buy, Side::Sell}) {
+		book.for_each_level(side, [&](Price, const typename Book::Level& level) {
+			uint64_t open = 0;
+			size_t orders = 0;
+			for (const auto& order : level) {
+				open += order.quantity.value - order.filled.value;
+				++orders;
+			}
+			consistent = consistent && open == level.open_quantity().value && orders == level.size();
+			return consistent;
+		});
+	}
+
+	DepthSnapshot<8> snapshot;
+	book.snapshot_depth(snapshot);
+	MarketDepth depth = book.get_market_depth(8);
+	if (!consistent || snapshot.bid_levels != depth.bid_levels() ||
+			snapshot.ask_levels != depth.ask_levels())
+		return false;
+
+	for (size_t i = 0; i < snapshot.bid_levels; ++i) {
+		if (snapshot.bids[i].price != depth.bid(i)->price ||
+				snapshot.bids[i].quantity != depth.bid(i)->quantity)
+			return false;
+	}
+	for (size_t i = 0; i < snapshot.ask_levels; ++i) {
+		if (snapshot.asks[i].price != depth.ask(i)->price ||
+				snapshot.asks[i].quantity != depth.ask(i)->quantity)
+			return false;
+	}
+	return true;
+}
+
+template <typename Book>
+bool run_depth_workload(Book& book, uint64_t& sum_check) {
+	uint64_t seed = 12345;
+	auto next = [&seed] {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		return seed >> 33;
+	};
+
+	std::vector<OrderId> live;
+	for (int i = 0; i < 2000; ++i) {
+		uint64_t r = next() % 10;
+		if (r < 6 || live.empty()) {
+			Side side = next() % 2 ? Side::Buy : Side::Sell;
+			Price price{9990 + static_cast<int64_t>(next() % 21)};
+			auto result = book.add_order(price, Quantity{1 + next() % 20}, side);
+			if (result.is_ok()) {
+				live.push_back(result.value().order_id);
+			}
+		} else if (r < 8) {
+			size_t pick = next() % live.size();
+			book.cancel_order(live[pick]);
+			live.erase(live.begin() + static_cast<std::ptrdiff_t>(pick));
+		} else {
+			size_t pick = next() % live.size();
+			book.modify_order(live[pick], Price{9990 + static_cast<int64_t>(next() % 21)},
+												Quantity{1 + next() % 20});
+		}
+		if (i % 50 == 0 && !depth_matches_orders(book))
+			return false;
+	}
+	book.take_events();
+
+	// Level totals must equal the open quantity of the orders resting there
+	DepthSnapshot<32> snapshot;
+	book.snapshot_depth(snapshot);
+	for (size_t i = 0; i < snapshot.bid_levels; ++i) {
+		sum_check += snapshot.bids[i].quantity.value * snapshot.bids[i].orders;
+	}
+	return depth_matches_orders(book);
+}
+
+coro::Task<void> test_incremental_depth() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 18: Incremental Market Depth ===\n");
+
+	OrderBook map_book;
+	LadderOrderBook ladder_book;
+	uint64_t map_check = 0;
+	uint64_t ladder_check = 0;
+	bool map_ok = run_depth_workload(map_book, map_check);
+	bool ladder_ok = run_depth_workload(ladder_book, ladder_check);
+
+	if (map_ok && ladder_ok && map_check == ladder_check) {
+		fmt::print(fg(fmt::color::green),
+							 "✓ Level aggregates track adds, fills, cancels and modifies on both layouts\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Incremental depth diverged (map={}, ladder={})\n", map_ok,
+							 ladder_ok);
+	}
+
+	// Order counts per level come along for free
+	OrderBook book;
+	book.add_order(Price::from_double(99.0), Quantity{5}, Side::Buy);
+	book.add_order(Price::from_double(99.0), Quantity{7}, Side::Buy);
+	book.add_order(Price::from_double(101.0), Quantity{3}, Side::Sell);
+	book.add_order(Price::from_double(99.0), Quantity{2}, Side::Sell);	// Hits first bid
+	DepthSnapshot<4> snapshot;
+	book.snapshot_depth(snapshot);
+
+	if (snapshot.bid_levels == 1 && snapshot.bids[0].quantity.value == 10 &&
+			snapshot.bids[0].orders == 2 && snapshot.ask_levels == 1 && snapshot.asks[0].orders == 1) {
+		fmt::print(fg(fmt::color::green), "✓ Snapshot: bid 99.00 x 10 in 2 orders, ask 101.00 x 3\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Snapshot levels wrong\n");
+	}
+	co_return;
+}
+
+// Test 19: L2 delta feed with snapshot resync
+struct L2Replica {
+	std::map<int64_t, uint64_t, std::greater<>> bids;
+	std::map<int64_t, uint64_t> asks;
+	uint64_t sequence = 0;
+
+	template <size_t N>
+	void reset(const DepthSnapshot<N>& snapshot) {
+		bids.clear();
+		asks.clear();
+		for (size_t i = 0; i < snapshot.bid_levels; ++i) {
+			bids[snapshot.bids[i].price.ticks] = snapshot.bids[i].quantity.value;
+		}
+		for (size_t i = 0; i < snapshot.ask_levels; ++i) {
+			asks[snapshot.asks[i].price.ticks] = snapshot.asks[i].quantity.value;
+		}
+		sequence = snapshot.sequence;
+	}
+
+	// false on a sequence gap (caller must resync)
+	bool apply(const BookUpdate& update) {
+		if (update.sequence <= sequence)
+			return true;	// Already covered by the snapshot
+		if (update.sequence != sequence + 1)
+			return false;
+		sequence = update.sequence;
+		auto apply_to = [&](auto& side) {
+			if (update.quantity.value == 0) {
+				side.erase(update.price.ticks);
+			} else {
+				side[update.price.ticks] = update.quantity.value;
+			}
+		};
+		if (update.side == Side::Buy) {
+			apply_to(bids);
+		} else {
+			apply_to(asks);
+		}
+		return true;
+	}
+
+	template <size_t N>
+	bool matches(const DepthSnapshot<N>& snapshot) const {
+		auto same = [](const auto& side, const auto& levels, size_t count) {
+			auto it = side.begin();
+			for (size_t i = 0; i < count; ++i, ++it) {
+				if (it == side.end() || it->first != levels[i].price.ticks ||
+						it->second != levels[i].quantity.value)
+					return false;
+			}
+			return true;
+		};
+		return same(bids, snapshot.bids, snapshot.bid_levels) &&
+					 same(asks, snapshot.asks, snapshot.ask_levels);
+	}
+};
+
+template <typename Engine>
+coro::Task<void> random_flow(Engine& engine, uint64_t seed, int orders) {
+	std::vector<OrderId> live;
+	for (int i = 0; i < orders; ++i) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		uint64_t r = seed >> 33;
+		OrderEvent event{.type = OrderEventType::New,
+										 .price = Price{9995 + static_cast<int64_t>(r % 11)},
+										 .quantity = Quantity{1 + (r >> 8) % 9},
+										 .side = (r >> 16) % 2 ? Side::Buy : Side::Sell};
+		if (!live.empty() && r % 4 == 0) {
+			event.type = OrderEventType::Cancel;
+			event.order_id = live[(r >> 20) % live.size()];
+		}
+		auto result = co_await engine.submit_order_async(event);
+		if (result.is_ok() && event.type == OrderEventType::New) {
+			live.push_back(result.value().order_id);
+		}
+	}
+}
+
+coro::Task<void> test_l2_delta_feed() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 19: L2 Delta Feed ===\n");
+
+	AsyncMatchingEngine<8192> engine;
+	L2Replica replica;
+	replica.reset(co_await engine.get_depth_snapshot_async<32>());
+
+	co_await random_flow(engine, 7, 500);
+
+	std::array<BookUpdate, 256> updates;
+	bool contiguous = true;
+	size_t received = 0;
+	while (size_t n = engine.poll_updates(updates)) {
+		for (size_t i = 0; i < n; ++i) {
+			contiguous = contiguous && replica.apply(updates[i]);
+		}
+		received += n;
+	}
+
+	auto truth = co_await engine.get_depth_snapshot_async<32>();
+	if (contiguous && received > 0 && replica.sequence == truth.sequence && replica.matches(truth)) {
+		fmt::print(fg(fmt::color::green), "✓ {} deltas rebuilt the book exactly (seq {})\n", received,
+							 replica.sequence);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Delta replica diverged after {} updates\n", received);
+	}
+
+	// A tiny update queue overflows: the consumer detects the gap and
+	// resyncs from a snapshot, after which deltas apply again
+	AsyncMatchingEngine<16> small;
+	L2Replica late;
+	auto drain_into = [&small](L2Replica& replica) {
+		bool ok = true;
+		std::array<BookUpdate, 16> block;
+		while (size_t n = small.poll_updates(block)) {
+			for (size_t i = 0; i < n; ++i) {
+				ok = replica.apply(block[i]) && ok;
+			}
+		}
+		return ok;
+	};
+
+	co_await random_flow(small, 11, 100);
+	drain_into(late);
+	co_await random_flow(small, 12, 3);
+	bool gap = !drain_into(late);
+
+	late.reset(co_await small.get_depth_snapshot_async<32>());
+	co_await random_flow(small, 13, 3);
+	bool resynced = drain_into(late);
+	auto small_truth = co_await small.get_depth_snapshot_async<32>();
+
+	if (small.dropped_updates() > 0 && gap && resynced && late.matches(small_truth)) {
+		fmt::print(fg(fmt::color::green), "✓ Dropped deltas showed up as a sequence gap; resync recovered\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Gap/resync handling (dropped={}, gap={}, resynced={})\n",
+							 small.dropped_updates(), gap, resynced);
+	}
+}
+
+// Test 20: Journal and replay
+coro::Task<void> test_journal_replay() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 20: Journal and Replay ===\n");
+
+	auto path = (std::filesystem::temp_directory_path() / "coro_matching_test.journal").string();
+	std::filesystem::remove(path);
+
+	// Live run: every inbound event is processed, then journaled
+	SyncMatchingEngine<> live;
+	std::vector<OrderEvent> live_fills;
+	{
+		auto journal = persistence::JournalWriter::open(path.c_str());
+		uint64_t seed = 99;
+		std::vector<OrderId> ids;
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			uint64_t r = seed >> 33;
+			OrderEvent event{.type = OrderEventType::New,
+											 .price = Price{9990 + static_cast<int64_t>(r % 21)},
+											 .quantity = Quantity{1 + (r >> 8) % 50},
+											 .side = (r >> 16) % 2 ? Side::Buy : Side::Sell};
+			if (!ids.empty() && r % 5 == 0) {
+				event.type = r % 10 == 0 ? OrderEventType::Cancel : OrderEventType::Modify;
+				event.order_id = ids[(r >> 20) % ids.size()];
+			}
+			auto result = persistence::process_journaled(live, *journal, event,
+																									 VectorEventSink{live_fills});
+			if (event.type == OrderEventType::New && result.is_ok()) {
+				ids.push_back(result.value().order_id);
+			}
+		}
+		journal->wait_durable(journal->appended());
+	}
+
+	// Recovery: map the file and rebuild a ReplayClock book from it
+	auto reader = persistence::JournalReader::open(path.c_str());
+	SyncMatchingEngine<BasicOrderBook<MapPriceLevels, ReplayClock>> recovered;
+	std::vector<OrderEvent> replay_fills;
+	auto start = std::chrono::steady_clock::now();
+	size_t applied = reader ? persistence::replay(reader->records(), recovered,
+																								VectorEventSink{replay_fills})
+													: 0;
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start);
+
+	bool same_fills = live_fills.size() == replay_fills.size();
+	for (size_t i = 0; same_fills && i < live_fills.size(); ++i) {
+		same_fills = live_fills[i].order_id == replay_fills[i].order_id &&
+								 live_fills[i].price == replay_fills[i].price &&
+								 live_fills[i].quantity == replay_fills[i].quantity &&
+								 live_fills[i].timestamp == replay_fills[i].timestamp;
+	}
+	DepthSnapshot<32> live_depth;
+	DepthSnapshot<32> recovered_depth;
+	live.snapshot_depth(live_depth);
+	recovered.snapshot_depth(recovered_depth);
+	bool same_book = live.orderbook().order_count() == recovered.orderbook().order_count() &&
+									 live_depth.bid_levels == recovered_depth.bid_levels &&
+									 live_depth.ask_levels == recovered_depth.ask_levels &&
+									 std::equal(live_depth.bids.begin(),
+															live_depth.bids.begin() + live_depth.bid_levels,
+															recovered_depth.bids.begin(), [](const auto& a, const auto& b) {
+																return a.price == b.price && a.quantity == b.quantity;
+															});
+
+	if (applied == 20000 && same_fills && same_book) {
+		fmt::print(fg(fmt::color::green), "✓ Replayed {} records in {} μs: {} fills and book identical\n",
+							 applied, elapsed.count(), replay_fills.size());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Replay diverged (applied={}, fills={}, book={})\n", applied,
+							 same_fills, same_book);
+	}
+
+	// A torn tail from a crash is cut off when the journal is reopened
+	{
+		std::FILE* file = std::fopen(path.c_str(), "ab");
+		std::fwrite("torn", 1, 4, file);
+		std::fclose(file);
+		auto journal = persistence::JournalWriter::open(path.c_str());
+		journal->append(OrderEvent{.type = OrderEventType::Cancel, .order_id = OrderId{1}});
+	}
+	reader = persistence::JournalReader::open(path.c_str());
+	if (reader && reader->size() == 20001 &&
+			reader->records().back().type == OrderEventType::Cancel) {
+		fmt::print(fg(fmt::color::green), "✓ Reopen trimmed torn tail and appended record 20001\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Torn-tail recovery failed\n");
+	}
+	reader.reset();
+	std::filesystem::remove(path);
+	co_return;
+}
+
+// Test 21: Snapshot plus journal tail recovery
+coro::Task<void> test_snapshot_recovery() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 21: Snapshot Recovery ===\n");
+
+	auto dir = std::filesystem::temp_directory_path();
+	auto journal_path = (dir / "coro_matching_test_snap.journal").string();
+	auto snapshot_path = (dir / "coro_matching_test.snapshot").string();
+	std::filesystem::remove(journal_path);
+	std::filesystem::remove(snapshot_path);
+
+	// Live run: snapshot half way through, keep matching while it is written
+	SyncMatchingEngine<> live;
+	uint64_t snapshot_sequence = 0;
+	{
+		auto journal = persistence::JournalWriter::open(journal_path.c_str());
+		persistence::SnapshotWriter snapshots(snapshot_path);
+		uint64_t seed = 7;
+		std::vector<OrderId> ids;
+		for (int i = 0; i < 20000; ++i) {
+			if (i == 10000) {
+				snapshot_sequence = journal->position();
+				snapshots.submit(persistence::capture_snapshot(live.orderbook(), snapshot_sequence));
+			}
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			uint64_t r = seed >> 33;
+			OrderEvent event{.type = OrderEventType::New,
+											 .price = Price{9990 + static_cast<int64_t>(r % 21)},
+											 .quantity = Quantity{1 + (r >> 8) % 50},
+											 .side = (r >> 16) % 2 ? Side::Buy : Side::Sell};
+			if (!ids.empty() && r % 5 == 0) {
+				event.type = r % 10 == 0 ? OrderEventType::Cancel : OrderEventType::Modify;
+				event.order_id = ids[(r >> 20) % ids.size()];
+			}
+			auto result = persistence::process_journaled(live, *journal, event, NullEventSink{});
+			if (event.type == OrderEventType::New && result.is_ok()) {
+				ids.push_back(result.value().order_id);
+			}
+		}
+		journal->wait_durable(journal->appended());
+	}
+
+	auto same_book = [&](auto& engine) {
+		DepthSnapshot<32> expected;
+		DepthSnapshot<32> actual;
+		live.snapshot_depth(expected);
+		engine.snapshot_depth(actual);
+		auto same_level = [](const auto& a, const auto& b) {
+			return a.price == b.price && a.quantity == b.quantity && a.orders == b.orders;
+		};
+		return live.orderbook().order_count() == engine.orderbook().order_count() &&
+					 live.orderbook().next_order_id() == engine.orderbook().next_order_id() &&
+					 expected.bid_levels == actual.bid_levels && expected.ask_levels == actual.ask_levels &&
+					 std::equal(expected.bids.begin(), expected.bids.begin() + expected.bid_levels,
+											actual.bids.begin(), same_level) &&
+					 std::equal(expected.asks.begin(), expected.asks.begin() + expected.ask_levels,
+											actual.asks.begin(), same_level);
+	};
+
+	using RecoveredEngine = SyncMatchingEngine<BasicOrderBook<MapPriceLevels, ReplayClock>>;
+	RecoveredEngine full;
+	auto reader = persistence::JournalReader::open(journal_path.c_str());
+	persistence::replay(reader->records(), full);
+	reader.reset();
+
+	auto start = std::chrono::steady_clock::now();
+	RecoveredEngine recovered;
+	auto replayed = persistence::recover(recovered, snapshot_path.c_str(), journal_path.c_str());
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start);
+
+	if (replayed && *replayed == 20000 - snapshot_sequence && same_book(recovered) &&
+			same_book(full)) {
+		fmt::print(fg(fmt::color::green),
+							 "✓ Snapshot at record {} + {} tail records rebuilt the book in {} μs\n",
+							 snapshot_sequence, *replayed, elapsed.count());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Snapshot recovery diverged (replayed={})\n",
+							 replayed.value_or(0));
+	}
+
+	// Drop the journal prefix the snapshot covers; recovery is unchanged
+	bool compacted = persistence::compact_journal(journal_path.c_str(), snapshot_sequence);
+	reader = persistence::JournalReader::open(journal_path.c_str());
+	bool trimmed = reader && reader->base_sequence() == snapshot_sequence &&
+								 reader->end_sequence() == 20000;
+	reader.reset();
+	RecoveredEngine after_compaction;
+	auto tail = persistence::recover(after_compaction, snapshot_path.c_str(), journal_path.c_str());
+
+	if (compacted && trimmed && tail && *tail == *replayed && same_book(after_compaction)) {
+		fmt::print(fg(fmt::color::green), "✓ Compacted journal to records [{}, 20000)\n",
+							 snapshot_sequence);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Recovery after compaction failed\n");
+	}
+
+	// Without the snapshot the compacted journal alone would lose orders
+	std::filesystem::remove(snapshot_path);
+	RecoveredEngine without_snapshot;
+	auto gap = persistence::recover(without_snapshot, snapshot_path.c_str(), journal_path.c_str());
+	if (!gap && without_snapshot.orderbook().order_count() == 0) {
+		fmt::print(fg(fmt::color::green), "✓ Recovery refused a journal compacted past its snapshot\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Recovery replayed a compacted journal without its snapshot\n");
+	}
+
+	// Recovered book keeps assigning the ids the live book would
+	OrderEvent next{.type = OrderEventType::New,
+									.price = Price{9000},
+									.quantity = Quantity{1},
+									.side = Side::Buy};
+	auto live_next = live.process_event(next);
+	auto recovered_next = recovered.process_event(next);
+	if (live_next.is_ok() && recovered_next.is_ok() &&
+			live_next.value().order_id == recovered_next.value().order_id) {
+		fmt::print(fg(fmt::color::green), "✓ Next order id after recovery: {}\n",
+							 recovered_next.value().order_id.value);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Order ids diverged after recovery\n");
+	}
+
+	std::filesystem::remove(journal_path);
+	std::filesystem::remove(snapshot_path);
+	co_return;
+}
+
+// Test 22: Level sweep fast path
+coro::Task<void> test_level_sweep() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 22: Level Sweep ===\n");
+
+	struct UpdateLog {
+		std::vector<BookUpdate>& updates;
+		void operator()(const BookUpdate& update) { updates.push_back(update); }
+	};
+
+	// Same deep, sparse book on both layouts; only the ladder has plan_sweep
+	LadderOrderBook ladder;
+	OrderBook map;
+	std::vector<OrderEvent> ladder_fills;
+	std::vector<OrderEvent> map_fills;
+	std::vector<BookUpdate> updates;
+	MarketDataSink<VectorEventSink, UpdateLog> ladder_sink{{ladder_fills}, {updates}};
+	VectorEventSink map_sink{map_fills};
+
+	uint64_t seed = 5;
+	auto next = [&seed] {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		return seed >> 33;
+	};
+	for (int i = 0; i < 600; ++i) {
+		for (uint64_t n = 1 + next() % 4; n > 0; --n) {
+			Quantity ask_qty{1 + next() % 40};
+			Quantity bid_qty{1 + next() % 40};
+			ladder.add_order(Price{10001 + 3 * i}, ask_qty, Side::Sell, OrderType::Limit, ladder_sink);
+			map.add_order(Price{10001 + 3 * i}, ask_qty, Side::Sell, OrderType::Limit, map_sink);
+			ladder.add_order(Price{9999 - 3 * i}, bid_qty, Side::Buy, OrderType::Limit, ladder_sink);
+			map.add_order(Price{9999 - 3 * i}, bid_qty, Side::Buy, OrderType::Limit, map_sink);
+		}
+	}
+
+	L2Replica replica;
+	{
+		DepthSnapshot<1> empty;
+		replica.reset(empty);
+	}
+	for (const BookUpdate& update : updates) {
+		replica.apply(update);
+	}
+	updates.clear();
+
+	// Exactly the first 37 ask levels, then a limit sell that stops part way
+	// into a bid level and rests nothing, then a market order larger than
+	// the whole side
+	uint64_t first_levels = 0;
+	{
+		size_t levels = 0;
+		ladder.for_each_level(Side::Sell, [&](Price, const auto& level) {
+			first_levels += level.open_quantity().value;
+			return ++levels < 37;
+		});
+	}
+	struct Sweep {
+		Price price;
+		Quantity quantity;
+		Side side;
+		OrderType type;
+	};
+	const Sweep sweeps[] = {
+			{Price{0}, Quantity{first_levels}, Side::Buy, OrderType::Market},
+			{Price{9999 - 3 * 250}, Quantity{5000}, Side::Sell, OrderType::Limit},
+			{Price{10001 + 3 * 120}, Quantity{100000}, Side::Buy, OrderType::Limit},
+			{Price{0}, Quantity{1 << 30}, Side::Sell, OrderType::Market},
+			{Price{0}, Quantity{1 << 30}, Side::Buy, OrderType::Market},
+	};
+	// Both books, and the replica fed by the ladder's deltas, agree
+	auto same_book = [&] {
+		DepthSnapshot<64> ladder_depth;
+		DepthSnapshot<64> map_depth;
+		ladder.snapshot_depth(ladder_depth);
+		map.snapshot_depth(map_depth);
+		auto same_level = [](const auto& a, const auto& b) {
+			return a.price == b.price && a.quantity == b.quantity && a.orders == b.orders;
+		};
+		return ladder.order_count() == map.order_count() &&
+					 ladder_depth.bid_levels == map_depth.bid_levels &&
+					 ladder_depth.ask_levels == map_depth.ask_levels &&
+					 std::equal(ladder_depth.bids.begin(),
+											ladder_depth.bids.begin() + ladder_depth.bid_levels, map_depth.bids.begin(),
+											same_level) &&
+					 std::equal(ladder_depth.asks.begin(),
+											ladder_depth.asks.begin() + ladder_depth.ask_levels, map_depth.asks.begin(),
+											same_level) &&
+					 replica.sequence == ladder.update_sequence() && replica.matches(ladder_depth) &&
+					 replica.bids.size() == ladder.bid_levels() && replica.asks.size() == ladder.ask_levels();
+	};
+
+	bool same_results = true;
+	bool same_books = true;
+	size_t cleared = 0;
+	for (const Sweep& sweep : sweeps) {
+		auto a = ladder.add_order(sweep.price, sweep.quantity, sweep.side, sweep.type, ladder_sink);
+		auto b = map.add_order(sweep.price, sweep.quantity, sweep.side, sweep.type, map_sink);
+		same_results = same_results &&
+									 a.value().fill_info.filled_quantity == b.value().fill_info.filled_quantity &&
+									 a.value().fill_info.remaining_quantity == b.value().fill_info.remaining_quantity;
+		for (const BookUpdate& update : updates) {
+			cleared += update.quantity.value == 0;
+			replica.apply(update);
+		}
+		updates.clear();
+		same_books = same_books && same_book();
+	}
+
+	bool same_fills = ladder_fills.size() == map_fills.size();
+	for (size_t i = 0; same_fills && i < map_fills.size(); ++i) {
+		same_fills = ladder_fills[i].order_id == map_fills[i].order_id &&
+								 ladder_fills[i].price == map_fills[i].price &&
+								 ladder_fills[i].quantity == map_fills[i].quantity &&
+								 ladder_fills[i].fill_info.remaining_quantity ==
+										 map_fills[i].fill_info.remaining_quantity;
+	}
+
+	if (same_results && same_fills && same_books && ladder.order_count() == 0) {
+		fmt::print(fg(fmt::color::green), "✓ {} sweeps match the map book: {} fills, {} levels cleared\n",
+							 std::size(sweeps), ladder_fills.size(), cleared);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Sweep diverged (results={}, fills={}, books={})\n",
+							 same_results, same_fills, same_books);
+	}
+
+	// Sweep latency through 1000 levels of 4 orders each
+	auto time_sweep = [](auto& book) {
+		for (int i = 0; i < 1000; ++i) {
+			for (int n = 0; n < 4; ++n) {
+				book.add_order(Price{10001 + i}, Quantity{10}, Side::Sell, OrderType::Limit,
+											 NullEventSink{});
+			}
+		}
+		auto start = std::chrono::steady_clock::now();
+		auto result = book.add_order(Price{0}, Quantity{40000}, Side::Buy, OrderType::Market,
+																 NullEventSink{});
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start);
+		return result.value().fill_info.filled_quantity.value == 40000 && book.order_count() == 0
+							 ? elapsed.count()
+							 : -1;
+	};
+	auto ladder_us = time_sweep(ladder);
+	auto map_us = time_sweep(map);
+	if (ladder_us >= 0 && map_us >= 0) {
+		fmt::print(fg(fmt::color::green), "✓ 4000-order sweep: ladder {} μs, map {} μs\n", ladder_us,
+							 map_us);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Timed sweep left orders behind\n");
+	}
+	co_return;
+}
+
+// Test 23: IOC, FOK, post-only and iceberg orders
+template <typename Book>
+bool run_order_type_checks() {
+	Book book;
+	std::vector<OrderEvent> fills;
+	VectorEventSink sink{fills};
+	auto add = [&](Price price, uint64_t quantity, Side side, OrderType type, uint64_t display = 0) {
+		fills.clear();
+		return book.add_order(price, Quantity{quantity}, side, type, sink, Quantity{display});
+	};
+	auto fill_sizes = [&] {
+		std::vector<uint64_t> sizes;
+		for (const OrderEvent& fill : fills) {
+			sizes.push_back(fill.quantity.value);
+		}
+		return sizes;
+	};
+	auto best_ask = [&] {
+		DepthSnapshot<1> depth;
+		book.snapshot_depth(depth);
+		return depth.ask_levels ? depth.asks[0] : DepthLevel{};
+	};
+
+	add(Price{10010}, 5, Side::Sell, OrderType::Limit);
+	add(Price{10020}, 5, Side::Sell, OrderType::Limit);
+
+	// IOC trades what crosses and drops the rest
+	auto ioc = add(Price{10010}, 8, Side::Buy, OrderType::ImmediateOrCancel);
+	bool ok = ioc.is_ok() && ioc.value().fill_info.filled_quantity.value == 5 &&
+						ioc.value().fill_info.remaining_quantity.value == 3 && book.order_count() == 1 &&
+						!book.get_best_bid();
+
+	// FOK fills completely or leaves the book untouched
+	uint64_t sequence = book.update_sequence();
+	auto fok = add(Price{10020}, 6, Side::Buy, OrderType::FillOrKill);
+	ok = ok && fok.is_err() &&
+			 *fok.value().reject_reason == reject_reason_text(RejectReason::NotFillable) &&
+			 fills.empty() && book.order_count() == 1 && book.update_sequence() == sequence;
+	fok = add(Price{10020}, 5, Side::Buy, OrderType::FillOrKill);
+	ok = ok && fok.is_ok() && fok.value().fill_info.filled_quantity.value == 5 &&
+			 book.order_count() == 0;
+
+	// Post-only rests, or is rejected if it would trade
+	add(Price{10000}, 3, Side::Buy, OrderType::PostOnly);
+	auto crossing = add(Price{10000}, 3, Side::Sell, OrderType::PostOnly);
+	auto passive = add(Price{10001}, 3, Side::Sell, OrderType::PostOnly);
+	ok = ok && crossing.is_err() && passive.is_ok() && fills.empty() && book.order_count() == 2;
+	ok = ok && book.modify_order(passive.value().order_id, Price{10000}, Quantity{3}).is_err() &&
+			 book.get_best_ask() == Price{10001};
+	book.cancel_order(passive.value().order_id);
+
+	// An iceberg shows 10 at a time; each new slice joins the back of the queue
+	auto iceberg = add(Price{10030}, 100, Side::Sell, OrderType::Iceberg, 10);
+	book.template add_order<OrderType::Limit>(Price{10030}, Quantity{10}, Side::Sell, sink);
+	ok = ok && best_ask().quantity.value == 20 && best_ask().orders == 2;
+	ok = ok && add(Price{10030}, 111, Side::Buy, OrderType::FillOrKill).is_err();
+
+	add(Price{10030}, 15, Side::Buy, OrderType::Limit);
+	ok = ok && fill_sizes() == std::vector<uint64_t>{10, 5} && best_ask().quantity.value == 15 &&
+			 best_ask().orders == 2;
+	add(Price{10030}, 5, Side::Buy, OrderType::Limit);
+	ok = ok && fill_sizes() == std::vector<uint64_t>{5} && best_ask().quantity.value == 10 &&
+			 best_ask().orders == 1;
+
+	// Shrinking the total takes hidden quantity first: 100 -> 60 leaves 50 open
+	auto shrunk = book.modify_order(iceberg.value().order_id, Price{10030}, Quantity{60});
+	ok = ok && shrunk.is_ok() && shrunk.value().fill_info.remaining_quantity.value == 50 &&
+			 best_ask().quantity.value == 10;
+	ok = ok && add(Price{10030}, 51, Side::Buy, OrderType::FillOrKill).is_err();
+	fok = add(Price{10030}, 50, Side::Buy, OrderType::FillOrKill);
+	ok = ok && fok.is_ok() && fill_sizes() == std::vector<uint64_t>(5, 10) && !book.get_best_ask() &&
+			 book.order_count() == 1;
+
+	// A market order still sweeps at any price
+	auto market = add(Price{0}, 3, Side::Sell, OrderType::Market);
+	return ok && market.value().fill_info.filled_quantity.value == 3 && book.order_count() == 0;
+}
+
+coro::Task<void> test_order_types() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 23: Order Types ===\n");
+
+	if (run_order_type_checks<OrderBook>() && run_order_type_checks<LadderOrderBook>()) {
+		fmt::print(fg(fmt::color::green), "✓ IOC, FOK, post-only and iceberg on both book layouts\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Order type behaviour (map={}, ladder={})\n",
+							 run_order_type_checks<OrderBook>(), run_order_type_checks<LadderOrderBook>());
+	}
+
+	// The peak survives the packed journal record
+	OrderEvent inbound{.type = OrderEventType::New,
+										 .price = Price{10030},
+										 .quantity = Quantity{100},
+										 .display_quantity = Quantity{10},
+										 .side = Side::Sell,
+										 .order_type = OrderType::Iceberg};
+	auto round = PackedOrderEvent::from_event(inbound).to_event();
+	if (round.order_type == OrderType::Iceberg && round.display_quantity.value == 10 &&
+			round.quantity.value == 100) {
+		fmt::print(fg(fmt::color::green), "✓ Iceberg peak round-trips through PackedOrderEvent\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Iceberg peak lost in PackedOrderEvent\n");
+	}
+	co_return;
+}
+
+// Test 24: self-trade prevention and per-account risk limits
+template <template <typename, Side> class Levels>
+bool run_self_trade_checks(SelfTradePrevention mode) {
+	BookConfig config;
+	config.self_trade = mode;
+	BasicOrderBook<Levels> book(config);
+	std::vector<OrderEvent> events;
+	VectorEventSink sink{events};
+	auto add = [&](Price price, uint64_t quantity, Side side, uint32_t account) {
+		events.clear();
+		return book.add_order(price, Quantity{quantity}, side, OrderType::Limit, sink, Quantity{0},
+													AccountId{account});
+	};
+	using Seen = std::vector<std::pair<OrderEventType, uint64_t>>;
+	auto seen = [&] {
+		Seen out;
+		for (const OrderEvent& event : events) {
+			out.emplace_back(event.type, event.quantity.value);
+		}
+		return out;
+	};
+	auto stp_cancels = [&] {
+		return std::all_of(events.begin(), events.end(), [](const OrderEvent& event) {
+			return event.type != OrderEventType::Cancel ||
+						 *event.reject_reason == reject_reason_text(RejectReason::SelfTrade);
+		});
+	};
+	constexpr auto Fill = OrderEventType::Fill;
+	constexpr auto Cancel = OrderEventType::Cancel;
+
+	// Account 1 rests in front of account 2, then buys through both levels
+	add(Price{10010}, 5, Side::Sell, 1);
+	add(Price{10010}, 5, Side::Sell, 2);
+	add(Price{10020}, 5, Side::Sell, 2);
+	auto taker = add(Price{10020}, 12, Side::Buy, 1);
+	bool ok = taker.is_ok() && stp_cancels();
+	switch (mode) {
+		case SelfTradePrevention::None:
+			ok = ok && seen() == Seen{{Fill, 5}, {Fill, 5}, {Fill, 2}} && book.order_count() == 1;
+			break;
+		case SelfTradePrevention::CancelNewest:
+			ok = ok && seen() == Seen{{Cancel, 12}} && events[0].order_id == taker.value().order_id &&
+					 taker.value().fill_info.remaining_quantity.value == 0 && book.order_count() == 3;
+			break;
+		case SelfTradePrevention::CancelOldest:
+			ok = ok && seen() == Seen{{Cancel, 5}, {Fill, 5}, {Fill, 5}} && book.order_count() == 1 &&
+					 book.get_best_bid() == Price{10020} && !book.get_best_ask();
+			break;
+		case SelfTradePrevention::Decrement:
+			ok = ok && seen() == Seen{{Cancel, 5}, {Fill, 5}, {Fill, 2}} && book.order_count() == 1 &&
+					 taker.value().fill_info.remaining_quantity.value == 0 && !book.get_best_bid();
+
+			// The smaller side is the incoming one: the resting order keeps 2
+			ok = ok && add(Price{10020}, 1, Side::Buy, 2).is_ok() && seen() == Seen{{Cancel, 1}} &&
+					 book.get_market_depth().ask(0)->quantity.value == 2;
+			break;
+	}
+
+	// A fill-or-kill stays all-or-none when it would meet its own account
+	{
+		BasicOrderBook<Levels> fok(config);
+		auto place = [&](uint64_t quantity, Side side, uint32_t account, OrderType type) {
+			events.clear();
+			return fok.add_order(Price{10010}, Quantity{quantity}, side, type, sink, Quantity{0},
+													 AccountId{account});
+		};
+		auto rejected = [](const Result<OrderEvent>& result, RejectReason reason) {
+			return result.is_err() && *result.value().reject_reason == reject_reason_text(reason);
+		};
+		place(5, Side::Sell, 2, OrderType::Limit);
+		place(5, Side::Sell, 1, OrderType::Limit);
+		auto kill = place(10, Side::Buy, 1, OrderType::FillOrKill);
+		if (mode == SelfTradePrevention::None) {
+			ok = ok && kill.is_ok() && seen() == Seen{{Fill, 5}, {Fill, 5}} && fok.order_count() == 0;
+		} else {
+			// CancelOldest would cancel its own 5, leaving too little; the
+			// others would cut the FOK itself short
+			ok = ok &&
+					 rejected(kill, mode == SelfTradePrevention::CancelOldest ? RejectReason::NotFillable
+																																		: RejectReason::SelfTrade) &&
+					 fok.order_count() == 2;
+			place(5, Side::Sell, 2, OrderType::Limit);
+			auto again = place(10, Side::Buy, 1, OrderType::FillOrKill);
+			if (mode == SelfTradePrevention::CancelOldest) {
+				ok = ok && again.is_ok() && seen() == Seen{{Fill, 5}, {Cancel, 5}, {Fill, 5}} &&
+						 fok.order_count() == 0;
+			} else {
+				ok = ok && rejected(again, RejectReason::SelfTrade) && fok.order_count() == 3;
+			}
+		}
+	}
+
+	// Account 0 is never checked
+	add(Price{10030}, 1, Side::Sell, 0);
+	ok = ok && add(Price{10030}, 1, Side::Buy, 0).is_ok() && seen() == Seen{{Fill, 1}};
+	return ok;
+}
+
+template <template <typename, Side> class Levels>
+bool run_risk_checks() {
+	BookConfig config;
+	config.max_accounts = 4;
+	BasicOrderBook<Levels, SystemClock, AccountRiskTable> book(config);
+	auto add = [&](Price price, uint64_t quantity, Side side, uint32_t account,
+								 OrderType type = OrderType::Limit) {
+		return book.add_order(price, Quantity{quantity}, side, type, book.default_sink(), Quantity{0},
+													AccountId{account});
+	};
+	auto rejected = [](const Result<OrderEvent>& result, RejectReason reason) {
+		return result.is_err() && *result.value().reject_reason == reject_reason_text(reason);
+	};
+	auto& risk = book.risk();
+	risk.set_limits(AccountId{1},
+									RiskLimits{.max_order_notional = 10010 * 10, .max_position = 20});
+	risk.set_limits(AccountId{3}, RiskLimits{.max_order_notional = 50000});
+
+	// Notional per order, then worst-case position across resting bids
+	bool ok = rejected(add(Price{10010}, 11, Side::Buy, 1), RejectReason::RiskLimit);
+	ok = ok && add(Price{10010}, 10, Side::Buy, 1).is_ok();
+	auto second = add(Price{10000}, 10, Side::Buy, 1);
+	ok = ok && second.is_ok() && rejected(add(Price{9990}, 1, Side::Buy, 1), RejectReason::RiskLimit);
+	ok = ok && risk.open_quantity(AccountId{1}, Side::Buy).value == 20;
+	ok = ok && rejected(add(Price{10000}, 1, Side::Buy, 7), RejectReason::UnknownAccount);
+
+	// Fills move open quantity into the position on both sides of the trade
+	add(Price{10000}, 15, Side::Sell, 2);
+	ok = ok && risk.position(AccountId{1}) == 15 && risk.position(AccountId{2}) == -15 &&
+			 risk.open_quantity(AccountId{1}, Side::Buy).value == 5 &&
+			 risk.open_quantity(AccountId{2}, Side::Sell).value == 0;
+	ok = ok && rejected(add(Price{9990}, 1, Side::Buy, 1), RejectReason::RiskLimit);
+
+	// A cancel/replace is checked without the quantity it replaces
+	OrderId id = second.value().order_id;
+	ok = ok && rejected(book.modify_order(id, Price{9990}, Quantity{11}), RejectReason::RiskLimit) &&
+			 book.modify_order(id, Price{9990}, Quantity{10}).is_ok() &&
+			 book.modify_order(id, Price{9990}, Quantity{7}).is_ok() &&
+			 risk.open_quantity(AccountId{1}, Side::Buy).value == 2;
+	book.cancel_order(id);
+	ok = ok && risk.open_quantity(AccountId{1}, Side::Buy).value == 0 &&
+			 add(Price{9990}, 5, Side::Buy, 1).is_ok();
+
+	// A market order is valued at what its sweep costs, deeper levels included
+	add(Price{10005}, 10, Side::Sell, 2);
+	ok = ok && rejected(add(Price{0}, 5, Side::Buy, 3, OrderType::Market), RejectReason::RiskLimit) &&
+			 add(Price{0}, 4, Side::Buy, 3, OrderType::Market).is_ok() &&
+			 risk.position(AccountId{3}) == 4 && risk.position(AccountId{2}) == -19;
+	add(Price{20000}, 10, Side::Sell, 2);
+	ok = ok && rejected(add(Price{0}, 8, Side::Buy, 3, OrderType::Market), RejectReason::RiskLimit) &&
+			 add(Price{0}, 4, Side::Buy, 3, OrderType::Market).is_ok() &&
+			 risk.position(AccountId{3}) == 8;
+	return ok;
+}
+
+coro::Task<void> test_self_trade_and_risk() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 24: Self-Trade Prevention and Risk Limits ===\n");
+
+	bool stp = true;
+	for (auto mode : {SelfTradePrevention::None, SelfTradePrevention::CancelNewest,
+										SelfTradePrevention::CancelOldest, SelfTradePrevention::Decrement}) {
+		stp = stp && run_self_trade_checks<MapPriceLevels>(mode) &&
+					run_self_trade_checks<LadderPriceLevels>(mode);
+	}
+	if (stp) {
+		fmt::print(fg(fmt::color::green), "✓ Self-trade prevention modes on both layouts\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Self-trade prevention misbehaved\n");
+	}
+
+	if (run_risk_checks<MapPriceLevels>() && run_risk_checks<LadderPriceLevels>()) {
+		fmt::print(fg(fmt::color::green), "✓ Notional and position limits track fills and cancels\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Risk limits (map={}, ladder={})\n",
+							 run_risk_checks<MapPriceLevels>(), run_risk_checks<LadderPriceLevels>());
+	}
+
+	// Owner and self-trade reason survive the packed record
+	OrderEvent cancel{.type = OrderEventType::Cancel,
+										.account = AccountId{42},
+										.price = Price{10010},
+										.quantity = Quantity{5},
+										.reject_reason = reject_reason_text(RejectReason::SelfTrade)};
+	auto round = PackedOrderEvent::from_event(cancel).to_event();
+	if (round.account.value == 42 && round.reject_reason &&
+			*round.reject_reason == reject_reason_text(RejectReason::SelfTrade)) {
+		fmt::print(fg(fmt::color::green), "✓ Account and self-trade reason round-trip when packed\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Account or reason lost in PackedOrderEvent\n");
+	}
+	co_return;
+}
+
+// Test 25: latency histograms and per-thread counters
+coro::Task<void> test_metrics() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 25: Metrics ===\n");
+
+	// Every value lands in a bucket whose range holds it, within 1/16
+	bool bounded = true;
+	for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull,
+												 ~0ull >> 1, ~0ull}) {
+		size_t bucket = metrics::LogHistogram::bucket_of(value);
+		uint64_t low = metrics::LogHistogram::lowest_in(bucket);
+		uint64_t high = metrics::LogHistogram::highest_in(bucket);
+		bounded = bounded && bucket < metrics::LogHistogram::BUCKETS && low <= value &&
+							value <= high && (high - low) <= low / 16;
+	}
+	metrics::LogHistogram histogram;
+	for (uint64_t value = 1; value <= 1000; ++value) {
+		histogram.record(value);
+	}
+	metrics::HistogramSnapshot merged;
+	histogram.merge_into(merged);
+	uint64_t p50 = merged.percentile(0.5);
+	uint64_t p99 = merged.percentile(0.99);
+	if (bounded && merged.total == 1000 && merged.max == 1000 && p50 >= 500 &&
+			p50 <= 500 + 500 / 16 && p99 >= 990 && p99 <= 1000 && merged.percentile(1.0) == 1000) {
+		fmt::print(fg(fmt::color::green), "✓ Log buckets: p50={} p99={} mean={:.1f}\n", p50, p99,
+							 merged.mean());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Histogram buckets or percentiles off (p50={}, p99={})\n",
+							 p50, p99);
+	}
+
+	// Two recording threads, read concurrently by the exporter thread
+	auto& registry = metrics::Registry::instance();
+	metrics::Snapshot before = registry.snapshot();
+	std::atomic<size_t> exports{0};
+	{
+		metrics::PeriodicExporter exporter(std::chrono::milliseconds(1),
+																			 [&](const metrics::Snapshot&) { exports.fetch_add(1); });
+		auto work = [&] {
+			auto& local = registry.local();
+			for (uint64_t i = 0; i < 20000; ++i) {
+				local.record(metrics::Histogram::FillsPerOrder, i % 8);
+				local.count(metrics::Counter::Fills, 1);
+			}
+		};
+		std::thread a(work), b(work);
+		a.join();
+		b.join();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	metrics::Snapshot after = registry.snapshot();
+	uint64_t fills = after[metrics::Counter::Fills] - before[metrics::Counter::Fills];
+	uint64_t recorded = after[metrics::Histogram::FillsPerOrder].total -
+											before[metrics::Histogram::FillsPerOrder].total;
+	if (fills == 40000 && recorded == 40000 && after.threads >= before.threads + 2 &&
+			exports.load() > 0) {
+		fmt::print(fg(fmt::color::green), "✓ Per-thread slots merge into one snapshot ({} exports)\n",
+							 exports.load());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Snapshot lost records (fills={}, recorded={})\n", fills,
+							 recorded);
+	}
+
+	// The engine hooks record only when built with MATCHING_ENGINE_METRICS
+	before = metrics::snapshot();
+	AsyncMatchingEngine<1024> engine;
+	co_await engine.submit_order_async(OrderEvent{.type = OrderEventType::New,
+																								.price = Price{10000},
+																								.quantity = Quantity{5},
+																								.side = Side::Sell});
+	co_await engine.submit_order_async(OrderEvent{.type = OrderEventType::New,
+																								.price = Price{10000},
+																								.quantity = Quantity{5},
+																								.side = Side::Buy});
+	after = metrics::snapshot();
+	auto delta = [&](metrics::Histogram which) {
+		return after[which].total - before[which].total;
+	};
+	bool hooks = metrics::enabled
+									 ? delta(metrics::Histogram::OrderToAck) == 2 &&
+												 delta(metrics::Histogram::SubmitAwait) == 2 &&
+												 delta(metrics::Histogram::QueueOccupancy) > 0 &&
+												 after[metrics::Counter::Fills] - before[metrics::Counter::Fills] == 1
+									 : delta(metrics::Histogram::OrderToAck) == 0 &&
+												 delta(metrics::Histogram::QueueOccupancy) == 0;
+	if (hooks) {
+		fmt::print(fg(fmt::color::green), "✓ Engine hooks {}\n",
+							 metrics::enabled ? "record ack, await and queue samples" : "compiled out");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Engine hooks (enabled={})\n", metrics::enabled);
+	}
+	co_return;
+}
+
+template <template <typename, Side> class Levels>
+bool run_tick_checks() {
+	// 1-tick increments below 100.00, 5 ticks from there
+	BookConfig config;
+	config.ticks.add_band(Price{10000}, 5);
+	BasicOrderBook<Levels> book(config);
+	auto rejected = [](const Result<OrderEvent>& result, RejectReason reason) {
+		return result.is_err() && *result.value().reject_reason == reject_reason_text(reason);
+	};
+
+	bool ok = book.add_order(Price{9999}, Quantity{1}, Side::Buy).is_ok() &&
+						book.add_order(Price{10005}, Quantity{1}, Side::Sell).is_ok();
+	ok = ok && rejected(book.add_order(Price{10003}, Quantity{1}, Side::Sell), RejectReason::OffTick);
+	ok = ok && rejected(book.add_order(Price{10003}, Quantity{1}, Side::Buy,
+																		 OrderType::ImmediateOrCancel),
+											RejectReason::OffTick);
+
+	// Market orders carry no price to check; modifies are checked like adds
+	ok = ok && book.add_order(Price{0}, Quantity{1}, Side::Sell, OrderType::Market).is_ok();
+	auto resting = book.add_order(Price{10010}, Quantity{2}, Side::Sell);
+	OrderId id = resting.value().order_id;
+	ok = ok && rejected(book.modify_order(id, Price{10012}, Quantity{2}), RejectReason::OffTick) &&
+			 book.modify_order(id, Price{10015}, Quantity{2}).is_ok();
+	return ok && book.ticks().bands() == 2;
+}
+
+// Test 26: decimal price parsing, tick tables and checked notional
+coro::Task<void> test_prices_and_ticks() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 26: Prices, Tick Tables and Notional ===\n");
+
+	// Truncation turned 100.29 into 10028
+	bool rounding = Price::from_double(100.29).ticks == 10029 &&
+									Price::from_double(-0.015).ticks == -2 && Price::from_double(0.0).ticks == 0;
+	if (rounding) {
+		fmt::print(fg(fmt::color::green), "✓ from_double rounds to the nearest tick\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ from_double(100.29) = {}\n", Price::from_double(100.29).ticks);
+	}
+
+	auto parsed = [](std::string_view text, int64_t scale, int64_t ticks) {
+		auto price = parse_price(text, scale);
+		return price && price->ticks == ticks;
+	};
+	bool parser = parsed("100.29", 100, 10029) && parsed("100.295", 100, 10030) &&
+								parsed("100.2949", 100, 10029) && parsed("-0.005", 100, -1) &&
+								parsed("+7", 100, 700) && parsed(".5", 100, 50) && parsed("12.", 100, 1200) &&
+								parsed("0.333", 3, 1) && parsed("1.25", 8, 10) &&
+								parsed("0.000000000000000000009", 100, 0) &&
+								parsed("92233720368547758.07", 100, INT64_MAX) &&
+								parsed("-92233720368547758.08", 100, INT64_MIN) &&
+								!parse_price("92233720368547758.08") && !parse_price("") && !parse_price("-") &&
+								!parse_price(".") && !parse_price("1.2.3") && !parse_price("1e5") &&
+								!parse_price("12 ") && !parse_price("1", 0);
+	static_assert(parse_price("100.29")->ticks == 10029);
+	if (parser) {
+		fmt::print(fg(fmt::color::green), "✓ Decimal text parses to exact, correctly rounded ticks\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ parse_price mis-parsed a decimal\n");
+	}
+
+	TickTable table(2);
+	table.add_band(Price{1000}, 10);
+	bool tick_table = table.on_tick(Price{998}) && !table.on_tick(Price{999}) &&
+										table.on_tick(Price{-4}) && !table.on_tick(Price{1005}) &&
+										table.round(Price{1005}, Side::Buy) == Price{1000} &&
+										table.round(Price{1005}, Side::Sell) == Price{1010} &&
+										table.round(Price{-3}, Side::Buy) == Price{-4} &&
+										!table.add_band(Price{500}, 1) && TickTable{}.on_tick(Price{12345});
+	if (tick_table && run_tick_checks<MapPriceLevels>() && run_tick_checks<LadderPriceLevels>()) {
+		fmt::print(fg(fmt::color::green), "✓ Tick bands reject off-tick limit prices and modifies\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Tick table (bands={}, map={}, ladder={})\n", tick_table,
+							 run_tick_checks<MapPriceLevels>(), run_tick_checks<LadderPriceLevels>());
+	}
+
+	// 2^62 ticks * 4 overflows 64 bits; the risk check must reject it
+	// rather than wrap to a small notional
+	bool notional = checked_notional(Price{-10}, Quantity{3}) == 30u &&
+									!checked_notional(Price{int64_t{1} << 62}, Quantity{4}) &&
+									checked_notional(Price{INT64_MIN}, Quantity{1}) == uint64_t{1} << 63;
+	AccountRiskTable risk;
+	risk.set_limits(AccountId{1}, RiskLimits{.max_order_notional = UINT64_MAX - 1});
+	notional = notional &&
+						 risk.check(AccountId{1}, Side::Buy, Price{int64_t{1} << 62}, Quantity{4}) ==
+								 RejectReason::RiskLimit &&
+						 risk.check(AccountId{1}, Side::Buy, Price{int64_t{1} << 62}, Quantity{3}) ==
+								 RejectReason::None;
+	if (notional) {
+		fmt::print(fg(fmt::color::green), "✓ Notional is checked in 128 bits\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Notional overflow slipped through\n");
+	}
+	co_return;
+}
+
+// Test 27: seqlock top-of-book publication
+coro::Task<void> test_top_of_book_seqlock() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 27: Top of Book SeqLock ===\n");
+
+	// Torn reads: every word of one write carries the same value, so a
+	// copy mixing two writes shows up as unequal words
+	struct Words {
+		std::array<uint64_t, 6> w;
+	};
+	memory::SeqLock<Words> lock;
+	std::atomic<bool> done{false};
+	std::atomic<size_t> torn{0}, reads{0};
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; ++r) {
+		readers.emplace_back([&] {
+			uint64_t last = 0;
+			while (!done.load(std::memory_order_acquire)) {
+				Words copy;
+				if (!lock.try_load(copy)) {
+					std::this_thread::yield();
+					continue;
+				}
+				reads.fetch_add(1, std::memory_order_relaxed);
+				bool same = std::all_of(copy.w.begin(), copy.w.end(), [&](uint64_t v) { return v == copy.w[0]; });
+				if (!same || copy.w[0] < last) {
+					torn.fetch_add(1, std::memory_order_relaxed);
+				}
+				last = copy.w[0];
+			}
+		});
+	}
+	for (uint64_t i = 1; i <= 200'000; ++i) {
+		Words value;
+		value.w.fill(i);
+		lock.store(value);
+	}
+	done.store(true, std::memory_order_release);
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	if (torn.load() == 0 && lock.load().w[0] == 200'000 && lock.version() == 200'000) {
+		fmt::print(fg(fmt::color::green), "✓ No torn or stale reads in {} seqlock reads\n", reads.load());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ {} torn seqlock reads\n", torn.load());
+	}
+
+	// The engine republishes after each submit and batch
+	AsyncMatchingEngine<> engine;
+	const auto& top = engine.top_of_book();
+	bool empty = !top.load().has_bid() && !top.load().has_ask();
+	co_await engine.submit_order_async(OrderEvent{
+			.type = OrderEventType::New, .price = Price{9990}, .quantity = Quantity{5}, .side = Side::Buy});
+	std::vector<OrderEvent> batch{
+			OrderEvent{.type = OrderEventType::New, .price = Price{9990}, .quantity = Quantity{3},
+								 .side = Side::Buy},
+			OrderEvent{.type = OrderEventType::New, .price = Price{10010}, .quantity = Quantity{7},
+								 .side = Side::Sell}};
+	co_await engine.process_batch_async(batch);
+	TopOfBook seen = top.load();
+	bool published = empty && seen.bid == Price{9990} && seen.bid_quantity.value == 8 &&
+									 seen.bid_orders == 2 && seen.ask == Price{10010} &&
+									 seen.ask_quantity.value == 7 &&
+									 seen.sequence == engine.engine().orderbook().update_sequence();
+
+	// A query that changes nothing does not republish
+	uint64_t version = top.version();
+	co_await engine.get_best_bid_async();
+	co_await engine.submit_order_async(OrderEvent{.type = OrderEventType::Cancel, .order_id = OrderId{99}});
+	published = published && top.version() == version;
+
+	// A buy taking the whole ask level empties that side
+	co_await engine.submit_order_async(OrderEvent{
+			.type = OrderEventType::New, .price = Price{10010}, .quantity = Quantity{7}, .side = Side::Buy});
+	seen = top.load();
+	published = published && !seen.has_ask() && seen.bid_quantity.value == 8 && top.version() > version;
+	if (published) {
+		fmt::print(fg(fmt::color::green), "✓ Top of book republished after submits and batches\n");
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Published top of book out of date\n");
+	}
+	co_return;
+}
+
+// Test 28: hierarchical timer wheel and sleeping coroutines
+struct ExpiryTimer {
+	coro::TimerNode node;
+	uint64_t fired_at = 0;	// Wheel time of the advance() that fired it
+	bool fired = false;
+	std::vector<uint64_t>* order = nullptr;
+};
+
+coro::Task<void> sleeper(std::vector<int>& trace, int id, std::chrono::microseconds delay) {
+	co_await coro::sleep_for(delay);
+	trace.push_back(id);
+}
+
+coro::Task<void> test_timer_wheel() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 28: Timer Wheel ===\n");
+
+	// Random deadlines from 1 tick to past the top level (overflow list),
+	// a third cancelled, advanced in random steps: every live timer fires
+	// exactly at the first advance() reaching its deadline, in order
+	{
+		coro::TimerWheel wheel(1, 0);
+		std::mt19937_64 rng(7);
+		std::vector<ExpiryTimer> timers(20000);
+		std::vector<uint64_t> order;
+		for (auto& t : timers) {
+			uint64_t horizon = uint64_t{1} << (rng() % 52);
+			t.node.context = &t;
+			t.node.callback = [](coro::TimerNode& node) {
+				auto& self = *static_cast<ExpiryTimer*>(node.context);
+				self.fired = true;
+				self.order->push_back(node.deadline_ns);
+			};
+			t.order = &order;
+			wheel.schedule(t.node, 1 + rng() % horizon);
+		}
+		size_t cancelled = 0;
+		for (size_t i = 0; i < timers.size(); i += 3) {
+			cancelled += wheel.cancel(timers[i].node);
+		}
+
+		bool on_time = true;
+		uint64_t now = 0;
+		while (!wheel.empty()) {
+			uint64_t step = uint64_t{1} << (rng() % 50);
+			now += 1 + rng() % step;
+			size_t before = order.size();
+			wheel.advance(now);
+			for (size_t i = before; i < order.size(); ++i) {
+				on_time = on_time && order[i] <= now;
+			}
+			for (auto& t : timers) {
+				on_time = on_time && (t.fired || !t.node.armed() || t.node.deadline_ns > now);
+			}
+		}
+		size_t fired = 0;
+		bool cancelled_quiet = true;
+		for (size_t i = 0; i < timers.size(); ++i) {
+			fired += timers[i].fired;
+			if (i % 3 == 0)
+				cancelled_quiet = cancelled_quiet && !timers[i].fired;
+		}
+		bool sorted = std::is_sorted(order.begin(), order.end());
+		if (cancelled == 6667 && fired == timers.size() - cancelled && cancelled_quiet && on_time && sorted) {
+			fmt::print(fg(fmt::color::green), "✓ {} timers fired on time and in order, {} cancelled stayed quiet\n",
+								 fired, cancelled);
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ Timer wheel fired {} (cancelled {}), on time {}, sorted {}\n", fired,
+								 cancelled, on_time, sorted);
+		}
+	}
+
+	// Callbacks may re-arm themselves and cancel timers due in the same tick
+	{
+		coro::TimerWheel wheel(1'000, 0);
+		struct Rearm {
+			coro::TimerNode node;
+			coro::TimerWheel* wheel;
+			coro::TimerNode* victim;
+			int runs = 0;
+		} rearm{};
+		coro::TimerNode victim{};
+		victim.callback = [](coro::TimerNode&) { throw std::logic_error("cancelled timer fired"); };
+		rearm.wheel = &wheel;
+		rearm.victim = &victim;
+		rearm.node.context = &rearm;
+		rearm.node.callback = [](coro::TimerNode& node) {
+			auto& self = *static_cast<Rearm*>(node.context);
+			self.wheel->cancel(*self.victim);
+			if (++self.runs < 3)
+				self.wheel->schedule(node, node.deadline_ns + 10'000);
+		};
+		wheel.schedule(rearm.node, 5'000);
+		wheel.schedule(victim, 5'000);
+		bool ok = true;
+		try {
+			for (uint64_t t = 0; t <= 100'000; t += 1'000)
+				wheel.advance(t);
+		} catch (const std::logic_error&) {
+			ok = false;
+		}
+		if (ok && rearm.runs == 3 && wheel.empty()) {
+			fmt::print(fg(fmt::color::green), "✓ Callbacks re-armed themselves and cancelled a same-tick timer\n");
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ Re-arm / cancel from callbacks broken ({} runs)\n", rearm.runs);
+		}
+	}
+
+	// Sleeping coroutines resume in deadline order, no earlier than asked
+	{
+		coro::Scheduler scheduler;
+		std::vector<int> trace;
+		auto slow = sleeper(trace, 3, std::chrono::microseconds(3000));
+		auto fast = sleeper(trace, 1, std::chrono::microseconds(500));
+		auto mid = sleeper(trace, 2, std::chrono::microseconds(1500));
+		auto start = std::chrono::steady_clock::now();
+		scheduler.spawn(fast);
+		scheduler.spawn(mid);
+		scheduler.block_on(slow);
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		scheduler.run_until_idle();
+		if (trace == std::vector<int>{1, 2, 3} && elapsed >= std::chrono::microseconds(3000)) {
+			fmt::print(fg(fmt::color::green), "✓ sleep_for resumed coroutines in deadline order after {} us\n",
+								 std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ sleep_for trace {} elapsed {} us\n", trace.size(),
+								 std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		}
+	}
+
+	// with_timeout: an empty ring times out; a push before the deadline wins
+	{
+		coro::Scheduler scheduler;
+		memory::AsyncRingBuffer<int, 4> ring;
+		auto waiter = [](memory::AsyncRingBuffer<int, 4>& ring,
+										 std::chrono::milliseconds timeout) -> coro::Task<std::optional<int>> {
+			co_return co_await coro::with_timeout(ring.pop_async(), timeout);
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		auto timed_out = waiter(ring, std::chrono::milliseconds(2));
+		auto missing = scheduler.block_on(timed_out);
+		auto waited = std::chrono::steady_clock::now() - start;
+
+		auto delivered = waiter(ring, std::chrono::milliseconds(2000));
+		std::thread producer([&ring] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			while (!ring.push(42)) {
+				std::this_thread::yield();
+			}
+		});
+		auto value = scheduler.block_on(delivered);
+		producer.join();
+		bool disarmed = scheduler.timers()->empty();
+
+		if (!missing && waited >= std::chrono::milliseconds(2) && value == 42 && disarmed) {
+			fmt::print(fg(fmt::color::green), "✓ with_timeout gave up after {} us and let a timely push through\n",
+								 std::chrono::duration_cast<std::chrono::microseconds>(waited).count());
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ with_timeout: missing {}, value {}, disarmed {}\n", missing.has_value(),
+								 value.value_or(-1), disarmed);
+		}
+	}
+
+	// A million O(1) order expiries: schedule, cancel half, sweep the rest
+	{
+		constexpr size_t kOrders = 1'000'000;
+		struct Order {
+			coro::TimerNode expiry;
+			bool expired = false;
+		};
+		std::vector<Order> orders(kOrders);
+		coro::TimerWheel wheel(1'000'000, 0);	 // 1 ms ticks, GTD-style deadlines
+		std::mt19937_64 rng(11);
+		auto start = std::chrono::steady_clock::now();
+		for (auto& order : orders) {
+			order.expiry.context = &order;
+			order.expiry.callback = [](coro::TimerNode& node) { static_cast<Order*>(node.context)->expired = true; };
+			wheel.schedule(order.expiry, rng() % (uint64_t{86'400} * 1'000'000'000));	// within a day
+		}
+		for (size_t i = 0; i < kOrders; i += 2) {
+			wheel.cancel(orders[i].expiry);
+		}
+		size_t expired = 0;
+		for (uint64_t t = 0; t <= uint64_t{86'400} * 1'000'000'000; t += uint64_t{60} * 1'000'000'000) {
+			expired += wheel.advance(t);
+		}
+		auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		bool all = expired == kOrders / 2 && wheel.empty();
+		for (size_t i = 1; i < kOrders && all; i += 2)
+			all = orders[i].expired;
+		if (all) {
+			fmt::print(fg(fmt::color::green), "✓ {} expiries scheduled, half cancelled, rest fired in {:.1f} ms\n",
+								 kOrders, ms);
+		} else {
+			fmt::print(fg(fmt::color::red), "✗ {} of {} order expiries fired\n", expired, kOrders / 2);
+		}
+	}
+	co_return;
+}
+
+// Test 29: Parallel backtest over multi-symbol captures
+coro::Task<void> test_backtest_runner() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 29: Parallel Backtest Runner ===\n");
+
+	constexpr uint32_t kSymbols = 8;
+	auto dir = std::filesystem::temp_directory_path();
+	std::array<std::string, 2> days{(dir / "coro_matching_test_day1.journal").string(),
+																	(dir / "coro_matching_test_day2.journal").string()};
+
+	// Live run over two "days", journaling each day to its own capture
+	std::vector<std::unique_ptr<SyncMatchingEngine<>>> live;
+	std::vector<std::vector<OrderId>> ids(kSymbols);
+	std::vector<size_t> live_fills(kSymbols);
+	std::vector<uint64_t> live_volume(kSymbols);
+	for (uint32_t s = 0; s < kSymbols; ++s) {
+		live.push_back(
+				std::make_unique<SyncMatchingEngine<>>(BookConfig{.symbol = SymbolId{100 + s}}));
+	}
+	uint64_t seed = 7;
+	size_t events = 0;
+	for (const auto& path : days) {
+		std::filesystem::remove(path);
+		auto journal = persistence::JournalWriter::open(path.c_str(), {.sync = false});
+		for (int i = 0; i < 40000; ++i) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			uint64_t r = seed >> 33;
+			// Skewed: low symbols see far fewer events than high ones
+			uint32_t s = static_cast<uint32_t>((r % 64) * (r % 64) / (64 * 64 / kSymbols));
+			OrderEvent event{.type = OrderEventType::New,
+											 .symbol = SymbolId{100 + s},
+											 .price = Price{9990 + static_cast<int64_t>((r >> 6) % 21)},
+											 .quantity = Quantity{1 + (r >> 12) % 50},
+											 .side = (r >> 18) % 2 ? Side::Buy : Side::Sell};
+			if (!ids[s].empty() && (r >> 20) % 5 == 0) {
+				event.type = (r >> 20) % 10 == 0 ? OrderEventType::Cancel : OrderEventType::Modify;
+				event.order_id = ids[s][(r >> 24) % ids[s].size()];
+			}
+			std::vector<OrderEvent> fills;
+			auto result =
+					persistence::process_journaled(*live[s], *journal, event, VectorEventSink{fills});
+			if (event.type == OrderEventType::New && result.is_ok()) {
+				ids[s].push_back(result.value().order_id);
+			}
+			live_fills[s] += fills.size();
+			for (const auto& fill : fills) {
+				live_volume[s] += fill.quantity.value;
+			}
+			++events;
+		}
+		// Output events in a capture are not replayed
+		journal->append(OrderEvent{.type = OrderEventType::Fill, .symbol = SymbolId{100}});
+		journal->wait_durable(journal->appended());
+	}
+
+	persistence::BacktestRunner<> runner;
+	bool opened = runner.add_capture(days[0].c_str()) && runner.add_capture(days[1].c_str()) &&
+								!runner.add_capture((dir / "coro_matching_test_missing.journal").string().c_str());
+
+	coro::ThreadPool one(1);
+	coro::ThreadPool four(4);
+	auto serial = runner.run(one, {.keep_fills = true});
+	auto parallel = runner.run(four, {.keep_fills = true});
+
+	bool matches_live =
+			serial.books.size() == kSymbols && serial.events == events && serial.skipped == 2;
+	for (uint32_t s = 0; matches_live && s < kSymbols; ++s) {
+		const auto& book = serial.books[s];
+		matches_live = book.symbol == SymbolId{100 + s} && book.fills == live_fills[s] &&
+									 book.volume == live_volume[s] &&
+									 book.resting_orders == live[s]->orderbook().order_count() &&
+									 book.best_bid == live[s]->get_best_bid() &&
+									 book.best_ask == live[s]->get_best_ask();
+	}
+	bool deterministic =
+			parallel.books.size() == serial.books.size() && parallel.fills == serial.fills;
+	for (size_t b = 0; deterministic && b < serial.books.size(); ++b) {
+		const auto& a = serial.books[b].fill_log;
+		const auto& p = parallel.books[b].fill_log;
+		deterministic =
+				std::equal(a.begin(), a.end(), p.begin(), p.end(), [](const auto& x, const auto& y) {
+					return x.order_id == y.order_id && x.price == y.price && x.quantity == y.quantity &&
+								 x.timestamp == y.timestamp;
+				});
+	}
+
+	if (opened && matches_live) {
+		fmt::print(fg(fmt::color::green),
+							 "✓ {} books, {} events from 2 captures: fills and books match the live run\n",
+							 serial.books.size(), serial.events);
+	} else {
+		fmt::print(fg(fmt::color::red),
+							 "✗ Backtest diverged from live run (opened={}, books={}, events={}, skipped={})\n",
+							 opened, serial.books.size(), serial.events, serial.skipped);
+	}
+	if (deterministic) {
+		fmt::print(fg(fmt::color::green),
+							 "✓ 1 and 4 workers give identical fills ({} fills, volume {}); {:.0f} vs {:.0f} "
+							 "events/s\n",
+							 parallel.fills, parallel.volume, serial.events_per_second(), parallel.events_per_second());
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Fills depend on the worker count\n");
+	}
+
+	for (const auto& path : days) {
+		std::filesystem::remove(path);
+	}
+	co_return;
+}
+
+// Test 30: Huge-page, NUMA-bound arena backing for books and rings
+coro::Task<void> test_page_arena() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 30: Page Arena Backing ===\n");
+
+	memory::PageArena arena({.pages = memory::PageSize::Huge2M});
+	constexpr std::array<const char*, 4> backings{"4 KB pages", "transparent huge pages",
+																								 "2 MB hugetlb pages", "1 GB hugetlb pages"};
+
+	// Same flow through a heap-backed and an arena-backed ladder book
+	BookConfig config{.ladder_ticks = 1 << 12, .max_orders = 1 << 14};
+	SyncMatchingEngine<LadderOrderBook> heap(config);
+	config.memory = &arena;
+	auto paged = arena.make<SyncMatchingEngine<LadderOrderBook>>(config);
+	size_t used = arena.used_bytes();
+
+	std::vector<OrderEvent> heap_fills;
+	std::vector<OrderEvent> paged_fills;
+	uint64_t seed = 3;
+	for (int i = 0; i < 20000; ++i) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		uint64_t r = seed >> 33;
+		OrderEvent event{.type = OrderEventType::New,
+										 .price = Price{9990 + static_cast<int64_t>(r % 21)},
+										 .quantity = Quantity{1 + (r >> 8) % 50},
+										 .side = (r >> 16) % 2 ? Side::Buy : Side::Sell};
+		heap.process_event(event, VectorEventSink{heap_fills});
+		paged->process_event(event, VectorEventSink{paged_fills});
+	}
+	bool same = heap_fills.size() == paged_fills.size() &&
+							heap.orderbook().order_count() == paged->orderbook().order_count() &&
+							heap.get_best_bid() == paged->get_best_bid() &&
+							arena.used_bytes() == used;	 // Nothing allocated after construction
+	for (size_t i = 0; same && i < heap_fills.size(); ++i) {
+		same = heap_fills[i].order_id == paged_fills[i].order_id &&
+					 heap_fills[i].quantity == paged_fills[i].quantity;
+	}
+
+	// A ring made on the arena keeps its slots there
+	using Ring = memory::AsyncRingBuffer<OrderEvent, 4096>;
+	auto ring = arena.make<Ring>();
+	bool ring_ok = reinterpret_cast<uintptr_t>(ring.get()) % alignof(Ring) == 0;
+	for (uint64_t i = 1; i <= 10000 && ring_ok; ++i) {
+		ring_ok = ring->push(OrderEvent{.order_id = OrderId{i}}) &&
+							ring->pop()->order_id == OrderId{i};
+	}
+
+	if (same && ring_ok) {
+		fmt::print(fg(fmt::color::green),
+							 "✓ Book and ring on {} ({} MB mapped, {} KB used); fills match the heap book\n",
+							 backings[static_cast<size_t>(arena.backing())], arena.mapped_bytes() >> 20,
+							 arena.used_bytes() >> 10);
+	} else {
+		fmt::print(fg(fmt::color::red), "✗ Arena-backed book or ring diverged (book={}, ring={})\n", same,
+							 ring_ok);
+	}
+	fmt::print("  NUMA node {} {}\n", memory::current_numa_node(),
+						 arena.numa_bound() ? "(bound)" : "(mbind unavailable, first touch only)");
+
+	paged.reset();
+	ring.reset();
+	co_return;
+}
+
+// Test 31: Shared-memory ring between processes
+using ShmRing = memory::ShmRingBuffer<PackedOrderEvent, 64>;
+
+coro::Task<uint64_t> shm_producer(ShmRing& ring, uint64_t count) {
+	uint64_t sent = 0;
+	for (uint64_t i = 1; i <= count; ++i) {
+		if (!co_await ring.push_async(PackedOrderEvent::from_event(OrderEvent{.order_id = OrderId{i}})))
+			break;
+		++sent;
+	}
+	ring.close();
+	co_return sent;
+}
+
+coro::Task<uint64_t> shm_consumer(ShmRing& ring) {
+	uint64_t in_order = 0;
+	while (auto event = co_await ring.pop_async()) {
+		if (event->order_id == in_order + 1) {
+			++in_order;
+		}
+	}
+	co_return in_order;
+}
+
+coro::Task<void> test_shm_ring_buffer() {
+	fmt::print(fg(fmt::color::cyan), "\n=== Test 31: Shared-Memory Ring Between Processes ===\n");
+
+	constexpr uint64_t kEvents = 200000;
+	std::string name = fmt::format("/me_shm_ring_{}", ::getpid());
+	ShmRing::unlink(name.c_str());
+
+	// The child opens the segment once the parent has created it and feeds
+	// it through a 64-slot ring, so both sides keep parking on each other
+	pid_t child = ::fork();
+	if (child == 0) {
+		std::unique_ptr<ShmRing> ring;
+		for (int tries = 0; !ring && tries < 5000; ++tries) {
+			ring = ShmRing::open(name.c_str(), memory::ShmRole::Producer);
+			if (!ring) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+		if (!ring) {
+			::_exit(2);
+		}
+		coro::Scheduler scheduler;
+		auto producer = shm_producer(*ring, kEvents);
+		uint64_t sent = scheduler.block_on(producer);
+		ring.reset();
+		::_exit(sent == kEvents ? 0 : 1);
+	}
+
+	auto ring = ShmRing::create(name.c_str(), memory::ShmRole::Consumer);
+	uint64_t received = 0;
+	std::chrono::steady_clock::duration elapsed{};
+	if (ring) {
+		coro::Scheduler scheduler;
+		auto start = std::chrono::steady_clock::now();
+		auto consumer = shm_consumer(*ring);
+		received = scheduler.block_on(consumer);
+		elapsed = std::chrono::steady_clock::now() - start;
+	}
+	int status = -1;
+	::waitpid(child, &status, 0);
+	bool child_ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	bool reopen_rejected =
+			!memory::ShmRingBuffer<PackedOrderEvent, 128>::open(name.c_str(), memory::ShmRole::Producer);
+	ShmRing::unlink(name.c_str());
+
+	if (ring && child_ok && received == kEvents && reopen_rejected) {
+		auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+		fmt::print(fg(fmt::color::green),
+							 "✓ {} events from another process in order via pop_async ({:.1f} M/s)\n", received,
+							 static_cast<double>(received) / static_cast<double>(std::max<int64_t>(us, 1)));
+		fmt::print(fg(fmt::color::green), "✓ Segment with a different capacity refused to open\n");
+	} else {
+		fmt::print(fg(fmt::color::red),
+							 "✗ Shared-memory ring: created {}, child ok {}, received {}, reopen rejected {}\n",
+							 ring != nullptr, child_ok, received, reopen_rejected);
+	}
+	co_return;
+}
+
+int main() {
+	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+						 "\n╔══════════════════════════════════════╗\n");
+	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+						 "║  Coroutine Matching Engine Tests    ║\n");
+	fmt::print(fg(fmt::color::magenta) | fmt::emphasis::bold,
+						 "╚══════════════════════════════════════╝\n");
+
+	// Run all tests
+	auto test1 = test_async_order_submission();
+	while (!test1.done()) {
+		test1.resume();
+	}
+
+	auto test2 = test_producer_consumer();
+	while (!test2.done()) {
+		test2.resume();
+	}
+
+	auto test3 = test_batch_processing();
+	while (!test3.done()) {
+		test3.resume();
+	}
+
+	auto test4 = test_market_depth_monitoring();
+	while (!test4.done()) {
+		test4.resume();
+	}
+
+	auto test5 = test_ring_buffer_async();
+	while (!test5.done()) {
+		test5.resume();
+	}
+
+	auto test6 = test_ladder_orderbook();
+	while (!test6.done()) {
+		test6.resume();
+	}
+
+	auto test7 = test_cancel_modify();
+	while (!test7.done()) {
+		test7.resume();
+	}
+
+	auto test8 = test_event_sinks();
+	while (!test8.done()) {
+		test8.resume();
+	}
+
+	auto test9 = test_packed_events();
+	while (!test9.done()) {
+		test9.resume();
+	}
+
+	auto test10 = test_clock_policies();
+	while (!test10.done()) {
+		test10.resume();
+	}
+
+	auto test11 = test_parking_awaitables();
+	while (!test11.done()) {
+		test11.resume();
+	}
+
+	auto test12 = test_mpmc_ring_buffer();
+	while (!test12.done()) {
+		test12.resume();
+	}
+
+	auto test13 = test_bulk_ring_buffer();
+	while (!test13.done()) {
+		test13.resume();
+	}
+
+	auto test14 = test_scheduler_run_loops();
+	while (!test14.done()) {
+		test14.resume();
+	}
+
+	auto test15 = test_thread_pool();
+	while (!test15.done()) {
+		test15.resume();
+	}
+
+	auto test16 = test_frame_recycling();
+	while (!test16.done()) {
+		test16.resume();
+	}
+
+	auto test17 = test_multi_symbol_engine();
+	while (!test17.done()) {
+		test17.resume();
+	}
+
+	auto test18 = test_incremental_depth();
+	while (!test18.done()) {
+		test18.resume();
+	}
+
+	auto test19 = test_l2_delta_feed();
+	while (!test19.done()) {
+		test19.resume();
+	}
+
+	auto test20 = test_journal_replay();
+	while (!test20.done()) {
+		test20.resume();
+	}
+
+	auto test21 = test_snapshot_recovery();
+	while (!test21.done()) {
+		test21.resume();
+	}
+
+	auto test22 = test_level_sweep();
+	while (!test22.done()) {
+		test22.resume();
+	}
+
+	auto test23 = test_order_types();
+	while (!test23.done()) {
+		test23.resume();
+	}
+
+	auto test24 = test_self_trade_and_risk();
+	while (!test24.done()) {
+		test24.resume();
+	}
+
+	auto test25 = test_metrics();
+	while (!test25.done()) {
+		test25.resume();
+	}
+
+	auto test26 = test_prices_and_ticks();
+	while (!test26.done()) {
+		test26.resume();
+	}
+
+	auto test27 = test_top_of_book_seqlock();
+	while (!test27.done()) {
+		test27.resume();
+	}
+
+	auto test28 = test_timer_wheel();
+	while (!test28.done()) {
+		test28.resume();
+	}
+
+	auto test29 = test_backtest_runner();
+	while (!test29.done()) {
+		test29.resume();
+	}
+
+	auto test30 = test_page_arena();
+	while (!test30.done()) {
+		test30.resume();
+	}
+
+	auto test31 = test_shm_ring_buffer();
+	while (!test31.done()) {
+		test31.resume();
 	}
 
 	fmt::print(fg(fmt::color::green) | fmt::emphasis::bold, "\n✓ All tests completed!\n\n");